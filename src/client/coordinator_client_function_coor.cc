@@ -96,8 +96,10 @@ dingodb::pb::common::RawEngine GetRawEngine(const std::string& engine_name) {
     return dingodb::pb::common::RawEngine::RAW_ENG_ROCKSDB;
   } else if (engine_name == "bdb") {
     return dingodb::pb::common::RawEngine::RAW_ENG_BDB;
+  } else if (engine_name == "memory") {
+    return dingodb::pb::common::RawEngine::RAW_ENG_MEMORY;
   } else {
-    DINGO_LOG(FATAL) << "raw_engine_name is illegal, please input -raw-engine=[rocksdb, bdb]";
+    DINGO_LOG(FATAL) << "raw_engine_name is illegal, please input -raw-engine=[rocksdb, bdb, memory]";
   }
 }
 
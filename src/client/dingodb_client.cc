@@ -128,7 +128,7 @@ DEFINE_string(scalar_filter_value2, "", "Request scalar_filter_value");
 DEFINE_int64(ttl, 0, "ttl");
 DEFINE_bool(auto_split, false, "auto split");
 DEFINE_string(engine, "rocksdb", "engine type for table and index, [rocksdb, bdb]");
-DEFINE_string(raw_engine, "", "engine type for table and index, [rocksdb, bdb]");
+DEFINE_string(raw_engine, "", "engine type for table and index, [rocksdb, bdb, memory]");
 DEFINE_int64(status, 0, "status");
 DEFINE_int64(errcode, -1, "errcode");
 DEFINE_string(errmsg, "", "errmsg");
@@ -122,6 +122,14 @@ class Constant {
   inline static const std::string kMaxBytesForLevelMultiplier = "max_bytes_for_level_multiplier";
   inline static const std::string kMaxBytesForLevelMultiplierDefaultValue = "10";
 
+  // store-wide block cache and memtable budget
+  inline static const std::string kStoreBlockCacheType = "store.block_cache.type";
+  inline static const std::string kStoreBlockCacheCapacity = "store.block_cache.capacity";
+  inline static const std::string kBlockCacheTypeLRU = "lru";
+  inline static const std::string kBlockCacheTypeHyperClock = "hyper_clock";
+  inline static const std::string kStoreWriteBufferManagerBufferSize = "store.write_buffer_manager.buffer_size";
+  inline static const std::string kStoreWriteBufferManagerCostToCache = "store.write_buffer_manager.cost_to_cache";
+
   static const int kRocksdbBackgroundThreadNumDefault = 16;
   static const int kStatsDumpPeriodSecDefault = 600;
 
@@ -14,6 +14,8 @@
 
 #include "common/synchronization.h"
 
+#include <cerrno>
+
 namespace dingodb {
 
 // BthreadCond
@@ -97,6 +99,24 @@ int BthreadCond::TimedWait(int64_t timeout_us, int cond) {
   return ret;
 }
 
+int BthreadCond::QuietTimedWait(int64_t timeout_us, int cond) {
+  int ret = 0;
+  timespec tm = butil::microseconds_from_now(timeout_us);
+  bthread_mutex_lock(&mutex_);
+  while (count_ > cond) {
+    ret = bthread_cond_timedwait(&cond_, &mutex_, &tm);
+    if (ret != 0) {
+      if (ret != ETIMEDOUT) {
+        DINGO_LOG(WARNING) << "wait failed, ret: " << ret;
+      }
+      break;
+    }
+  }
+
+  bthread_mutex_unlock(&mutex_);
+  return ret;
+}
+
 int BthreadCond::IncreaseTimedWait(int64_t timeout_us, int cond) {
   int ret = 0;
   timespec tm = butil::microseconds_from_now(timeout_us);
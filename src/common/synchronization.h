@@ -37,6 +37,8 @@ class BthreadCond {
   int Wait(int cond = 0);
   int IncreaseWait(int cond = 0);
   int TimedWait(int64_t timeout_us, int cond = 0);
+  // Same as TimedWait, but timeout is expected and not logged.
+  int QuietTimedWait(int64_t timeout_us, int cond = 0);
   int IncreaseTimedWait(int64_t timeout_us, int cond = 0);
 
  private:
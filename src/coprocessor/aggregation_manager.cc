@@ -14,13 +14,17 @@
 
 #include "coprocessor/aggregation_manager.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <exception>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "common/logging.h"
 #include "fmt/core.h"
@@ -314,32 +318,43 @@ butil::Status AggregationManager::Open(
     i++;
   }
 
+  InitColumnBatchOpers();
+
   return butil::Status();
 }
 
-butil::Status AggregationManager::Execute(const std::string& group_by_key,
-                                          const std::vector<std::any>& group_by_operator_record) {
-  butil::Status status;
-  std::shared_ptr<Aggregation> aggregation;
-
+butil::Status AggregationManager::GetOrCreateAggregation(const std::string& group_by_key,
+                                                         std::shared_ptr<Aggregation>* aggregation) {
   if (!aggregations_) {
     using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
     aggregations_ = std::make_shared<MapType>();
   }
 
   const auto& iter = aggregations_->find(group_by_key);
-  if (iter == aggregations_->end()) {
-    const auto& [iter_new, _] = aggregations_->emplace(group_by_key, std::make_shared<Aggregation>());
-    aggregation = iter_new->second;
-
-    status = aggregation->Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
-                               result_serial_schemas_, aggregation_operators_);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
-      return status;
-    }
-  } else {
-    aggregation = iter->second;
+  if (iter != aggregations_->end()) {
+    *aggregation = iter->second;
+    return butil::Status();
+  }
+
+  const auto& [iter_new, _] = aggregations_->emplace(group_by_key, std::make_shared<Aggregation>());
+  *aggregation = iter_new->second;
+
+  auto status = (*aggregation)->Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
+                                     result_serial_schemas_, aggregation_operators_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
+    return status;
+  }
+
+  return butil::Status();
+}
+
+butil::Status AggregationManager::Execute(const std::string& group_by_key,
+                                          const std::vector<std::any>& group_by_operator_record) {
+  std::shared_ptr<Aggregation> aggregation;
+  butil::Status status = GetOrCreateAggregation(group_by_key, &aggregation);
+  if (!status.ok()) {
+    return status;
   }
 
   status = aggregation->Execute(aggregation_functions_, group_by_operator_record);
@@ -351,6 +366,187 @@ butil::Status AggregationManager::Execute(const std::string& group_by_key,
   return butil::Status();
 }
 
+// Reduce kernels of column batch, branchless so the compiler can vectorize them.
+template <typename T>
+static int64_t ReduceSum(const std::vector<T>& values, const std::vector<uint8_t>& valids, T* sum) {
+  T sum_value = 0;
+  int64_t valid_count = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    sum_value += values[i];
+    valid_count += valids[i];
+  }
+  *sum = sum_value;
+  return valid_count;
+}
+
+template <typename T>
+static int64_t ReduceMax(const std::vector<T>& values, const std::vector<uint8_t>& valids, T* max) {
+  T max_value = std::numeric_limits<T>::lowest();
+  int64_t valid_count = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    max_value = (valids[i] != 0 && values[i] > max_value) ? values[i] : max_value;
+    valid_count += valids[i];
+  }
+  *max = max_value;
+  return valid_count;
+}
+
+template <typename T>
+static int64_t ReduceMin(const std::vector<T>& values, const std::vector<uint8_t>& valids, T* min) {
+  T min_value = std::numeric_limits<T>::max();
+  int64_t valid_count = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    min_value = (valids[i] != 0 && values[i] < min_value) ? values[i] : min_value;
+    valid_count += valids[i];
+  }
+  *min = min_value;
+  return valid_count;
+}
+
+static int64_t ReduceCount(const std::vector<uint8_t>& valids) {
+  int64_t valid_count = 0;
+  for (auto valid : valids) {
+    valid_count += valid;
+  }
+  return valid_count;
+}
+
+// Merge the partial of one batch into the result, same as the row by row aggregation functions.
+template <typename T, typename REDUCE, typename MERGE>
+static void MergeColumnBatch(const std::vector<T>& values, const std::vector<uint8_t>& valids, REDUCE reduce,
+                             MERGE merge, std::any* result) {
+  T partial;
+  if (reduce(values, valids, &partial) == 0) {
+    return;
+  }
+
+  std::optional<T>& result_value = std::any_cast<std::optional<T>&>(*result);
+  result_value = result_value.has_value() ? merge(result_value.value(), partial) : partial;
+}
+
+butil::Status AggregationManager::ExecuteColumnBatch(const std::string& group_by_key,
+                                                     const std::vector<AggregationColumnBatch>& columns) {
+  if (columns.size() != column_batch_opers_.size()) {
+    std::string error_message =
+        fmt::format("column batch size : {} not match operator size : {}", columns.size(), column_batch_opers_.size());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  std::shared_ptr<Aggregation> aggregation;
+  butil::Status status = GetOrCreateAggregation(group_by_key, &aggregation);
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto& result_record = *aggregation->GetResult();
+  try {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const auto& column = columns[i];
+      std::any* result = &result_record[i];
+      switch (column_batch_opers_[i]) {
+        case ColumnBatchOper::kSumLong:
+          MergeColumnBatch(column.longs, column.valids, ReduceSum<int64_t>, std::plus<int64_t>(), result);
+          break;
+        case ColumnBatchOper::kSumDouble:
+          MergeColumnBatch(column.doubles, column.valids, ReduceSum<double>, std::plus<double>(), result);
+          break;
+        case ColumnBatchOper::kMaxLong:
+          MergeColumnBatch(
+              column.longs, column.valids, ReduceMax<int64_t>,
+              [](int64_t lhs, int64_t rhs) { return std::max(lhs, rhs); }, result);
+          break;
+        case ColumnBatchOper::kMaxDouble:
+          MergeColumnBatch(
+              column.doubles, column.valids, ReduceMax<double>,
+              [](double lhs, double rhs) { return lhs < rhs ? rhs : lhs; }, result);
+          break;
+        case ColumnBatchOper::kMinLong:
+          MergeColumnBatch(
+              column.longs, column.valids, ReduceMin<int64_t>,
+              [](int64_t lhs, int64_t rhs) { return std::min(lhs, rhs); }, result);
+          break;
+        case ColumnBatchOper::kMinDouble:
+          MergeColumnBatch(
+              column.doubles, column.valids, ReduceMin<double>,
+              [](double lhs, double rhs) { return lhs > rhs ? rhs : lhs; }, result);
+          break;
+        case ColumnBatchOper::kCount: {
+          std::optional<int64_t>& result_value = std::any_cast<std::optional<int64_t>&>(*result);
+          result_value = result_value.value_or(0) + ReduceCount(column.valids);
+          break;
+        }
+        case ColumnBatchOper::kCountWithNull: {
+          std::optional<int64_t>& result_value = std::any_cast<std::optional<int64_t>&>(*result);
+          result_value = result_value.value_or(0) + column.selected_count;
+          break;
+        }
+      }
+    }
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("ExecuteColumnBatch exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  return butil::Status();
+}
+
+void AggregationManager::InitColumnBatchOpers() {
+  column_batch_opers_.clear();
+
+  size_t start_aggregation_operators_index = result_serial_schemas_->size() - aggregation_operators_.size();
+  std::vector<ColumnBatchOper> opers;
+  size_t i = 0;
+  for (const auto& aggregation_operator : aggregation_operators_) {
+    BaseSchema::Type serial_schema_type = (*group_by_operator_serial_schemas_)[i]->GetType();
+    BaseSchema::Type result_schema_type = (*result_serial_schemas_)[i + start_aggregation_operators_index]->GetType();
+    bool is_long = serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong;
+    bool is_double = serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble;
+    i++;
+
+    switch (aggregation_operator.oper()) {
+      case pb::store::AggregationType::SUM0:
+        [[fallthrough]];
+      case pb::store::AggregationType::SUM:
+        if (!is_long && !is_double) {
+          return;
+        }
+        opers.push_back(is_long ? ColumnBatchOper::kSumLong : ColumnBatchOper::kSumDouble);
+        break;
+      case pb::store::AggregationType::MAX:
+        if (!is_long && !is_double) {
+          return;
+        }
+        opers.push_back(is_long ? ColumnBatchOper::kMaxLong : ColumnBatchOper::kMaxDouble);
+        break;
+      case pb::store::AggregationType::MIN:
+        if (!is_long && !is_double) {
+          return;
+        }
+        opers.push_back(is_long ? ColumnBatchOper::kMinLong : ColumnBatchOper::kMinDouble);
+        break;
+      case pb::store::AggregationType::COUNT:
+        // count value of column need a typed column to check null.
+        if (aggregation_operator.index_of_column() == -1) {
+          opers.push_back(ColumnBatchOper::kCountWithNull);
+        } else if (serial_schema_type == BaseSchema::kLong || serial_schema_type == BaseSchema::kDouble) {
+          opers.push_back(ColumnBatchOper::kCount);
+        } else {
+          return;
+        }
+        break;
+      case pb::store::AggregationType::COUNTWITHNULL:
+        opers.push_back(ColumnBatchOper::kCountWithNull);
+        break;
+      default:
+        return;
+    }
+  }
+
+  column_batch_opers_ = std::move(opers);
+}
+
 void AggregationManager::Close() {
   if (group_by_operator_serial_schemas_) {
     group_by_operator_serial_schemas_.reset();
@@ -363,6 +559,7 @@ void AggregationManager::Close() {
   }
 
   aggregation_functions_.clear();
+  column_batch_opers_.clear();
 
   if (aggregations_) {
     aggregations_.reset();
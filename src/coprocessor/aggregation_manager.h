@@ -18,6 +18,7 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -49,6 +50,23 @@ class AggregationIterator {
   std::map<std::string, std::shared_ptr<Aggregation>>::iterator iter_;
 };
 
+// One aggregation operator column of a batch of rows, decoded into a typed array so the reduce is a tight loop.
+// valids[i] is 1 when row i is selected and the column is not null, values of invalid rows are 0.
+struct AggregationColumnBatch {
+  std::vector<int64_t> longs;
+  std::vector<double> doubles;
+  std::vector<uint8_t> valids;
+  // rows of the batch that pass the filter, for COUNTWITHNULL.
+  int64_t selected_count = 0;
+
+  void Clear() {
+    longs.clear();
+    doubles.clear();
+    valids.clear();
+    selected_count = 0;
+  }
+};
+
 class AggregationManager {
  public:
   AggregationManager();
@@ -65,11 +83,32 @@ class AggregationManager {
 
   butil::Status Execute(const std::string& group_by_key, const std::vector<std::any>& group_by_operator_record);
 
+  // Column batch only support SUM/SUM0/MAX/MIN of LONG or DOUBLE and COUNT/COUNTWITHNULL.
+  bool IsSupportColumnBatch() const { return !column_batch_opers_.empty(); }
+  // Return the type of column batch of operator i, kLong or kDouble.
+  BaseSchema::Type GetColumnBatchType(size_t i) const { return (*group_by_operator_serial_schemas_)[i]->GetType(); }
+  // columns[i] is the column of aggregation operator i.
+  butil::Status ExecuteColumnBatch(const std::string& group_by_key, const std::vector<AggregationColumnBatch>& columns);
+
   std::shared_ptr<AggregationIterator> CreateIterator();
 
   void Close();
 
  private:
+  enum class ColumnBatchOper {
+    kSumLong,
+    kSumDouble,
+    kMaxLong,
+    kMaxDouble,
+    kMinLong,
+    kMinDouble,
+    kCount,
+    kCountWithNull,
+  };
+
+  butil::Status GetOrCreateAggregation(const std::string& group_by_key, std::shared_ptr<Aggregation>* aggregation);
+  void InitColumnBatchOpers();
+
   butil::Status AddSumFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
   butil::Status AddCountFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
   butil::Status AddCountWithNullFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
@@ -81,6 +120,8 @@ class AggregationManager {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
   std::vector<std::function<bool(const std::any&, std::any*)>> aggregation_functions_;
   std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
+  // empty when some operator not support column batch.
+  std::vector<ColumnBatchOper> column_batch_opers_;
 };
 
 }  // namespace dingodb
@@ -26,6 +26,7 @@
 #include "common/logging.h"
 #include "coprocessor/utils.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
 #include "serial/record_decoder.h"
@@ -34,6 +35,8 @@
 // Must be after proto, otherwise it will cause naming collision. such as TYPE_STRING
 #include "libexpr/src/runner.h"
 
+DEFINE_int32(coprocessor_batch_size, 1024, "coprocessor decode and execute rows by batch, 1 means row by row");
+
 namespace dingodb {
 
 Coprocessor::Coprocessor() : enable_expression_(true), end_of_group_by_(true) {}
@@ -174,6 +177,29 @@ butil::Status Coprocessor::Open(const pb::store::Coprocessor& coprocessor) {
   }
   enable_expression_ = !coprocessor_.expression().empty();
 
+  original_record_decoder_ = std::make_shared<RecordDecoder>(
+      coprocessor_.schema_version(), original_serial_schemas_, coprocessor_.original_schema().common_id());
+  result_record_encoder_ = std::make_shared<RecordEncoder>(
+      coprocessor_.schema_version(), result_serial_schemas_sorted_, coprocessor_.result_schema().common_id());
+  if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
+    group_by_key_encoder_ = std::make_shared<RecordEncoder>(
+        coprocessor_.schema_version(), group_by_key_serial_schemas_, coprocessor_.result_schema().common_id());
+  }
+
+  // decode expression only once, every row just bind tuple and run.
+  if (enable_expression_) {
+    expr_runner_ = std::make_shared<expr::Runner>();
+    try {
+      expr_runner_->Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
+                           coprocessor_.expression().length());
+    } catch (const std::exception& my_exception) {
+      expr_runner_.reset();
+      std::string error_message = fmt::format("expr::Runner Decode failed. exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open enable_expression_ : {}", enable_expression_);
 
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open Leave");
@@ -192,10 +218,15 @@ butil::Status Coprocessor::Open(const pb::store::Coprocessor& coprocessor) {
 butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                    std::vector<pb::common::KeyValue>* kvs) {
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Execute Enter");
+  if (FLAGS_coprocessor_batch_size > 1) {
+    return ExecuteBatch(iter, key_only, max_fetch_cnt, max_bytes_rpc, kvs);
+  }
+
   ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
+  // reuse key value buffer across rows.
+  pb::common::KeyValue kv;
   while (iter->Valid()) {
-    pb::common::KeyValue kv;
     *kv.mutable_key() = iter->Key();
     *kv.mutable_value() = iter->Value();
     bool has_result_kv = false;
@@ -231,14 +262,189 @@ butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_f
 
   return status;
 }
-butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_result_kv,
-                                     pb::common::KeyValue* result_kv) {
+// Batch mode, every round:
+// 1. read a batch of key values from iterator.
+// 2. decode the batch into records and run expression into a selection bitmap.
+// 3. aggregate or select the selected records, aggregation without group by keys reduce typed columns.
+butil::Status Coprocessor::ExecuteBatch(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                                        std::vector<pb::common::KeyValue>* kvs) {
+  ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
 
-  RecordDecoder original_record_decoder(coprocessor_.schema_version(), original_serial_schemas_,
-                                        coprocessor_.original_schema().common_id());
+  size_t batch_size = FLAGS_coprocessor_batch_size;
+  if (!end_of_group_by_ && max_fetch_cnt > 0) {
+    // selection return at most max_fetch_cnt rows, not read more.
+    batch_size = std::min(batch_size, max_fetch_cnt);
+  }
+  if (batch_kvs_.size() < batch_size) {
+    batch_kvs_.resize(batch_size);
+    batch_records_.resize(batch_size);
+  }
+
+  while (iter->Valid()) {
+    size_t count = 0;
+    for (; count < batch_size && iter->Valid(); ++count, iter->Next()) {
+      *batch_kvs_[count].mutable_key() = iter->Key();
+      *batch_kvs_[count].mutable_value() = iter->Value();
+    }
+
+    batch_selection_.assign(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+      status = DecodeRecord(batch_kvs_[i], &batch_records_[i]);
+      if (!status.ok()) {
+        return status;
+      }
+
+      bool is_key_value_reserve = true;
+      status = FilterRecord(batch_records_[i], &is_key_value_reserve);
+      if (!status.ok()) {
+        return status;
+      }
+      batch_selection_[i] = is_key_value_reserve ? 1 : 0;
+    }
+
+    if (end_of_group_by_ && coprocessor_.group_by_columns().empty()) {
+      status = OpenAggregationManager();
+      if (!status.ok()) {
+        return status;
+      }
+      if (aggregation_manager_->IsSupportColumnBatch()) {
+        status = DoExecuteBatchForColumnAggregation(count);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("Coprocessor::DoExecuteBatchForColumnAggregation failed");
+          return status;
+        }
+        continue;
+      }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      if (batch_selection_[i] == 0) {
+        continue;
+      }
+
+      bool has_result_kv = false;
+      pb::common::KeyValue result_key_value;
+      status = DoExecuteRecord(batch_records_[i], &has_result_kv, &result_key_value);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("Coprocessor::ExecuteBatch failed");
+        return status;
+      }
+      if (!has_result_kv) {
+        continue;
+      }
+
+      if (key_only) {
+        result_key_value.set_value("");
+      }
+
+      kvs->emplace_back(std::move(result_key_value));
+
+      if (scan_filter.UptoLimit(kvs->back())) {
+        // iterator is ahead of the batch, seek back to the first row not executed.
+        if (i + 1 < count) {
+          iter->Seek(batch_kvs_[i + 1].key());
+        }
+        return butil::Status();
+      }
+    }
+  }
+
+  return GetKeyValueFromAggregation(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
+}
+
+// Aggregation without group by keys, gather operator columns of the batch into typed arrays.
+butil::Status Coprocessor::DoExecuteBatchForColumnAggregation(size_t count) {
+  const auto& aggregation_operators = coprocessor_.aggregation_operators();
+  batch_columns_.resize(aggregation_operators.size());
+
+  int64_t selected_count = 0;
+  for (size_t i = 0; i < count; ++i) {
+    selected_count += batch_selection_[i];
+  }
+
+  for (int j = 0; j < aggregation_operators.size(); ++j) {
+    const auto& aggregation = aggregation_operators[j];
+    int32_t index_of_column =
+        (aggregation.index_of_column() < 0 || aggregation.index_of_column() >= selection_column_indexes_.size())
+            ? 0
+            : aggregation.index_of_column();
+
+    auto& column = batch_columns_[j];
+    column.Clear();
+    column.selected_count = selected_count;
+
+    auto type = aggregation_manager_->GetColumnBatchType(j);
+    if (type != BaseSchema::kLong && type != BaseSchema::kDouble) {
+      // only COUNTWITHNULL, selected_count is enough.
+      continue;
+    }
+
+    column.valids.resize(count, 0);
+    if (type == BaseSchema::kLong) {
+      column.longs.resize(count, 0);
+    } else {
+      column.doubles.resize(count, 0.0);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      if (batch_selection_[i] == 0) {
+        continue;
+      }
+
+      const std::any& value = batch_records_[i][index_of_column];
+      if (type == BaseSchema::kLong) {
+        const auto* long_value = std::any_cast<std::optional<int64_t>>(&value);
+        if (long_value == nullptr) {
+          std::string error_message = fmt::format("column {} is not long", index_of_column);
+          DINGO_LOG(ERROR) << error_message;
+          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+        }
+        if (long_value->has_value()) {
+          column.longs[i] = long_value->value();
+          column.valids[i] = 1;
+        }
+      } else {
+        const auto* double_value = std::any_cast<std::optional<double>>(&value);
+        if (double_value == nullptr) {
+          std::string error_message = fmt::format("column {} is not double", index_of_column);
+          DINGO_LOG(ERROR) << error_message;
+          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+        }
+        if (double_value->has_value()) {
+          column.doubles[i] = double_value->value();
+          column.valids[i] = 1;
+        }
+      }
+    }
+  }
+
+  return aggregation_manager_->ExecuteColumnBatch("", batch_columns_);
+}
 
+butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_result_kv,
+                                     pb::common::KeyValue* result_kv) {
   std::vector<std::any> original_record;
+  butil::Status status = DecodeRecord(kv, &original_record);
+  if (!status.ok()) {
+    return status;
+  }
+
+  bool is_key_value_reserve = true;
+  status = FilterRecord(original_record, &is_key_value_reserve);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // discard this key value
+  if (!is_key_value_reserve) {
+    return butil::Status();
+  }
+
+  return DoExecuteRecord(original_record, has_result_kv, result_kv);
+}
+
+butil::Status Coprocessor::DecodeRecord(const pb::common::KeyValue& kv, std::vector<std::any>* original_record) {
 
   // if (original_column_indexes_.empty()) {
   //   GetOriginalColumnIndexes();
@@ -255,7 +461,7 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
   int ret = 0;
   try {
     // decode some column. not decode all
-    ret = original_record_decoder.Decode(kv, selection_column_indexes_, original_record);
+    ret = original_record_decoder_->Decode(kv, selection_column_indexes_, *original_record);
   } catch (const std::exception& my_exception) {
     std::string error_message = fmt::format("serial::Decode failed exception : {}", my_exception.what());
     DINGO_LOG(ERROR) << error_message;
@@ -286,29 +492,30 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
   //    i++;
   //  }
 
-  bool is_key_value_reserve = true;
-  if (enable_expression_) {
-    expr::Runner runner;
+  return butil::Status();
+}
 
+butil::Status Coprocessor::FilterRecord(const std::vector<std::any>& original_record, bool* is_key_value_reserve) {
+  *is_key_value_reserve = true;
+  if (enable_expression_) {
     try {
-      runner.Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
-                    coprocessor_.expression().length());
-      runner.BindTuple(reinterpret_cast<const expr::Tuple*>(&original_record));
-      runner.Run();
-      expr::Wrap<bool> ok = runner.GetResult<bool>();
-      is_key_value_reserve = ok.has_value() && ok.value();
+      expr_runner_->BindTuple(reinterpret_cast<const expr::Tuple*>(&original_record));
+      expr_runner_->Run();
+      expr::Wrap<bool> ok = expr_runner_->GetResult<bool>();
+      *is_key_value_reserve = ok.has_value() && ok.value();
     } catch (const std::exception& my_exception) {
-      std::string error_message = fmt::format("expr::Runner Decode or Run failed. exception : {}", my_exception.what());
+      std::string error_message = fmt::format("expr::Runner Run failed. exception : {}", my_exception.what());
       DINGO_LOG(ERROR) << error_message;
       return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
   }
 
-  // discard this key value
-  if (!is_key_value_reserve) {
-    return butil::Status();
-  }
+  return butil::Status();
+}
 
+butil::Status Coprocessor::DoExecuteRecord(const std::vector<std::any>& original_record, bool* has_result_kv,
+                                           pb::common::KeyValue* result_kv) {
+  butil::Status status;
   if (end_of_group_by_) {  // group by
     status = DoExecuteForAggregation(original_record);
     if (!status.ok()) {
@@ -386,12 +593,10 @@ butil::Status Coprocessor::DoExecuteForAggregation(const std::vector<std::any>&
 
   std::string group_by_key;
   if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
-    RecordEncoder group_by_key_encoder(coprocessor_.schema_version(), group_by_key_serial_schemas_,
-                                       coprocessor_.result_schema().common_id());
     int ret = 0;
     try {
       // group_by_key_record [0,1,2,3,4,5,6] sort, for group_by_key_serial_schemas_ in vector index no schema index
-      ret = group_by_key_encoder.EncodeKey(group_by_key_record, group_by_key);
+      ret = group_by_key_encoder_->EncodeKey(group_by_key_record, group_by_key);
     } catch (const std::exception& my_exception) {
       std::string error_message = fmt::format("serial::EncodeKey failed exception : {}", my_exception.what());
       DINGO_LOG(ERROR) << error_message;
@@ -406,14 +611,9 @@ butil::Status Coprocessor::DoExecuteForAggregation(const std::vector<std::any>&
 
   Utils::DebugGroupByKey(group_by_key, "group_by_key");
 
-  if (!aggregation_manager_) {
-    aggregation_manager_ = std::make_shared<AggregationManager>();
-    status = aggregation_manager_->Open(group_by_operator_serial_schemas_, coprocessor_.aggregation_operators(),
-                                        result_serial_schemas_);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("AggregationManager::Open failed");
-      return status;
-    }
+  status = OpenAggregationManager();
+  if (!status.ok()) {
+    return status;
   }
 
   status = aggregation_manager_->Execute(group_by_key, group_by_operator_record);
@@ -428,12 +628,10 @@ butil::Status Coprocessor::DoExecuteForSelection(const std::vector<std::any>& se
                                                  pb::common::KeyValue* result_kv) {
   butil::Status status;
   // selection
-  RecordEncoder result_record_encoder(coprocessor_.schema_version(), result_serial_schemas_sorted_,
-                                      coprocessor_.result_schema().common_id());
   pb::common::KeyValue result_key_value;
   int ret = 0;
   try {
-    ret = result_record_encoder.Encode(selection_record, result_key_value);
+    ret = result_record_encoder_->Encode(selection_record, result_key_value);
   } catch (const std::exception& my_exception) {
     std::string error_message = fmt::format("serial::Encode failed exception : {}", my_exception.what());
     DINGO_LOG(ERROR) << error_message;
@@ -451,6 +649,23 @@ butil::Status Coprocessor::DoExecuteForSelection(const std::vector<std::any>& se
   return butil::Status();
 }
 
+butil::Status Coprocessor::OpenAggregationManager() {
+  if (aggregation_manager_) {
+    return butil::Status();
+  }
+
+  aggregation_manager_ = std::make_shared<AggregationManager>();
+  auto status = aggregation_manager_->Open(group_by_operator_serial_schemas_, coprocessor_.aggregation_operators(),
+                                           result_serial_schemas_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("AggregationManager::Open failed");
+    aggregation_manager_.reset();
+    return status;
+  }
+
+  return butil::Status();
+}
+
 butil::Status Coprocessor::GetKeyValueFromAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                                       std::vector<pb::common::KeyValue>* kvs) {
   butil::Status status;
@@ -586,6 +801,16 @@ void Coprocessor::Close() {
   enable_expression_ = false;
   end_of_group_by_ = false;
 
+  original_record_decoder_.reset();
+  result_record_encoder_.reset();
+  group_by_key_encoder_.reset();
+  expr_runner_.reset();
+
+  batch_kvs_.clear();
+  batch_records_.clear();
+  batch_selection_.clear();
+  batch_columns_.clear();
+
   if (aggregation_manager_) {
     aggregation_manager_.reset();
   }
@@ -18,6 +18,7 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +28,13 @@
 #include "engine/iterator.h"
 #include "proto/store.pb.h"
 #include "scan/scan_filter.h"
+#include "serial/record_decoder.h"
+#include "serial/record_encoder.h"
+
+// Forward declare, libexpr runner.h must be included after proto, otherwise it will cause naming collision.
+namespace dingodb::expr {
+class Runner;
+}  // namespace dingodb::expr
 
 namespace dingodb {
 
@@ -47,8 +55,18 @@ class Coprocessor {
   void Close();
 
  private:
+  butil::Status ExecuteBatch(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                             std::vector<pb::common::KeyValue>* kvs);
+  butil::Status DoExecuteBatchForColumnAggregation(size_t count);
+
   butil::Status DoExecute(const pb::common::KeyValue& kv, bool* has_result_kv, pb::common::KeyValue* result_kv);
 
+  butil::Status DecodeRecord(const pb::common::KeyValue& kv, std::vector<std::any>* original_record);
+  butil::Status FilterRecord(const std::vector<std::any>& original_record, bool* is_key_value_reserve);
+  butil::Status DoExecuteRecord(const std::vector<std::any>& original_record, bool* has_result_kv,
+                                pb::common::KeyValue* result_kv);
+  butil::Status OpenAggregationManager();
+
   butil::Status DoExecuteForAggregation(const std::vector<std::any>& selection_record);
 
   butil::Status DoExecuteForSelection(const std::vector<std::any>& selection_record, bool* has_result_kv,
@@ -74,6 +92,11 @@ class Coprocessor {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_serial_schemas_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
   bool enable_expression_;
+  // decoder and expression runner are built once in Open, and reused by every row of the scan.
+  std::shared_ptr<RecordDecoder> original_record_decoder_;
+  std::shared_ptr<RecordEncoder> result_record_encoder_;
+  std::shared_ptr<RecordEncoder> group_by_key_encoder_;
+  std::shared_ptr<expr::Runner> expr_runner_;
   bool end_of_group_by_;
   std::shared_ptr<AggregationManager> aggregation_manager_;
   std::shared_ptr<AggregationIterator> aggregation_iterator_;
@@ -83,6 +106,12 @@ class Coprocessor {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas_sorted_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> selection_serial_schemas_sorted_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_sorted_;
+
+  // batch mode buffer, reused across batches.
+  std::vector<pb::common::KeyValue> batch_kvs_;
+  std::vector<std::vector<std::any>> batch_records_;
+  std::vector<uint8_t> batch_selection_;
+  std::vector<AggregationColumnBatch> batch_columns_;
 };
 
 }  // namespace dingodb
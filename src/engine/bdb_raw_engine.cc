@@ -15,6 +15,8 @@
 
 #include <gflags/gflags.h>
 
+#include <algorithm>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -404,6 +406,112 @@ butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr sna
   return butil::Status(pb::error::EBDB_UNKNOW, "unknow error.");
 }
 
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& founds) {
+#ifdef BDB_BUILD_USE_SNAPSHOT
+  return KvMultiGet(cf_name, GetSnapshot(), keys, values, founds);
+#else
+  return KvMultiGet(cf_name, nullptr, keys, values, founds);
+#endif
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& founds) {
+  values.clear();
+  founds.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // Visit keys in order through one cursor, so adjacent keys hit the already fetched btree pages.
+  std::vector<size_t> indexes(keys.size());
+  std::iota(indexes.begin(), indexes.end(), 0);
+  std::sort(indexes.begin(), indexes.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+  // Acquire a cursor
+  Dbc* cursorp = nullptr;
+  // Release the cursor later
+  DEFER(  // FOR_CLANG_FORMAT
+      if (cursorp != nullptr) {
+        try {
+          cursorp->close();
+        } catch (DbException& db_exception) {
+          LOG(WARNING) << fmt::format("cursor close failed, exception: {} {}.", db_exception.get_errno(),
+                                      db_exception.what());
+        }
+      });
+
+  try {
+    int ret = 0;
+    if (snapshot != nullptr) {
+      std::shared_ptr<bdb::Snapshot> ss = std::dynamic_pointer_cast<bdb::Snapshot>(snapshot);
+      if (ss == nullptr) {
+        DINGO_LOG(ERROR) << "[bdb] snapshot pointer cast error.";
+        return butil::Status(pb::error::EINTERNAL, "snapshot pointer cast error.");
+      }
+      ret = GetDb()->cursor(ss->GetDbTxn(), &cursorp, DB_TXN_SNAPSHOT);
+    } else {
+      ret = GetDb()->cursor(nullptr, &cursorp, DB_READ_COMMITTED);
+    }
+
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] create cursor failed ret: {}.", ret);
+      return butil::Status(pb::error::EINTERNAL, "Internal create cursor error.");
+    }
+
+    values.resize(keys.size());
+    founds.resize(keys.size(), false);
+    for (auto index : indexes) {
+      std::string store_key = BdbHelper::EncodeKey(cf_name, keys[index]);
+      Dbt bdb_key;
+      BdbHelper::BinaryToDbt(store_key, bdb_key);
+
+      Dbt bdb_value;
+      bdb_value.set_flags(DB_DBT_MALLOC);
+
+      ret = cursorp->get(&bdb_key, &bdb_value, DB_SET);
+      if (ret == 0) {
+        BdbHelper::DbtToBinary(bdb_value, values[index]);
+        free(bdb_value.get_data());
+        founds[index] = true;
+      } else if (ret != DB_NOTFOUND) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] cursor get failed, ret: {}.", ret);
+        values.clear();
+        founds.clear();
+        return butil::Status(pb::error::EINTERNAL, "Internal multi get error.");
+      }
+    }
+
+    return butil::Status();
+  } catch (DbDeadlockException&) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] multi get got DeadLockException, giving up.");
+    values.clear();
+    founds.clear();
+    return butil::Status(pb::error::EBDB_DEADLOCK, "multi get got DeadLockException, giving up.");
+  } catch (DbException& db_exception) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] db multi get failed, exception: {} {}.", db_exception.get_errno(),
+                                    db_exception.what());
+    values.clear();
+    founds.clear();
+    return butil::Status(pb::error::EBDB_EXCEPTION, fmt::format("db multi get failed, {}.", db_exception.what()));
+  } catch (std::exception& std_exception) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] std exception, {}.", std_exception.what());
+    values.clear();
+    founds.clear();
+    return butil::Status(pb::error::ESTD_EXCEPTION, fmt::format("std exception, {}.", std_exception.what()));
+  }
+
+  return butil::Status(pb::error::EBDB_UNKNOW, "unknown error.");
+}
+
 butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
 #ifdef BDB_BUILD_USE_SNAPSHOT
@@ -1055,6 +1163,106 @@ butil::Status Writer::KvBatchPutAndDelete(
   return butil::Status(pb::error::EBDB_UNKNOW, "unknown error.");
 }
 
+butil::Status Writer::KvBatchWrite(const RawEngine::WriteBatch& batch) {
+  if (BAIDU_UNLIKELY(batch.Empty())) {
+    return butil::Status::OK();
+  }
+
+  DbEnv* envp = GetDb()->get_env();
+  DbTxn* txn = nullptr;
+  // release txn if commit failed.
+  DEFER(  // FOR_CLANG_FORMAT
+      if (txn != nullptr) {
+        txn->abort();
+        txn = nullptr;
+      });
+
+  bool retry = true;
+  int32_t retry_count = 0;
+
+  while (retry) {
+    try {
+      int ret = envp->txn_begin(nullptr, &txn, DB_TXN_BULK);
+      if (ret != 0) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] txn begin failed ret: {}.", ret);
+        return butil::Status(pb::error::EINTERNAL, "Internal txn begin error.");
+      }
+
+      // apply ops in order, a later op on the same key overwrite the earlier one.
+      for (const auto& op : batch.Ops()) {
+        if (BAIDU_UNLIKELY(op.key.empty())) {
+          DINGO_LOG(ERROR) << fmt::format("[bdb] key empty not support");
+          return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+        }
+
+        std::string store_key = BdbHelper::EncodeKey(op.cf_name, op.key);
+        Dbt bdb_key;
+        BdbHelper::BinaryToDbt(store_key, bdb_key);
+        if (op.is_delete) {
+          ret = GetDb()->del(txn, &bdb_key, 0);
+          if (ret != 0 && ret != DB_NOTFOUND) {
+            DINGO_LOG(ERROR) << fmt::format("[bdb] delete failed, ret: {}.", ret);
+            return butil::Status(pb::error::EINTERNAL, "Internal delete error.");
+          }
+        } else {
+          Dbt bdb_value;
+          BdbHelper::BinaryToDbt(op.value, bdb_value);
+          ret = GetDb()->put(txn, &bdb_key, &bdb_value, DB_OVERWRITE_DUP);
+          if (ret != 0) {
+            DINGO_LOG(ERROR) << fmt::format("[bdb] put failed, ret: {}.", ret);
+            return butil::Status(pb::error::EINTERNAL, "Internal put error.");
+          }
+        }
+      }
+
+      // commit
+      try {
+        ret = txn->commit(0);
+        if (ret == 0) {
+          txn = nullptr;
+          return butil::Status();
+        }
+      } catch (DbException& db_exception) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] error on txn commit: {} {}.", db_exception.get_errno(),
+                                        db_exception.what());
+        ret = BdbHelper::kCommitException;
+      }
+
+      if (ret != 0) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] error on txn commit, ret: {}.", ret);
+        return butil::Status(pb::error::EBDB_COMMIT, "error on txn commit.");
+      }
+
+    } catch (DbDeadlockException&) {
+      if (retry_count < FLAGS_bdb_max_retries) {
+        // First thing that we MUST do is abort the transaction.
+        if (txn != nullptr) {
+          txn->abort();
+          txn = nullptr;
+        }
+
+        DINGO_LOG(WARNING) << fmt::format(
+            "[bdb] writer got DB_LOCK_DEADLOCK. retrying write operation, retry_count: {}.", retry_count);
+        retry_count++;
+        retry = true;
+      } else {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] writer got DeadLockException and out of retries: {}. giving up.",
+                                        retry_count);
+        return butil::Status(pb::error::EBDB_DEADLOCK, "writer got DeadLockException and out of retries. giving up.");
+      }
+    } catch (DbException& db_exception) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] db batch write failed, exception: {} {}.", db_exception.get_errno(),
+                                      db_exception.what());
+      return butil::Status(pb::error::EBDB_EXCEPTION, fmt::format("db batch write failed, {}.", db_exception.what()));
+    } catch (std::exception& std_exception) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] std exception, {}.", std_exception.what());
+      return butil::Status(pb::error::ESTD_EXCEPTION, fmt::format("std exception, {}.", std_exception.what()));
+    }
+  }
+
+  return butil::Status(pb::error::EBDB_UNKNOW, "unknown error.");
+}
+
 butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& key) {
   if (BAIDU_UNLIKELY(key.empty())) {
     DINGO_LOG(ERROR) << fmt::format("[bdb] not support empty key.");
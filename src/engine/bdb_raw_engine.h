@@ -122,6 +122,12 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& founds) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& founds) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
@@ -161,6 +167,8 @@ class Writer : public RawEngine::Writer {
   butil::Status KvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
                                     const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
 
+  butil::Status KvBatchWrite(const RawEngine::WriteBatch& batch) override;
+
   butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) override;
   butil::Status KvBatchDeleteRange(
       const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) override;
@@ -70,6 +70,8 @@ class Engine : public std::enable_shared_from_this<Engine> {
     virtual ~Reader() = default;
 
     virtual butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) = 0;
+    virtual butil::Status KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                     std::vector<pb::common::KeyValue>& kvs) = 0;
 
     virtual butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
@@ -147,7 +149,7 @@ class Engine : public std::enable_shared_from_this<Engine> {
     virtual butil::Status VectorBatchSearchDebug(std::shared_ptr<VectorReader::Context> ctx,
                                                  std::vector<pb::index::VectorWithDistanceResult>& results,
                                                  int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
-                                                 int64_t& search_time_us) = 0;
+                                                 int64_t& search_time_us, std::string& filter_strategy) = 0;
   };
 
   class TxnReader {
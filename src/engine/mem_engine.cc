@@ -14,42 +14,795 @@
 
 #include "engine/mem_engine.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "butil/fast_rand.h"
 #include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+DEFINE_int64(mem_engine_auto_compact_min_count, 100000,
+             "mem engine auto compact column family when entry count reach it, 0 means disable auto compact");
+DEFINE_int64(mem_engine_auto_compact_ratio, 2,
+             "mem engine auto compact column family when entry count reach ratio times of count after last compact");
 
 namespace dingodb {
 
-bool MemEngine::Init(std::shared_ptr<Config> /*config*/) {
-  DINGO_LOG(INFO) << "Init MemEngine...";
+namespace mem {
+
+static bool EntryIsLess(const Entry& entry, const std::string& key, uint64_t seq) {
+  int cmp = entry.key.compare(key);
+  return cmp < 0 || (cmp == 0 && entry.seq > seq);
+}
+
+SkipList::Node::Node(Entry&& entry, int height) : entry(std::move(entry)), next(new std::atomic<Node*>[height]) {
+  for (int i = 0; i < height; ++i) {
+    next[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+SkipList::SkipList() : head_(new Node(Entry(), kMaxHeight)) {}
+
+SkipList::~SkipList() {
+  Node* node = head_;
+  while (node != nullptr) {
+    Node* next = node->Next(0);
+    delete node;
+    node = next;
+  }
+}
+
+int SkipList::RandomHeight() {
+  int height = 1;
+  while (height < kMaxHeight && butil::fast_rand_less_than(4) == 0) {
+    ++height;
+  }
+
+  return height;
+}
+
+SkipList::Node* SkipList::FindGreaterOrEqual(const std::string& key, uint64_t seq, Node** prev) const {
+  Node* node = head_;
+  int level = max_height_.load(std::memory_order_relaxed) - 1;
+  for (;;) {
+    Node* next = node->Next(level);
+    if (next != nullptr && EntryIsLess(next->entry, key, seq)) {
+      node = next;
+    } else {
+      if (prev != nullptr) {
+        prev[level] = node;
+      }
+      if (level == 0) {
+        return next;
+      }
+      --level;
+    }
+  }
+}
+
+void SkipList::Insert(Entry&& entry) {
+  Node* prev[kMaxHeight];
+  FindGreaterOrEqual(entry.key, entry.seq, prev);
+
+  int height = RandomHeight();
+  int max_height = max_height_.load(std::memory_order_relaxed);
+  if (height > max_height) {
+    for (int i = max_height; i < height; ++i) {
+      prev[i] = head_;
+    }
+    // Reader see the new height before the node is linked is fine, the next of head is nullptr.
+    max_height_.store(height, std::memory_order_relaxed);
+  }
+
+  int64_t size = sizeof(Node) + height * sizeof(std::atomic<Node*>) + entry.key.size() + entry.value.size();
+  Node* node = new Node(std::move(entry), height);
+  for (int i = 0; i < height; ++i) {
+    node->next[i].store(prev[i]->Next(i), std::memory_order_relaxed);
+    // Publish node after its next pointers are ready.
+    prev[i]->SetNext(i, node);
+  }
+
+  count_.fetch_add(1, std::memory_order_relaxed);
+  memory_usage_.fetch_add(size, std::memory_order_relaxed);
+}
+
+SkipList::Node* SkipList::Seek(const std::string& key, uint64_t seq) const {
+  return FindGreaterOrEqual(key, seq, nullptr);
+}
+
+SkipList::Node* SkipList::SeekLessThan(const std::string& key) const {
+  Node* node = head_;
+  int level = max_height_.load(std::memory_order_relaxed) - 1;
+  for (;;) {
+    Node* next = node->Next(level);
+    if (next != nullptr && next->entry.key < key) {
+      node = next;
+    } else {
+      if (level == 0) {
+        return node == head_ ? nullptr : node;
+      }
+      --level;
+    }
+  }
+}
+
+SkipList::Node* SkipList::Last() const {
+  Node* node = head_;
+  int level = max_height_.load(std::memory_order_relaxed) - 1;
+  for (;;) {
+    Node* next = node->Next(level);
+    if (next != nullptr) {
+      node = next;
+    } else {
+      if (level == 0) {
+        return node == head_ ? nullptr : node;
+      }
+      --level;
+    }
+  }
+}
+
+Iterator::Iterator(IteratorOptions options, SkipListPtr list, uint64_t seq, dingodb::SnapshotPtr snapshot)
+    : options_(std::move(options)), list_(list), seq_(seq), snapshot_(snapshot) {}
+
+bool Iterator::Valid() const {
+  if (node_ == nullptr) {
+    return false;
+  }
+  if (!options_.upper_bound.empty() && node_->entry.key >= options_.upper_bound) {
+    return false;
+  }
+  if (!options_.lower_bound.empty() && node_->entry.key < options_.lower_bound) {
+    return false;
+  }
+
+  return true;
+}
+
+void Iterator::SeekToFirst() {
+  if (!options_.lower_bound.empty()) {
+    Seek(options_.lower_bound);
+    return;
+  }
+
+  FindNextVisible(list_->First());
+}
+
+void Iterator::SeekToLast() {
+  if (!options_.upper_bound.empty()) {
+    FindPrevVisible(options_.upper_bound);
+    return;
+  }
+
+  auto* node = list_->Last();
+  if (node == nullptr) {
+    node_ = nullptr;
+    return;
+  }
+
+  SeekForPrev(node->entry.key);
+}
+
+void Iterator::Seek(const std::string& target) {
+  const auto& start_key =
+      (!options_.lower_bound.empty() && target < options_.lower_bound) ? options_.lower_bound : target;
+
+  FindNextVisible(list_->Seek(start_key, seq_));
+}
+
+void Iterator::SeekForPrev(const std::string& target) {
+  if (!options_.upper_bound.empty() && target >= options_.upper_bound) {
+    FindPrevVisible(options_.upper_bound);
+    return;
+  }
+
+  auto* node = list_->Seek(target, seq_);
+  if (node != nullptr && node->entry.key == target && !node->entry.is_delete) {
+    node_ = node;
+    return;
+  }
+
+  FindPrevVisible(target);
+}
+
+void Iterator::Next() {
+  // Seq start from 1, so (key, 0) skip all versions of key.
+  FindNextVisible(list_->Seek(node_->entry.key, 0));
+}
+
+void Iterator::Prev() { FindPrevVisible(node_->entry.key); }
+
+void Iterator::FindNextVisible(SkipList::Node* node) {
+  while (node != nullptr) {
+    if (!options_.upper_bound.empty() && node->entry.key >= options_.upper_bound) {
+      node = nullptr;
+      break;
+    }
+
+    // Newer than snapshot.
+    if (node->entry.seq > seq_) {
+      node = node->Next(0);
+      continue;
+    }
+    // Visible version is delete, skip older versions.
+    if (node->entry.is_delete) {
+      node = list_->Seek(node->entry.key, 0);
+      continue;
+    }
+
+    break;
+  }
+
+  node_ = node;
+}
+
+void Iterator::FindPrevVisible(const std::string& target) {
+  std::string key = target;
+  for (;;) {
+    auto* node = list_->SeekLessThan(key);
+    if (node == nullptr || (!options_.lower_bound.empty() && node->entry.key < options_.lower_bound)) {
+      node_ = nullptr;
+      return;
+    }
+
+    auto* visible_node = list_->Seek(node->entry.key, seq_);
+    if (visible_node != nullptr && visible_node->entry.key == node->entry.key && !visible_node->entry.is_delete) {
+      node_ = visible_node;
+      return;
+    }
+
+    key = node->entry.key;
+  }
+}
+
+Snapshot::~Snapshot() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine != nullptr) {
+    raw_engine->ReleaseSnapshot(seq_);
+  }
+}
+
+std::shared_ptr<MemEngine> Reader::GetRawEngine() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine == nullptr) {
+    DINGO_LOG(FATAL) << "[mem] get raw engine failed.";
+  }
+
+  return raw_engine;
+}
+
+butil::Status Reader::GetReadView(const std::string& cf_name, dingodb::SnapshotPtr snapshot, SkipListPtr& list,
+                                  uint64_t& seq) {
+  auto raw_engine = GetRawEngine();
+  auto column_family = raw_engine->GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not found column family {}.", cf_name);
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family");
+  }
+
+  if (snapshot != nullptr) {
+    auto mem_snapshot = std::dynamic_pointer_cast<mem::Snapshot>(snapshot);
+    if (mem_snapshot == nullptr) {
+      DINGO_LOG(ERROR) << "[mem] snapshot is not mem engine snapshot.";
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Snapshot is not mem engine snapshot");
+    }
+
+    // Compact keep all versions visible to live snapshot.
+    list = column_family->GetList();
+    seq = mem_snapshot->GetSeq();
+    return butil::Status();
+  }
+
+  // Compact maybe switch list between get list and seq, the new list has no version older than compact
+  // sequence, so retry until list not changed.
+  do {
+    list = column_family->GetList();
+    seq = raw_engine->GetLastSeq();
+  } while (list != column_family->GetList());
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvGet(const std::string& cf_name, const std::string& key, std::string& value) {
+  return KvGet(cf_name, nullptr, key, value);
+}
+
+butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                            std::string& value) {
+  if (BAIDU_UNLIKELY(key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  SkipListPtr list;
+  uint64_t seq = 0;
+  auto status = GetReadView(cf_name, snapshot, list, seq);
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto* node = list->Seek(key, seq);
+  if (node == nullptr || node->entry.key != key || node->entry.is_delete) {
+    return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+  }
+
+  value = node->entry.value;
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& founds) {
+  return KvMultiGet(cf_name, nullptr, keys, values, founds);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& founds) {
+  values.clear();
+  founds.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // All keys read on same list and sequence, so it is consistent without snapshot.
+  SkipListPtr list;
+  uint64_t seq = 0;
+  auto status = GetReadView(cf_name, snapshot, list, seq);
+  if (!status.ok()) {
+    return status;
+  }
+
+  values.resize(keys.size());
+  founds.resize(keys.size(), false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto* node = list->Seek(keys[i], seq);
+    if (node != nullptr && node->entry.key == keys[i] && !node->entry.is_delete) {
+      values[i] = node->entry.value;
+      founds[i] = true;
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                             std::vector<pb::common::KeyValue>& kvs) {
+  return KvScan(cf_name, nullptr, start_key, end_key, kvs);
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                             const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  if (BAIDU_UNLIKELY(start_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty start_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (BAIDU_UNLIKELY(end_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty end_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  SkipListPtr list;
+  uint64_t seq = 0;
+  auto status = GetReadView(cf_name, snapshot, list, seq);
+  if (!status.ok()) {
+    return status;
+  }
+
+  IteratorOptions options;
+  options.upper_bound = end_key;
+  Iterator iter(options, list, seq, snapshot);
+  for (iter.Seek(start_key); iter.Valid(); iter.Next()) {
+    pb::common::KeyValue kv;
+    kv.set_key(iter.Key().data(), iter.Key().size());
+    kv.set_value(iter.Value().data(), iter.Value().size());
+
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                              int64_t& count) {
+  return KvCount(cf_name, nullptr, start_key, end_key, count);
+}
+
+butil::Status Reader::KvCount(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                              const std::string& end_key, int64_t& count) {
+  if (BAIDU_UNLIKELY(start_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty start_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (BAIDU_UNLIKELY(end_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty end_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  SkipListPtr list;
+  uint64_t seq = 0;
+  auto status = GetReadView(cf_name, snapshot, list, seq);
+  if (!status.ok()) {
+    return status;
+  }
+
+  count = 0;
+  IteratorOptions options;
+  options.upper_bound = end_key;
+  Iterator iter(options, list, seq, snapshot);
+  for (iter.Seek(start_key); iter.Valid(); iter.Next()) {
+    ++count;
+  }
+
+  return butil::Status();
+}
+
+dingodb::IteratorPtr Reader::NewIterator(const std::string& cf_name, IteratorOptions options) {
+  return NewIterator(cf_name, nullptr, options);
+}
+
+dingodb::IteratorPtr Reader::NewIterator(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                         IteratorOptions options) {
+  SkipListPtr list;
+  uint64_t seq = 0;
+  auto status = GetReadView(cf_name, snapshot, list, seq);
+  if (!status.ok()) {
+    return nullptr;
+  }
+
+  return std::make_shared<Iterator>(options, list, seq, snapshot);
+}
+
+std::shared_ptr<MemEngine> Writer::GetRawEngine() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine == nullptr) {
+    DINGO_LOG(FATAL) << "[mem] get raw engine failed.";
+  }
+
+  return raw_engine;
+}
+
+butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) {
+  RawEngine::WriteBatch batch;
+  batch.Put(cf_name, kv.key(), kv.value());
+
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& key) {
+  RawEngine::WriteBatch batch;
+  batch.Delete(cf_name, key);
+
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvBatchPutAndDelete(const std::string& cf_name,
+                                          const std::vector<pb::common::KeyValue>& kvs_to_put,
+                                          const std::vector<std::string>& keys_to_delete) {
+  RawEngine::WriteBatch batch;
+  for (const auto& kv : kvs_to_put) {
+    batch.Put(cf_name, kv.key(), kv.value());
+  }
+  for (const auto& key : keys_to_delete) {
+    batch.Delete(cf_name, key);
+  }
+
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvBatchPutAndDelete(
+    const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) {
+  RawEngine::WriteBatch batch;
+  for (const auto& [cf_name, kvs] : kv_puts_with_cf) {
+    for (const auto& kv : kvs) {
+      batch.Put(cf_name, kv.key(), kv.value());
+    }
+  }
+  for (const auto& [cf_name, keys] : kv_deletes_with_cf) {
+    for (const auto& key : keys) {
+      batch.Delete(cf_name, key);
+    }
+  }
+
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvBatchWrite(const RawEngine::WriteBatch& batch) { return GetRawEngine()->Write(batch); }
+
+butil::Status Writer::KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) {
+  std::map<std::string, std::vector<pb::common::Range>> range_with_cfs;
+  range_with_cfs[cf_name].push_back(range);
+
+  return GetRawEngine()->DeleteRange(range_with_cfs);
+}
+
+butil::Status Writer::KvBatchDeleteRange(const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) {
+  return GetRawEngine()->DeleteRange(range_with_cfs);
+}
+
+}  // namespace mem
+
+bool MemEngine::Init(std::shared_ptr<Config> /*config*/, const std::vector<std::string>& cf_names) {
+  if (cf_names.empty()) {
+    DINGO_LOG(ERROR) << "[mem] column family names is empty.";
+    return false;
+  }
+
+  for (const auto& cf_name : cf_names) {
+    column_families_[cf_name] = std::make_shared<mem::ColumnFamily>(cf_name);
+  }
+
+  reader_ = std::make_shared<mem::Reader>(GetSelfPtr());
+  writer_ = std::make_shared<mem::Writer>(GetSelfPtr());
+
+  DINGO_LOG(INFO) << fmt::format("[mem] init finish, column family count: {}", column_families_.size());
+
   return true;
 }
 
-std::string MemEngine::GetName() { return pb::common::StorageEngine_Name(GetID()); }
+void MemEngine::Close() {
+  BAIDU_SCOPED_LOCK(write_mutex_);
+  column_families_.clear();
+
+  DINGO_LOG(INFO) << "[mem] close finish.";
+}
+
+void MemEngine::Destroy() { Close(); }
+
+std::string MemEngine::GetName() { return pb::common::RawEngine_Name(pb::common::RAW_ENG_MEMORY); }
+
+pb::common::RawEngine MemEngine::GetRawEngineType() { return pb::common::RawEngine::RAW_ENG_MEMORY; }
+
+dingodb::SnapshotPtr MemEngine::GetSnapshot() {
+  BAIDU_SCOPED_LOCK(snapshot_mutex_);
+  uint64_t seq = GetLastSeq();
+  snapshots_.insert(seq);
+
+  return std::make_shared<mem::Snapshot>(seq, GetSelfPtr());
+}
+
+void MemEngine::ReleaseSnapshot(uint64_t seq) {
+  BAIDU_SCOPED_LOCK(snapshot_mutex_);
+  auto it = snapshots_.find(seq);
+  if (it != snapshots_.end()) {
+    snapshots_.erase(it);
+  }
+}
 
-pb::common::StorageEngine MemEngine::GetID() { return pb::common::StorageEngine::STORE_ENG_MEMORY; }
+mem::ColumnFamilyPtr MemEngine::GetColumnFamily(const std::string& cf_name) {
+  auto it = column_families_.find(cf_name);
+  if (it == column_families_.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+butil::Status MemEngine::Write(const RawEngine::WriteBatch& batch) {
+  if (batch.Empty()) {
+    return butil::Status();
+  }
+
+  // Check all ops before apply, so batch is all or nothing.
+  std::vector<mem::ColumnFamilyPtr> column_families;
+  column_families.reserve(batch.Count());
+  for (const auto& op : batch.Ops()) {
+    if (BAIDU_UNLIKELY(op.key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    auto column_family = GetColumnFamily(op.cf_name);
+    if (column_family == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] not found column family {}.", op.cf_name);
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family");
+    }
+    column_families.push_back(column_family);
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(write_mutex_);
+    // Every op has its own seq, so later op of same key override the earlier one.
+    uint64_t seq = last_seq_.load(std::memory_order_relaxed);
+    const auto& ops = batch.Ops();
+    for (size_t i = 0; i < ops.size(); ++i) {
+      const auto& op = ops[i];
+      column_families[i]->GetList()->Insert(mem::Entry{op.key, ++seq, op.is_delete, op.is_delete ? "" : op.value});
+    }
+
+    // Publish after all ops inserted, reader never see part of batch.
+    last_seq_.store(seq, std::memory_order_release);
+  }
+
+  std::sort(column_families.begin(), column_families.end());
+  column_families.erase(std::unique(column_families.begin(), column_families.end()), column_families.end());
+  for (auto& column_family : column_families) {
+    MaybeCompact(column_family);
+  }
 
-butil::Status MemEngine::Write(std::shared_ptr<Context> /*ctx*/, std::shared_ptr<WriteData> /*write_data*/) {
   return butil::Status();
 }
 
-butil::Status MemEngine::AsyncWrite(std::shared_ptr<Context> /*ctx*/, std::shared_ptr<WriteData> /*write_data*/) {
+butil::Status MemEngine::DeleteRange(const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) {
+  for (const auto& [cf_name, ranges] : range_with_cfs) {
+    if (GetColumnFamily(cf_name) == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] not found column family {}.", cf_name);
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family");
+    }
+
+    for (const auto& range : ranges) {
+      if (range.start_key().empty() || range.end_key().empty()) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "range is empty");
+      }
+      if (range.start_key() >= range.end_key()) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "range is wrong");
+      }
+    }
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(write_mutex_);
+    uint64_t seq = last_seq_.load(std::memory_order_relaxed);
+    for (const auto& [cf_name, ranges] : range_with_cfs) {
+      auto list = GetColumnFamily(cf_name)->GetList();
+
+      // Collect visible keys first, tombstone of this batch is invisible to the iterator anyway.
+      std::vector<std::string> keys;
+      for (const auto& range : ranges) {
+        IteratorOptions options;
+        options.upper_bound = range.end_key();
+        mem::Iterator iter(options, list, seq, nullptr);
+        for (iter.Seek(range.start_key()); iter.Valid(); iter.Next()) {
+          keys.emplace_back(iter.Key());
+        }
+      }
+
+      for (auto& key : keys) {
+        list->Insert(mem::Entry{std::move(key), ++seq, true, ""});
+      }
+    }
+
+    last_seq_.store(seq, std::memory_order_release);
+  }
+
+  for (const auto& [cf_name, ranges] : range_with_cfs) {
+    MaybeCompact(GetColumnFamily(cf_name));
+  }
+
   return butil::Status();
 }
 
-butil::Status MemEngine::AsyncWrite(std::shared_ptr<Context> /*ctx*/, std::shared_ptr<WriteData> /*write_data*/,
-                                    WriteCbFunc /*cb*/) {
+RawEngine::CheckpointPtr MemEngine::NewCheckpoint() { return std::make_shared<RawEngine::Checkpoint>(); }
+
+butil::Status MemEngine::MergeCheckpointFiles(const std::string& /*path*/, const pb::common::Range& /*range*/,
+                                              const std::vector<std::string>& /*cf_names*/,
+                                              std::vector<std::string>& /*merge_sst_paths*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Not support merge checkpoint files.");
+}
+
+butil::Status MemEngine::IngestExternalFile(const std::string& /*cf_name*/, const std::vector<std::string>& /*files*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Not support ingest external file.");
+}
+
+void MemEngine::Flush(const std::string& /*cf_name*/) {}
+
+butil::Status MemEngine::Compact(const std::string& cf_name) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not found column family {}.", cf_name);
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family");
+  }
+
+  // Block write, so last seq is stable until the new list is switched.
+  BAIDU_SCOPED_LOCK(write_mutex_);
+  uint64_t min_seq = GetLastSeq();
+  {
+    BAIDU_SCOPED_LOCK(snapshot_mutex_);
+    if (!snapshots_.empty()) {
+      min_seq = std::min(min_seq, *snapshots_.begin());
+    }
+  }
+
+  auto list = column_family->GetList();
+  auto new_list = std::make_shared<mem::SkipList>();
+  const std::string* last_key = nullptr;
+  bool has_base_version = false;
+  for (auto* node = list->First(); node != nullptr; node = node->Next(0)) {
+    const auto& entry = node->entry;
+    if (last_key == nullptr || entry.key != *last_key) {
+      last_key = &entry.key;
+      has_base_version = false;
+    }
+
+    // Maybe visible to some snapshot.
+    if (entry.seq > min_seq) {
+      new_list->Insert(mem::Entry(entry));
+      continue;
+    }
+
+    // The newest version <= min_seq is visible to all snapshot, older versions are garbage.
+    if (has_base_version) {
+      continue;
+    }
+    has_base_version = true;
+
+    // All older versions are dropped, tombstone is useless.
+    if (entry.is_delete) {
+      continue;
+    }
+    new_list->Insert(mem::Entry(entry));
+  }
+
+  column_family->SetList(new_list);
+  column_family->SetCompactBaseCount(new_list->Count());
+
+  DINGO_LOG(INFO) << fmt::format("[mem] compact cf {} min_seq: {} entry count: {} -> {}", cf_name, min_seq,
+                                 list->Count(), new_list->Count());
+
   return butil::Status();
 }
 
-std::shared_ptr<Engine::Reader> MemEngine::NewReader(pb::common::RawEngine) { return nullptr; }
+void MemEngine::MaybeCompact(mem::ColumnFamilyPtr column_family) {
+  if (FLAGS_mem_engine_auto_compact_min_count <= 0) {
+    return;
+  }
 
-std::shared_ptr<Engine::Writer> MemEngine::NewWriter(pb::common::RawEngine) { return nullptr; }
+  // Versions kept by snapshot survive compact, so the threshold grows with the count after last compact,
+  // the cost of compact is amortized to the writes.
+  int64_t threshold = std::max(FLAGS_mem_engine_auto_compact_min_count,
+                               column_family->GetCompactBaseCount() * FLAGS_mem_engine_auto_compact_ratio);
+  if (column_family->GetList()->Count() < threshold || !column_family->TryStartCompact()) {
+    return;
+  }
 
-std::shared_ptr<Engine::VectorReader> MemEngine::NewVectorReader(pb::common::RawEngine) { return nullptr; }
+  auto status = Compact(column_family->Name());
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[mem] auto compact cf {} failed, error: {}", column_family->Name(),
+                                      status.error_str());
+  }
 
-std::shared_ptr<Engine::TxnReader> MemEngine::NewTxnReader(pb::common::RawEngine) { return nullptr; }
+  column_family->FinishCompact();
+}
+
+std::vector<int64_t> MemEngine::GetApproximateSizes(const std::string& cf_name,
+                                                    std::vector<pb::common::Range>& ranges) {
+  std::vector<int64_t> result(ranges.size(), 0);
+
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not found column family {}.", cf_name);
+    return result;
+  }
 
-std::shared_ptr<Engine::TxnWriter> MemEngine::NewTxnWriter(pb::common::RawEngine) { return nullptr; }
+  auto list = column_family->GetList();
+  uint64_t seq = GetLastSeq();
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    IteratorOptions options;
+    options.upper_bound = ranges[i].end_key();
+    mem::Iterator iter(options, list, seq, nullptr);
+    for (iter.Seek(ranges[i].start_key()); iter.Valid(); iter.Next()) {
+      result[i] += iter.Key().size() + iter.Value().size();
+    }
+  }
+
+  return result;
+}
 
 }  // namespace dingodb
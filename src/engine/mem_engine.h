@@ -12,49 +12,303 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#ifndef DINGODB_ENGINE_MEM_ENGINE_H_
+#ifndef DINGODB_ENGINE_MEM_ENGINE_H_  // NOLINT
 #define DINGODB_ENGINE_MEM_ENGINE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <map>
-#include <shared_mutex>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
-#include "common/context.h"
-#include "engine/engine.h"
+#include "bthread/mutex.h"
+#include "config/config.h"
+#include "engine/iterator.h"
+#include "engine/raw_engine.h"
 #include "engine/snapshot.h"
-#include "proto/error.pb.h"
-#include "proto/store.pb.h"
+#include "proto/common.pb.h"
 
 namespace dingodb {
 
-class MemEngine : public Engine {
+class MemEngine;
+
+namespace mem {
+
+// One version of user key.
+struct Entry {
+  std::string key;
+  // Sequence number of write, start from 1.
+  uint64_t seq{0};
+  bool is_delete{false};
+  std::string value;
+};
+
+// Skiplist ordered by key asc and seq desc, so the first version not newer than snapshot is the visible one.
+// Insert must be serialized by caller, read is lock free and can run with insert concurrently.
+// Node is never removed from list, Compact() build a new list without garbage versions.
+class SkipList {
+ public:
+  struct Node {
+    Node(Entry&& entry, int height);
+    ~Node() = default;
+
+    Node* Next(int level) const { return next[level].load(std::memory_order_acquire); }
+    void SetNext(int level, Node* node) { next[level].store(node, std::memory_order_release); }
+
+    Entry entry;
+    std::unique_ptr<std::atomic<Node*>[]> next;
+  };
+
+  SkipList();
+  ~SkipList();
+
+  SkipList(const SkipList& rhs) = delete;
+  SkipList& operator=(const SkipList& rhs) = delete;
+
+  void Insert(Entry&& entry);
+
+  // First node >= (key, seq).
+  Node* Seek(const std::string& key, uint64_t seq) const;
+  // Last node which key < key.
+  Node* SeekLessThan(const std::string& key) const;
+  Node* First() const { return head_->Next(0); }
+  Node* Last() const;
+
+  int64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  int64_t MemoryUsage() const { return memory_usage_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr int kMaxHeight = 12;
+
+  static int RandomHeight();
+
+  // Return first node >= (key, seq), fill prev of every level when prev is not nullptr.
+  Node* FindGreaterOrEqual(const std::string& key, uint64_t seq, Node** prev) const;
+
+  Node* head_;
+  std::atomic<int> max_height_{1};
+
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> memory_usage_{0};
+};
+using SkipListPtr = std::shared_ptr<SkipList>;
+
+class ColumnFamily {
+ public:
+  explicit ColumnFamily(const std::string& name) : name_(name), list_(std::make_shared<SkipList>()) {}
+  ~ColumnFamily() = default;
+
+  const std::string& Name() const { return name_; }
+
+  SkipListPtr GetList() const { return std::atomic_load(&list_); }
+  void SetList(SkipListPtr list) { std::atomic_store(&list_, list); }
+
+  int64_t GetCompactBaseCount() const { return compact_base_count_.load(std::memory_order_relaxed); }
+  void SetCompactBaseCount(int64_t count) { compact_base_count_.store(count, std::memory_order_relaxed); }
+
+  // Only one auto compact of column family run at the same time.
+  bool TryStartCompact() { return !compacting_.exchange(true); }
+  void FinishCompact() { compacting_.store(false); }
+
+ private:
+  std::string name_;
+  SkipListPtr list_;
+
+  // Entry count after last compact.
+  std::atomic<int64_t> compact_base_count_{0};
+  std::atomic<bool> compacting_{false};
+};
+using ColumnFamilyPtr = std::shared_ptr<ColumnFamily>;
+
+class Iterator : public dingodb::Iterator {
+ public:
+  Iterator(IteratorOptions options, SkipListPtr list, uint64_t seq, dingodb::SnapshotPtr snapshot);
+  ~Iterator() override = default;
+
+  std::string GetName() override { return "RawMem"; }
+  IteratorType GetID() override { return IteratorType::kMemEngine; }
+
+  bool Valid() const override;
+
+  void SeekToFirst() override;
+  void SeekToLast() override;
+
+  void Seek(const std::string& target) override;
+  void SeekForPrev(const std::string& target) override;
+
+  void Next() override;
+  void Prev() override;
+
+  std::string_view Key() const override { return node_->entry.key; }
+  std::string_view Value() const override { return node_->entry.value; }
+
+  butil::Status Status() const override { return butil::Status(); }
+
+ private:
+  // Move forward from node to the first visible and not deleted version.
+  void FindNextVisible(SkipList::Node* node);
+  // Move backward to the last visible and not deleted key which < target.
+  void FindPrevVisible(const std::string& target);
+
+  IteratorOptions options_;
+  SkipListPtr list_;
+  uint64_t seq_;
+  // Hold snapshot for keep the versions it see.
+  dingodb::SnapshotPtr snapshot_;
+
+  SkipList::Node* node_{nullptr};
+};
+
+class Snapshot : public dingodb::Snapshot {
+ public:
+  Snapshot(uint64_t seq, std::shared_ptr<MemEngine> raw_engine) : seq_(seq), raw_engine_(raw_engine) {}
+  ~Snapshot() override;
+
+  const void* Inner() override { return &seq_; }
+
+  uint64_t GetSeq() const { return seq_; }
+
+ private:
+  const uint64_t seq_;
+  std::weak_ptr<MemEngine> raw_engine_;
+};
+
+class Reader : public RawEngine::Reader {
+ public:
+  Reader(std::shared_ptr<MemEngine> raw_engine) : raw_engine_(raw_engine) {}
+  ~Reader() override = default;
+
+  butil::Status KvGet(const std::string& cf_name, const std::string& key, std::string& value) override;
+  butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                      std::string& value) override;
+
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& founds) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& founds) override;
+
+  butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                       std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                       const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) override;
+
+  butil::Status KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                        int64_t& count) override;
+  butil::Status KvCount(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                        const std::string& end_key, int64_t& count) override;
+
+  dingodb::IteratorPtr NewIterator(const std::string& cf_name, IteratorOptions options) override;
+  dingodb::IteratorPtr NewIterator(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                   IteratorOptions options) override;
+
+ private:
+  std::shared_ptr<MemEngine> GetRawEngine();
+  // Get list and sequence of read, use the latest sequence when snapshot is nullptr.
+  butil::Status GetReadView(const std::string& cf_name, dingodb::SnapshotPtr snapshot, SkipListPtr& list,
+                            uint64_t& seq);
+
+  std::weak_ptr<MemEngine> raw_engine_;
+};
+
+class Writer : public RawEngine::Writer {
+ public:
+  Writer(std::shared_ptr<MemEngine> raw_engine) : raw_engine_(raw_engine) {}
+  ~Writer() override = default;
+
+  butil::Status KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) override;
+  butil::Status KvDelete(const std::string& cf_name, const std::string& key) override;
+
+  butil::Status KvBatchPutAndDelete(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs_to_put,
+                                    const std::vector<std::string>& keys_to_delete) override;
+  butil::Status KvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+                                    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
+
+  butil::Status KvBatchWrite(const RawEngine::WriteBatch& batch) override;
+
+  butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status KvBatchDeleteRange(
+      const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) override;
+
+ private:
+  std::shared_ptr<MemEngine> GetRawEngine();
+
+  std::weak_ptr<MemEngine> raw_engine_;
+};
+
+}  // namespace mem
+
+// Pure memory raw engine, data is lost after restart.
+// Every write get a increasing sequence number, snapshot is a sequence number, so read never block write.
+// It is suitable for small hot table, metadata and test/benchmark without disk io.
+// Overwrite and delete add new versions, the column family is compacted by the writer when its entry count grows
+// to mem_engine_auto_compact_ratio times of the count after last compact, see MaybeCompact().
+class MemEngine : public RawEngine {
  public:
   MemEngine() = default;
   ~MemEngine() override = default;
 
-  bool Init(std::shared_ptr<Config> config) override;
+  MemEngine(const MemEngine& rhs) = delete;
+  MemEngine& operator=(const MemEngine& rhs) = delete;
+  MemEngine(MemEngine&& rhs) = delete;
+  MemEngine& operator=(MemEngine&& rhs) = delete;
+
+  std::shared_ptr<MemEngine> GetSelfPtr() { return std::dynamic_pointer_cast<MemEngine>(shared_from_this()); }
+
+  // override functions
+  bool Init(std::shared_ptr<Config> config, const std::vector<std::string>& cf_names) override;
+  void Close() override;
+  void Destroy() override;
+
   std::string GetName() override;
-  pb::common::StorageEngine GetID() override;
+  pb::common::RawEngine GetRawEngineType() override;
+  dingodb::SnapshotPtr GetSnapshot() override;
+
+  RawEngine::ReaderPtr Reader() override { return reader_; }
+  RawEngine::WriterPtr Writer() override { return writer_; }
+  RawEngine::CheckpointPtr NewCheckpoint() override;
+
+  butil::Status MergeCheckpointFiles(const std::string& path, const pb::common::Range& range,
+                                     const std::vector<std::string>& cf_names,
+                                     std::vector<std::string>& merge_sst_paths) override;
+  butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
+
+  void Flush(const std::string& cf_name) override;
+  // Drop the versions which not visible to any snapshot.
+  butil::Status Compact(const std::string& cf_name) override;
+  std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
 
-  std::shared_ptr<Snapshot> GetSnapshot() override { return nullptr; }
-  butil::Status SaveSnapshot(std::shared_ptr<Context>, int64_t, bool) override { return butil::Status(); }
-  butil::Status AyncSaveSnapshot(std::shared_ptr<Context>, int64_t, bool) override { return butil::Status(); }
+  mem::ColumnFamilyPtr GetColumnFamily(const std::string& cf_name);
 
-  butil::Status Write(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
-  butil::Status AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
-  butil::Status AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data,
-                           WriteCbFunc cb) override;
+  // Last sequence which all write of it is visible.
+  uint64_t GetLastSeq() const { return last_seq_.load(std::memory_order_acquire); }
 
-  std::shared_ptr<Engine::Reader> NewReader(pb::common::RawEngine type) override;
-  std::shared_ptr<Engine::Writer> NewWriter(pb::common::RawEngine type) override;
-  std::shared_ptr<Engine::VectorReader> NewVectorReader(pb::common::RawEngine type) override;
-  std::shared_ptr<Engine::TxnReader> NewTxnReader(pb::common::RawEngine type) override;
-  std::shared_ptr<Engine::TxnWriter> NewTxnWriter(pb::common::RawEngine type) override;
+  // Write batch atomically, the ops is applied in order.
+  butil::Status Write(const RawEngine::WriteBatch& batch);
+  // Write delete tombstone for every visible key in ranges atomically.
+  butil::Status DeleteRange(const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs);
+
+  void ReleaseSnapshot(uint64_t seq);
 
  private:
-  std::map<std::string, std::string> store_;
+  // Compact column family if there are too many versions, called after write without holding write_mutex_.
+  void MaybeCompact(mem::ColumnFamilyPtr column_family);
+
+  std::map<std::string, mem::ColumnFamilyPtr> column_families_;
+
+  // Serialize write and compact.
+  bthread::Mutex write_mutex_;
+  std::atomic<uint64_t> last_seq_{0};
+
+  bthread::Mutex snapshot_mutex_;
+  std::multiset<uint64_t> snapshots_;
+
+  RawEngine::ReaderPtr reader_;
+  RawEngine::WriterPtr writer_;
 };
 
 }  // namespace dingodb
 
-#endif
+#endif  // DINGODB_ENGINE_MEM_ENGINE_H_  // NOLINT
@@ -39,6 +39,9 @@
 #include "engine/write_data.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "log/raft_log_storage.h"
+#include "log/segment_log_storage.h"
+#include "log/shared_log_storage.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator_internal.pb.h"
@@ -54,9 +57,11 @@
 
 namespace dingodb {
 
-RaftStoreEngine::RaftStoreEngine(std::shared_ptr<RawEngine> rocks_engine, std::shared_ptr<RawEngine> bdb_engine)
+RaftStoreEngine::RaftStoreEngine(std::shared_ptr<RawEngine> rocks_engine, std::shared_ptr<RawEngine> bdb_engine,
+                                 std::shared_ptr<RawEngine> mem_engine)
     : raw_rocks_engine(rocks_engine),
       raw_bdb_engine(bdb_engine),
+      raw_mem_engine(mem_engine),
       raft_node_manager(std::move(std::make_unique<RaftNodeManager>())) {}
 
 RaftStoreEngine::~RaftStoreEngine() = default;
@@ -180,6 +185,8 @@ std::shared_ptr<RawEngine> RaftStoreEngine::GetRawEngine(pb::common::RawEngine t
     return raw_rocks_engine;
   } else if (type == pb::common::RawEngine::RAW_ENG_BDB) {
     return raw_bdb_engine;
+  } else if (type == pb::common::RawEngine::RAW_ENG_MEMORY) {
+    return raw_mem_engine;
   }
 
   DINGO_LOG(FATAL) << "[raft.engine] unknown raw engine type.";
@@ -189,6 +196,10 @@ butil::Status RaftStoreEngine::AddNode(store::RegionPtr region, const AddNodePar
   DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] add region.", region->Id());
 
   std::shared_ptr<RawEngine> raw_engine = GetRawEngine(region->GetRawEngineType());
+  if (raw_engine == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("Raw engine {} is not enabled",
+                                                           pb::common::RawEngine_Name(region->GetRawEngineType())));
+  }
   // Build StateMachine
   auto state_machine = std::make_shared<StoreStateMachine>(raw_engine, region, parameter.raft_meta,
                                                            parameter.region_metrics, parameter.listeners);
@@ -197,10 +208,16 @@ butil::Status RaftStoreEngine::AddNode(store::RegionPtr region, const AddNodePar
   }
 
   // Build log storage
-  std::string log_path = fmt::format("{}/{}", parameter.log_path, region->Id());
-  int64_t max_segment_size =
-      parameter.log_max_segment_size > 0 ? parameter.log_max_segment_size : Constant::kSegmentLogDefaultMaxSegmentSize;
-  auto log_storage = std::make_shared<SegmentLogStorage>(log_path, region->Id(), max_segment_size);
+  std::shared_ptr<RaftLogStorage> log_storage;
+  auto shared_log_engine = Server::GetInstance().GetLogStorageManager()->GetSharedLogEngine();
+  if (shared_log_engine != nullptr) {
+    log_storage = std::make_shared<SharedLogStorage>(shared_log_engine, region->Id());
+  } else {
+    std::string log_path = fmt::format("{}/{}", parameter.log_path, region->Id());
+    int64_t max_segment_size = parameter.log_max_segment_size > 0 ? parameter.log_max_segment_size
+                                                                  : Constant::kSegmentLogDefaultMaxSegmentSize;
+    log_storage = std::make_shared<SegmentLogStorage>(log_path, region->Id(), max_segment_size);
+  }
   Server::GetInstance().GetLogStorageManager()->AddLogStorage(region->Id(), log_storage);
 
   // Build RaftNode
@@ -442,6 +459,30 @@ butil::Status RaftStoreEngine::Reader::KvGet(std::shared_ptr<Context> ctx, const
   return reader_->KvGet(ctx->CfName(), key, value);
 }
 
+butil::Status RaftStoreEngine::Reader::KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                                  std::vector<pb::common::KeyValue>& kvs) {
+  std::vector<std::string> values;
+  std::vector<bool> founds;
+  auto status = reader_->KvMultiGet(ctx->CfName(), keys, values, founds);
+  if (!status.ok()) {
+    return status;
+  }
+
+  kvs.reserve(kvs.size() + keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!founds[i]) {
+      continue;
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(keys[i]);
+    kv.set_value(std::move(values[i]));
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
 butil::Status RaftStoreEngine::Reader::KvScan(std::shared_ptr<Context> ctx, const std::string& start_key,
                                               const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
   return reader_->KvScan(ctx->CfName(), start_key, end_key, kvs);
@@ -496,10 +537,10 @@ butil::Status RaftStoreEngine::VectorReader::VectorCount(const pb::common::Range
 butil::Status RaftStoreEngine::VectorReader::VectorBatchSearchDebug(
     std::shared_ptr<VectorReader::Context> ctx,  // NOLINT
     std::vector<pb::index::VectorWithDistanceResult>& results, int64_t& deserialization_id_time_us,
-    int64_t& scan_scalar_time_us, int64_t& search_time_us) {
+    int64_t& scan_scalar_time_us, int64_t& search_time_us, std::string& filter_strategy) {
   auto vector_reader = dingodb::VectorReader::New(reader_);
   return vector_reader->VectorBatchSearchDebug(ctx, results, deserialization_id_time_us, scan_scalar_time_us,
-                                               search_time_us);
+                                               search_time_us, filter_strategy);
 }
 
 std::shared_ptr<Engine::VectorReader> RaftStoreEngine::NewVectorReader(pb::common::RawEngine type) {
@@ -73,7 +73,8 @@ class RaftControlAble {
 
 class RaftStoreEngine : public Engine, public RaftControlAble {
  public:
-  RaftStoreEngine(std::shared_ptr<RawEngine> raw_rocks_engine, std::shared_ptr<RawEngine> raw_bdb_engine);
+  RaftStoreEngine(std::shared_ptr<RawEngine> raw_rocks_engine, std::shared_ptr<RawEngine> raw_bdb_engine,
+                  std::shared_ptr<RawEngine> raw_mem_engine);
   ~RaftStoreEngine() override;
 
   std::shared_ptr<RaftStoreEngine> GetSelfPtr();
@@ -113,6 +114,8 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
    public:
     Reader(RawEngine::ReaderPtr reader) : reader_(reader) {}
     butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) override;
+    butil::Status KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                             std::vector<pb::common::KeyValue>& kvs) override;
 
     butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                          std::vector<pb::common::KeyValue>& kvs) override;
@@ -164,7 +167,8 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
     butil::Status VectorBatchSearchDebug(std::shared_ptr<VectorReader::Context> ctx,  // NOLINT
                                          std::vector<pb::index::VectorWithDistanceResult>& results,
                                          int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
-                                         int64_t& search_time_us) override;  // NOLINT
+                                         int64_t& search_time_us,
+                                         std::string& filter_strategy) override;  // NOLINT
 
    private:
     RawEngine::ReaderPtr reader_;
@@ -231,6 +235,7 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
  protected:
   std::shared_ptr<RawEngine> raw_rocks_engine;  // RocksDB, the system engine, for meta and data
   std::shared_ptr<RawEngine> raw_bdb_engine;    // BDB, the engine for data
+  std::shared_ptr<RawEngine> raw_mem_engine;    // Memory, the engine for data, nullptr if not enabled
   std::unique_ptr<RaftNodeManager> raft_node_manager;
 };
 
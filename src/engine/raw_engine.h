@@ -25,6 +25,7 @@
 #include "butil/status.h"
 #include "common/context.h"
 #include "config/config.h"
+#include "engine/gc_safe_point.h"
 #include "engine/iterator.h"
 #include "engine/snapshot.h"
 #include "engine/write_data.h"
@@ -46,6 +47,14 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
     virtual butil::Status KvGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                                 const std::string& key, std::string& value) = 0;
 
+    // Get many keys in one call, values and founds are aligned with keys.
+    // Missing key is not an error, it only set founds[i] to false.
+    virtual butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                     std::vector<std::string>& values, std::vector<bool>& founds) = 0;
+    virtual butil::Status KvMultiGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                     const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                     std::vector<bool>& founds) = 0;
+
     virtual butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
     virtual butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -64,6 +73,33 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
   };
   using ReaderPtr = std::shared_ptr<Reader>;
 
+  // Ordered put/delete on multiple column families, written atomically by Writer::KvBatchWrite.
+  class WriteBatch {
+   public:
+    struct Op {
+      bool is_delete{false};
+      std::string cf_name;
+      std::string key;
+      std::string value;
+    };
+
+    WriteBatch() = default;
+    ~WriteBatch() = default;
+
+    void Put(const std::string& cf_name, const std::string& key, const std::string& value) {
+      ops_.push_back(Op{false, cf_name, key, value});
+    }
+    void Delete(const std::string& cf_name, const std::string& key) { ops_.push_back(Op{true, cf_name, key, ""}); }
+
+    const std::vector<Op>& Ops() const { return ops_; }
+    size_t Count() const { return ops_.size(); }
+    bool Empty() const { return ops_.empty(); }
+    void Clear() { ops_.clear(); }
+
+   private:
+    std::vector<Op> ops_;
+  };
+
   class Writer {
    public:
     Writer() = default;
@@ -79,6 +115,8 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
         const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_put_with_cfs,
         const std::map<std::string, std::vector<std::string>>& kv_delete_with_cfs) = 0;
 
+    virtual butil::Status KvBatchWrite(const WriteBatch& batch) = 0;
+
     virtual butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) = 0;
     virtual butil::Status KvBatchDeleteRange(
         const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) = 0;
@@ -133,9 +171,35 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
   virtual std::vector<int64_t> GetApproximateSizes(const std::string& cf_name,
                                                    std::vector<pb::common::Range>& ranges) = 0;
 
+  // Sampled key distribution of range, collected when build sst file.
+  struct RangeProperties {
+    struct Sample {
+      std::string key;
+      // Size and key number between previous sample key and this key.
+      int64_t size{0};
+      int64_t keys{0};
+    };
+
+    // Sst samples in range, ordered by key.
+    std::vector<Sample> samples;
+    // Data still in memtable, not sampled.
+    int64_t memtable_size{0};
+    int64_t memtable_keys{0};
+  };
+
+  // Return ENOT_SUPPORT when engine not collect properties or some sst in range lack properties,
+  // caller should fallback to scan.
+  virtual butil::Status GetRangeProperties(const std::string& /*cf_name*/, const pb::common::Range& /*range*/,
+                                           RangeProperties& /*properties*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support range properties.");
+  }
+
   virtual void Flush(const std::string& cf_name) = 0;
   virtual butil::Status Compact(const std::string& cf_name) = 0;
 
+  // Safe point for mvcc gc on compaction.
+  virtual void SetGcSafePoint(std::shared_ptr<GCSafePoint> /*gc_safe_point*/) {}
+
  protected:
   RawEngine() = default;
 };
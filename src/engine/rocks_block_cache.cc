@@ -0,0 +1,116 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/rocks_block_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "common/constant.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+namespace rocks {
+
+ColumnFamilyBlockCache::ColumnFamilyBlockCache(std::shared_ptr<rocksdb::Cache> target,
+                                               const std::string& metrics_prefix, const std::string& cf_name)
+    : rocksdb::CacheWrapper(std::move(target)) {
+  hit_count_.expose_as(metrics_prefix + "_block_cache", cf_name + "_hit");
+  miss_count_.expose_as(metrics_prefix + "_block_cache", cf_name + "_miss");
+}
+
+rocksdb::Cache::Handle* ColumnFamilyBlockCache::Lookup(const rocksdb::Slice& key, const CacheItemHelper* helper,
+                                                       CreateContext* create_context, Priority priority,
+                                                       rocksdb::Statistics* stats) {
+  auto* handle = target_->Lookup(key, helper, create_context, priority, stats);
+  if (handle != nullptr) {
+    hit_count_ << 1;
+  } else {
+    miss_count_ << 1;
+  }
+
+  return handle;
+}
+
+bool SharedBlockCache::Init(std::shared_ptr<Config> config, const std::string& metrics_prefix) {
+  metrics_prefix_ = metrics_prefix;
+
+  int64_t capacity = config->GetInt64(Constant::kStoreBlockCacheCapacity);
+  if (capacity > 0) {
+    std::string type = config->GetString(Constant::kStoreBlockCacheType);
+    if (type.empty() || type == Constant::kBlockCacheTypeLRU) {
+      cache_ = rocksdb::NewLRUCache(capacity);
+    } else if (type == Constant::kBlockCacheTypeHyperClock) {
+      // Estimated entry charge is the data block size.
+      int64_t block_size = config->GetInt64(Constant::kBaseColumnFamily + "." + Constant::kBlockSize);
+      if (block_size <= 0) {
+        block_size = std::stoll(Constant::kBlockSizeDefaultValue);
+      }
+      cache_ = rocksdb::HyperClockCacheOptions(capacity, block_size).MakeSharedCache();
+    } else {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support block cache type: {}", type);
+      return false;
+    }
+
+    cache_usage_ = std::make_unique<bvar::PassiveStatus<int64_t>>(metrics_prefix + "_block_cache_usage",
+                                                                   &SharedBlockCache::GetCacheUsage, this);
+    cache_pinned_usage_ = std::make_unique<bvar::PassiveStatus<int64_t>>(
+        metrics_prefix + "_block_cache_pinned_usage", &SharedBlockCache::GetCachePinnedUsage, this);
+
+    DINGO_LOG(INFO) << fmt::format("[rocksdb] shared block cache type: {} capacity: {}",
+                                   type.empty() ? Constant::kBlockCacheTypeLRU : type, capacity);
+  }
+
+  int64_t buffer_size = config->GetInt64(Constant::kStoreWriteBufferManagerBufferSize);
+  if (buffer_size > 0) {
+    bool cost_to_cache = config->GetBool(Constant::kStoreWriteBufferManagerCostToCache);
+    if (cost_to_cache && cache_ == nullptr) {
+      DINGO_LOG(WARNING) << "[rocksdb] shared block cache is disable, memtable memory not cost to cache.";
+    }
+
+    write_buffer_manager_ =
+        std::make_shared<rocksdb::WriteBufferManager>(buffer_size, cost_to_cache ? cache_ : nullptr);
+
+    memtable_usage_ = std::make_unique<bvar::PassiveStatus<int64_t>>(metrics_prefix + "_memtable_usage",
+                                                                      &SharedBlockCache::GetMemtableUsage, this);
+
+    DINGO_LOG(INFO) << fmt::format("[rocksdb] write buffer manager buffer_size: {} cost_to_cache: {}", buffer_size,
+                                   cost_to_cache && cache_ != nullptr);
+  }
+
+  return true;
+}
+
+int64_t SharedBlockCache::GetCacheUsage(void* arg) {
+  auto* self = static_cast<SharedBlockCache*>(arg);
+  return self->cache_ != nullptr ? self->cache_->GetUsage() : 0;
+}
+
+int64_t SharedBlockCache::GetCachePinnedUsage(void* arg) {
+  auto* self = static_cast<SharedBlockCache*>(arg);
+  return self->cache_ != nullptr ? self->cache_->GetPinnedUsage() : 0;
+}
+
+int64_t SharedBlockCache::GetMemtableUsage(void* arg) {
+  auto* self = static_cast<SharedBlockCache*>(arg);
+  return self->write_buffer_manager_ != nullptr ? self->write_buffer_manager_->memory_usage() : 0;
+}
+
+}  // namespace rocks
+
+}  // namespace dingodb
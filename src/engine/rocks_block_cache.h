@@ -0,0 +1,91 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_ROCKS_BLOCK_CACHE_H_  // NOLINT
+#define DINGODB_ENGINE_ROCKS_BLOCK_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "bvar/bvar.h"
+#include "config/config.h"
+#include "rocksdb/advanced_cache.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/write_buffer_manager.h"
+
+namespace dingodb {
+
+namespace rocks {
+
+// Count block cache hit/miss of one column family, all column families can wrap the same store-wide cache,
+// so memory follow the workload and the hit rate of every column family is still visible.
+// bvar: {metrics_prefix}_block_cache_{cf_name}_hit/miss
+class ColumnFamilyBlockCache : public rocksdb::CacheWrapper {
+ public:
+  ColumnFamilyBlockCache(std::shared_ptr<rocksdb::Cache> target, const std::string& metrics_prefix,
+                         const std::string& cf_name);
+  ~ColumnFamilyBlockCache() override = default;
+
+  const char* Name() const override { return "ColumnFamilyBlockCache"; }
+
+  Handle* Lookup(const rocksdb::Slice& key, const CacheItemHelper* helper = nullptr,
+                 CreateContext* create_context = nullptr, Priority priority = Priority::LOW,
+                 rocksdb::Statistics* stats = nullptr) override;
+
+ private:
+  bvar::Adder<int64_t> hit_count_;
+  bvar::Adder<int64_t> miss_count_;
+};
+
+// Store-wide block cache and memtable budget, config from store yaml:
+//   store.block_cache.type: lru or hyper_clock
+//   store.block_cache.capacity: bytes, 0 means every column family has its own cache(store.base.block_cache)
+//   store.write_buffer_manager.buffer_size: memtable memory limit of all column families, 0 means no limit
+//   store.write_buffer_manager.cost_to_cache: charge memtable memory to the shared block cache
+// bvar: {metrics_prefix}_block_cache_usage/pinned_usage and {metrics_prefix}_memtable_usage
+class SharedBlockCache {
+ public:
+  SharedBlockCache() = default;
+  ~SharedBlockCache() = default;
+
+  // metrics_prefix is unique of every engine, bvar name is process-global.
+  bool Init(std::shared_ptr<Config> config, const std::string& metrics_prefix);
+
+  const std::string& GetMetricsPrefix() const { return metrics_prefix_; }
+
+  // Return nullptr when shared block cache is disable.
+  std::shared_ptr<rocksdb::Cache> GetCache() { return cache_; }
+  // Return nullptr when write buffer manager is disable.
+  std::shared_ptr<rocksdb::WriteBufferManager> GetWriteBufferManager() { return write_buffer_manager_; }
+
+ private:
+  static int64_t GetCacheUsage(void* arg);
+  static int64_t GetCachePinnedUsage(void* arg);
+  static int64_t GetMemtableUsage(void* arg);
+
+  std::string metrics_prefix_;
+  std::shared_ptr<rocksdb::Cache> cache_;
+  std::shared_ptr<rocksdb::WriteBufferManager> write_buffer_manager_;
+
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> cache_usage_;
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> cache_pinned_usage_;
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> memtable_usage_;
+};
+
+}  // namespace rocks
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_ROCKS_BLOCK_CACHE_H_  // NOLINT
@@ -0,0 +1,166 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/rocks_gc_compaction_filter.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/store.pb.h"
+
+DEFINE_bool(enable_txn_gc_compaction_filter, false,
+            "enable txn mvcc gc by compaction filter, raft gc only clean up delete tombstone");
+
+namespace dingodb {
+
+namespace rocks {
+
+static bvar::Adder<int64_t> g_txn_gc_filter_write_count("txn_gc_compaction_filter_write_count");
+static bvar::Adder<int64_t> g_txn_gc_filter_data_count("txn_gc_compaction_filter_data_count");
+
+TxnWriteGcCompactionFilter::~TxnWriteGcCompactionFilter() {
+  if (filtered_count_ > 0) {
+    DINGO_LOG(INFO) << fmt::format("[txn_gc][compaction_filter] safe_point_ts: {} filtered write count: {}",
+                                   safe_point_ts_, filtered_count_);
+  }
+}
+
+bool TxnWriteGcCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+                                        std::string* /*new_value*/, bool* /*value_changed*/) const {
+  std::string write_key;
+  int64_t write_ts = 0;
+  auto status = Helper::DecodeTxnKey(std::string_view(key.data(), key.size()), write_key, write_ts);
+  if (!status.ok()) {
+    return false;
+  }
+
+  // Versions of same key is ordered by write_ts desc.
+  if (write_key != last_key_) {
+    last_key_ = write_key;
+    has_safe_point_version_ = false;
+  }
+
+  if (write_ts > safe_point_ts_) {
+    return false;
+  }
+
+  pb::store::WriteInfo write_info;
+  if (!write_info.ParseFromArray(existing_value.data(), existing_value.size())) {
+    DINGO_LOG(ERROR) << fmt::format("[txn_gc][compaction_filter] parse write info failed, key: {}",
+                                    Helper::StringToHex(std::string_view(key.data(), key.size())));
+    return false;
+  }
+
+  bool is_filter = false;
+  switch (write_info.op()) {
+    case pb::store::Put:
+      if (!has_safe_point_version_) {
+        has_safe_point_version_ = true;
+      } else if (write_info.short_value().empty()) {
+        // Drop the write record only after the data value is deleted, otherwise the data value is never reclaimed.
+        is_filter = DeleteDataKey(Helper::EncodeTxnKey(write_key, write_info.start_ts()));
+      } else {
+        is_filter = true;
+      }
+      break;
+    case pb::store::Delete:
+      // Tombstone is kept for raft gc.
+      if (!has_safe_point_version_) {
+        has_safe_point_version_ = true;
+      } else {
+        is_filter = true;
+      }
+      break;
+    case pb::store::Rollback:
+      is_filter = true;
+      break;
+    default:
+      break;
+  }
+
+  if (is_filter) {
+    ++filtered_count_;
+    g_txn_gc_filter_write_count << 1;
+  }
+
+  return is_filter;
+}
+
+bool TxnWriteGcCompactionFilter::DeleteDataKey(const std::string& data_key) const {
+  if (data_delete_failed_) {
+    return false;
+  }
+
+  auto db = db_.lock();
+  if (db == nullptr || data_cf_handle_ == nullptr) {
+    return false;
+  }
+
+  // Run in compaction thread, never wait write stall which maybe wait this compaction.
+  rocksdb::WriteOptions write_options;
+  write_options.no_slowdown = true;
+  rocksdb::Status s = db->Delete(write_options, data_cf_handle_, data_key);
+  if (!s.ok()) {
+    // Keep the rest versions of this compaction, they are dropped by the later compaction.
+    data_delete_failed_ = true;
+    DINGO_LOG(WARNING) << fmt::format("[txn_gc][compaction_filter] delete data failed, key: {} error: {}",
+                                      Helper::StringToHex(data_key), s.ToString());
+    return false;
+  }
+
+  g_txn_gc_filter_data_count << 1;
+  return true;
+}
+
+void TxnWriteGcCompactionFilterFactory::SetDataColumnFamily(std::weak_ptr<rocksdb::DB> db,
+                                                            rocksdb::ColumnFamilyHandle* data_cf_handle) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  db_ = db;
+  data_cf_handle_ = data_cf_handle;
+}
+
+void TxnWriteGcCompactionFilterFactory::SetGcSafePoint(std::shared_ptr<GCSafePoint> gc_safe_point) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  gc_safe_point_ = gc_safe_point;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> TxnWriteGcCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  if (!FLAGS_enable_txn_gc_compaction_filter) {
+    return nullptr;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (gc_safe_point_ == nullptr || data_cf_handle_ == nullptr) {
+    return nullptr;
+  }
+
+  auto [gc_stop, safe_point_ts] = gc_safe_point_->GetGcFlagAndSafePointTs();
+  if (gc_stop || gc_safe_point_->GetForceGcStop() || safe_point_ts <= 0) {
+    return nullptr;
+  }
+
+  return std::make_unique<TxnWriteGcCompactionFilter>(safe_point_ts, db_, data_cf_handle_);
+}
+
+}  // namespace rocks
+
+}  // namespace dingodb
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_ROCKS_GC_COMPACTION_FILTER_H_  // NOLINT
+#define DINGODB_ENGINE_ROCKS_GC_COMPACTION_FILTER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "bthread/mutex.h"
+#include "engine/gc_safe_point.h"
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/db.h"
+
+namespace dingodb {
+
+namespace rocks {
+
+// MVCC gc on compaction of txn write column family.
+// For every user key, the versions are ordered from new to old, the newest version(Put/Delete) which
+// commit_ts <= safe_point_ts must be kept, the older versions and rollback record can be dropped.
+// The data column family value of dropped Put is deleted before the write record is dropped, it is not
+// replicated by raft, every replica do it by itself. If the delete fails the version is kept for later compaction.
+// Delete tombstone is always kept, the version under it maybe in other sst which not join this compaction,
+// drop it will make the old version visible again, so tombstone is cleaned up by raft gc.
+class TxnWriteGcCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  TxnWriteGcCompactionFilter(int64_t safe_point_ts, std::weak_ptr<rocksdb::DB> db,
+                             rocksdb::ColumnFamilyHandle* data_cf_handle)
+      : safe_point_ts_(safe_point_ts), db_(db), data_cf_handle_(data_cf_handle) {}
+  ~TxnWriteGcCompactionFilter() override;
+
+  bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+              bool* value_changed) const override;
+
+  const char* Name() const override { return "TxnWriteGcCompactionFilter"; }
+
+ private:
+  // Delete data column family value of dropped Put, return false if the write record must be kept.
+  bool DeleteDataKey(const std::string& data_key) const;
+
+  const int64_t safe_point_ts_;
+  std::weak_ptr<rocksdb::DB> db_;
+  rocksdb::ColumnFamilyHandle* data_cf_handle_;
+
+  // Compaction filter is used by one compaction thread, Filter() is const so state is mutable.
+  mutable std::string last_key_;
+  // Already meet the newest version which commit_ts <= safe_point_ts of last_key_.
+  mutable bool has_safe_point_version_{false};
+  // Delete data failed(e.g. write stall), stop deleting in this compaction.
+  mutable bool data_delete_failed_{false};
+  mutable int64_t filtered_count_{0};
+};
+
+class TxnWriteGcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  TxnWriteGcCompactionFilterFactory() = default;
+  ~TxnWriteGcCompactionFilterFactory() override = default;
+
+  // Data column family is ready after db open.
+  void SetDataColumnFamily(std::weak_ptr<rocksdb::DB> db, rocksdb::ColumnFamilyHandle* data_cf_handle);
+  void SetGcSafePoint(std::shared_ptr<GCSafePoint> gc_safe_point);
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "TxnWriteGcCompactionFilterFactory"; }
+
+ private:
+  bthread::Mutex mutex_;
+  std::weak_ptr<rocksdb::DB> db_;
+  rocksdb::ColumnFamilyHandle* data_cf_handle_{nullptr};
+  std::shared_ptr<GCSafePoint> gc_safe_point_;
+};
+
+}  // namespace rocks
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_ROCKS_GC_COMPACTION_FILTER_H_  // NOLINT
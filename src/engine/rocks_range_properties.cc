@@ -0,0 +1,171 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/rocks_range_properties.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+namespace rocks {
+
+static void PutFixed64(std::string& dst, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    dst.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+  }
+}
+
+static bool GetFixed64(const std::string& src, size_t& pos, uint64_t& value) {
+  if (pos + 8 > src.size()) {
+    return false;
+  }
+
+  value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(src[pos + i])) << (i * 8);
+  }
+  pos += 8;
+
+  return true;
+}
+
+rocksdb::Status RangePropertiesCollector::AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value,
+                                                     rocksdb::EntryType type, rocksdb::SequenceNumber /*seq*/,
+                                                     uint64_t /*file_size*/) {
+  // Tombstone is not visible data, same as scan.
+  if (type != rocksdb::kEntryPut && type != rocksdb::kEntryMerge) {
+    return rocksdb::Status::OK();
+  }
+
+  size_ += key.size() + value.size();
+  ++keys_;
+  last_key_.assign(key.data(), key.size());
+
+  if (size_ >= sample_size_ || keys_ >= sample_keys_) {
+    samples_.push_back(RawEngine::RangeProperties::Sample{last_key_, size_, keys_});
+    size_ = 0;
+    keys_ = 0;
+  }
+
+  return rocksdb::Status::OK();
+}
+
+rocksdb::Status RangePropertiesCollector::Finish(rocksdb::UserCollectedProperties* properties) {
+  if (keys_ > 0) {
+    samples_.push_back(RawEngine::RangeProperties::Sample{last_key_, size_, keys_});
+    size_ = 0;
+    keys_ = 0;
+  }
+
+  properties->insert({kPropertiesName, Encode(samples_)});
+  return rocksdb::Status::OK();
+}
+
+rocksdb::UserCollectedProperties RangePropertiesCollector::GetReadableProperties() const {
+  int64_t total_size = 0;
+  int64_t total_keys = 0;
+  for (const auto& sample : samples_) {
+    total_size += sample.size;
+    total_keys += sample.keys;
+  }
+
+  return {{"dingo.range_properties.samples", std::to_string(samples_.size())},
+          {"dingo.range_properties.size", std::to_string(total_size)},
+          {"dingo.range_properties.keys", std::to_string(total_keys)}};
+}
+
+// Format: | sample count(8) | [size(8) keys(8) key_len(8) key] ... |
+std::string RangePropertiesCollector::Encode(const std::vector<RawEngine::RangeProperties::Sample>& samples) {
+  std::string data;
+  PutFixed64(data, samples.size());
+  for (const auto& sample : samples) {
+    PutFixed64(data, sample.size);
+    PutFixed64(data, sample.keys);
+    PutFixed64(data, sample.key.size());
+    data.append(sample.key);
+  }
+
+  return data;
+}
+
+bool RangePropertiesCollector::Decode(const std::string& data,
+                                      std::vector<RawEngine::RangeProperties::Sample>& samples) {
+  size_t pos = 0;
+  uint64_t count = 0;
+  if (!GetFixed64(data, pos, count)) {
+    return false;
+  }
+
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t size = 0, keys = 0, key_len = 0;
+    if (!GetFixed64(data, pos, size) || !GetFixed64(data, pos, keys) || !GetFixed64(data, pos, key_len)) {
+      return false;
+    }
+    if (pos + key_len > data.size()) {
+      return false;
+    }
+
+    samples.push_back(RawEngine::RangeProperties::Sample{data.substr(pos, key_len), static_cast<int64_t>(size),
+                                                         static_cast<int64_t>(keys)});
+    pos += key_len;
+  }
+
+  return true;
+}
+
+bool MergeRangeProperties(const rocksdb::TablePropertiesCollection& tables, const std::string& start_key,
+                          const std::string& end_key, std::vector<RawEngine::RangeProperties::Sample>& samples) {
+  for (const auto& [file_name, table] : tables) {
+    if (table == nullptr) {
+      return false;
+    }
+
+    auto it = table->user_collected_properties.find(RangePropertiesCollector::kPropertiesName);
+    if (it == table->user_collected_properties.end()) {
+      DINGO_LOG(DEBUG) << fmt::format("[rocksdb] sst {} not exist range properties.", file_name);
+      return false;
+    }
+
+    std::vector<RawEngine::RangeProperties::Sample> table_samples;
+    if (!RangePropertiesCollector::Decode(it->second, table_samples)) {
+      DINGO_LOG(WARNING) << fmt::format("[rocksdb] decode sst {} range properties failed.", file_name);
+      return false;
+    }
+
+    for (auto& sample : table_samples) {
+      if (sample.key < start_key || (!end_key.empty() && sample.key >= end_key)) {
+        continue;
+      }
+      samples.push_back(std::move(sample));
+    }
+  }
+
+  std::sort(samples.begin(), samples.end(),
+            [](const RawEngine::RangeProperties::Sample& lhs, const RawEngine::RangeProperties::Sample& rhs) {
+              return lhs.key < rhs.key;
+            });
+
+  return true;
+}
+
+}  // namespace rocks
+
+}  // namespace dingodb
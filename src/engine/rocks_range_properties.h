@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_ROCKS_RANGE_PROPERTIES_H_  // NOLINT
+#define DINGODB_ENGINE_ROCKS_RANGE_PROPERTIES_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine/raw_engine.h"
+#include "rocksdb/table_properties.h"
+
+namespace dingodb {
+
+namespace rocks {
+
+// Sample key every sample_size bytes or sample_keys keys when build sst, used by split check
+// to choose split key without scan the whole region.
+// Every sample record the size and keys between previous sample and this sample, the last key of sst is
+// always sampled, so sum of samples is the total of sst.
+class RangePropertiesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  RangePropertiesCollector(int64_t sample_size, int64_t sample_keys)
+      : sample_size_(sample_size), sample_keys_(sample_keys) {}
+  ~RangePropertiesCollector() override = default;
+
+  static constexpr const char* kPropertiesName = "dingo.range_properties";
+
+  rocksdb::Status AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value, rocksdb::EntryType type,
+                             rocksdb::SequenceNumber seq, uint64_t file_size) override;
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override;
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override;
+
+  const char* Name() const override { return "RangePropertiesCollector"; }
+
+  static std::string Encode(const std::vector<RawEngine::RangeProperties::Sample>& samples);
+  static bool Decode(const std::string& data, std::vector<RawEngine::RangeProperties::Sample>& samples);
+
+ private:
+  const int64_t sample_size_;
+  const int64_t sample_keys_;
+
+  std::vector<RawEngine::RangeProperties::Sample> samples_;
+  std::string last_key_;
+  int64_t size_{0};
+  int64_t keys_{0};
+};
+
+class RangePropertiesCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  RangePropertiesCollectorFactory(int64_t sample_size, int64_t sample_keys)
+      : sample_size_(sample_size), sample_keys_(sample_keys) {}
+  ~RangePropertiesCollectorFactory() override = default;
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context /*context*/) override {
+    return new RangePropertiesCollector(sample_size_, sample_keys_);
+  }
+
+  const char* Name() const override { return "RangePropertiesCollectorFactory"; }
+
+ private:
+  const int64_t sample_size_;
+  const int64_t sample_keys_;
+};
+
+// Merge range properties of sst tables, filter sample out of range.
+// Return false when some table has no range properties.
+bool MergeRangeProperties(const rocksdb::TablePropertiesCollection& tables, const std::string& start_key,
+                          const std::string& end_key, std::vector<RawEngine::RangeProperties::Sample>& samples);
+
+}  // namespace rocks
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_ROCKS_RANGE_PROPERTIES_H_  // NOLINT
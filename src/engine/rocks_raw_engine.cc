@@ -26,6 +26,7 @@
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -41,8 +42,12 @@
 #include "common/logging.h"
 #include "config/config_helper.h"
 #include "engine/raw_engine.h"
+#include "engine/rocks_block_cache.h"
+#include "engine/rocks_gc_compaction_filter.h"
+#include "engine/rocks_range_properties.h"
 #include "engine/snapshot.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "rocksdb/advanced_options.h"
@@ -53,6 +58,10 @@
 #include "rocksdb/table.h"
 #include "rocksdb/write_batch.h"
 
+DEFINE_bool(rocks_enable_range_properties, true, "enable collect range properties for split check");
+DEFINE_int64(rocks_range_properties_sample_size, 4 * 1024 * 1024, "range properties sample distance size");
+DEFINE_int64(rocks_range_properties_sample_keys, 64 * 1024, "range properties sample distance keys");
+
 namespace dingodb {
 
 namespace rocks {
@@ -342,6 +351,72 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& founds) {
+  return KvMultiGet(GetColumnFamily(cf_name), GetSnapshot(), keys, values, founds);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& founds) {
+  return KvMultiGet(GetColumnFamily(cf_name), snapshot, keys, values, founds);
+}
+
+butil::Status Reader::KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& founds) {
+  values.clear();
+  founds.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // MultiGet with sorted input can batch block reads of the same data block and skip the inner sort.
+  std::vector<size_t> indexes(keys.size());
+  std::iota(indexes.begin(), indexes.end(), 0);
+  std::sort(indexes.begin(), indexes.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (auto index : indexes) {
+    key_slices.emplace_back(keys[index]);
+  }
+
+  std::vector<rocksdb::PinnableSlice> pinnable_values(keys.size());
+  std::vector<rocksdb::Status> statuses(keys.size());
+
+  rocksdb::ReadOptions read_option;
+  if (snapshot != nullptr) {
+    read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+  }
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), keys.size(), key_slices.data(), pinnable_values.data(),
+                    statuses.data(), true);
+
+  values.resize(keys.size());
+  founds.resize(keys.size(), false);
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      values[indexes[i]].assign(pinnable_values[i].data(), pinnable_values[i].size());
+      founds[indexes[i]] = true;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] multi get key failed, error: {}", s.ToString());
+      values.clear();
+      founds.clear();
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
@@ -579,6 +654,38 @@ butil::Status Writer::KvBatchPutAndDelete(
   return butil::Status::OK();
 }
 
+butil::Status Writer::KvBatchWrite(const RawEngine::WriteBatch& batch) {
+  if (BAIDU_UNLIKELY(batch.Empty())) {
+    return butil::Status::OK();
+  }
+
+  rocksdb::WriteBatch write_batch;
+  for (const auto& op : batch.Ops()) {
+    if (BAIDU_UNLIKELY(op.key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    auto column_family = GetColumnFamily(op.cf_name);
+    rocksdb::Status s = op.is_delete ? write_batch.Delete(column_family->GetHandle(), op.key)
+                                   : write_batch.Put(column_family->GetHandle(), op.key, op.value);
+    if (BAIDU_UNLIKELY(!s.ok())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] batch {} failed, error: {}", op.is_delete ? "delete" : "put",
+                                      s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal batch write error");
+    }
+  }
+
+  rocksdb::WriteOptions write_options;
+  rocksdb::Status s = GetDB()->Write(write_options, &write_batch);
+  if (BAIDU_UNLIKELY(!s.ok())) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}", s.ToString());
+    return butil::Status(pb::error::EINTERNAL, fmt::format("rocksdb::DB::Write failed : {}", s.ToString()));
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& key) {
   if (BAIDU_UNLIKELY(key.empty())) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
@@ -753,19 +860,26 @@ bool CastValue(std::string value, std::string& dst_value) {
 }
 
 // set cf config
-static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(rocks::ColumnFamilyPtr column_family) {
+static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(rocks::ColumnFamilyPtr column_family,
+                                                                  rocks::SharedBlockCache& shared_block_cache) {
   rocksdb::ColumnFamilyOptions family_options;
   rocksdb::BlockBasedTableOptions table_options;
 
   // block_size
   CastValue(column_family->GetConfItem(Constant::kBlockSize), table_options.block_size);
 
-  // block_cache
+  // block_cache, prefer store-wide shared cache, wrap for per column family hit/miss
   {
-    size_t option_value = 0;
-    CastValue(column_family->GetConfItem(Constant::kBlockCache), option_value);
+    auto block_cache = shared_block_cache.GetCache();
+    if (block_cache == nullptr) {
+      size_t option_value = 0;
+      CastValue(column_family->GetConfItem(Constant::kBlockCache), option_value);
+
+      block_cache = rocksdb::NewLRUCache(option_value);  // LRUcache
+    }
 
-    table_options.block_cache = rocksdb::NewLRUCache(option_value);  // LRUcache
+    table_options.block_cache = std::make_shared<rocks::ColumnFamilyBlockCache>(
+        block_cache, shared_block_cache.GetMetricsPrefix(), column_family->Name());
   }
 
   // arena_block_size
@@ -815,15 +929,27 @@ static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(rocks::ColumnF
   rocksdb::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   family_options.table_factory.reset(table_factory);
 
+  // Sample key distribution, avoid split check scan region.
+  if (FLAGS_rocks_enable_range_properties) {
+    family_options.table_properties_collector_factories.push_back(
+        std::make_shared<rocks::RangePropertiesCollectorFactory>(FLAGS_rocks_range_properties_sample_size,
+                                                                 FLAGS_rocks_range_properties_sample_keys));
+  }
+
   return family_options;
 }
 
-static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& column_families) {
+static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& column_families,
+                           std::shared_ptr<rocksdb::CompactionFilterFactory> txn_write_gc_filter_factory,
+                           rocks::SharedBlockCache& shared_block_cache) {
   // Cast ColumnFamily to rocksdb::ColumnFamilyOptions
   std::vector<rocksdb::ColumnFamilyDescriptor> column_family_descs;
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
-    rocksdb::ColumnFamilyOptions family_options = GenRcoksDBColumnFamilyOptions(column_family);
+    rocksdb::ColumnFamilyOptions family_options = GenRcoksDBColumnFamilyOptions(column_family, shared_block_cache);
+    if (cf_name == Constant::kTxnWriteCF) {
+      family_options.compaction_filter_factory = txn_write_gc_filter_factory;
+    }
     column_family_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
@@ -833,6 +959,7 @@ static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& c
   db_options.max_background_jobs = ConfigHelper::GetRocksDBBackgroundThreadNum();
   db_options.max_subcompactions = db_options.max_background_jobs / 4 * 3;
   db_options.stats_dump_period_sec = ConfigHelper::GetRocksDBStatsDumpPeriodSec();
+  db_options.write_buffer_manager = shared_block_cache.GetWriteBufferManager();
   DINGO_LOG(INFO) << fmt::format("[rocksdb] config max_background_jobs({}) max_subcompactions({})",
                                  db_options.max_background_jobs, db_options.max_subcompactions);
 
@@ -874,7 +1001,14 @@ bool RocksRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   auto column_families = GenColumnFamilyByDefaultConfig(cf_names);
   SetColumnFamilyCustomConfig(config, column_families);
 
-  rocksdb::DB* db = InitDB(db_path_, column_families);
+  // bvar of every engine is distinguished by db path, there maybe more than one engine in process(e.g. unit test).
+  if (!shared_block_cache_.Init(config, fmt::format("dingo_rocksdb_{}", db_path_))) {
+    DINGO_LOG(ERROR) << "[rocksdb] init shared block cache failed.";
+    return false;
+  }
+
+  txn_write_gc_filter_factory_ = std::make_shared<rocks::TxnWriteGcCompactionFilterFactory>();
+  rocksdb::DB* db = InitDB(db_path_, column_families, txn_write_gc_filter_factory_, shared_block_cache_);
   if (db == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] open failed, path: {}", db_path_);
     return false;
@@ -882,6 +1016,11 @@ bool RocksRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   column_families_ = column_families;
   db_.reset(db);
 
+  auto it = column_families_.find(Constant::kTxnDataCF);
+  if (it != column_families_.end()) {
+    txn_write_gc_filter_factory_->SetDataColumnFamily(db_, it->second->GetHandle());
+  }
+
   reader_ = std::make_shared<rocks::Reader>(GetSelfPtr());
   writer_ = std::make_shared<rocks::Writer>(GetSelfPtr());
 
@@ -1136,4 +1275,34 @@ std::vector<int64_t> RocksRawEngine::GetApproximateSizes(const std::string& cf_n
   return result;
 }
 
+void RocksRawEngine::SetGcSafePoint(std::shared_ptr<GCSafePoint> gc_safe_point) {
+  txn_write_gc_filter_factory_->SetGcSafePoint(gc_safe_point);
+}
+
+butil::Status RocksRawEngine::GetRangeProperties(const std::string& cf_name, const pb::common::Range& range,
+                                                RangeProperties& properties) {
+  auto column_family = GetColumnFamily(cf_name);
+
+  rocksdb::Range inner_range(range.start_key(), range.end_key());
+  rocksdb::TablePropertiesCollection tables;
+  rocksdb::Status s = db_->GetPropertiesOfTablesInRange(column_family->GetHandle(), &inner_range, 1, &tables);
+  if (!s.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] get properties of tables failed, error: {}", s.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Internal get properties of tables error.");
+  }
+
+  // Sst generated before enable range properties.
+  if (!rocks::MergeRangeProperties(tables, range.start_key(), range.end_key(), properties.samples)) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Some sst lack range properties.");
+  }
+
+  uint64_t memtable_keys = 0;
+  uint64_t memtable_size = 0;
+  db_->GetApproximateMemTableStats(column_family->GetHandle(), inner_range, &memtable_keys, &memtable_size);
+  properties.memtable_keys = memtable_keys;
+  properties.memtable_size = memtable_size;
+
+  return butil::Status();
+}
+
 }  // namespace dingodb
@@ -27,6 +27,8 @@
 #include "config/config.h"
 #include "engine/iterator.h"
 #include "engine/raw_engine.h"
+#include "engine/rocks_block_cache.h"
+#include "engine/rocks_gc_compaction_filter.h"
 #include "engine/snapshot.h"
 #include "proto/common.pb.h"
 #include "proto/store_internal.pb.h"
@@ -185,6 +187,12 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& founds) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& founds) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -209,6 +217,9 @@ class Reader : public RawEngine::Reader {
 
   butil::Status KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value);
+  butil::Status KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& founds);
   butil::Status KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                        const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs);
@@ -233,6 +244,8 @@ class Writer : public RawEngine::Writer {
   butil::Status KvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
                                     const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
 
+  butil::Status KvBatchWrite(const RawEngine::WriteBatch& batch) override;
+
   butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) override;
   butil::Status KvBatchDeleteRange(
       const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) override;
@@ -287,6 +300,11 @@ class RocksRawEngine : public RawEngine {
 
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
 
+  butil::Status GetRangeProperties(const std::string& cf_name, const pb::common::Range& range,
+                                   RangeProperties& properties) override;
+
+  void SetGcSafePoint(std::shared_ptr<GCSafePoint> gc_safe_point) override;
+
  private:
   friend rocks::Reader;
   friend rocks::Writer;
@@ -304,6 +322,12 @@ class RocksRawEngine : public RawEngine {
 
   RawEngine::ReaderPtr reader_;
   RawEngine::WriterPtr writer_;
+
+  // Mvcc gc of txn write column family on compaction.
+  std::shared_ptr<rocks::TxnWriteGcCompactionFilterFactory> txn_write_gc_filter_factory_;
+
+  // Block cache and memtable budget shared by all column families.
+  rocks::SharedBlockCache shared_block_cache_;
 };
 
 }  // namespace dingodb
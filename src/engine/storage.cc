@@ -89,21 +89,10 @@ butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std
   if (reader == nullptr) {
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "reader is nullptr");
   }
-  for (const auto& key : keys) {
-    std::string value;
-    auto status = reader->KvGet(ctx, key, value);
-    if (!status.ok()) {
-      if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
-        continue;
-      }
-      kvs.clear();
-      return status;
-    }
-
-    pb::common::KeyValue kv;
-    kv.set_key(key);
-    kv.set_value(value);
-    kvs.emplace_back(kv);
+  status = reader->KvBatchGet(ctx, keys, kvs);
+  if (!status.ok()) {
+    kvs.clear();
+    return status;
   }
 
   return butil::Status();
@@ -472,7 +461,7 @@ butil::Status Storage::VectorCalcDistance(const ::dingodb::pb::index::VectorCalc
 butil::Status Storage::VectorBatchSearchDebug(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                               std::vector<pb::index::VectorWithDistanceResult>& results,
                                               int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
-                                              int64_t& search_time_us) {
+                                              int64_t& search_time_us, std::string& filter_strategy) {
   auto status = ValidateLeader(ctx->region_id);
   if (!status.ok()) {
     return status;
@@ -480,7 +469,7 @@ butil::Status Storage::VectorBatchSearchDebug(std::shared_ptr<Engine::VectorRead
 
   auto vector_reader = engine_->NewVectorReader(ctx->raw_engine_type);
   status = vector_reader->VectorBatchSearchDebug(ctx, results, deserialization_id_time_us, scan_scalar_time_us,
-                                                 search_time_us);
+                                                 search_time_us, filter_strategy);
   if (!status.ok()) {
     if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
       // return OK if not found
@@ -138,7 +138,7 @@ class Storage {
   butil::Status VectorBatchSearchDebug(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                        std::vector<pb::index::VectorWithDistanceResult>& results,
                                        int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
-                                       int64_t& search_time_us);
+                                       int64_t& search_time_us, std::string& filter_strategy);
 
   butil::Status ValidateLeader(int64_t region_id);
   bool IsLeader(int64_t region_id);
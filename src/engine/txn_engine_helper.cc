@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -36,11 +37,16 @@
 #include "server/server.h"
 #include "vector/codec.h"
 
+DECLARE_bool(enable_txn_gc_compaction_filter);
+
 namespace dingodb {
 
 DEFINE_int64(max_short_value_in_write_cf, 1024, "max short value in write cf");
 DEFINE_int64(max_batch_get_count, 1024, "max batch get count");
 DEFINE_int64(max_batch_get_memory_size, 32 * 1024 * 1024, "max batch get memory size");
+// Kill switch of the sorted batch get pass, false fall back to seek write cf for every key in request order.
+DEFINE_bool(txn_batch_get_sorted, true, "txn batch get read write cf in key order with one forward iterator");
+DEFINE_int32(txn_batch_get_next_before_seek, 8, "txn batch get max next step before fallback to seek");
 DEFINE_int64(max_scan_memory_size, 32 * 1024 * 1024, "max scan memory size");
 DEFINE_int64(max_scan_line_limit, 2048, "max scan line limit");
 DEFINE_int64(max_scan_lock_limit, 2048, "Max scan lock limit");
@@ -115,8 +121,8 @@ butil::Status TxnIterator::Seek(const std::string &key) {
     if (!value_.empty()) {
       return butil::Status::OK();
     } else {
-      DINGO_LOG(INFO) << "[txn]InnerNext value is empty, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
-                      << ", key_: " << key_;
+      DINGO_LOG(DEBUG) << "[txn]InnerNext value is empty, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
+                       << ", key_: " << key_;
       continue;
     }
   }
@@ -139,8 +145,8 @@ butil::Status TxnIterator::InnerSeek(const std::string &key) {
                        << ", start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_;
     }
   } else {
-    DINGO_LOG(INFO) << "[txn]Scan lock_iter is invalid, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
-                    << ", last_lock_key: " << Helper::StringToHex(last_lock_key_);
+    DINGO_LOG(DEBUG) << "[txn]Scan lock_iter is invalid, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
+                     << ", last_lock_key: " << Helper::StringToHex(last_lock_key_);
   }
 
   write_iter_->Seek(Helper::EncodeTxnKey(key, seek_ts_));
@@ -152,21 +158,21 @@ butil::Status TxnIterator::InnerSeek(const std::string &key) {
                        << ", start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_;
     }
   } else {
-    DINGO_LOG(INFO) << "[txn]Scan write_iter is invalid, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
-                    << ", last_write_key: " << Helper::StringToHex(last_write_key_);
+    DINGO_LOG(DEBUG) << "[txn]Scan write_iter is invalid, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
+                     << ", last_write_key: " << Helper::StringToHex(last_write_key_);
   }
 
   if (last_lock_key_.empty() && last_write_key_.empty()) {
-    DINGO_LOG(INFO) << "[txn]Scan last_lock_key_ and last_write_key_ are empty, start_ts: " << start_ts_
-                    << ", seek_ts: " << seek_ts_ << ", key: " << Helper::StringToHex(key);
+    DINGO_LOG(DEBUG) << "[txn]Scan last_lock_key_ and last_write_key_ are empty, start_ts: " << start_ts_
+                     << ", seek_ts: " << seek_ts_ << ", key: " << Helper::StringToHex(key);
     return butil::Status::OK();
   }
 
   auto ret = GetCurrentValue();
   if (ret.ok()) {
-    DINGO_LOG(INFO) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_)
-                    << ", value_: " << Helper::StringToHex(value_) << ", start_ts: " << start_ts_
-                    << ", seek_ts: " << seek_ts_;
+    DINGO_LOG(DEBUG) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_)
+                     << ", value_: " << Helper::StringToHex(value_) << ", start_ts: " << start_ts_
+                     << ", seek_ts: " << seek_ts_;
     return butil::Status::OK();
   } else {
     DINGO_LOG(ERROR) << "[txn]GetCurrentValue failed, errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
@@ -180,15 +186,15 @@ butil::Status TxnIterator::Next() {
   while (ret.ok()) {
     ret = InnerNext();
     if (!ret.ok()) {
-      DINGO_LOG(INFO) << "[txn]InnerNext stopped, errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
+      DINGO_LOG(DEBUG) << "[txn]InnerNext stopped, errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
       return ret;
     }
 
     if (!value_.empty()) {
       return butil::Status::OK();
     } else {
-      DINGO_LOG(INFO) << "[txn]InnerNext value is empty, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
-                      << ", key_: " << Helper::StringToHex(key_);
+      DINGO_LOG(DEBUG) << "[txn]InnerNext value is empty, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
+                       << ", key_: " << Helper::StringToHex(key_);
       continue;
     }
   }
@@ -222,15 +228,15 @@ butil::Status TxnIterator::InnerNext() {
                            << ", seek_ts: " << seek_ts_;
         }
         if (last_lock_key_ > key_) {
-          DINGO_LOG(INFO) << "[txn]Scan last_lock_key_ > key_, find next key, start_ts: " << start_ts_
-                          << ", seek_ts: " << seek_ts_ << ", last_lock_key: " << Helper::StringToHex(last_lock_key_)
-                          << ", key_: " << Helper::StringToHex(key_);
+          DINGO_LOG(DEBUG) << "[txn]Scan last_lock_key_ > key_, find next key, start_ts: " << start_ts_
+                           << ", seek_ts: " << seek_ts_ << ", last_lock_key: " << Helper::StringToHex(last_lock_key_)
+                           << ", key_: " << Helper::StringToHex(key_);
           break;
         }
       } else {
-        DINGO_LOG(INFO) << "[txn]Scan lock_iter is invalid, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
-                        << ", last_lock_key: " << Helper::StringToHex(last_lock_key_)
-                        << ", will set last_lock_key to empty";
+        DINGO_LOG(DEBUG) << "[txn]Scan lock_iter is invalid, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_
+                         << ", last_lock_key: " << Helper::StringToHex(last_lock_key_)
+                         << ", will set last_lock_key to empty";
         last_lock_key_ = std::string();
       }
     }
@@ -256,26 +262,26 @@ butil::Status TxnIterator::InnerNext() {
   // }
 
   if (last_lock_key_.empty() && last_write_key_.empty()) {
-    DINGO_LOG(INFO) << "[txn]Scan last_lock_key_ and last_write_key_ are empty, start_ts: " << start_ts_
-                    << ", seek_ts: " << seek_ts_ << ", key_: " << Helper::StringToHex(key_);
+    DINGO_LOG(DEBUG) << "[txn]Scan last_lock_key_ and last_write_key_ are empty, start_ts: " << start_ts_
+                     << ", seek_ts: " << seek_ts_ << ", key_: " << Helper::StringToHex(key_);
     return butil::Status::OK();
   }
 
   if (last_lock_key_ <= key_ && last_write_key_ <= key_) {
-    DINGO_LOG(INFO) << "[txn]Scan last_lock_key_ <= key_ && last_write_key_ <= key_, no key found, start_ts: "
-                    << start_ts_ << ", seek_ts: " << seek_ts_
-                    << ", last_lock_key: " << Helper::StringToHex(last_lock_key_)
-                    << ", last_write_key: " << Helper::StringToHex(last_write_key_)
-                    << ", key_: " << Helper::StringToHex(key_);
+    DINGO_LOG(DEBUG) << "[txn]Scan last_lock_key_ <= key_ && last_write_key_ <= key_, no key found, start_ts: "
+                     << start_ts_ << ", seek_ts: " << seek_ts_
+                     << ", last_lock_key: " << Helper::StringToHex(last_lock_key_)
+                     << ", last_write_key: " << Helper::StringToHex(last_write_key_)
+                     << ", key_: " << Helper::StringToHex(key_);
     key_.clear();
     return butil::Status::OK();
   }
 
   auto ret = GetCurrentValue();
   if (ret.ok()) {
-    DINGO_LOG(INFO) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_)
-                    << ", value_: " << Helper::StringToHex(value_) << ", start_ts: " << start_ts_
-                    << ", seek_ts: " << seek_ts_;
+    DINGO_LOG(DEBUG) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_)
+                     << ", value_: " << Helper::StringToHex(value_) << ", start_ts: " << start_ts_
+                     << ", seek_ts: " << seek_ts_;
     return butil::Status::OK();
   } else {
     DINGO_LOG(ERROR) << "[txn]GetCurrentValue failed, errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
@@ -332,24 +338,24 @@ butil::Status TxnIterator::GetUserValueInWriteIter(std::shared_ptr<Iterator> wri
     }
 
     if (last_write_key > user_key) {
-      DINGO_LOG(INFO) << "[txn]Scan last_write_key > user_key, means no value, start_ts: " << start_ts
-                      << ", seek_ts: " << seek_ts << ", last_write_key: " << Helper::StringToHex(last_write_key)
-                      << ", user_key: " << Helper::StringToHex(user_key);
+      DINGO_LOG(DEBUG) << "[txn]Scan last_write_key > user_key, means no value, start_ts: " << start_ts
+                       << ", seek_ts: " << seek_ts << ", last_write_key: " << Helper::StringToHex(last_write_key)
+                       << ", user_key: " << Helper::StringToHex(user_key);
       return butil::Status::OK();
     }
 
     // check isolation_level
     if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
       if (commit_ts > start_ts) {
-        DINGO_LOG(INFO)
+        DINGO_LOG(DEBUG)
             << "[txn]Scan commit_ts > start_ts, means this value is not accepted, will go to next, start_ts: "
             << start_ts << ", commit_ts: " << commit_ts << ", user_key: " << Helper::StringToHex(user_key);
         write_iter->Next();
         continue;
       }
     } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-      DINGO_LOG(INFO) << "[txn]Scan RC, commit_ts: " << commit_ts << ", start_ts: " << start_ts
-                      << ", seek_ts: " << seek_ts << ", user_key: " << Helper::StringToHex(user_key);
+      DINGO_LOG(DEBUG) << "[txn]Scan RC, commit_ts: " << commit_ts << ", start_ts: " << start_ts
+                       << ", seek_ts: " << seek_ts << ", user_key: " << Helper::StringToHex(user_key);
     } else {
       DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
       return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
@@ -580,7 +586,7 @@ butil::Status TxnEngineHelper::GetLockInfo(RawEngine::ReaderPtr reader, const st
   // else the key is locked, return WriteConflict
   if (status.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
     // key is not exists, the key is not locked
-    DINGO_LOG(INFO) << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is not locked, lock_key is not exist";
+    DINGO_LOG(DEBUG) << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is not locked, lock_key is not exist";
     return butil::Status::OK();
   }
 
@@ -593,7 +599,7 @@ butil::Status TxnEngineHelper::GetLockInfo(RawEngine::ReaderPtr reader, const st
 
   if (lock_value.empty()) {
     // lock_value is empty, the key is not locked
-    DINGO_LOG(INFO) << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is not locked, lock_value is null";
+    DINGO_LOG(DEBUG) << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is not locked, lock_value is null";
     return butil::Status::OK();
   }
 
@@ -646,10 +652,10 @@ butil::Status TxnEngineHelper::ScanLockInfo(RawEnginePtr engine, int64_t min_loc
                                       << ", lock_value(hex): " << Helper::StringToHex(lock_value);
     }
 
-    DINGO_LOG(INFO) << "get lock_info lock_ts: " << lock_info.lock_ts()
-                    << ", lock_info: " << lock_info.ShortDebugString()
-                    << ", iter->key: " << Helper::StringToHex(iter->Key())
-                    << ", lock_key: " << Helper::StringToHex(lock_info.key());
+    DINGO_LOG(DEBUG) << "get lock_info lock_ts: " << lock_info.lock_ts()
+                     << ", lock_info: " << lock_info.ShortDebugString()
+                     << ", iter->key: " << Helper::StringToHex(iter->Key())
+                     << ", lock_key: " << Helper::StringToHex(lock_info.key());
 
     // if lock is not exist, nothing to do
     if (lock_info.lock_ts() == 0) {
@@ -670,7 +676,7 @@ butil::Status TxnEngineHelper::ScanLockInfo(RawEnginePtr engine, int64_t min_loc
     }
 
     lock_infos.push_back(lock_info);
-    DINGO_LOG(INFO) << "[txn] ScanLock push_back lock_info: " << lock_info.ShortDebugString();
+    DINGO_LOG(DEBUG) << "[txn] ScanLock push_back lock_info: " << lock_info.ShortDebugString();
 
     if (limit > 0 && lock_infos.size() >= limit) {
       break;
@@ -686,14 +692,14 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
                                         int64_t start_ts, const std::vector<std::string> &keys,
                                         std::vector<pb::common::KeyValue> &kvs,
                                         pb::store::TxnResultInfo &txn_result_info) {
-  DINGO_LOG(INFO) << "[txn]BatchGet keys_count: " << keys.size() << ", isolation_level: " << isolation_level
-                  << ", start_ts: " << start_ts << ", first_key: " << Helper::StringToHex(keys[0])
-                  << ", last_key: " << Helper::StringToHex(keys[keys.size() - 1]);
-
   if (keys.empty()) {
     return butil::Status::OK();
   }
 
+  DINGO_LOG(DEBUG) << "[txn]BatchGet keys_count: " << keys.size() << ", isolation_level: " << isolation_level
+                   << ", start_ts: " << start_ts << ", first_key: " << Helper::StringToHex(keys[0])
+                   << ", last_key: " << Helper::StringToHex(keys[keys.size() - 1]);
+
   if (engine == nullptr) {
     DINGO_LOG(FATAL) << "[txn]BatchGet engine is null";
   }
@@ -718,122 +724,160 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
   }
 
   auto reader = engine->Reader();
+  auto snapshot = engine->GetSnapshot();
+  if (snapshot == nullptr) {
+    DINGO_LOG(ERROR) << "[txn]BatchGet GetSnapshot failed";
+    return butil::Status(pb::error::Errno::EINTERNAL, "get snapshot failed");
+  }
 
-  int64_t response_memory_size = 0;
-
-  // for every key in keys, get lock info, if lock_ts < start_ts, return LockInfo
-  // else find the latest write below our start_ts
-  // then read data from data_cf
+  // get lock info of all keys in one batch, if lock_ts < start_ts, return LockInfo
+  std::vector<std::string> lock_keys;
+  lock_keys.reserve(keys.size());
   for (const auto &key : keys) {
-    pb::common::KeyValue kv;
-    kv.set_key(key);
+    lock_keys.push_back(Helper::EncodeTxnKey(key, Constant::kLockVer));
+  }
+
+  std::vector<std::string> lock_values;
+  std::vector<bool> lock_founds;
+  auto ret = reader->KvMultiGet(Constant::kTxnLockCF, snapshot, lock_keys, lock_values, lock_founds);
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << "[txn]BatchGet read lock failed, keys_count: " << keys.size()
+                     << ", status: " << ret.error_str();
+    return ret;
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!lock_founds[i] || lock_values[i].empty()) {
+      continue;
+    }
 
     pb::store::LockInfo lock_info;
-    auto ret = GetLockInfo(reader, key, lock_info);
-    if (!ret.ok()) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet GetLockInfo failed, key: " << Helper::StringToHex(key)
-                       << ", status: " << ret.error_str();
+    if (!lock_info.ParseFromString(lock_values[i])) {
+      DINGO_LOG(FATAL) << "[txn]BatchGet parse lock info failed, lock_key: " << Helper::StringToHex(keys[i])
+                       << ", lock_value: " << Helper::StringToHex(lock_values[i]);
     }
 
     auto is_lock_conflict = CheckLockConflict(lock_info, isolation_level, start_ts, txn_result_info);
     if (is_lock_conflict) {
-      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(key)
+      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(keys[i])
                          << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts
                          << ", lock_info: " << lock_info.ShortDebugString();
       return butil::Status::OK();
     }
+  }
 
-    int64_t iter_start_ts;
-    bool is_valid = false;
-    if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
-      iter_start_ts = start_ts;
-    } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-      iter_start_ts = Constant::kMaxVer;
-    } else {
-      DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
-      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
-    }
+  int64_t iter_start_ts =
+      isolation_level == pb::store::IsolationLevel::SnapshotIsolation ? start_ts : Constant::kMaxVer;
 
-    DINGO_LOG(INFO) << "key: " << Helper::StringToHex(key) << ", iter_start_ts: " << iter_start_ts;
+  // Visit keys in order, so the write cf iterator only move forward, the near key is reached by Next()
+  // instead of a new Seek().
+  std::vector<size_t> indexes(keys.size());
+  std::iota(indexes.begin(), indexes.end(), 0);
+  if (FLAGS_txn_batch_get_sorted) {
+    std::sort(indexes.begin(), indexes.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+  }
 
-    IteratorOptions iter_options;
-    iter_options.lower_bound = Helper::EncodeTxnKey(key, iter_start_ts);
-    iter_options.upper_bound = Helper::EncodeTxnKey(key, 0);
-    auto iter = reader->NewIterator(Constant::kTxnWriteCF, iter_options);
-    if (iter == nullptr) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet NewIterator failed, start_ts: " << start_ts;
-    }
+  // find the latest write below our start_ts with one write cf iterator,
+  // the values not inlined in write_info are collected and read from data_cf in one batch.
+  IteratorOptions iter_options;
+  if (FLAGS_txn_batch_get_sorted) {
+    iter_options.lower_bound = Helper::EncodeTxnKey(keys[indexes.front()], Constant::kMaxVer);
+    iter_options.upper_bound = Helper::EncodeTxnKey(keys[indexes.back()], 0);
+  }
+  auto iter = reader->NewIterator(Constant::kTxnWriteCF, snapshot, iter_options);
+  if (iter == nullptr) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet NewIterator failed, start_ts: " << start_ts;
+  }
 
-    DINGO_LOG(INFO) << "iter_options.lower_bound: " << Helper::StringToHex(iter_options.lower_bound)
-                    << ", iter_options.upper_bound: " << Helper::StringToHex(iter_options.upper_bound);
+  kvs.resize(keys.size());
+  std::vector<size_t> data_indexes;
+  std::vector<std::string> data_keys;
+  std::string write_key;
+  for (auto i : indexes) {
+    const auto &key = keys[i];
+    kvs[i].set_key(key);
+
+    std::string seek_key = Helper::EncodeTxnKey(key, iter_start_ts);
+    bool need_seek = true;
+    if (FLAGS_txn_batch_get_sorted && iter->Valid() && iter->Key() <= seek_key) {
+      for (int step = 0; step < FLAGS_txn_batch_get_next_before_seek && iter->Valid() && iter->Key() < seek_key;
+           ++step) {
+        iter->Next();
+      }
+      // Invalid means no more write after seek_key.
+      need_seek = iter->Valid() && iter->Key() < seek_key;
+    }
+    if (need_seek) {
+      iter->Seek(seek_key);
+    }
 
-    // check isolation level and return value
-    iter->Seek(iter_options.lower_bound);
-    while (iter->Valid()) {
-      if (iter->Key().length() <= 8) {
-        DINGO_LOG(ERROR) << ", invalid write_key, key: " << Helper::StringToHex(iter->Key())
-                         << ", start_ts: " << start_ts
-                         << ", write_key is less than 8 bytes: " << Helper::StringToHex(iter->Key());
+    for (; iter->Valid(); iter->Next()) {
+      int64_t write_ts;
+      auto ret1 = Helper::DecodeTxnKey(iter->Key(), write_key, write_ts);
+      if (!ret1.ok()) {
+        DINGO_LOG(ERROR) << "[txn]BatchGet invalid write_key, key: " << Helper::StringToHex(iter->Key())
+                         << ", start_ts: " << start_ts << ", status: " << ret1.error_str();
         return butil::Status(pb::error::Errno::EINTERNAL, "invalid write_key");
       }
-      std::string write_key;
-      int64_t write_ts;
-      Helper::DecodeTxnKey(iter->Key(), write_key, write_ts);
 
-      bool is_valid = false;
-      if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
-        if (write_ts <= start_ts) {
-          is_valid = true;
-        }
-      } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-        is_valid = true;
-      } else {
-        DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
-        return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+      if (write_key != key) {
+        break;
       }
 
-      if (is_valid) {
-        // write_ts <= start_ts, return write_info
-        pb::store::WriteInfo write_info;
-        auto ret = write_info.ParseFromArray(iter->Value().data(), iter->Value().size());
-        if (!ret) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet parse write info failed, key: " << Helper::StringToHex(key)
-                           << ", write_key: " << Helper::StringToHex(iter->Key())
-                           << ", write_value(hex): " << Helper::StringToHex(iter->Value());
-        }
+      pb::store::WriteInfo write_info;
+      if (!write_info.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+        DINGO_LOG(FATAL) << "[txn]BatchGet parse write info failed, key: " << Helper::StringToHex(key)
+                         << ", write_key: " << Helper::StringToHex(iter->Key())
+                         << ", write_value(hex): " << Helper::StringToHex(iter->Value());
+      }
 
-        if (!write_info.short_value().empty()) {
-          kv.set_value(write_info.short_value());
-          break;
-        }
+      if (write_info.op() == pb::store::Op::Rollback) {
+        continue;
+      }
 
-        auto ret1 =
-            reader->KvGet(Constant::kTxnDataCF, Helper::EncodeTxnKey(key, write_info.start_ts()), *kv.mutable_value());
-        if (!ret1.ok() && ret1.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, key: " << Helper::StringToHex(key)
-                           << ", status: " << ret1.error_str();
-        } else if (ret1.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
-                           << Helper::StringToHex(key) << ", status: " << ret1.error_str()
-                           << ", raw_key: " << Helper::EncodeTxnKey(key, write_info.start_ts());
+      if (write_info.op() == pb::store::Op::Put) {
+        // Short value is inlined in write_info, no need read data cf.
+        if (!write_info.short_value().empty()) {
+          kvs[i].set_value(std::move(*write_info.mutable_short_value()));
+        } else {
+          data_indexes.push_back(i);
+          data_keys.push_back(Helper::EncodeTxnKey(key, write_info.start_ts()));
         }
-        break;
-      } else {
-        DINGO_LOG(ERROR) << "[txn]BatchGet write_ts: " << write_ts << " >= start_ts: " << start_ts
-                         << ", key: " << Helper::StringToHex(key)
-                         << ", write_key: " << Helper::StringToHex(iter->Key());
       }
 
-      iter->Next();
+      // op is Put or Delete, the latest visible version is found.
+      break;
     }
+  }
 
-    kvs.emplace_back(kv);
-    response_memory_size += kv.ByteSizeLong();
+  if (!data_keys.empty()) {
+    std::vector<std::string> data_values;
+    std::vector<bool> data_founds;
+    auto ret2 = reader->KvMultiGet(Constant::kTxnDataCF, snapshot, data_keys, data_values, data_founds);
+    if (!ret2.ok()) {
+      DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, data_keys_count: " << data_keys.size()
+                       << ", status: " << ret2.error_str();
+    }
 
+    for (size_t j = 0; j < data_keys.size(); ++j) {
+      if (!data_founds[j]) {
+        DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
+                         << Helper::StringToHex(keys[data_indexes[j]])
+                         << ", raw_key: " << Helper::StringToHex(data_keys[j]);
+        continue;
+      }
+      kvs[data_indexes[j]].set_value(std::move(data_values[j]));
+    }
+  }
+
+  int64_t response_memory_size = 0;
+  for (size_t i = 0; i < kvs.size(); ++i) {
+    response_memory_size += kvs[i].ByteSizeLong();
     if (response_memory_size >= FLAGS_max_batch_get_memory_size) {
-      DINGO_LOG(INFO) << "[txn]BatchGet kvs.size: " << kvs.size() << ", response_memory_size: " << response_memory_size
+      DINGO_LOG(INFO) << "[txn]BatchGet kvs.size: " << i + 1 << ", response_memory_size: " << response_memory_size
                       << ", max_batch_get_count: " << FLAGS_max_batch_get_count
                       << ", max_batch_get_memory_size: " << FLAGS_max_batch_get_memory_size;
+      kvs.resize(i + 1);
       break;
     }
   }
@@ -845,10 +889,10 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
                                     int64_t start_ts, const pb::common::Range &range, int64_t limit, bool key_only,
                                     bool is_reverse, pb::store::TxnResultInfo &txn_result_info,
                                     std::vector<pb::common::KeyValue> &kvs, bool &has_more, std::string &end_key) {
-  DINGO_LOG(INFO) << "[txn]Scan start_ts: " << start_ts << ", range: " << range.ShortDebugString()
-                  << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts << ", limit: " << limit
-                  << ", key_only: " << key_only << ", is_reverse: " << is_reverse
-                  << ", txn_result_info: " << txn_result_info.ShortDebugString();
+  DINGO_LOG(DEBUG) << "[txn]Scan start_ts: " << start_ts << ", range: " << range.ShortDebugString()
+                   << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts << ", limit: " << limit
+                   << ", key_only: " << key_only << ", is_reverse: " << is_reverse
+                   << ", txn_result_info: " << txn_result_info.ShortDebugString();
 
   if (BAIDU_UNLIKELY(limit > FLAGS_max_scan_line_limit)) {
     DINGO_LOG(ERROR) << "[txn]Scan limit: " << limit
@@ -2869,6 +2913,8 @@ butil::Status TxnEngineHelper::DoGc(RawEnginePtr raw_engine, std::shared_ptr<Eng
   bool is_exist_put_or_delete_key_if_write_ts_gt_safe_point_ts = false;
   // this var is too long. this is important var. do not cut down it.
   bool is_first_put_key_if_write_ts_le_safe_point_ts = true;
+  // compaction filter mode, raft gc only clean up the version under delete tombstone.
+  bool is_under_delete_tombstone_if_write_ts_le_safe_point_ts = false;
 
   std::string write_key;
   std::string last_write_key;
@@ -2902,6 +2948,7 @@ butil::Status TxnEngineHelper::DoGc(RawEnginePtr raw_engine, std::shared_ptr<Eng
       is_exist_put_or_delete_key_if_write_ts_gt_safe_point_ts = false;
       last_write_key = write_key;
       is_first_put_key_if_write_ts_le_safe_point_ts = true;
+      is_under_delete_tombstone_if_write_ts_le_safe_point_ts = false;
     }
 
     // update lock_start_key
@@ -2938,6 +2985,11 @@ butil::Status TxnEngineHelper::DoGc(RawEnginePtr raw_engine, std::shared_ptr<Eng
             continue;
           }
         }
+        // old version is dropped by compaction filter.
+        if (FLAGS_enable_txn_gc_compaction_filter && !is_under_delete_tombstone_if_write_ts_le_safe_point_ts) {
+          write_iter->Next();
+          continue;
+        }
         kv_deletes_write.emplace_back(write_iter_key);
         if (write_info.short_value().empty()) {
           // try get key from data column family. if not exist , do not delete.
@@ -2976,11 +3028,16 @@ butil::Status TxnEngineHelper::DoGc(RawEnginePtr raw_engine, std::shared_ptr<Eng
             is_first_put_key_if_write_ts_le_safe_point_ts = false;
           }
         }
+        // the older version must be deleted with tombstone, otherwise it will be visible again.
+        is_under_delete_tombstone_if_write_ts_le_safe_point_ts = true;
         kv_deletes_write.emplace_back(write_iter_key);
         break;
       }
 
       case pb::store::Rollback: {
+        if (FLAGS_enable_txn_gc_compaction_filter && !is_under_delete_tombstone_if_write_ts_le_safe_point_ts) {
+          break;
+        }
         kv_deletes_write.emplace_back(write_iter_key);
         break;
       }
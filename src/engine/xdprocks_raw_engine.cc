@@ -26,6 +26,7 @@
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -342,6 +343,72 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& founds) {
+  return KvMultiGet(GetColumnFamily(cf_name), GetSnapshot(), keys, values, founds);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& founds) {
+  return KvMultiGet(GetColumnFamily(cf_name), snapshot, keys, values, founds);
+}
+
+butil::Status Reader::KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& founds) {
+  values.clear();
+  founds.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // MultiGet with sorted input can batch block reads of the same data block and skip the inner sort.
+  std::vector<size_t> indexes(keys.size());
+  std::iota(indexes.begin(), indexes.end(), 0);
+  std::sort(indexes.begin(), indexes.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+  std::vector<xdprocks::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (auto index : indexes) {
+    key_slices.emplace_back(keys[index]);
+  }
+
+  std::vector<xdprocks::PinnableSlice> pinnable_values(keys.size());
+  std::vector<xdprocks::Status> statuses(keys.size());
+
+  xdprocks::ReadOptions read_option;
+  if (snapshot != nullptr) {
+    read_option.snapshot = static_cast<const xdprocks::Snapshot*>(snapshot->Inner());
+  }
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), keys.size(), key_slices.data(), pinnable_values.data(),
+                    statuses.data(), true);
+
+  values.resize(keys.size());
+  founds.resize(keys.size(), false);
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      values[indexes[i]].assign(pinnable_values[i].data(), pinnable_values[i].size());
+      founds[indexes[i]] = true;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] multi get key failed, error: {}", s.ToString());
+      values.clear();
+      founds.clear();
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
@@ -579,6 +646,38 @@ butil::Status Writer::KvBatchPutAndDelete(
   return butil::Status::OK();
 }
 
+butil::Status Writer::KvBatchWrite(const RawEngine::WriteBatch& batch) {
+  if (BAIDU_UNLIKELY(batch.Empty())) {
+    return butil::Status::OK();
+  }
+
+  xdprocks::WriteBatch write_batch;
+  for (const auto& op : batch.Ops()) {
+    if (BAIDU_UNLIKELY(op.key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    auto column_family = GetColumnFamily(op.cf_name);
+    xdprocks::Status s = op.is_delete ? write_batch.Delete(column_family->GetHandle(), op.key)
+                                      : write_batch.Put(column_family->GetHandle(), op.key, op.value);
+    if (BAIDU_UNLIKELY(!s.ok())) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] batch {} failed, error: {}", op.is_delete ? "delete" : "put",
+                                      s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal batch write error");
+    }
+  }
+
+  xdprocks::WriteOptions write_options;
+  xdprocks::Status s = GetDB()->Write(write_options, &write_batch);
+  if (BAIDU_UNLIKELY(!s.ok())) {
+    DINGO_LOG(ERROR) << fmt::format("[xdprocks] write failed, error: {}", s.ToString());
+    return butil::Status(pb::error::EINTERNAL, fmt::format("xdprocks::DB::Write failed : {}", s.ToString()));
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& key) {
   if (BAIDU_UNLIKELY(key.empty())) {
     DINGO_LOG(ERROR) << fmt::format("[xdprocks] not support empty key.");
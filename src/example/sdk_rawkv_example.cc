@@ -15,10 +15,16 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "common/logging.h"
@@ -28,12 +34,15 @@
 #include "sdk/coordinator_proxy.h"
 #include "sdk/meta_cache.h"
 #include "sdk/status.h"
+#include "sdk/utils/async_util.h"
 
 using dingodb::sdk::MetaCache;
 using dingodb::sdk::Region;
 using dingodb::sdk::Status;
 
 DEFINE_string(coordinator_url, "", "coordinator url");
+DEFINE_int32(async_request_num, 10000, "request num of each op in async throughput example");
+DEFINE_int32(async_max_in_flight, 1000, "max in flight requests in async throughput example");
 
 // TODO: remove
 static std::shared_ptr<dingodb::CoordinatorInteraction> g_coordinator_interaction;
@@ -478,6 +487,81 @@ void RawKVExample() {
   }
 }
 
+// Keep up to async_max_in_flight requests in flight from this single thread, no thread per outstanding request.
+void RawKVAsyncThroughputExample() {
+  std::shared_ptr<dingodb::sdk::RawKV> raw_kv;
+  Status built = g_client->NewRawKV(raw_kv);
+  CHECK(built.IsOK()) << "dingo raw_kv build fail";
+  CHECK_NOTNULL(raw_kv.get());
+
+  int request_num = FLAGS_async_request_num;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  keys.reserve(request_num);
+  values.reserve(request_num);
+  for (int i = 0; i < request_num; i++) {
+    keys.push_back(fmt::format("wb{:08}", i));
+    values.push_back(fmt::format("value{:08}", i));
+  }
+
+  std::mutex lock;
+  std::condition_variable cv;
+  int in_flight = 0;
+
+  auto acquire = [&]() {
+    std::unique_lock<std::mutex> lk(lock);
+    while (in_flight >= FLAGS_async_max_in_flight) {
+      cv.wait(lk);
+    }
+    in_flight++;
+  };
+
+  auto release = [&]() {
+    std::unique_lock<std::mutex> lk(lock);
+    in_flight--;
+    cv.notify_one();
+  };
+
+  auto run = [&](const std::string& name, const std::function<void(int, dingodb::sdk::StatusCallback)>& op) {
+    std::atomic<int64_t> fail_count(0);
+    dingodb::sdk::CountDownLatch latch(request_num);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < request_num; i++) {
+      acquire();
+      op(i, [&](const Status& s) {
+        if (!s.IsOK()) {
+          fail_count.fetch_add(1);
+        }
+        release();
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+    auto elapsed_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    DINGO_LOG(INFO) << fmt::format("raw_kv async {} num:{} fail:{} max_in_flight:{} elapsed:{}ms qps:{:.0f}", name,
+                                   request_num, fail_count.load(), FLAGS_async_max_in_flight, elapsed_us / 1000,
+                                   request_num * 1000000.0 / std::max(elapsed_us, static_cast<int64_t>(1)));
+  };
+
+  run("put", [&](int i, dingodb::sdk::StatusCallback cb) { raw_kv->AsyncPut(keys[i], values[i], std::move(cb)); });
+
+  std::vector<std::string> get_values(request_num);
+  run("get", [&](int i, dingodb::sdk::StatusCallback cb) { raw_kv->AsyncGet(keys[i], get_values[i], std::move(cb)); });
+
+  int mismatch = 0;
+  for (int i = 0; i < request_num; i++) {
+    if (get_values[i] != values[i]) {
+      mismatch++;
+    }
+  }
+  DINGO_LOG(INFO) << "raw_kv async get mismatch:" << mismatch;
+
+  run("delete", [&](int i, dingodb::sdk::StatusCallback cb) { raw_kv->AsyncDelete(keys[i], std::move(cb)); });
+}
+
 int main(int argc, char* argv[]) {
   FLAGS_minloglevel = google::GLOG_INFO;
   FLAGS_logtostdout = true;
@@ -526,5 +610,7 @@ int main(int argc, char* argv[]) {
 
   RawKVExample();
 
+  RawKVAsyncThroughputExample();
+
   PostClean();
 }
\ No newline at end of file
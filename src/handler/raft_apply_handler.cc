@@ -14,6 +14,7 @@
 
 #include "handler/raft_apply_handler.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -22,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "braft/util.h"
 #include "bthread/bthread.h"
 #include "butil/status.h"
 #include "common/constant.h"
@@ -1045,6 +1047,10 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
 
   // Handle vector index
   auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (status.ok()) {
+    vector_index_wrapper->ScalarIndex()->Upsert(request.vectors());
+  }
+
   int64_t vector_index_id = vector_index_wrapper->Id();
   bool is_ready = vector_index_wrapper->IsReady();
   if (is_ready) {
@@ -1169,6 +1175,10 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
   }
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (status.ok() && !delete_ids.empty()) {
+    vector_index_wrapper->ScalarIndex()->Delete(delete_ids);
+  }
+
   int64_t vector_index_id = vector_index_wrapper->Id();
   bool is_ready = vector_index_wrapper->IsReady();
   if (is_ready && !delete_ids.empty()) {
@@ -1207,6 +1217,204 @@ int RebuildVectorIndexHandler::Handle(std::shared_ptr<Context>, store::RegionPtr
   return 0;
 }
 
+template <typename T>
+static bool IsAllKeyNotEmpty(const T &keys) {
+  return !keys.empty() && std::all_of(keys.begin(), keys.end(), [](const auto &key) { return !key.empty(); });
+}
+
+static bool IsAllKvKeyNotEmpty(const google::protobuf::RepeatedPtrField<pb::common::KeyValue> &kvs) {
+  return !kvs.empty() && std::all_of(kvs.begin(), kvs.end(), [](const auto &kv) { return !kv.key().empty(); });
+}
+
+bool ApplyLogBatch::IsBatchable(const pb::raft::RaftCmdRequest &raft_cmd) {
+  if (raft_cmd.requests().empty()) {
+    return false;
+  }
+
+  // Invalid request keep going the handler path, so the error is same as before.
+  for (const auto &req : raft_cmd.requests()) {
+    switch (req.cmd_type()) {
+      case pb::raft::CmdType::PUT:
+        if (!IsAllKvKeyNotEmpty(req.put().kvs())) {
+          return false;
+        }
+        break;
+      case pb::raft::CmdType::DELETEBATCH:
+        if (!IsAllKeyNotEmpty(req.delete_batch().keys())) {
+          return false;
+        }
+        break;
+      case pb::raft::CmdType::TXN: {
+        if (!req.txn_raft_req().has_multi_cf_put_and_delete()) {
+          return false;
+        }
+        const auto &request = req.txn_raft_req().multi_cf_put_and_delete();
+        if (request.vector_add().vectors_size() > 0 || request.vector_del().ids_size() > 0) {
+          return false;
+        }
+        for (const auto &puts : request.puts_with_cf()) {
+          if (!IsAllKvKeyNotEmpty(puts.kvs())) {
+            return false;
+          }
+        }
+        for (const auto &dels : request.deletes_with_cf()) {
+          if (!IsAllKeyNotEmpty(dels.keys())) {
+            return false;
+          }
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+void ApplyLogBatch::Add(google::protobuf::Closure *done, std::shared_ptr<Context> ctx,
+                        std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd, int64_t term_id, int64_t log_id) {
+  for (const auto &req : raft_cmd->requests()) {
+    switch (req.cmd_type()) {
+      case pb::raft::CmdType::PUT:
+        AddPut(req.put());
+        break;
+      case pb::raft::CmdType::DELETEBATCH:
+        AddDeleteBatch(ctx, req.delete_batch());
+        break;
+      case pb::raft::CmdType::TXN:
+        AddMultiCfPutAndDelete(req.txn_raft_req().multi_cf_put_and_delete(), term_id, log_id);
+        break;
+      default:
+        DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] not support batch cmd type {}, log {}:{}",
+                                        region_->Id(), pb::raft::CmdType_Name(req.cmd_type()), term_id, log_id);
+    }
+  }
+
+  logs_.push_back({term_id, log_id});
+  dones_.push_back(done);
+  ctxs_.push_back(ctx);
+}
+
+void ApplyLogBatch::AddPut(const pb::raft::PutRequest &request) {
+  auto &key_states = pending_key_states_[request.cf_name()];
+  for (const auto &kv : request.kvs()) {
+    write_batch_.Put(request.cf_name(), kv.key(), kv.value());
+    key_states[kv.key()] = true;
+  }
+
+  // Update region metrics min/max key
+  if (region_metrics_ != nullptr) {
+    region_metrics_->UpdateMaxAndMinKey(request.kvs());
+  }
+}
+
+void ApplyLogBatch::AddDeleteBatch(std::shared_ptr<Context> ctx, const pb::raft::DeleteBatchRequest &request) {
+  std::vector<bool> key_states(request.keys().size(), false);
+  for (int i = 0; i < request.keys().size(); ++i) {
+    key_states[i] = IsKeyExist(request.cf_name(), request.keys().at(i));
+  }
+
+  auto &pending_key_states = pending_key_states_[request.cf_name()];
+  for (const auto &key : request.keys()) {
+    write_batch_.Delete(request.cf_name(), key);
+    pending_key_states[key] = false;
+  }
+
+  if (ctx && ctx->Response()) {
+    auto *response = dynamic_cast<pb::store::KvBatchDeleteResponse *>(ctx->Response());
+    if (response != nullptr) {
+      for (const auto &state : key_states) {
+        response->add_key_states(state);
+      }
+    }
+  }
+
+  // Update region metrics min/max key policy
+  if (region_metrics_ != nullptr) {
+    region_metrics_->UpdateMaxAndMinKeyPolicy(request.keys());
+  }
+}
+
+void ApplyLogBatch::AddMultiCfPutAndDelete(const pb::raft::MultiCfPutAndDeleteRequest &request, int64_t term_id,
+                                           int64_t log_id) {
+  DINGO_LOG(DEBUG) << fmt::format("[txn][region({})] batch MultiCfPutAndDelete, term: {} apply_log_id: {}",
+                                  region_->Id(), term_id, log_id)
+                   << ", request: " << request.ShortDebugString();
+
+  // Same as TxnHandler, put first then delete.
+  for (const auto &puts : request.puts_with_cf()) {
+    auto &key_states = pending_key_states_[puts.cf_name()];
+    for (const auto &kv : puts.kvs()) {
+      write_batch_.Put(puts.cf_name(), kv.key(), kv.value());
+      key_states[kv.key()] = true;
+    }
+  }
+
+  for (const auto &dels : request.deletes_with_cf()) {
+    auto &key_states = pending_key_states_[dels.cf_name()];
+    for (const auto &key : dels.keys()) {
+      write_batch_.Delete(dels.cf_name(), key);
+      key_states[key] = false;
+    }
+  }
+}
+
+bool ApplyLogBatch::IsKeyExist(const std::string &cf_name, const std::string &key) {
+  auto cf_it = pending_key_states_.find(cf_name);
+  if (cf_it != pending_key_states_.end()) {
+    auto it = cf_it->second.find(key);
+    if (it != cf_it->second.end()) {
+      return it->second;
+    }
+  }
+
+  if (snapshot_ == nullptr) {
+    snapshot_ = engine_->GetSnapshot();
+  }
+
+  std::string value;
+  return engine_->Reader()->KvGet(cf_name, snapshot_, key, value).ok();
+}
+
+void ApplyLogBatch::Write() {
+  if (logs_.empty()) {
+    return;
+  }
+
+  auto status = engine_->Writer()->KvBatchWrite(write_batch_);
+  if (!status.ok()) {
+    DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] batch write failed, log {}:{}-{}:{} ops({}) error: {}",
+                                    region_->Id(), logs_.front().term_id, logs_.front().log_id, logs_.back().term_id,
+                                    logs_.back().log_id, write_batch_.Count(), status.error_str());
+  }
+
+  for (auto &ctx : ctxs_) {
+    if (ctx != nullptr) {
+      ctx->SetStatus(status);
+    }
+  }
+
+  DINGO_LOG(DEBUG) << fmt::format("[raft.apply][region({})] batch write log {}:{}-{}:{} count({}) ops({})",
+                                  region_->Id(), logs_.front().term_id, logs_.front().log_id, logs_.back().term_id,
+                                  logs_.back().log_id, logs_.size(), write_batch_.Count());
+}
+
+void ApplyLogBatch::Done() {
+  for (auto *done : dones_) {
+    if (done != nullptr) {
+      braft::run_closure_in_bthread(done);
+    }
+  }
+
+  dones_.clear();
+  ctxs_.clear();
+  logs_.clear();
+  write_batch_.Clear();
+  pending_key_states_.clear();
+  snapshot_ = nullptr;
+}
+
 std::shared_ptr<HandlerCollection> RaftApplyHandlerFactory::Build() {
   auto handler_collection = std::make_shared<HandlerCollection>();
   handler_collection->Register(std::make_shared<PutHandler>());
@@ -16,8 +16,12 @@
 #define DINGODB_HANDLER_RAFT_HANDLER_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "braft/raft.h"
 #include "butil/status.h"
 #include "common/context.h"
 #include "engine/raw_engine.h"
@@ -156,6 +160,59 @@ class TxnHandler : public BaseHandler {
                                           store::RegionMetricsPtr region_metrics, int64_t term_id, int64_t log_id);
 };
 
+// Coalesce consecutive write-only raft logs into one engine write batch.
+// Only PUT/DELETEBATCH and txn MultiCfPutAndDelete without vector index change are batchable,
+// the other command must be applied by the handler one by one.
+// Usage: Add() logs in order, Write() persist them at once, then Done() respond the closures.
+class ApplyLogBatch {
+ public:
+  struct Log {
+    int64_t term_id;
+    int64_t log_id;
+  };
+
+  ApplyLogBatch(store::RegionPtr region, std::shared_ptr<RawEngine> engine, store::RegionMetricsPtr region_metrics)
+      : region_(region), engine_(engine), region_metrics_(region_metrics) {}
+  ~ApplyLogBatch() = default;
+
+  static bool IsBatchable(const pb::raft::RaftCmdRequest &raft_cmd);
+
+  // Take the ownership of done.
+  void Add(google::protobuf::Closure *done, std::shared_ptr<Context> ctx,
+           std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd, int64_t term_id, int64_t log_id);
+
+  // Write all pending ops into engine, and set the result to context.
+  void Write();
+  // Run all closures in order and reset the batch.
+  void Done();
+
+  const std::vector<Log> &Logs() const { return logs_; }
+  size_t LogCount() const { return logs_.size(); }
+  bool Empty() const { return logs_.empty(); }
+
+ private:
+  void AddPut(const pb::raft::PutRequest &request);
+  void AddDeleteBatch(std::shared_ptr<Context> ctx, const pb::raft::DeleteBatchRequest &request);
+  void AddMultiCfPutAndDelete(const pb::raft::MultiCfPutAndDeleteRequest &request, int64_t term_id, int64_t log_id);
+
+  // Whether key is exist, consider the pending ops in the batch first.
+  bool IsKeyExist(const std::string &cf_name, const std::string &key);
+
+  store::RegionPtr region_;
+  std::shared_ptr<RawEngine> engine_;
+  store::RegionMetricsPtr region_metrics_;
+
+  RawEngine::WriteBatch write_batch_;
+  std::vector<Log> logs_;
+  std::vector<google::protobuf::Closure *> dones_;
+  std::vector<std::shared_ptr<Context>> ctxs_;
+
+  // cf_name -> key -> is_exist, the key state after applied the pending ops.
+  std::map<std::string, std::map<std::string, bool>> pending_key_states_;
+  // Snapshot before the pending ops, for check key state.
+  std::shared_ptr<Snapshot> snapshot_;
+};
+
 class RaftApplyHandlerFactory : public HandlerFactory {
  public:
   std::shared_ptr<HandlerCollection> Build() override;
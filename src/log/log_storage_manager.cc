@@ -14,23 +14,41 @@
 
 #include "log/log_storage_manager.h"
 
+#include <memory>
+#include <string>
 #include <utility>
 
 namespace dingodb {
 
-void LogStorageManager::AddLogStorage(int64_t region_id, std::shared_ptr<SegmentLogStorage> log_storage) {
+bool LogStorageManager::InitSharedLogEngine(const std::string& path, uint64_t max_file_size) {
+  auto shared_log_engine = std::make_shared<SharedLogEngine>(path, max_file_size);
+  if (!shared_log_engine->Init()) {
+    return false;
+  }
+
+  shared_log_engine_ = shared_log_engine;
+  return true;
+}
+
+void LogStorageManager::AddLogStorage(int64_t region_id, std::shared_ptr<RaftLogStorage> log_storage) {
   BAIDU_SCOPED_LOCK(mutex_);
 
   log_storages_.insert(std::make_pair(region_id, log_storage));
 }
 
 void LogStorageManager::DeleteStorage(int64_t region_id) {
-  BAIDU_SCOPED_LOCK(mutex_);
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    log_storages_.erase(region_id);
+  }
 
-  log_storages_.erase(region_id);
+  // Shared log is not deleted with storage object, drop region log explicitly.
+  if (shared_log_engine_ != nullptr) {
+    shared_log_engine_->RemoveRegion(region_id);
+  }
 }
 
-std::shared_ptr<SegmentLogStorage> LogStorageManager::GetLogStorage(int64_t region_id) {
+std::shared_ptr<RaftLogStorage> LogStorageManager::GetLogStorage(int64_t region_id) {
   BAIDU_SCOPED_LOCK(mutex_);
 
   auto it = log_storages_.find(region_id);
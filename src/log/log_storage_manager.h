@@ -18,8 +18,10 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <string>
 
-#include "log/segment_log_storage.h"
+#include "log/raft_log_storage.h"
+#include "log/shared_log_storage.h"
 
 namespace dingodb {
 
@@ -28,13 +30,19 @@ class LogStorageManager {
   LogStorageManager() { bthread_mutex_init(&mutex_, nullptr); }
   ~LogStorageManager() { bthread_mutex_destroy(&mutex_); }
 
-  void AddLogStorage(int64_t region_id, std::shared_ptr<SegmentLogStorage> log_storage);
+  // Init the shared raft log engine, all store region log write into it.
+  bool InitSharedLogEngine(const std::string& path, uint64_t max_file_size);
+  SharedLogEnginePtr GetSharedLogEngine() { return shared_log_engine_; }
+
+  void AddLogStorage(int64_t region_id, std::shared_ptr<RaftLogStorage> log_storage);
   void DeleteStorage(int64_t region_id);
-  std::shared_ptr<SegmentLogStorage> GetLogStorage(int64_t region_id);
+  std::shared_ptr<RaftLogStorage> GetLogStorage(int64_t region_id);
 
  private:
   bthread_mutex_t mutex_;
-  std::map<int64_t, std::shared_ptr<SegmentLogStorage>> log_storages_;
+  std::map<int64_t, std::shared_ptr<RaftLogStorage>> log_storages_;
+
+  SharedLogEnginePtr shared_log_engine_;
 };
 
 }  // namespace dingodb
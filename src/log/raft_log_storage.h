@@ -0,0 +1,163 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_RAFT_LOG_STORAGE_H_
+#define DINGODB_RAFT_LOG_STORAGE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "braft/storage.h"
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "common/logging.h"
+
+namespace dingodb {
+
+enum class LogEntryType { kEntryTypeUnknown = 0, kEntryTypeNoOp = 1, kEntryTypeData = 2, kEntryTypeConfiguration = 3 };
+
+struct LogEntry {
+  LogEntryType type;
+  int64_t index;
+  int64_t term;
+  butil::IOBuf data;
+};
+
+// Region raft log storage, include the vector index extension.
+// The vector index replay wal from VectorIndexFirstLogIndex(), so the log before it must be kept
+// even if braft already truncate prefix.
+// Implement:
+//   SegmentLogStorage: every region own segment files.
+//   SharedLogStorage: all regions share the same append-only files.
+class RaftLogStorage {
+ public:
+  RaftLogStorage() = default;
+  virtual ~RaftLogStorage() = default;
+
+  // init logstorage, check consistency and integrity
+  virtual int Init(braft::ConfigurationManager* configuration_manager) = 0;
+
+  virtual int64_t RegionId() const = 0;
+
+  // first log index in log
+  virtual int64_t FirstLogIndex() = 0;
+  virtual int64_t VectorIndexFirstLogIndex() = 0;
+
+  // last log index in log
+  virtual int64_t LastLogIndex() = 0;
+
+  // get logentry by index
+  virtual braft::LogEntry* GetEntry(int64_t index) = 0;
+
+  // [begin_index, end_index]
+  virtual std::vector<std::shared_ptr<LogEntry>> GetEntrys(uint64_t begin_index, uint64_t end_index) = 0;
+
+  using MatchFuncer = std::function<bool(const LogEntry&)>;
+  virtual bool HasSpecificLog(uint64_t begin_index, uint64_t end_index, MatchFuncer matcher) = 0;
+
+  // get logentry's term by index
+  virtual int64_t GetTerm(int64_t index) = 0;
+
+  // append entry to log
+  virtual int AppendEntry(const braft::LogEntry* entry) = 0;
+
+  // append entries to log and update IOMetric, return success append number
+  virtual int AppendEntries(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric) = 0;
+
+  // delete logs from storage's head, [1, first_index_kept) will be discarded
+  virtual int TruncatePrefix(int64_t first_index_kept) = 0;
+  virtual int TruncateVectorIndexPrefix(int64_t first_index_kept) = 0;
+
+  // delete uncommitted logs from storage's tail, (last_index_kept, infinity) will be discarded
+  virtual int TruncateSuffix(int64_t last_index_kept) = 0;
+
+  virtual int Reset(int64_t next_log_index) = 0;
+
+  virtual butil::Status GcInstance(const std::string& uri) = 0;
+
+  virtual void ListFiles(std::vector<std::string>* seg_files) = 0;
+
+  virtual void Sync() = 0;
+
+  // Create a same type log storage on uri, for braft new_instance.
+  virtual std::shared_ptr<RaftLogStorage> NewInstance(const std::string& uri) = 0;
+};
+
+// NOLINTBEGIN
+
+// Wrap RaftLogStorage for inject braft
+class RaftLogStorageWrapper : public braft::LogStorage {
+ public:
+  explicit RaftLogStorageWrapper(std::shared_ptr<RaftLogStorage> log_storage)
+      : log_storage_(log_storage), region_id_(log_storage->RegionId()) {}
+  ~RaftLogStorageWrapper() override = default;
+
+  // init logstorage, check consistency and integrity
+  virtual int init(braft::ConfigurationManager* configuration_manager) {
+    return log_storage_->Init(configuration_manager);
+  }
+
+  // first log index in log
+  virtual int64_t first_log_index() { return log_storage_->FirstLogIndex(); }
+
+  // last log index in log
+  virtual int64_t last_log_index() { return log_storage_->LastLogIndex(); }
+
+  // get logentry by index
+  virtual braft::LogEntry* get_entry(const int64_t index) { return log_storage_->GetEntry(index); }
+
+  // get logentry's term by index
+  virtual int64_t get_term(const int64_t index) { return log_storage_->GetTerm(index); }
+
+  // append entry to log
+  int append_entry(const braft::LogEntry* entry) { return log_storage_->AppendEntry(entry); }
+
+  // append entries to log and update IOMetric, return success append number
+  virtual int append_entries(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric) {
+    return log_storage_->AppendEntries(entries, metric);
+  }
+
+  // delete logs from storage's head, [1, first_index_kept) will be discarded
+  virtual int truncate_prefix(const int64_t first_index_kept) { return log_storage_->TruncatePrefix(first_index_kept); }
+
+  // delete uncommitted logs from storage's tail, (last_index_kept, infinity) will be discarded
+  virtual int truncate_suffix(const int64_t last_index_kept) { return log_storage_->TruncateSuffix(last_index_kept); }
+
+  virtual int reset(const int64_t next_log_index) { return log_storage_->Reset(next_log_index); }
+
+  LogStorage* new_instance(const std::string& uri) const {
+    DINGO_LOG(INFO) << "New raft log storage instance " << region_id_;
+    return new RaftLogStorageWrapper(log_storage_->NewInstance(uri));
+  }
+
+  butil::Status gc_instance(const std::string& uri) const { return log_storage_->GcInstance(uri); }
+
+  void list_files(std::vector<std::string>* seg_files) { log_storage_->ListFiles(seg_files); }
+
+  void sync() { log_storage_->Sync(); }
+
+ private:
+  std::shared_ptr<RaftLogStorage> log_storage_;
+  int64_t region_id_;
+};
+
+// NOLINTEND
+
+}  //  namespace dingodb
+
+#endif  // DINGODB_RAFT_LOG_STORAGE_H_
@@ -30,18 +30,10 @@
 #include "butil/logging.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "log/raft_log_storage.h"
 
 namespace dingodb {
 
-enum class LogEntryType { kEntryTypeUnknown = 0, kEntryTypeNoOp = 1, kEntryTypeData = 2, kEntryTypeConfiguration = 3 };
-
-struct LogEntry {
-  LogEntryType type;
-  int64_t index;
-  int64_t term;
-  butil::IOBuf data;
-};
-
 class BAIDU_CACHELINE_ALIGNMENT Segment {
  public:
   Segment(int64_t region_id, const std::string& path, const int64_t first_index, int checksum_type)
@@ -145,7 +137,7 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
 //      log_meta: record start_log
 //      log_000001-0001000: closed segment
 //      log_inprogress_0001001: open segment
-class SegmentLogStorage {
+class SegmentLogStorage : public RaftLogStorage {
  public:
   using SegmentMap = std::map<int64_t, std::shared_ptr<Segment>>;
 
@@ -154,57 +146,60 @@ class SegmentLogStorage {
 
   SegmentLogStorage();
 
-  ~SegmentLogStorage();
+  ~SegmentLogStorage() override;
 
   // init logstorage, check consistency and integrity
-  int Init(braft::ConfigurationManager* configuration_manager);
+  int Init(braft::ConfigurationManager* configuration_manager) override;
 
-  int64_t RegionId() const { return region_id_; }
+  int64_t RegionId() const override { return region_id_; }
 
   // first log index in log
-  int64_t FirstLogIndex();
-  int64_t VectorIndexFirstLogIndex();
+  int64_t FirstLogIndex() override;
+  int64_t VectorIndexFirstLogIndex() override;
 
   // last log index in log
-  int64_t LastLogIndex();
+  int64_t LastLogIndex() override;
 
   // get logentry by index
-  braft::LogEntry* GetEntry(int64_t index);
+  braft::LogEntry* GetEntry(int64_t index) override;
 
   // [begin_index, end_index]
-  std::vector<std::shared_ptr<LogEntry>> GetEntrys(uint64_t begin_index, uint64_t end_index);
+  std::vector<std::shared_ptr<LogEntry>> GetEntrys(uint64_t begin_index, uint64_t end_index) override;
 
-  using MatchFuncer = std::function<bool(const LogEntry&)>;
-  bool HasSpecificLog(uint64_t begin_index, uint64_t end_index, MatchFuncer matcher);
+  bool HasSpecificLog(uint64_t begin_index, uint64_t end_index, MatchFuncer matcher) override;
 
   // get logentry's term by index
-  int64_t GetTerm(int64_t index);
+  int64_t GetTerm(int64_t index) override;
 
   // append entry to log
-  int AppendEntry(const braft::LogEntry* entry);
+  int AppendEntry(const braft::LogEntry* entry) override;
 
   // append entries to log and update IOMetric, return success append number
-  int AppendEntries(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric);
+  int AppendEntries(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric) override;
 
   // delete logs from storage's head, [1, first_index_kept) will be discarded
-  int TruncatePrefix(int64_t first_index_kept);
-  int TruncateVectorIndexPrefix(int64_t first_index_kept);
+  int TruncatePrefix(int64_t first_index_kept) override;
+  int TruncateVectorIndexPrefix(int64_t first_index_kept) override;
 
   // delete uncommitted logs from storage's tail, (last_index_kept, infinity) will be discarded
-  int TruncateSuffix(int64_t last_index_kept);
+  int TruncateSuffix(int64_t last_index_kept) override;
 
-  int Reset(int64_t next_log_index);
+  int Reset(int64_t next_log_index) override;
 
-  butil::Status GcInstance(const std::string& uri);
+  butil::Status GcInstance(const std::string& uri) override;
 
   SegmentMap Segments() {
     BAIDU_SCOPED_LOCK(mutex_);
     return segments_;
   }
 
-  void ListFiles(std::vector<std::string>* seg_files);
+  void ListFiles(std::vector<std::string>* seg_files) override;
 
-  void Sync();
+  void Sync() override;
+
+  std::shared_ptr<RaftLogStorage> NewInstance(const std::string& uri) override {
+    return std::make_shared<SegmentLogStorage>(uri, region_id_, max_segment_size_);
+  }
 
   uint64_t MaxSegmentSize() const { return max_segment_size_; }
 
@@ -243,67 +238,6 @@ class SegmentLogStorage {
   uint64_t max_segment_size_;
 };
 
-// NOLINTBEGIN
-
-// Wrap SegmentLogStorage for inject braft
-class SegmentLogStorageWrapper : public braft::LogStorage {
- public:
-  explicit SegmentLogStorageWrapper(std::shared_ptr<SegmentLogStorage> log_storage)
-      : log_storage_(log_storage), region_id_(log_storage->RegionId()) {}
-  ~SegmentLogStorageWrapper() override = default;
-
-  // init logstorage, check consistency and integrity
-  virtual int init(braft::ConfigurationManager* configuration_manager) {
-    return log_storage_->Init(configuration_manager);
-  }
-
-  // first log index in log
-  virtual int64_t first_log_index() { return log_storage_->FirstLogIndex(); }
-
-  // last log index in log
-  virtual int64_t last_log_index() { return log_storage_->LastLogIndex(); }
-
-  // get logentry by index
-  virtual braft::LogEntry* get_entry(const int64_t index) { return log_storage_->GetEntry(index); }
-
-  // get logentry's term by index
-  virtual int64_t get_term(const int64_t index) { return log_storage_->GetTerm(index); }
-
-  // append entry to log
-  int append_entry(const braft::LogEntry* entry) { return log_storage_->AppendEntry(entry); }
-
-  // append entries to log and update IOMetric, return success append number
-  virtual int append_entries(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric) {
-    return log_storage_->AppendEntries(entries, metric);
-  }
-
-  // delete logs from storage's head, [1, first_index_kept) will be discarded
-  virtual int truncate_prefix(const int64_t first_index_kept) { return log_storage_->TruncatePrefix(first_index_kept); }
-
-  // delete uncommitted logs from storage's tail, (last_index_kept, infinity) will be discarded
-  virtual int truncate_suffix(const int64_t last_index_kept) { return log_storage_->TruncateSuffix(last_index_kept); }
-
-  virtual int reset(const int64_t next_log_index) { return log_storage_->Reset(next_log_index); }
-
-  LogStorage* new_instance(const std::string& uri) const {
-    DINGO_LOG(INFO) << "New segment log storage instance " << region_id_;
-    auto log_storage = std::make_shared<SegmentLogStorage>(uri, region_id_, log_storage_->MaxSegmentSize());
-    return new SegmentLogStorageWrapper(log_storage);
-  }
-
-  butil::Status gc_instance(const std::string& uri) const { return log_storage_->GcInstance(uri); }
-
-  void list_files(std::vector<std::string>* seg_files) { log_storage_->ListFiles(seg_files); }
-
-  void sync() { log_storage_->Sync(); }
-
- private:
-  int64_t region_id_;
-  std::shared_ptr<SegmentLogStorage> log_storage_;
-};
-
-// NOLINTEND
-
 }  //  namespace dingodb
 
 #endif  // DINGODB_SEGMENT_LOG_STORAGE_H_
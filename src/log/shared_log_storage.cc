@@ -0,0 +1,1177 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/shared_log_storage.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "braft/fsync.h"
+#include "braft/protobuf_file.h"
+#include "braft/util.h"
+#include "bthread/bthread.h"
+#include "butil/crc32c.h"
+#include "butil/fd_utility.h"
+#include "butil/file_util.h"
+#include "butil/files/dir_reader_posix.h"
+#include "butil/raw_pack.h"
+#include "butil/string_printf.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/recorder.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/store_internal.pb.h"
+
+#define SHARED_LOG_FILE_PATTERN "shared_log_%020" PRId64
+#define SHARED_LOG_META_FILE "log_meta"
+
+// Can only be switched on a new store, the server refuses to start if the other kind of raft log exists.
+DEFINE_bool(enable_shared_raft_log, false, "store region use one shared raft log instead of segment log per region");
+DEFINE_int64(shared_raft_log_max_file_size, 128 * 1024 * 1024, "max size of one shared raft log file");
+DEFINE_bool(shared_raft_log_sync, true, "fsync after write shared raft log");
+DEFINE_int32(shared_raft_log_max_group_count, 1024, "max write task count of one shared raft log group commit");
+DEFINE_int32(shared_raft_log_purge_interval_s, 10, "interval of purge shared raft log file");
+
+namespace dingodb {
+
+using ::butil::RawPacker;
+using ::butil::RawUnpacker;
+
+static bvar::LatencyRecorder g_shared_log_write_latency("shared_log_write");
+static bvar::LatencyRecorder g_shared_log_sync_latency("shared_log_sync");
+static bvar::IntRecorder g_shared_log_group_size("shared_log_group_size");
+
+// Format of record header, all fields are in network order
+// | -------------------- region_id (64bits) --------------------  |
+// | -------------------- index (64bits) ------------------------  |
+// | -------------------- term (64bits) -------------------------  |
+// | record-type (8bits) | checksum_type (8bits) | reserved(16bits) |
+// | ------------------ data len (32bits) -----------------------  |
+// | data_checksum (32bits) | header checksum (32bits)             |
+static const size_t kRecordHeaderSize = 40;
+
+static const int kChecksumMurmurhash32 = 0;
+static const int kChecksumCrc32 = 1;
+
+static uint32_t RecordChecksum(int checksum_type, const char* data, size_t len) {
+  return checksum_type == kChecksumCrc32 ? braft::crc32(data, len) : braft::murmurhash32(data, len);
+}
+
+static uint32_t RecordChecksum(int checksum_type, const butil::IOBuf& data) {
+  return checksum_type == kChecksumCrc32 ? braft::crc32(data) : braft::murmurhash32(data);
+}
+
+SharedLogFile::~SharedLogFile() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+std::string SharedLogFile::FilePath() const {
+  std::string path(path_);
+  butil::string_appendf(&path, "/" SHARED_LOG_FILE_PATTERN, id_);
+  return path;
+}
+
+int SharedLogFile::Create() {
+  std::string path = FilePath();
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] create file failed, path: {} error: {}", path, berror());
+    return -1;
+  }
+  butil::make_close_on_exec(fd_);
+  bytes_ = 0;
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] created new file, fd: {} path: {}", fd_, path);
+  return 0;
+}
+
+int SharedLogFile::Open() {
+  std::string path = FilePath();
+  fd_ = ::open(path.c_str(), O_RDWR);
+  if (fd_ < 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] open file failed, path: {} error: {}", path, berror());
+    return -1;
+  }
+  butil::make_close_on_exec(fd_);
+
+  struct stat st_buf;
+  if (fstat(fd_, &st_buf) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] get file stat failed, path: {} error: {}", path, berror());
+    return -1;
+  }
+  bytes_ = st_buf.st_size;
+
+  return 0;
+}
+
+int SharedLogFile::Unlink() {
+  std::string path = FilePath();
+  int ret = ::unlink(path.c_str());
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] unlink file failed, path: {} error: {}", path, berror());
+    return ret;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] unlinked file, path: {}", path);
+  return 0;
+}
+
+SharedLogEngine::SharedLogEngine(const std::string& path, uint64_t max_file_size)
+    : path_(path), max_file_size_(max_file_size), checksum_type_(kChecksumMurmurhash32), purge_tid_(0) {
+  DINGO_LOG(DEBUG) << fmt::format("[new.SharedLogEngine][path({})]", path_);
+}
+
+SharedLogEngine::~SharedLogEngine() {
+  Destroy();
+  DINGO_LOG(DEBUG) << fmt::format("[delete.SharedLogEngine][path({})]", path_);
+}
+
+bool SharedLogEngine::Init() {
+  butil::FilePath dir_path(path_);
+  butil::File::Error e;
+  if (!butil::CreateDirectoryAndGetError(dir_path, &e, true)) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] create directory failed, path: {} error: {}", path_,
+                                    static_cast<int>(e));
+    return false;
+  }
+
+  if (butil::crc32c::IsFastCrc32Supported()) {
+    checksum_type_ = kChecksumCrc32;
+  }
+
+  butil::Timer timer;
+  timer.start();
+
+  if (LoadMeta() != 0) {
+    return false;
+  }
+  if (LoadFiles() != 0) {
+    return false;
+  }
+
+  timer.stop();
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] init finish, path: {} region count: {} file count: {} time: {}us",
+                                 path_, RegionCount(), FileCount(), timer.u_elapsed());
+
+  is_stop_.store(false);
+  if (bthread_start_background(&purge_tid_, nullptr, PurgeRoutine, this) != 0) {
+    DINGO_LOG(ERROR) << "[raft.shared_log] start purge bthread failed.";
+    is_stop_.store(true);
+    return false;
+  }
+
+  return true;
+}
+
+void SharedLogEngine::Destroy() {
+  if (is_stop_.exchange(true)) {
+    return;
+  }
+
+  {
+    std::unique_lock<bthread::Mutex> lck(purge_mutex_);
+    purge_cond_.notify_all();
+  }
+  bthread_join(purge_tid_, nullptr);
+}
+
+int SharedLogEngine::AddRegion(int64_t region_id, braft::ConfigurationManager* configuration_manager) {
+  std::vector<std::pair<int64_t, EntryPos>> conf_entries;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = regions_.find(region_id);
+    if (it == regions_.end()) {
+      regions_.insert(std::make_pair(region_id, RegionLog()));
+      DINGO_LOG(INFO) << fmt::format("[raft.shared_log][region({})] add new region.", region_id);
+      return 0;
+    }
+
+    auto& region_log = it->second;
+    for (size_t i = 0; i < region_log.entries.size(); ++i) {
+      if (region_log.entries[i].type == kRecordConfiguration) {
+        conf_entries.emplace_back(region_log.base_index + i, region_log.entries[i]);
+      }
+    }
+
+    DINGO_LOG(INFO) << fmt::format(
+        "[raft.shared_log][region({}).index({}_{})] add exist region, vector_index_first_log_index: {} entry count: {}",
+        region_id, region_log.first_log_index, region_log.last_log_index, region_log.vector_index_first_log_index,
+        region_log.entries.size());
+  }
+
+  if (configuration_manager == nullptr) {
+    return 0;
+  }
+
+  for (auto& [index, pos] : conf_entries) {
+    SharedLogFilePtr file;
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      auto it = files_.find(pos.file_id);
+      if (it == files_.end()) {
+        return -1;
+      }
+      file = it->second;
+    }
+
+    Record record;
+    if (ReadRecord(file, pos.offset, pos.length, record) != 0) {
+      return -1;
+    }
+
+    scoped_refptr<braft::LogEntry> entry = new braft::LogEntry();
+    entry->id.index = index;
+    entry->id.term = record.term;
+    butil::Status status = parse_configuration_meta(record.data, entry);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log][region({})] parse configuration meta failed, index: {}",
+                                      region_id, index);
+      return -1;
+    }
+    braft::ConfigurationEntry conf_entry(*entry);
+    configuration_manager->add(conf_entry);
+  }
+
+  return 0;
+}
+
+int SharedLogEngine::RemoveRegion(int64_t region_id) {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (regions_.find(region_id) == regions_.end()) {
+      return 0;
+    }
+  }
+
+  WriteTask task;
+  task.records.push_back(Record{region_id, 0, 0, kRecordRemoveRegion, butil::IOBuf()});
+  int ret = Write(&task);
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log][region({})] remove region failed.", region_id);
+    return ret;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log][region({})] remove region.", region_id);
+  TriggerPurge();
+  return 0;
+}
+
+int64_t SharedLogEngine::FirstLogIndex(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  return it != regions_.end() ? it->second.first_log_index : 1;
+}
+
+int64_t SharedLogEngine::LastLogIndex(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  return it != regions_.end() ? it->second.last_log_index : 0;
+}
+
+int64_t SharedLogEngine::VectorIndexFirstLogIndex(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  return it != regions_.end() ? it->second.vector_index_first_log_index : INT64_MAX;
+}
+
+int64_t SharedLogEngine::MinEntryIndex(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  return it != regions_.end() ? it->second.base_index : INT64_MAX;
+}
+
+bool SharedLogEngine::GetEntryPos(int64_t region_id, int64_t index, EntryPos& pos, SharedLogFilePtr& file) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return false;
+  }
+
+  const auto& region_log = it->second;
+  if (index < region_log.base_index ||
+      index >= region_log.base_index + static_cast<int64_t>(region_log.entries.size())) {
+    return false;
+  }
+
+  pos = region_log.entries[index - region_log.base_index];
+  auto file_it = files_.find(pos.file_id);
+  if (file_it == files_.end()) {
+    return false;
+  }
+  file = file_it->second;
+
+  return true;
+}
+
+braft::LogEntry* SharedLogEngine::GetEntry(int64_t region_id, int64_t index) {
+  EntryPos pos;
+  SharedLogFilePtr file;
+  if (!GetEntryPos(region_id, index, pos, file)) {
+    return nullptr;
+  }
+
+  Record record;
+  if (ReadRecord(file, pos.offset, pos.length, record) != 0) {
+    return nullptr;
+  }
+  CHECK(record.region_id == region_id && record.index == index)
+      << fmt::format("[raft.shared_log][region({})] record not match, index: {} record: {}/{}", region_id, index,
+                     record.region_id, record.index);
+
+  auto* entry = new braft::LogEntry();
+  entry->AddRef();
+  switch (record.type) {
+    case kRecordData:
+      entry->data.swap(record.data);
+      break;
+    case kRecordNoOp:
+      CHECK(record.data.empty()) << fmt::format("[raft.shared_log][region({})] data of NO_OP must be empty",
+                                                region_id);
+      break;
+    case kRecordConfiguration: {
+      butil::Status status = parse_configuration_meta(record.data, entry);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[raft.shared_log][region({})] parse ConfigurationPBMeta failed, index: {}",
+                                          region_id, index);
+        entry->Release();
+        return nullptr;
+      }
+    } break;
+    default:
+      CHECK(false) << fmt::format("[raft.shared_log][region({})] unknown entry type: {}", region_id, record.type);
+      break;
+  }
+
+  entry->id.index = index;
+  entry->id.term = record.term;
+  entry->type = static_cast<braft::EntryType>(record.type);
+  return entry;
+}
+
+int64_t SharedLogEngine::GetTerm(int64_t region_id, int64_t index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return 0;
+  }
+
+  const auto& region_log = it->second;
+  if (index < region_log.base_index ||
+      index >= region_log.base_index + static_cast<int64_t>(region_log.entries.size())) {
+    return 0;
+  }
+
+  return region_log.entries[index - region_log.base_index].term;
+}
+
+std::vector<std::shared_ptr<LogEntry>> SharedLogEngine::GetEntrys(int64_t region_id, int64_t begin_index,
+                                                                  int64_t end_index) {
+  begin_index = std::max(begin_index, MinEntryIndex(region_id));
+
+  std::vector<std::shared_ptr<LogEntry>> log_entrys;
+  for (int64_t index = begin_index; index <= end_index; ++index) {
+    EntryPos pos;
+    SharedLogFilePtr file;
+    if (!GetEntryPos(region_id, index, pos, file)) {
+      break;
+    }
+    if (pos.type != kRecordData) {
+      continue;
+    }
+
+    Record record;
+    if (ReadRecord(file, pos.offset, pos.length, record) != 0) {
+      break;
+    }
+
+    auto log_entry = std::make_shared<LogEntry>();
+    log_entry->type = LogEntryType::kEntryTypeData;
+    log_entry->term = record.term;
+    log_entry->index = index;
+    log_entry->data.swap(record.data);
+    log_entrys.push_back(log_entry);
+  }
+
+  return log_entrys;
+}
+
+bool SharedLogEngine::HasSpecificLog(int64_t region_id, int64_t begin_index, int64_t end_index,
+                                     RaftLogStorage::MatchFuncer matcher) {
+  begin_index = std::max(begin_index, MinEntryIndex(region_id));
+
+  for (int64_t index = begin_index; index <= end_index; ++index) {
+    EntryPos pos;
+    SharedLogFilePtr file;
+    if (!GetEntryPos(region_id, index, pos, file)) {
+      break;
+    }
+
+    LogEntry log_entry;
+    log_entry.term = pos.term;
+    log_entry.index = index;
+    if (pos.type == kRecordData) {
+      Record record;
+      if (ReadRecord(file, pos.offset, pos.length, record) != 0) {
+        break;
+      }
+      log_entry.type = LogEntryType::kEntryTypeData;
+      log_entry.data.swap(record.data);
+    } else if (pos.type == kRecordConfiguration) {
+      log_entry.type = LogEntryType::kEntryTypeConfiguration;
+    } else {
+      continue;
+    }
+
+    if (matcher(log_entry)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int SharedLogEngine::AppendEntries(int64_t region_id, const std::vector<braft::LogEntry*>& entries) {
+  if (entries.empty()) {
+    return 0;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = regions_.find(region_id);
+    if (it == regions_.end()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log][region({})] append entries, not found region.", region_id);
+      return 0;
+    }
+    if (it->second.last_log_index + 1 != entries.front()->id.index) {
+      DINGO_LOG(FATAL) << fmt::format(
+          "[raft.shared_log][region({}).index({}_{})] there's gap between appending entries and last_log_index, "
+          "entry_index: {}_{}",
+          region_id, it->second.first_log_index, it->second.last_log_index, entries.front()->id.term,
+          entries.front()->id.index);
+      return 0;
+    }
+  }
+
+  WriteTask task;
+  task.records.reserve(entries.size());
+  for (const auto* entry : entries) {
+    Record record{region_id, entry->id.index, entry->id.term, entry->type, butil::IOBuf()};
+    switch (entry->type) {
+      case braft::ENTRY_TYPE_DATA:
+        record.data.append(entry->data);
+        break;
+      case braft::ENTRY_TYPE_NO_OP:
+        break;
+      case braft::ENTRY_TYPE_CONFIGURATION: {
+        butil::Status status = serialize_configuration_meta(entry, record.data);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("[raft.shared_log][region({})] serialize ConfigurationPBMeta failed.",
+                                          region_id);
+          return 0;
+        }
+      } break;
+      default:
+        DINGO_LOG(FATAL) << fmt::format("[raft.shared_log][region({})] unknown entry type: {}", region_id,
+                                        static_cast<int>(entry->type));
+        return 0;
+    }
+    task.records.push_back(std::move(record));
+  }
+
+  return Write(&task) == 0 ? entries.size() : 0;
+}
+
+int SharedLogEngine::TruncatePrefix(int64_t region_id, int64_t first_index_kept) {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = regions_.find(region_id);
+    if (it == regions_.end() || it->second.first_log_index >= first_index_kept) {
+      return 0;
+    }
+  }
+
+  WriteTask task;
+  task.records.push_back(Record{region_id, first_index_kept, 0, kRecordTruncatePrefix, butil::IOBuf()});
+  int ret = Write(&task);
+  if (ret != 0) {
+    return ret;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log][region({}).index({}_{})] truncate prefix, first_index_kept: {}",
+                                 region_id, FirstLogIndex(region_id), LastLogIndex(region_id), first_index_kept);
+  TriggerPurge();
+  return 0;
+}
+
+int SharedLogEngine::TruncateVectorIndexPrefix(int64_t region_id, int64_t first_index_kept) {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = regions_.find(region_id);
+    if (it == regions_.end()) {
+      return 0;
+    }
+    if (first_index_kept <= it->second.vector_index_first_log_index) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[raft.shared_log][region({}).index({}_{})] truncate vector index prefix, must greater "
+          "vector_index_first_log_index: {} first_index_kept: {}",
+          region_id, it->second.first_log_index, it->second.last_log_index,
+          it->second.vector_index_first_log_index, first_index_kept);
+      return 0;
+    }
+  }
+
+  WriteTask task;
+  task.records.push_back(Record{region_id, first_index_kept, 0, kRecordTruncateVectorIndexPrefix, butil::IOBuf()});
+  int ret = Write(&task);
+  if (ret != 0) {
+    return ret;
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[raft.shared_log][region({}).index({}_{})] truncate vector index prefix, first_index_kept: {}", region_id,
+      FirstLogIndex(region_id), LastLogIndex(region_id), first_index_kept);
+  TriggerPurge();
+  return 0;
+}
+
+int SharedLogEngine::TruncateSuffix(int64_t region_id, int64_t last_index_kept) {
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log][region({}).index({}_{})] truncate suffix, last_index_kept: {}",
+                                 region_id, FirstLogIndex(region_id), LastLogIndex(region_id), last_index_kept);
+
+  WriteTask task;
+  task.records.push_back(Record{region_id, last_index_kept, 0, kRecordTruncateSuffix, butil::IOBuf()});
+  return Write(&task);
+}
+
+int SharedLogEngine::Reset(int64_t region_id, int64_t next_log_index) {
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log][region({}).index({}_{})] reset log, next_log_index: {}", region_id,
+                                 FirstLogIndex(region_id), LastLogIndex(region_id), next_log_index);
+  if (next_log_index <= 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log][region({})] invalid next_log_index: {}", region_id,
+                                    next_log_index);
+    return EINVAL;
+  }
+
+  WriteTask task;
+  task.records.push_back(Record{region_id, next_log_index, 0, kRecordReset, butil::IOBuf()});
+  int ret = Write(&task);
+  if (ret != 0) {
+    return ret;
+  }
+
+  TriggerPurge();
+  return 0;
+}
+
+void SharedLogEngine::Sync() {
+  SharedLogFilePtr file;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (files_.empty()) {
+      return;
+    }
+    file = files_.rbegin()->second;
+  }
+
+  braft::raft_fsync(file->Fd());
+}
+
+// Leader-follower group commit, the leader write all pending task with one write and one fsync.
+int SharedLogEngine::Write(WriteTask* task) {
+  std::unique_lock<bthread::Mutex> lck(write_mutex_);
+  write_queue_.push_back(task);
+  while (!task->done && task != write_queue_.front()) {
+    write_cond_.wait(lck);
+  }
+  if (task->done) {
+    return task->ret;
+  }
+
+  std::vector<WriteTask*> group;
+  for (auto* pending_task : write_queue_) {
+    group.push_back(pending_task);
+    if (group.size() >= static_cast<size_t>(FLAGS_shared_raft_log_max_group_count)) {
+      break;
+    }
+  }
+  lck.unlock();
+
+  int ret = WriteGroup(group);
+
+  lck.lock();
+  for (auto* done_task : group) {
+    CHECK(done_task == write_queue_.front());
+    done_task->ret = ret;
+    done_task->done = true;
+    write_queue_.pop_front();
+  }
+  write_cond_.notify_all();
+
+  return task->ret;
+}
+
+int SharedLogEngine::WriteGroup(std::vector<WriteTask*>& group) {
+  int64_t start_time = butil::cpuwide_time_us();
+
+  struct RecordPos {
+    const Record* record;
+    int64_t offset;
+    int64_t length;
+  };
+  std::vector<RecordPos> record_poses;
+
+  butil::IOBuf buf;
+  for (auto* task : group) {
+    for (const auto& record : task->records) {
+      CHECK_LE(record.data.length(), UINT32_MAX);
+      char header_buf[kRecordHeaderSize];
+      const uint32_t meta_field = (record.type << 24) | (checksum_type_ << 16);
+      RawPacker packer(header_buf);
+      packer.pack64(record.region_id)
+          .pack64(record.index)
+          .pack64(record.term)
+          .pack32(meta_field)
+          .pack32(static_cast<uint32_t>(record.data.length()))
+          .pack32(RecordChecksum(checksum_type_, record.data));
+      packer.pack32(RecordChecksum(checksum_type_, header_buf, kRecordHeaderSize - 4));
+
+      int64_t offset = buf.length();
+      buf.append(header_buf, kRecordHeaderSize);
+      buf.append(record.data);
+      record_poses.push_back({&record, offset, static_cast<int64_t>(buf.length()) - offset});
+    }
+  }
+
+  auto file = RollFile(buf.length());
+  if (file == nullptr) {
+    return -1;
+  }
+
+  int64_t base_offset = file->Bytes();
+  int64_t to_write = buf.length();
+  while (!buf.empty()) {
+    ssize_t n = buf.pcut_into_file_descriptor(file->Fd(), base_offset + (to_write - buf.length()));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] write file failed, path: {} error: {}", file->FilePath(),
+                                      berror());
+      return -1;
+    }
+  }
+
+  if (FLAGS_shared_raft_log_sync) {
+    int64_t sync_start_time = butil::cpuwide_time_us();
+    if (braft::raft_fsync(file->Fd()) != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] sync file failed, path: {} error: {}", file->FilePath(),
+                                      berror());
+      return -1;
+    }
+    g_shared_log_sync_latency << (butil::cpuwide_time_us() - sync_start_time);
+  }
+  file->SetBytes(base_offset + to_write);
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (const auto& record_pos : record_poses) {
+      ApplyRecord(*record_pos.record, file->Id(), base_offset + record_pos.offset, record_pos.length);
+    }
+  }
+
+  g_shared_log_group_size << record_poses.size();
+  g_shared_log_write_latency << (butil::cpuwide_time_us() - start_time);
+
+  return 0;
+}
+
+SharedLogFilePtr SharedLogEngine::RollFile(int64_t incoming_bytes) {
+  if (active_file_ != nullptr &&
+      (active_file_->Bytes() == 0 || active_file_->Bytes() + incoming_bytes <= max_file_size_)) {
+    return active_file_;
+  }
+
+  int64_t file_id = active_file_ != nullptr ? active_file_->Id() + 1 : 1;
+  auto file = std::make_shared<SharedLogFile>(path_, file_id);
+  if (file->Create() != 0) {
+    return nullptr;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    files_[file_id] = file;
+  }
+  active_file_ = file;
+
+  return file;
+}
+
+void SharedLogEngine::ApplyRecord(const Record& record, int64_t file_id, int64_t offset, int64_t length) {
+  if (record.type == kRecordRemoveRegion) {
+    auto it = regions_.find(record.region_id);
+    if (it != regions_.end()) {
+      ClearEntries(it->second);
+      regions_.erase(it);
+    }
+    return;
+  }
+
+  auto& region_log = regions_[record.region_id];
+  switch (record.type) {
+    case kRecordNoOp:
+    case kRecordData:
+    case kRecordConfiguration: {
+      // Overwrite the uncommitted log, only happen on replay.
+      if (record.index <= region_log.last_log_index) {
+        PopBackEntries(region_log, record.index - 1);
+      }
+      if (region_log.entries.empty()) {
+        region_log.base_index = record.index;
+      } else if (region_log.base_index + static_cast<int64_t>(region_log.entries.size()) != record.index) {
+        // The previous entries is purged, only happen on replay.
+        ClearEntries(region_log);
+        region_log.base_index = record.index;
+      }
+
+      region_log.entries.push_back(EntryPos{file_id, offset, length, record.term, record.type});
+      auto file_it = files_.find(file_id);
+      if (file_it != files_.end()) {
+        file_it->second->IncAliveCount();
+      }
+      region_log.last_log_index = record.index;
+    } break;
+    case kRecordTruncatePrefix:
+      region_log.first_log_index = std::max(region_log.first_log_index, record.index);
+      region_log.last_log_index = std::max(region_log.last_log_index, region_log.first_log_index - 1);
+      PopFrontEntries(region_log,
+                      std::min(region_log.first_log_index, region_log.vector_index_first_log_index));
+      break;
+    case kRecordTruncateVectorIndexPrefix:
+      if (record.index > region_log.vector_index_first_log_index) {
+        region_log.vector_index_first_log_index = record.index;
+        PopFrontEntries(region_log,
+                        std::min(region_log.first_log_index, region_log.vector_index_first_log_index));
+      }
+      break;
+    case kRecordTruncateSuffix:
+      PopBackEntries(region_log, record.index);
+      region_log.last_log_index = record.index;
+      if (region_log.entries.empty() && region_log.first_log_index > region_log.last_log_index + 1) {
+        region_log.first_log_index = region_log.last_log_index + 1;
+      }
+      break;
+    case kRecordReset:
+      ClearEntries(region_log);
+      region_log.first_log_index = record.index;
+      region_log.vector_index_first_log_index = record.index;
+      region_log.last_log_index = record.index - 1;
+      region_log.base_index = record.index;
+      break;
+    default:
+      DINGO_LOG(FATAL) << fmt::format("[raft.shared_log][region({})] unknown record type: {}", record.region_id,
+                                      record.type);
+  }
+}
+
+void SharedLogEngine::PopFrontEntries(RegionLog& region_log, int64_t first_index_kept) {
+  while (!region_log.entries.empty() && region_log.base_index < first_index_kept) {
+    DecFileAliveCount(region_log.entries.front());
+    region_log.entries.pop_front();
+    ++region_log.base_index;
+  }
+}
+
+void SharedLogEngine::PopBackEntries(RegionLog& region_log, int64_t last_index_kept) {
+  while (!region_log.entries.empty() &&
+         region_log.base_index + static_cast<int64_t>(region_log.entries.size()) - 1 > last_index_kept) {
+    DecFileAliveCount(region_log.entries.back());
+    region_log.entries.pop_back();
+  }
+}
+
+void SharedLogEngine::ClearEntries(RegionLog& region_log) {
+  for (const auto& pos : region_log.entries) {
+    DecFileAliveCount(pos);
+  }
+  region_log.entries.clear();
+}
+
+void SharedLogEngine::DecFileAliveCount(const EntryPos& pos) {
+  auto it = files_.find(pos.file_id);
+  if (it != files_.end()) {
+    it->second->DecAliveCount();
+  }
+}
+
+int SharedLogEngine::ReadRecord(SharedLogFilePtr file, int64_t offset, int64_t length, Record& record) {
+  butil::IOPortal buf;
+  const ssize_t n = braft::file_pread(&buf, file->Fd(), offset, length);
+  if (n != length) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] read record failed, path: {} offset: {} length: {} read: {}",
+                                    file->FilePath(), offset, length, n);
+    return -1;
+  }
+
+  char header_buf[kRecordHeaderSize];
+  const char* p = static_cast<const char*>(buf.fetch(header_buf, kRecordHeaderSize));
+  uint32_t meta_field = 0;
+  uint32_t data_len = 0;
+  uint32_t data_checksum = 0;
+  uint32_t header_checksum = 0;
+  RawUnpacker(p)
+      .unpack64((uint64_t&)record.region_id)
+      .unpack64((uint64_t&)record.index)
+      .unpack64((uint64_t&)record.term)
+      .unpack32(meta_field)
+      .unpack32(data_len)
+      .unpack32(data_checksum)
+      .unpack32(header_checksum);
+  record.type = meta_field >> 24;
+  int checksum_type = (meta_field << 8) >> 24;
+  if (header_checksum != RecordChecksum(checksum_type, p, kRecordHeaderSize - 4)) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] found corrupted header, path: {} offset: {}", file->FilePath(),
+                                    offset);
+    return -1;
+  }
+  if (kRecordHeaderSize + data_len != length) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] record length not match, path: {} offset: {} {}/{}",
+                                    file->FilePath(), offset, kRecordHeaderSize + data_len, length);
+    return -1;
+  }
+
+  buf.pop_front(kRecordHeaderSize);
+  if (data_checksum != RecordChecksum(checksum_type, buf)) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] found corrupted data, path: {} offset: {}", file->FilePath(),
+                                    offset);
+    return -1;
+  }
+  record.data.swap(buf);
+
+  return 0;
+}
+
+int SharedLogEngine::ReplayFile(SharedLogFilePtr file) {
+  int64_t file_size = file->Bytes();
+  int64_t offset = 0;
+  int64_t record_count = 0;
+  while (offset < file_size) {
+    if (offset + static_cast<int64_t>(kRecordHeaderSize) > file_size) {
+      break;
+    }
+
+    butil::IOPortal buf;
+    ssize_t n = braft::file_pread(&buf, file->Fd(), offset, kRecordHeaderSize);
+    if (n != static_cast<ssize_t>(kRecordHeaderSize)) {
+      break;
+    }
+
+    char header_buf[kRecordHeaderSize];
+    const char* p = static_cast<const char*>(buf.fetch(header_buf, kRecordHeaderSize));
+    Record record;
+    uint32_t meta_field = 0;
+    uint32_t data_len = 0;
+    uint32_t data_checksum = 0;
+    uint32_t header_checksum = 0;
+    RawUnpacker(p)
+        .unpack64((uint64_t&)record.region_id)
+        .unpack64((uint64_t&)record.index)
+        .unpack64((uint64_t&)record.term)
+        .unpack32(meta_field)
+        .unpack32(data_len)
+        .unpack32(data_checksum)
+        .unpack32(header_checksum);
+    record.type = meta_field >> 24;
+    int checksum_type = (meta_field << 8) >> 24;
+    if (header_checksum != RecordChecksum(checksum_type, p, kRecordHeaderSize - 4)) {
+      DINGO_LOG(WARNING) << fmt::format("[raft.shared_log] found corrupted header, path: {} offset: {}",
+                                        file->FilePath(), offset);
+      break;
+    }
+
+    int64_t length = kRecordHeaderSize + data_len;
+    if (offset + length > file_size) {
+      // The last record was not completely written.
+      break;
+    }
+
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      ApplyRecord(record, file->Id(), offset, length);
+    }
+    offset += length;
+    ++record_count;
+  }
+
+  if (offset != file_size) {
+    DINGO_LOG(WARNING) << fmt::format(
+        "[raft.shared_log] truncate last uncompleted write record, path: {} old_size: {} new_size: {}",
+        file->FilePath(), file_size, offset);
+    if (::ftruncate(file->Fd(), offset) != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] truncate file failed, path: {} error: {}", file->FilePath(),
+                                      berror());
+      return -1;
+    }
+    file->SetBytes(offset);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] replay file finish, path: {} record count: {}", file->FilePath(),
+                                 record_count);
+  return 0;
+}
+
+int SharedLogEngine::LoadFiles() {
+  butil::DirReaderPosix dir_reader(path_.c_str());
+  if (!dir_reader.IsValid()) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] directory reader failed, path: {}", path_);
+    return -1;
+  }
+
+  std::vector<int64_t> file_ids;
+  while (dir_reader.Next()) {
+    int64_t file_id = 0;
+    if (sscanf(dir_reader.name(), SHARED_LOG_FILE_PATTERN, &file_id) == 1) {
+      file_ids.push_back(file_id);
+    }
+  }
+  std::sort(file_ids.begin(), file_ids.end());
+
+  for (auto file_id : file_ids) {
+    auto file = std::make_shared<SharedLogFile>(path_, file_id);
+    if (file->Open() != 0) {
+      return -1;
+    }
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      files_[file_id] = file;
+    }
+    if (ReplayFile(file) != 0) {
+      return -1;
+    }
+    active_file_ = file;
+  }
+
+  // The entry before min first index is useless, it maybe left by crash before purge.
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto& [_, region_log] : regions_) {
+    region_log.last_log_index = std::max(region_log.last_log_index, region_log.first_log_index - 1);
+    PopFrontEntries(region_log, std::min(region_log.first_log_index, region_log.vector_index_first_log_index));
+  }
+
+  return 0;
+}
+
+int SharedLogEngine::SaveMeta() {
+  butil::Timer timer;
+  timer.start();
+
+  pb::store_internal::SharedLogMeta meta;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (const auto& [region_id, region_log] : regions_) {
+      auto& log_meta = (*meta.mutable_region_log_metas())[region_id];
+      log_meta.set_first_log_index(region_log.first_log_index);
+      log_meta.set_vector_index_first_log_index(region_log.vector_index_first_log_index);
+    }
+  }
+
+  std::string meta_path(path_);
+  meta_path.append("/" SHARED_LOG_META_FILE);
+  braft::ProtoBufFile pb_file(meta_path);
+  int ret = pb_file.save(&meta, braft::raft_sync_meta());
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] save meta failed, path: {}", meta_path);
+    return ret;
+  }
+
+  timer.stop();
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] save meta finish, region count: {} elapsed time: {}us",
+                                 meta.region_log_metas_size(), timer.u_elapsed());
+  return 0;
+}
+
+int SharedLogEngine::LoadMeta() {
+  std::string meta_path(path_);
+  meta_path.append("/" SHARED_LOG_META_FILE);
+
+  braft::ProtoBufFile pb_file(meta_path);
+  pb::store_internal::SharedLogMeta meta;
+  if (0 != pb_file.load(&meta)) {
+    if (errno == ENOENT) {
+      return 0;
+    }
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] load meta failed, path: {}", meta_path);
+    return -1;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (const auto& [region_id, log_meta] : meta.region_log_metas()) {
+    auto& region_log = regions_[region_id];
+    region_log.first_log_index = log_meta.first_log_index();
+    region_log.vector_index_first_log_index = log_meta.vector_index_first_log_index();
+    region_log.last_log_index = log_meta.first_log_index() - 1;
+    region_log.base_index = log_meta.first_log_index();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] load meta finish, region count: {}",
+                                 meta.region_log_metas_size());
+  return 0;
+}
+
+void SharedLogEngine::Purge() {
+  std::vector<SharedLogFilePtr> purgeds;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (files_.size() <= 1) {
+      return;
+    }
+
+    // Keep the newest file, it's the writing file.
+    int64_t active_file_id = files_.rbegin()->first;
+    for (auto& [file_id, file] : files_) {
+      if (file_id == active_file_id || file->AliveCount() > 0) {
+        break;
+      }
+      purgeds.push_back(file);
+    }
+  }
+
+  if (purgeds.empty()) {
+    return;
+  }
+
+  // Checkpoint region meta first, the control record in purged files will be lost.
+  if (SaveMeta() != 0) {
+    return;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (auto& file : purgeds) {
+      files_.erase(file->Id());
+    }
+  }
+
+  for (auto& file : purgeds) {
+    file->Unlink();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] purge file count: {} [{}, {}]", purgeds.size(),
+                                 purgeds.front()->Id(), purgeds.back()->Id());
+}
+
+void SharedLogEngine::TriggerPurge() {
+  std::unique_lock<bthread::Mutex> lck(purge_mutex_);
+  purge_triggered_ = true;
+  purge_cond_.notify_all();
+}
+
+void* SharedLogEngine::PurgeRoutine(void* arg) {
+  auto* self = static_cast<SharedLogEngine*>(arg);
+  while (!self->is_stop_.load()) {
+    {
+      std::unique_lock<bthread::Mutex> lck(self->purge_mutex_);
+      if (!self->purge_triggered_) {
+        self->purge_cond_.wait_for(lck, static_cast<int64_t>(FLAGS_shared_raft_log_purge_interval_s) * 1000 * 1000);
+      }
+      self->purge_triggered_ = false;
+    }
+    if (self->is_stop_.load()) {
+      break;
+    }
+
+    self->Purge();
+  }
+
+  return nullptr;
+}
+
+size_t SharedLogEngine::RegionCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return regions_.size();
+}
+
+size_t SharedLogEngine::FileCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return files_.size();
+}
+
+SharedLogStorage::SharedLogStorage(SharedLogEnginePtr engine, int64_t region_id)
+    : engine_(engine), region_id_(region_id) {
+  DINGO_LOG(DEBUG) << fmt::format("[new.SharedLogStorage][id({})]", region_id_);
+}
+
+SharedLogStorage::~SharedLogStorage() {
+  DINGO_LOG(DEBUG) << fmt::format("[delete.SharedLogStorage][id({})]", region_id_);
+}
+
+int SharedLogStorage::Init(braft::ConfigurationManager* configuration_manager) {
+  return engine_->AddRegion(region_id_, configuration_manager);
+}
+
+std::vector<std::shared_ptr<LogEntry>> SharedLogStorage::GetEntrys(uint64_t begin_index, uint64_t end_index) {
+  return engine_->GetEntrys(region_id_, begin_index, std::min(end_index, static_cast<uint64_t>(LastLogIndex())));
+}
+
+bool SharedLogStorage::HasSpecificLog(uint64_t begin_index, uint64_t end_index, MatchFuncer matcher) {
+  return engine_->HasSpecificLog(region_id_, begin_index, std::min(end_index, static_cast<uint64_t>(LastLogIndex())),
+                                 matcher);
+}
+
+int SharedLogStorage::AppendEntry(const braft::LogEntry* entry) {
+  std::vector<braft::LogEntry*> entries = {const_cast<braft::LogEntry*>(entry)};
+  return engine_->AppendEntries(region_id_, entries) == 1 ? 0 : EIO;
+}
+
+int SharedLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* /*metric*/) {
+  return engine_->AppendEntries(region_id_, entries);
+}
+
+int SharedLogStorage::TruncatePrefix(int64_t first_index_kept) {
+  return engine_->TruncatePrefix(region_id_, first_index_kept);
+}
+
+int SharedLogStorage::TruncateVectorIndexPrefix(int64_t first_index_kept) {
+  return engine_->TruncateVectorIndexPrefix(region_id_, first_index_kept);
+}
+
+int SharedLogStorage::TruncateSuffix(int64_t last_index_kept) {
+  return engine_->TruncateSuffix(region_id_, last_index_kept);
+}
+
+int SharedLogStorage::Reset(int64_t next_log_index) { return engine_->Reset(region_id_, next_log_index); }
+
+butil::Status SharedLogStorage::GcInstance(const std::string& uri) {
+  if (engine_->RemoveRegion(region_id_) != 0) {
+    return butil::Status(EINVAL, "gc shared log storage failed, uri %s", uri.c_str());
+  }
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,260 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SHARED_LOG_STORAGE_H_
+#define DINGODB_SHARED_LOG_STORAGE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "braft/storage.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "log/raft_log_storage.h"
+
+namespace dingodb {
+
+// One append-only file of shared log.
+class SharedLogFile {
+ public:
+  SharedLogFile(const std::string& path, int64_t id) : path_(path), id_(id) {}
+  ~SharedLogFile();
+
+  int Create();
+  int Open();
+  int Unlink();
+
+  int64_t Id() const { return id_; }
+  int Fd() const { return fd_; }
+  std::string FilePath() const;
+
+  int64_t Bytes() const { return bytes_; }
+  void SetBytes(int64_t bytes) { bytes_ = bytes; }
+
+  int64_t AliveCount() const { return alive_count_; }
+  void IncAliveCount() { ++alive_count_; }
+  void DecAliveCount() { --alive_count_; }
+
+ private:
+  std::string path_;
+  const int64_t id_;
+  int fd_{-1};
+  int64_t bytes_{0};
+  // Count of the entry still referenced by region index, protected by SharedLogEngine::mutex_.
+  int64_t alive_count_{0};
+};
+
+using SharedLogFilePtr = std::shared_ptr<SharedLogFile>;
+
+// Multiplex all region raft log into one append-only log, instead of one SegmentLogStorage per region.
+// Every region only has an in-memory index point to the entry position.
+// Appending from different regions are group committed, one write and one fsync for a group.
+// Truncate/reset are also written as control record, so the index can be rebuilt by replay the log.
+// The oldest file is purged in background when no entry in it is referenced, and region meta is
+// checkpointed into log_meta before purge.
+//
+// SharedLog layout:
+//      log_meta: SharedLogMeta checkpoint
+//      shared_log_00000000000000000001: closed file
+//      shared_log_00000000000000000002: open file, the max id
+class SharedLogEngine {
+ public:
+  SharedLogEngine(const std::string& path, uint64_t max_file_size);
+  ~SharedLogEngine();
+
+  // Record type, braft::EntryType or control record.
+  enum RecordType {
+    kRecordNoOp = braft::ENTRY_TYPE_NO_OP,
+    kRecordData = braft::ENTRY_TYPE_DATA,
+    kRecordConfiguration = braft::ENTRY_TYPE_CONFIGURATION,
+    kRecordTruncatePrefix = 100,
+    kRecordTruncateSuffix = 101,
+    kRecordReset = 102,
+    kRecordTruncateVectorIndexPrefix = 103,
+    kRecordRemoveRegion = 104,
+  };
+
+  struct Record {
+    int64_t region_id;
+    int64_t index;
+    int64_t term;
+    int type;
+    butil::IOBuf data;
+  };
+
+  // load checkpoint and replay all files.
+  bool Init();
+  void Destroy();
+
+  // Register region, load configuration entry of region.
+  int AddRegion(int64_t region_id, braft::ConfigurationManager* configuration_manager);
+  // Drop all log of region.
+  int RemoveRegion(int64_t region_id);
+
+  int64_t FirstLogIndex(int64_t region_id);
+  int64_t LastLogIndex(int64_t region_id);
+  int64_t VectorIndexFirstLogIndex(int64_t region_id);
+
+  braft::LogEntry* GetEntry(int64_t region_id, int64_t index);
+  int64_t GetTerm(int64_t region_id, int64_t index);
+  // Read entry in [begin_index, end_index] which is still in log, include the vector index kept entry.
+  std::vector<std::shared_ptr<LogEntry>> GetEntrys(int64_t region_id, int64_t begin_index, int64_t end_index);
+  bool HasSpecificLog(int64_t region_id, int64_t begin_index, int64_t end_index, RaftLogStorage::MatchFuncer matcher);
+
+  // return success append number
+  int AppendEntries(int64_t region_id, const std::vector<braft::LogEntry*>& entries);
+
+  int TruncatePrefix(int64_t region_id, int64_t first_index_kept);
+  int TruncateVectorIndexPrefix(int64_t region_id, int64_t first_index_kept);
+  int TruncateSuffix(int64_t region_id, int64_t last_index_kept);
+  int Reset(int64_t region_id, int64_t next_log_index);
+
+  void Sync();
+
+  // Delete the oldest files which have no alive entry.
+  void Purge();
+  void TriggerPurge();
+
+  size_t RegionCount();
+  size_t FileCount();
+
+ private:
+  struct EntryPos {
+    int64_t file_id;
+    int64_t offset;
+    int64_t length;
+    int64_t term;
+    int type;
+  };
+
+  struct RegionLog {
+    int64_t first_log_index{1};
+    int64_t last_log_index{0};
+    // Control truncate log.
+    int64_t vector_index_first_log_index{INT64_MAX};
+
+    // entries[i] is the log of index base_index + i.
+    int64_t base_index{1};
+    std::deque<EntryPos> entries;
+  };
+
+  struct WriteTask {
+    std::vector<Record> records;
+    int ret{0};
+    bool done{false};
+  };
+
+  int Write(WriteTask* task);
+  int WriteGroup(std::vector<WriteTask*>& group);
+  SharedLogFilePtr RollFile(int64_t incoming_bytes);
+
+  // Apply record to index, it's used by write and replay, so must be idempotent on replay.
+  void ApplyRecord(const Record& record, int64_t file_id, int64_t offset, int64_t length);
+  void PopFrontEntries(RegionLog& region_log, int64_t first_index_kept);
+  void PopBackEntries(RegionLog& region_log, int64_t last_index_kept);
+  void ClearEntries(RegionLog& region_log);
+  void DecFileAliveCount(const EntryPos& pos);
+
+  int ReadRecord(SharedLogFilePtr file, int64_t offset, int64_t length, Record& record);
+  bool GetEntryPos(int64_t region_id, int64_t index, EntryPos& pos, SharedLogFilePtr& file);
+  // The min index which entry is still kept.
+  int64_t MinEntryIndex(int64_t region_id);
+
+  int SaveMeta();
+  int LoadMeta();
+  int LoadFiles();
+  int ReplayFile(SharedLogFilePtr file);
+
+  static void* PurgeRoutine(void* arg);
+
+  std::string path_;
+  uint64_t max_file_size_;
+  int checksum_type_;
+
+  // Protect regions_ and files_.
+  bthread::Mutex mutex_;
+  std::map<int64_t, RegionLog> regions_;
+  std::map<int64_t, SharedLogFilePtr> files_;
+
+  // Group commit, the task in front of queue is the leader of group.
+  bthread::Mutex write_mutex_;
+  bthread::ConditionVariable write_cond_;
+  std::deque<WriteTask*> write_queue_;
+  // Only access by leader.
+  SharedLogFilePtr active_file_;
+
+  // Background purge.
+  bthread_t purge_tid_;
+  bthread::Mutex purge_mutex_;
+  bthread::ConditionVariable purge_cond_;
+  bool purge_triggered_{false};
+  std::atomic<bool> is_stop_{true};
+};
+
+using SharedLogEnginePtr = std::shared_ptr<SharedLogEngine>;
+
+// Region view of SharedLogEngine.
+class SharedLogStorage : public RaftLogStorage {
+ public:
+  SharedLogStorage(SharedLogEnginePtr engine, int64_t region_id);
+  ~SharedLogStorage() override;
+
+  int Init(braft::ConfigurationManager* configuration_manager) override;
+
+  int64_t RegionId() const override { return region_id_; }
+
+  int64_t FirstLogIndex() override { return engine_->FirstLogIndex(region_id_); }
+  int64_t VectorIndexFirstLogIndex() override { return engine_->VectorIndexFirstLogIndex(region_id_); }
+  int64_t LastLogIndex() override { return engine_->LastLogIndex(region_id_); }
+
+  braft::LogEntry* GetEntry(int64_t index) override { return engine_->GetEntry(region_id_, index); }
+  std::vector<std::shared_ptr<LogEntry>> GetEntrys(uint64_t begin_index, uint64_t end_index) override;
+  bool HasSpecificLog(uint64_t begin_index, uint64_t end_index, MatchFuncer matcher) override;
+  int64_t GetTerm(int64_t index) override { return engine_->GetTerm(region_id_, index); }
+
+  int AppendEntry(const braft::LogEntry* entry) override;
+  int AppendEntries(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric) override;
+
+  int TruncatePrefix(int64_t first_index_kept) override;
+  int TruncateVectorIndexPrefix(int64_t first_index_kept) override;
+  int TruncateSuffix(int64_t last_index_kept) override;
+  int Reset(int64_t next_log_index) override;
+
+  butil::Status GcInstance(const std::string& uri) override;
+
+  // Shared log files is not owned by region.
+  void ListFiles(std::vector<std::string>* /*seg_files*/) override {}
+
+  void Sync() override { engine_->Sync(); }
+
+  std::shared_ptr<RaftLogStorage> NewInstance(const std::string& /*uri*/) override {
+    return std::make_shared<SharedLogStorage>(engine_, region_id_);
+  }
+
+ private:
+  SharedLogEnginePtr engine_;
+  int64_t region_id_;
+};
+
+}  //  namespace dingodb
+
+#endif  // DINGODB_SHARED_LOG_STORAGE_H_
@@ -30,7 +30,7 @@
 #include "config/config_manager.h"
 #include "engine/raw_engine.h"
 #include "fmt/core.h"
-#include "log/segment_log_storage.h"
+#include "log/raft_log_storage.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
@@ -42,7 +42,7 @@ DEFINE_int32(node_destroy_wait_time_ms, 3000, "wait time on node destroy");
 namespace dingodb {
 
 RaftNode::RaftNode(int64_t node_id, const std::string& raft_group_name, braft::PeerId peer_id,
-                   std::shared_ptr<BaseStateMachine> fsm, std::shared_ptr<SegmentLogStorage> log_storage)
+                   std::shared_ptr<BaseStateMachine> fsm, std::shared_ptr<RaftLogStorage> log_storage)
     : node_id_(node_id),
       str_node_id_(std::to_string(node_id)),
       raft_group_name_(raft_group_name),
@@ -77,7 +77,7 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
   node_options.snapshot_uri = "local://" + path_ + "/snapshot";
   node_options.disable_cli = false;
 
-  node_options.log_storage = new SegmentLogStorageWrapper(log_storage_);
+  node_options.log_storage = new RaftLogStorageWrapper(log_storage_);
   node_options.node_owns_log_storage = true;
 
   // coordinator's region does not have store_region_meta, so coordinator will pass nullptr to call AddNode.
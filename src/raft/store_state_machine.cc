@@ -26,6 +26,8 @@
 #include "common/synchronization.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "handler/raft_apply_handler.h"
 #include "meta/meta_writer.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_bvar_metrics.h"
@@ -37,6 +39,9 @@
 
 const int kSaveAppliedIndexStep = 10;
 
+DEFINE_bool(enable_raft_apply_log_batch, false, "enable coalesce consecutive write log into one engine write batch");
+DEFINE_int32(raft_apply_log_batch_max_count, 256, "max log count of one raft apply write batch");
+
 namespace dingodb {
 
 StoreStateMachine::StoreStateMachine(std::shared_ptr<RawEngine> engine, store::RegionPtr region,
@@ -75,99 +80,161 @@ int StoreStateMachine::DispatchEvent(dingodb::EventType event_type, std::shared_
   return 0;
 }
 
+void StoreStateMachine::AdvanceAppliedIndex(int64_t term, int64_t index) {
+  applied_term_ = term;
+  applied_index_ = index;
+  raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+
+  // bvar metrics
+  StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+
+  // Persistence applied index
+  // If operation is idempotent, it's ok.
+  // If not, must be stored with the data.
+  if (applied_index_ % kSaveAppliedIndexStep == 0) {
+    Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+  }
+}
+
+// Write the batched logs at once, the applied index must advance after the data is written.
+void StoreStateMachine::FlushApplyLogBatch(ApplyLogBatch& apply_batch) {
+  if (apply_batch.Empty()) {
+    return;
+  }
+
+  apply_batch.Write();
+  for (const auto& log : apply_batch.Logs()) {
+    AdvanceAppliedIndex(log.term_id, log.log_id);
+  }
+  apply_batch.Done();
+}
+
+namespace {
+
+class BraftLogIterator : public StoreStateMachine::LogIterator {
+ public:
+  explicit BraftLogIterator(braft::Iterator& iter) : iter_(iter) {}
+  ~BraftLogIterator() override = default;
+
+  bool Valid() const override { return iter_.valid(); }
+  void Next() override { iter_.next(); }
+  int64_t Index() const override { return iter_.index(); }
+  int64_t Term() const override { return iter_.term(); }
+  const butil::IOBuf& Data() const override { return iter_.data(); }
+  braft::Closure* Done() const override { return iter_.done(); }
+
+ private:
+  braft::Iterator& iter_;
+};
+
+}  // namespace
+
 void StoreStateMachine::on_apply(braft::Iterator& iter) {
+  BraftLogIterator log_iter(iter);
+  ApplyLogs(log_iter);
+}
+
+void StoreStateMachine::ApplyLogs(LogIterator& iter) {
   BAIDU_SCOPED_LOCK(apply_mutex_);
 
-  for (; iter.valid(); iter.next()) {
-    braft::AsyncClosureGuard done_guard(iter.done());
+  ApplyLogBatch apply_batch(region_, raw_engine_, region_metrics_);
 
-    if (iter.index() <= applied_index_) {
+  for (; iter.Valid(); iter.Next()) {
+    if (iter.Index() <= applied_index_) {
+      braft::AsyncClosureGuard done_guard(iter.Done());
       continue;
     }
 
-    // Region is STANDBY state, wait to apply.
-    while (region_->State() == pb::common::StoreRegionState::STANDBY) {
-      DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] region is standby for spliting, waiting...",
-                                        region_->Id());
-      bthread_usleep(1000 * 1000);
-    }
-
     // Parse raft command
     auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-    if (iter.done()) {
-      BaseClosure* store_closure = dynamic_cast<BaseClosure*>(iter.done());
+    BaseClosure* store_closure = dynamic_cast<BaseClosure*>(iter.Done());
+    if (store_closure != nullptr && store_closure->GetRequest() != nullptr) {
       raft_cmd = store_closure->GetRequest();
     } else {
-      butil::IOBufAsZeroCopyInputStream wrapper(iter.data());
+      butil::IOBufAsZeroCopyInputStream wrapper(iter.Data());
       CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper));
     }
 
-    bool need_apply = true;
-    // Check region state
-    auto region_state = region_->State();
-    if (region_state == pb::common::StoreRegionState::DELETING ||
-        region_state == pb::common::StoreRegionState::DELETED ||
-        region_state == pb::common::StoreRegionState::TOMBSTONE) {
-      std::string s = fmt::format("Region({}) is {} state, abandon apply log", region_->Id(),
-                                  pb::common::StoreRegionState_Name(region_state));
-      DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] {}", region_->Id(), s);
-
-      auto* done = dynamic_cast<BaseClosure*>(iter.done());
-      auto ctx = done ? done->GetCtx() : nullptr;
-      if (ctx != nullptr) {
-        ctx->SetStatus(butil::Status(pb::error::EREGION_UNAVAILABLE, s));
-      }
-      need_apply = false;
-    }
+    ApplyLog(apply_batch, raft_cmd, iter.Done(), iter.Term(), iter.Index());
+  }
 
-    // Check region epoch
-    if (need_apply && !Helper::IsEqualRegionEpoch(raft_cmd->header().epoch(), region_->Epoch())) {
-      std::string s = fmt::format("Region({}) epoch is not match, region_epoch({}) raft_cmd_epoch({})", region_->Id(),
-                                  region_->EpochToString(), Helper::RegionEpochToString(raft_cmd->header().epoch()));
-      DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] {}", region_->Id(), s);
+  FlushApplyLogBatch(apply_batch);
+}
 
-      auto* done = dynamic_cast<BaseClosure*>(iter.done());
-      auto ctx = done ? done->GetCtx() : nullptr;
-      if (ctx != nullptr) {
-        ctx->SetStatus(butil::Status(pb::error::EREGION_VERSION, s));
-      }
-      need_apply = false;
+void StoreStateMachine::ApplyLog(ApplyLogBatch& apply_batch, std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd,
+                                 braft::Closure* done, int64_t term, int64_t index) {
+  braft::AsyncClosureGuard done_guard(done);
+
+  // Region is STANDBY state, wait to apply.
+  while (region_->State() == pb::common::StoreRegionState::STANDBY) {
+    DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] region is standby for spliting, waiting...",
+                                      region_->Id());
+    bthread_usleep(1000 * 1000);
+  }
+
+  auto* store_closure = dynamic_cast<BaseClosure*>(done);
+  auto ctx = store_closure ? store_closure->GetCtx() : nullptr;
+
+  bool need_apply = true;
+  // Check region state
+  auto region_state = region_->State();
+  if (region_state == pb::common::StoreRegionState::DELETING ||
+      region_state == pb::common::StoreRegionState::DELETED ||
+      region_state == pb::common::StoreRegionState::TOMBSTONE) {
+    std::string s = fmt::format("Region({}) is {} state, abandon apply log", region_->Id(),
+                                pb::common::StoreRegionState_Name(region_state));
+    DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] {}", region_->Id(), s);
+
+    if (ctx != nullptr) {
+      ctx->SetStatus(butil::Status(pb::error::EREGION_UNAVAILABLE, s));
     }
+    need_apply = false;
+  }
 
-    DINGO_LOG(DEBUG) << fmt::format(
-        "[raft.sm][region({}).epoch({})] apply log {}:{} applied_index({}) cmd_type({})",
-        raft_cmd->header().region_id(), Helper::RegionEpochToString(raft_cmd->header().epoch()), iter.term(),
-        iter.index(), applied_index_,
-        raft_cmd->requests().empty() ? "" : pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
+  // Check region epoch
+  if (need_apply && !Helper::IsEqualRegionEpoch(raft_cmd->header().epoch(), region_->Epoch())) {
+    std::string s = fmt::format("Region({}) epoch is not match, region_epoch({}) raft_cmd_epoch({})", region_->Id(),
+                                region_->EpochToString(), Helper::RegionEpochToString(raft_cmd->header().epoch()));
+    DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] {}", region_->Id(), s);
 
-    if (need_apply) {
-      // Build event
-      auto event = std::make_shared<SmApplyEvent>();
-      event->region = region_;
-      event->engine = raw_engine_;
-      event->done = iter.done();
-      event->raft_cmd = raft_cmd;
-      event->region_metrics = region_metrics_;
-      event->term_id = iter.term();
-      event->log_id = iter.index();
+    if (ctx != nullptr) {
+      ctx->SetStatus(butil::Status(pb::error::EREGION_VERSION, s));
+    }
+    need_apply = false;
+  }
 
-      DispatchEvent(EventType::kSmApply, event);
+  DINGO_LOG(DEBUG) << fmt::format(
+      "[raft.sm][region({}).epoch({})] apply log {}:{} applied_index({}) cmd_type({})", raft_cmd->header().region_id(),
+      Helper::RegionEpochToString(raft_cmd->header().epoch()), term, index, applied_index_,
+      raft_cmd->requests().empty() ? "" : pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
+
+  // Consecutive write log is coalesced into one engine write batch.
+  if (need_apply && FLAGS_enable_raft_apply_log_batch && ApplyLogBatch::IsBatchable(*raft_cmd)) {
+    apply_batch.Add(done_guard.release(), ctx, raft_cmd, term, index);
+    if (static_cast<int64_t>(apply_batch.LogCount()) >= FLAGS_raft_apply_log_batch_max_count) {
+      FlushApplyLogBatch(apply_batch);
     }
+    return;
+  }
 
-    applied_term_ = iter.term();
-    applied_index_ = iter.index();
-    raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+  // Keep apply order, the pending batch must be written before this log.
+  FlushApplyLogBatch(apply_batch);
 
-    // bvar metrics
-    StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+  if (need_apply) {
+    // Build event
+    auto event = std::make_shared<SmApplyEvent>();
+    event->region = region_;
+    event->engine = raw_engine_;
+    event->done = done;
+    event->raft_cmd = raft_cmd;
+    event->region_metrics = region_metrics_;
+    event->term_id = term;
+    event->log_id = index;
 
-    // Persistence applied index
-    // If operation is idempotent, it's ok.
-    // If not, must be stored with the data.
-    if (applied_index_ % kSaveAppliedIndexStep == 0) {
-      Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
-    }
+    DispatchEvent(EventType::kSmApply, event);
   }
+
+  AdvanceAppliedIndex(term, index);
 }
 
 int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>& entries) {
@@ -209,17 +276,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
 
       DispatchEvent(EventType::kSmApply, event);
 
-      applied_term_ = entry.term();
-      applied_index_ = entry.index();
-
-      raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
-
-      // bvar metrics
-      StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
-
-      if (applied_index_ % kSaveAppliedIndexStep == 0) {
-        Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
-      }
+      AdvanceAppliedIndex(entry.term(), entry.index());
 
       ++actual_apply_log_count;
     }
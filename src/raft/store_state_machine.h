@@ -34,6 +34,7 @@
 namespace dingodb {
 
 struct SnapshotContext;
+class ApplyLogBatch;
 
 // Execute order on restart: on_snapshot_load
 //                           on_configuration_committed
@@ -41,6 +42,19 @@ struct SnapshotContext;
 //                           on_apply
 class StoreStateMachine : public BaseStateMachine {
  public:
+  // Committed logs to apply, on_apply wraps braft::Iterator into it.
+  class LogIterator {
+   public:
+    virtual ~LogIterator() = default;
+
+    virtual bool Valid() const = 0;
+    virtual void Next() = 0;
+    virtual int64_t Index() const = 0;
+    virtual int64_t Term() const = 0;
+    virtual const butil::IOBuf& Data() const = 0;
+    virtual braft::Closure* Done() const = 0;
+  };
+
   explicit StoreStateMachine(std::shared_ptr<RawEngine> engine, store::RegionPtr region, store::RaftMetaPtr raft_meta,
                              store::RegionMetricsPtr region_metrics,
                              std::shared_ptr<EventListenerCollection> listeners);
@@ -69,8 +83,19 @@ class StoreStateMachine : public BaseStateMachine {
   std::shared_ptr<SnapshotContext> MakeSnapshotContext();
 
  private:
+  friend class StoreStateMachineTest;
+
   int DispatchEvent(dingodb::EventType, std::shared_ptr<dingodb::Event> event);
 
+  // Apply the committed logs of on_apply.
+  void ApplyLogs(LogIterator& iter);
+  // Apply one committed log, take the ownership of done.
+  void ApplyLog(ApplyLogBatch& apply_batch, std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd, braft::Closure* done,
+                int64_t term, int64_t index);
+  // Update applied term/index, persist it every few logs.
+  void AdvanceAppliedIndex(int64_t term, int64_t index);
+  void FlushApplyLogBatch(ApplyLogBatch& apply_batch);
+
   store::RegionPtr region_;
   std::string str_node_id_;
   std::shared_ptr<RawEngine> raw_engine_;
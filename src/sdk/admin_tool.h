@@ -15,7 +15,10 @@
 #ifndef DINGODB_SDK_ADMIN_TOOL_H_
 #define DINGODB_SDK_ADMIN_TOOL_H_
 
+#include <memory>
+
 #include "sdk/coordinator_proxy.h"
+#include "sdk/tso_client.h"
 
 namespace dingodb {
 namespace sdk {
@@ -29,6 +32,7 @@ class AdminTool {
 
   ~AdminTool() = default;
 
+  // Concurrent calls are coalesced into one tso rpc by TsoClient.
   Status GetCurrentTsoTimeStamp(pb::meta::TsoTimestamp& tso_timestamp);
 
   Status GetCurrentTimeStamp(int64_t& timestamp);
@@ -39,6 +43,7 @@ class AdminTool {
 
  private:
   std::shared_ptr<CoordinatorProxy> coordinator_proxy_;
+  TsoClient tso_client_;
 };
 
 }  // namespace sdk
@@ -32,6 +32,7 @@
 #include "sdk/client_stub.h"
 #include "sdk/common/param_config.h"
 #include "sdk/rawkv/raw_kv_impl.h"
+#include "sdk/rawkv/raw_kv_scanner_impl.h"
 #include "sdk/region_creator_internal_data.h"
 #include "sdk/status.h"
 #include "sdk/transaction/txn_impl.h"
@@ -191,6 +192,70 @@ Status RawKV::Scan(const std::string& start_key, const std::string& end_key, uin
   return impl_->Scan(start_key, end_key, limit, kvs);
 }
 
+void RawKV::AsyncGet(const std::string& key, std::string& value, StatusCallback cb) {
+  impl_->AsyncGet(key, value, std::move(cb));
+}
+
+void RawKV::AsyncBatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& kvs, StatusCallback cb) {
+  impl_->AsyncBatchGet(keys, kvs, std::move(cb));
+}
+
+void RawKV::AsyncPut(const std::string& key, const std::string& value, StatusCallback cb) {
+  impl_->AsyncPut(key, value, std::move(cb));
+}
+
+void RawKV::AsyncBatchPut(const std::vector<KVPair>& kvs, StatusCallback cb) {
+  impl_->AsyncBatchPut(kvs, std::move(cb));
+}
+
+void RawKV::AsyncPutIfAbsent(const std::string& key, const std::string& value, bool& state, StatusCallback cb) {
+  impl_->AsyncPutIfAbsent(key, value, state, std::move(cb));
+}
+
+void RawKV::AsyncBatchPutIfAbsent(const std::vector<KVPair>& kvs, std::vector<KeyOpState>& states,
+                                  StatusCallback cb) {
+  impl_->AsyncBatchPutIfAbsent(kvs, states, std::move(cb));
+}
+
+void RawKV::AsyncDelete(const std::string& key, StatusCallback cb) { impl_->AsyncDelete(key, std::move(cb)); }
+
+void RawKV::AsyncBatchDelete(const std::vector<std::string>& keys, StatusCallback cb) {
+  impl_->AsyncBatchDelete(keys, std::move(cb));
+}
+
+void RawKV::AsyncCompareAndSet(const std::string& key, const std::string& value, const std::string& expected_value,
+                               bool& state, StatusCallback cb) {
+  impl_->AsyncCompareAndSet(key, value, expected_value, state, std::move(cb));
+}
+
+void RawKV::AsyncBatchCompareAndSet(const std::vector<KVPair>& kvs, const std::vector<std::string>& expected_values,
+                                    std::vector<KeyOpState>& states, StatusCallback cb) {
+  impl_->AsyncBatchCompareAndSet(kvs, expected_values, states, std::move(cb));
+}
+
+void RawKV::AsyncScan(const std::string& start_key, const std::string& end_key, uint64_t limit,
+                      std::vector<KVPair>& kvs, StatusCallback cb) {
+  impl_->AsyncScan(start_key, end_key, limit, kvs, std::move(cb));
+}
+
+Status RawKV::NewScanner(const std::string& start_key, const std::string& end_key, const ScanOptions& options,
+                         std::shared_ptr<RawKVScanner>& scanner) {
+  std::unique_ptr<RawKVScanner::RawKVScannerImpl> scanner_impl(
+      new RawKVScanner::RawKVScannerImpl(impl_->GetStub(), start_key, end_key, options));
+  DINGO_RETURN_NOT_OK(scanner_impl->Open());
+
+  scanner.reset(new RawKVScanner(scanner_impl.release()));
+  return Status::OK();
+}
+
+RawKVScanner::RawKVScanner(RawKVScannerImpl* impl) : impl_(impl) {}
+
+RawKVScanner::~RawKVScanner() { impl_.reset(nullptr); }
+
+bool RawKVScanner::HasMore() { return impl_->HasMore(); }
+
+Status RawKVScanner::Next(KVPair& kv) { return impl_->Next(kv); }
+
 Transaction::Transaction(TxnImpl* impl) : impl_(impl) {}
 
 Transaction::~Transaction() { impl_.reset(nullptr); }
@@ -228,6 +293,12 @@ Status Transaction::Commit() { return impl_->Commit(); }
 
 Status Transaction::Rollback() { return impl_->Rollback(); }
 
+void Transaction::AsyncPreCommit(StatusCallback cb) { impl_->AsyncPreCommit(std::move(cb)); }
+
+void Transaction::AsyncCommit(StatusCallback cb) { impl_->AsyncCommit(std::move(cb)); }
+
+void Transaction::AsyncRollback(StatusCallback cb) { impl_->AsyncRollback(std::move(cb)); }
+
 RegionCreator::RegionCreator(Data* data) : data_(data) {}
 
 RegionCreator::~RegionCreator() = default;
@@ -22,11 +22,13 @@
 #include <vector>
 
 #include "sdk/status.h"
+#include "sdk/utils/callback.h"
 
 namespace dingodb {
 namespace sdk {
 
 class RawKV;
+class RawKVScanner;
 class RegionCreator;
 class TestBase;
 class TransactionOptions;
@@ -85,6 +87,19 @@ struct KeyOpState {
   bool state;
 };
 
+struct ScanOptions {
+  // kvs fetched by one rpc, 0 means use the default
+  int64_t batch_size{0};
+  // batches fetched ahead of the caller for each region, at least 1
+  int64_t prefetch_batch_num{4};
+  // stop fetching ahead when the fetched but not consumed kvs exceed this size
+  int64_t max_buffer_bytes{64 * 1024 * 1024};
+  // regions scanned at the same time, at least 1
+  int64_t parallel_region_num{1};
+  // when false, kvs of different regions may interleave, kvs of the same region are always in key order
+  bool ordered{true};
+};
+
 class RawKV : public std::enable_shared_from_this<RawKV> {
  public:
   RawKV(const RawKV&) = delete;
@@ -127,6 +142,42 @@ class RawKV : public std::enable_shared_from_this<RawKV> {
   // limit: 0 means no limit, will scan all key in [start_key, end_key)
   Status Scan(const std::string& start_key, const std::string& end_key, uint64_t limit, std::vector<KVPair>& out_kvs);
 
+  // Async version of above, cb is called with the same status as the sync one when the op is done,
+  // maybe in the caller thread when params check fail.
+  // NOTE: Caller must keep all params and out params valid until cb is called, and the out params
+  // are only set before cb is called.
+  void AsyncGet(const std::string& key, std::string& out_value, StatusCallback cb);
+
+  void AsyncBatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& out_kvs, StatusCallback cb);
+
+  void AsyncPut(const std::string& key, const std::string& value, StatusCallback cb);
+
+  void AsyncBatchPut(const std::vector<KVPair>& kvs, StatusCallback cb);
+
+  void AsyncPutIfAbsent(const std::string& key, const std::string& value, bool& out_state, StatusCallback cb);
+
+  void AsyncBatchPutIfAbsent(const std::vector<KVPair>& kvs, std::vector<KeyOpState>& out_states,
+                             StatusCallback cb);
+
+  void AsyncDelete(const std::string& key, StatusCallback cb);
+
+  void AsyncBatchDelete(const std::vector<std::string>& keys, StatusCallback cb);
+
+  void AsyncCompareAndSet(const std::string& key, const std::string& value, const std::string& expected_value,
+                          bool& out_state, StatusCallback cb);
+
+  void AsyncBatchCompareAndSet(const std::vector<KVPair>& kvs, const std::vector<std::string>& expected_values,
+                               std::vector<KeyOpState>& out_states, StatusCallback cb);
+
+  void AsyncScan(const std::string& start_key, const std::string& end_key, uint64_t limit,
+                 std::vector<KVPair>& out_kvs, StatusCallback cb);
+
+  // Iterate kvs in [start_key, end_key) without collecting them into memory, the next batches are fetched
+  // in background while caller is processing current kvs.
+  // NOTE: Caller must keep client valid until the scanner is destroyed.
+  Status NewScanner(const std::string& start_key, const std::string& end_key, const ScanOptions& options,
+                    std::shared_ptr<RawKVScanner>& out_scanner);
+
  private:
   friend class Client;
 
@@ -137,6 +188,29 @@ class RawKV : public std::enable_shared_from_this<RawKV> {
   explicit RawKV(RawKVImpl* impl);
 };
 
+class RawKVScanner {
+ public:
+  RawKVScanner(const RawKVScanner&) = delete;
+  const RawKVScanner& operator=(const RawKVScanner&) = delete;
+
+  ~RawKVScanner();
+
+  // Return true if Next will return a kv or the scan fail, it maybe wait for the in flight batches.
+  bool HasMore();
+
+  // Caller should check HasMore before Next, return NotFound if there is no more kv.
+  Status Next(KVPair& out_kv);
+
+ private:
+  friend class RawKV;
+
+  // own
+  class RawKVScannerImpl;
+  std::unique_ptr<RawKVScannerImpl> impl_;
+
+  explicit RawKVScanner(RawKVScannerImpl* impl);
+};
+
 enum TransactionKind : uint8_t { kOptimistic, kPessimistic };
 
 enum TransactionIsolation : uint8_t { kSnapshotIsolation, kReadCommitted };
@@ -184,6 +258,15 @@ class Transaction : public std::enable_shared_from_this<Transaction> {
 
   Status Rollback();
 
+  // Async version of above, cb is called with the same status as the sync one when the op is done.
+  // NOTE: Caller must keep txn valid until cb is called, and must not issue other op on the same txn
+  // before cb is called.
+  void AsyncPreCommit(StatusCallback cb);
+
+  void AsyncCommit(StatusCallback cb);
+
+  void AsyncRollback(StatusCallback cb);
+
  private:
   friend class Client;
   friend class TestBase;
@@ -44,6 +44,12 @@ const int64_t kCoordinatorInteractionMaxRetry = 3;
 
 const int64_t kTxnOpMaxRetry = 2;
 
+// max region sub tasks of one txn running at the same time, include the calling thread
+const int64_t kTxnMaxSubTaskConcurrency = 16;
+
+// max tso count of one rpc, the concurrent tso requests are coalesced into one rpc
+const int64_t kTsoBatchMaxSize = 1024;
+
 const int64_t kExecutorThreadNum = 8;
 
 const int64_t kRawkvBackoffMs = 200;
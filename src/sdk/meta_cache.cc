@@ -14,7 +14,14 @@
 
 #include "sdk/meta_cache.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "common/logging.h"
 #include "glog/logging.h"
@@ -26,20 +33,24 @@ namespace sdk {
 
 using pb::coordinator::ScanRegionInfo;
 
+// coordinator treats range_end "\0" as the max key
+static const std::string kScanRegionsMaxKey(1, '\0');
+
+static std::atomic<int64_t> meta_cache_id_generator(0);
+
 MetaCache::MetaCache(std::shared_ptr<CoordinatorProxy> coordinator_proxy)
-    : coordinator_proxy_(std::move(coordinator_proxy)) {}
+    : coordinator_proxy_(std::move(coordinator_proxy)),
+      cache_id_(meta_cache_id_generator.fetch_add(1) + 1),
+      snapshot_(std::make_shared<const RegionSnapshot>()),
+      snapshot_version_(1) {}
 
 MetaCache::~MetaCache() = default;
 
 Status MetaCache::LookupRegionByKey(std::string_view key, std::shared_ptr<Region>& region) {
   CHECK(!key.empty()) << "key should not empty";
-  Status s;
-  {
-    std::shared_lock<std::shared_mutex> r(rw_lock_);
-    s = FastLookUpRegionByKeyUnlocked(key, region);
-    if (s.IsOK()) {
-      return s;
-    }
+  Status s = FastLookUpRegionByKey(key, region);
+  if (s.IsOK()) {
+    return s;
   }
 
   s = SlowLookUpRegionByKey(key, region);
@@ -50,13 +61,9 @@ Status MetaCache::LookupRegionBetweenRange(std::string_view start_key, std::stri
                                            std::shared_ptr<Region>& region) {
   CHECK(!start_key.empty()) << "start_key should not empty";
   CHECK(!end_key.empty()) << "end_key should not empty";
-  Status s;
-  {
-    std::shared_lock<std::shared_mutex> r(rw_lock_);
-    s = FastLookUpRegionByKeyUnlocked(start_key, region);
-    if (s.IsOK()) {
-      return s;
-    }
+  Status s = FastLookUpRegionByKey(start_key, region);
+  if (s.IsOK()) {
+    return s;
   }
 
   std::vector<std::shared_ptr<Region>> regions;
@@ -72,13 +79,9 @@ Status MetaCache::LookupRegionBetweenRangeNoPrefetch(std::string_view start_key,
                                                      std::shared_ptr<Region>& region) {
   CHECK(!start_key.empty()) << "start_key should not empty";
   CHECK(!end_key.empty()) << "end_key should not empty";
-  Status s;
-  {
-    std::shared_lock<std::shared_mutex> r(rw_lock_);
-    s = FastLookUpRegionByKeyUnlocked(start_key, region);
-    if (s.IsOK()) {
-      return s;
-    }
+  Status s = FastLookUpRegionByKey(start_key, region);
+  if (s.IsOK()) {
+    return s;
   }
 
   std::vector<std::shared_ptr<Region>> regions;
@@ -119,12 +122,14 @@ void MetaCache::ClearRange(const std::shared_ptr<Region>& region) {
   } else {
     CHECK(iter != region_by_id_.end());
     RemoveRegionUnlocked(region->RegionId());
+    PublishSnapshotUnlocked();
   }
 }
 
 void MetaCache::MaybeAddRegion(const std::shared_ptr<Region>& new_region) {
   std::unique_lock<std::shared_mutex> w(rw_lock_);
   MaybeAddRegionUnlocked(new_region);
+  PublishSnapshotUnlocked();
 }
 
 void MetaCache::MaybeAddRegionUnlocked(const std::shared_ptr<Region>& new_region) {
@@ -145,17 +150,55 @@ void MetaCache::MaybeAddRegionUnlocked(const std::shared_ptr<Region>& new_region
   AddRangeToCacheUnlocked(new_region);
 }
 
-Status MetaCache::FastLookUpRegionByKeyUnlocked(std::string_view key, std::shared_ptr<Region>& region) {
-  auto iter = region_by_key_.upper_bound(key);
-  if (iter == region_by_key_.begin()) {
+const MetaCache::RegionSnapshot* MetaCache::GetSnapshot() {
+  struct ThreadSnapshot {
+    int64_t cache_id{0};
+    uint64_t version{0};
+    std::shared_ptr<const RegionSnapshot> snapshot;
+  };
+  thread_local ThreadSnapshot local;
+
+  uint64_t version = snapshot_version_.load(std::memory_order_acquire);
+  if (local.cache_id != cache_id_ || local.version != version) {
+    // snapshot is published before version, so it's at least as new as version
+    local.snapshot = std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+    local.cache_id = cache_id_;
+    local.version = version;
+  }
+
+  return local.snapshot.get();
+}
+
+void MetaCache::PublishSnapshotUnlocked() {
+  auto snapshot = std::make_shared<RegionSnapshot>();
+  snapshot->start_keys.reserve(region_by_key_.size());
+  snapshot->regions.reserve(region_by_key_.size());
+  for (const auto& entry : region_by_key_) {
+    snapshot->start_keys.push_back(entry.first);
+    snapshot->regions.push_back(entry.second);
+  }
+
+  std::atomic_store_explicit(&snapshot_, std::shared_ptr<const RegionSnapshot>(std::move(snapshot)),
+                             std::memory_order_release);
+  snapshot_version_.fetch_add(1, std::memory_order_release);
+}
+
+Status MetaCache::FastLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region) {
+  const RegionSnapshot* snapshot = GetSnapshot();
+  const auto& start_keys = snapshot->start_keys;
+  auto iter = std::upper_bound(start_keys.begin(), start_keys.end(), key,
+                               [](std::string_view key, const std::string& start_key) { return key < start_key; });
+  if (iter == start_keys.begin()) {
     return Status::NotFound(fmt::format("not found region for key:{}", key));
   }
 
-  iter--;
-  auto found_region = iter->second;
-  CHECK(!found_region->IsStale());
+  const auto& found_region = snapshot->regions[iter - start_keys.begin() - 1];
+  if (found_region->IsStale()) {
+    // removed after the snapshot is taken, the newer snapshot is publishing
+    return Status::NotFound(fmt::format("found region:{} for key:{} is stale", found_region->RegionId(), key));
+  }
 
-  auto range = found_region->Range();
+  const auto& range = found_region->Range();
   CHECK(key >= range.start_key());
 
   if (key >= range.end_key()) {
@@ -172,16 +215,65 @@ Status MetaCache::FastLookUpRegionByKeyUnlocked(std::string_view key, std::share
   }
 }
 
+std::string MetaCache::NextCachedStartKey(std::string_view key) {
+  const RegionSnapshot* snapshot = GetSnapshot();
+  const auto& start_keys = snapshot->start_keys;
+  auto iter = std::upper_bound(start_keys.begin(), start_keys.end(), key,
+                               [](std::string_view key, const std::string& start_key) { return key < start_key; });
+  return iter == start_keys.end() ? std::string() : *iter;
+}
+
 Status MetaCache::SlowLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region) {
+  std::string end_key = NextCachedStartKey(key);
+
+  std::shared_ptr<InflightLookup> inflight;
+  {
+    std::unique_lock<std::mutex> lk(inflight_mutex_);
+    std::shared_ptr<InflightLookup> waiting;
+    auto iter = inflight_lookups_.upper_bound(key);
+    if (iter != inflight_lookups_.begin()) {
+      iter--;
+      if (iter->second->end_key.empty() || key < iter->second->end_key) {
+        waiting = iter->second;
+      }
+    }
+
+    if (waiting != nullptr) {
+      while (!waiting->done) {
+        inflight_cv_.wait(lk);
+      }
+    } else {
+      inflight = std::make_shared<InflightLookup>();
+      inflight->end_key = end_key;
+      CHECK(inflight_lookups_.emplace(std::string(key), inflight).second);
+    }
+  }
+
+  if (inflight == nullptr) {
+    // the region maybe fetched by the lookup we waited, otherwise fetch it by ourself
+    if (FastLookUpRegionByKey(key, region).IsOK()) {
+      return Status::OK();
+    }
+  }
+
   pb::coordinator::ScanRegionsRequest request;
   pb::coordinator::ScanRegionsResponse response;
   request.set_key(std::string(key));
-  Status send = SendScanRegionsRequest(request, response);
-  if (!send.IsOK()) {
-    return send;
+  request.set_range_end(end_key.empty() ? kScanRegionsMaxKey : end_key);
+  request.set_limit(kPrefetchRegionCount);
+  Status s = SendScanRegionsRequest(request, response);
+  if (s.IsOK()) {
+    s = ProcessScanRegionsByKeyResponse(response, key, region);
+  }
+
+  if (inflight != nullptr) {
+    std::unique_lock<std::mutex> lk(inflight_mutex_);
+    inflight->done = true;
+    inflight_lookups_.erase(inflight_lookups_.find(key));
+    inflight_cv_.notify_all();
   }
 
-  return ProcessScanRegionsByKeyResponse(response, region);
+  return s;
 }
 
 Status MetaCache::SendScanRegionsRequest(const pb::coordinator::ScanRegionsRequest& request,
@@ -190,45 +282,27 @@ Status MetaCache::SendScanRegionsRequest(const pb::coordinator::ScanRegionsReque
 }
 
 Status MetaCache::ProcessScanRegionsByKeyResponse(const pb::coordinator::ScanRegionsResponse& response,
-                                                  std::shared_ptr<Region>& region) {
-  if (response.regions_size() > 0) {
-    CHECK(response.regions_size() == 1) << "expect ScanRegionsResponse  has one region";
+                                                  std::string_view key, std::shared_ptr<Region>& region) {
+  std::vector<std::shared_ptr<Region>> regions;
+  AddScanRegionsToCache(response, regions);
 
-    const auto& scan_region_info = response.regions(0);
-    std::shared_ptr<Region> new_region;
-    ProcessScanRegionInfo(scan_region_info, new_region);
-    {
-      std::unique_lock<std::shared_mutex> w(rw_lock_);
-      MaybeAddRegionUnlocked(new_region);
-      auto iter = region_by_id_.find(scan_region_info.region_id());
-      CHECK(iter != region_by_id_.end());
-      CHECK(iter->second.get() != nullptr);
-      region = iter->second;
+  for (const auto& tmp : regions) {
+    const auto& range = tmp->Range();
+    if (key >= range.start_key() && key < range.end_key()) {
+      region = tmp;
+      return Status::OK();
     }
-    return Status::OK();
-  } else {
-    DINGO_LOG(WARNING) << "response:" << response.DebugString();
-    return Status::NotFound("region not found");
   }
+
+  DINGO_LOG(WARNING) << "not found region for key:" << key << ", response:" << response.DebugString();
+  return Status::NotFound("region not found");
 }
 
 Status MetaCache::ProcessScanRegionsBetweenRangeResponse(const pb::coordinator::ScanRegionsResponse& response,
                                                          std::vector<std::shared_ptr<Region>>& regions) {
   if (response.regions_size() > 0) {
     std::vector<std::shared_ptr<Region>> tmp_regions;
-
-    for (const auto& scan_region_info : response.regions()) {
-      std::shared_ptr<Region> new_region;
-      ProcessScanRegionInfo(scan_region_info, new_region);
-      {
-        std::unique_lock<std::shared_mutex> w(rw_lock_);
-        MaybeAddRegionUnlocked(new_region);
-        auto iter = region_by_id_.find(scan_region_info.region_id());
-        CHECK(iter != region_by_id_.end());
-        CHECK(iter->second.get() != nullptr);
-        tmp_regions.push_back(iter->second);
-      }
-    }
+    AddScanRegionsToCache(response, tmp_regions);
 
     CHECK(!tmp_regions.empty());
     regions = std::move(tmp_regions);
@@ -240,6 +314,31 @@ Status MetaCache::ProcessScanRegionsBetweenRangeResponse(const pb::coordinator::
   }
 }
 
+void MetaCache::AddScanRegionsToCache(const pb::coordinator::ScanRegionsResponse& response,
+                                      std::vector<std::shared_ptr<Region>>& regions) {
+  if (response.regions_size() == 0) {
+    return;
+  }
+
+  std::vector<std::shared_ptr<Region>> new_regions;
+  new_regions.reserve(response.regions_size());
+  for (const auto& scan_region_info : response.regions()) {
+    std::shared_ptr<Region> new_region;
+    ProcessScanRegionInfo(scan_region_info, new_region);
+    new_regions.push_back(std::move(new_region));
+  }
+
+  std::unique_lock<std::shared_mutex> w(rw_lock_);
+  for (const auto& new_region : new_regions) {
+    MaybeAddRegionUnlocked(new_region);
+    auto iter = region_by_id_.find(new_region->RegionId());
+    CHECK(iter != region_by_id_.end());
+    CHECK(iter->second.get() != nullptr);
+    regions.push_back(iter->second);
+  }
+  PublishSnapshotUnlocked();
+}
+
 // TODO: check region state
 void MetaCache::ProcessScanRegionInfo(const ScanRegionInfo& scan_region_info, std::shared_ptr<Region>& region) {
   int64_t region_id = scan_region_info.region_id();
@@ -15,10 +15,15 @@
 #ifndef DINGODB_SDK_META_CACHE_H_
 #define DINGODB_SDK_META_CACHE_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -62,27 +67,56 @@ class MetaCache {
   void MaybeAddRegion(const std::shared_ptr<Region>& new_region);
 
   Status TEST_FastLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region) {  // NOLINT
-    std::shared_lock<std::shared_mutex> r(rw_lock_);
-    return FastLookUpRegionByKeyUnlocked(key, region);
+    return FastLookUpRegionByKey(key, region);
   }
 
   void Dump();
 
  private:
+  // Immutable copy of region_by_key_, looked up without lock.
+  struct RegionSnapshot {
+    // sorted start keys, start_keys[i] is the start key of regions[i]
+    std::vector<std::string> start_keys;
+    std::vector<std::shared_ptr<Region>> regions;
+  };
+
+  // Misses of keys in [start_key, end_key) wait for the in flight lookup instead of sending another rpc.
+  struct InflightLookup {
+    // empty means no end
+    std::string end_key;
+    bool done{false};
+  };
+
+  // Return the snapshot kept by this thread, it's refreshed only when snapshot_version_ changed, so readers
+  // only read snapshot_version_ in common case. The returned snapshot is valid until next call in this thread.
+  const RegionSnapshot* GetSnapshot();
+
+  // Rebuild the snapshot from region_by_key_ and publish it, caller must hold write lock.
+  void PublishSnapshotUnlocked();
+
   // TODO: backoff when region not ready
+  // Fetch the region of key and the following regions until next cached region, concurrent misses in the
+  // same uncached range are coalesced into one ScanRegions rpc.
   Status SlowLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region);
 
-  Status FastLookUpRegionByKeyUnlocked(std::string_view key, std::shared_ptr<Region>& region);
+  Status FastLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region);
+
+  // return the start key of the first cached region after key, empty if there is no such region
+  std::string NextCachedStartKey(std::string_view key);
 
   Status SendScanRegionsRequest(const pb::coordinator::ScanRegionsRequest& request,
                                 pb::coordinator::ScanRegionsResponse& response);
 
-  Status ProcessScanRegionsByKeyResponse(const pb::coordinator::ScanRegionsResponse& response,
+  Status ProcessScanRegionsByKeyResponse(const pb::coordinator::ScanRegionsResponse& response, std::string_view key,
                                          std::shared_ptr<Region>& region);
 
   Status ProcessScanRegionsBetweenRangeResponse(const pb::coordinator::ScanRegionsResponse& response,
                                                 std::vector<std::shared_ptr<Region>>& regions);
 
+  // add all regions of response into cache and publish snapshot once
+  void AddScanRegionsToCache(const pb::coordinator::ScanRegionsResponse& response,
+                             std::vector<std::shared_ptr<Region>>& regions);
+
   static void ProcessScanRegionInfo(const pb::coordinator::ScanRegionInfo& scan_region_info,
                                     std::shared_ptr<Region>& new_region);
 
@@ -105,6 +139,16 @@ class MetaCache {
   std::unordered_map<int64_t, std::shared_ptr<Region>> region_by_id_;
   // start-key -> region
   std::map<std::string, std::shared_ptr<Region>, std::less<void>> region_by_key_;
+
+  // unique id to tell the snapshot of this cache from others in thread local
+  const int64_t cache_id_;
+  std::shared_ptr<const RegionSnapshot> snapshot_;
+  std::atomic<uint64_t> snapshot_version_;
+
+  std::mutex inflight_mutex_;
+  std::condition_variable inflight_cv_;
+  // start-key -> in flight lookup
+  std::map<std::string, std::shared_ptr<InflightLookup>, std::less<void>> inflight_lookups_;
 };
 
 }  // namespace sdk
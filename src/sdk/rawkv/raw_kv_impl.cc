@@ -341,5 +341,69 @@ Status RawKV::RawKVImpl::Scan(const std::string& start_key, const std::string& e
   return Status::OK();
 }
 
+void RawKV::RawKVImpl::AsyncGet(const std::string& key, std::string& value, StatusCallback cb) {
+  AsyncRunTask<RawKvGetTask>(std::move(cb), key, value);
+}
+
+void RawKV::RawKVImpl::AsyncBatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& kvs,
+                                     StatusCallback cb) {
+  AsyncRunTask<RawKvBatchGetTask>(std::move(cb), keys, kvs);
+}
+
+void RawKV::RawKVImpl::AsyncPut(const std::string& key, const std::string& value, StatusCallback cb) {
+  AsyncRunTask<RawKvPutTask>(std::move(cb), key, value);
+}
+
+void RawKV::RawKVImpl::AsyncBatchPut(const std::vector<KVPair>& kvs, StatusCallback cb) {
+  AsyncRunTask<RawKvBatchPutTask>(std::move(cb), kvs);
+}
+
+void RawKV::RawKVImpl::AsyncPutIfAbsent(const std::string& key, const std::string& value, bool& state,
+                                        StatusCallback cb) {
+  AsyncRunTask<RawKvPutIfAbsentTask>(std::move(cb), key, value, state);
+}
+
+void RawKV::RawKVImpl::AsyncBatchPutIfAbsent(const std::vector<KVPair>& kvs, std::vector<KeyOpState>& states,
+                                             StatusCallback cb) {
+  AsyncRunTask<RawKvBatchPutIfAbsentTask>(std::move(cb), kvs, states);
+}
+
+void RawKV::RawKVImpl::AsyncDelete(const std::string& key, StatusCallback cb) {
+  AsyncRunTask<RawKvDeleteTask>(std::move(cb), key);
+}
+
+void RawKV::RawKVImpl::AsyncBatchDelete(const std::vector<std::string>& keys, StatusCallback cb) {
+  AsyncRunTask<RawKvBatchDeleteTask>(std::move(cb), keys);
+}
+
+void RawKV::RawKVImpl::AsyncCompareAndSet(const std::string& key, const std::string& value,
+                                          const std::string& expected_value, bool& state, StatusCallback cb) {
+  AsyncRunTask<RawKvCompareAndSetTask>(std::move(cb), key, value, expected_value, state);
+}
+
+void RawKV::RawKVImpl::AsyncBatchCompareAndSet(const std::vector<KVPair>& kvs,
+                                               const std::vector<std::string>& expected_values,
+                                               std::vector<KeyOpState>& states, StatusCallback cb) {
+  if (kvs.size() != expected_values.size()) {
+    cb(Status::InvalidArgument(
+        fmt::format("kvs size:{} must equal expected_values size:{}", kvs.size(), expected_values.size())));
+    return;
+  }
+  AsyncRunTask<RawKvBatchCompareAndSetTask>(std::move(cb), kvs, expected_values, states);
+}
+
+void RawKV::RawKVImpl::AsyncScan(const std::string& start_key, const std::string& end_key, uint64_t limit,
+                                 std::vector<KVPair>& kvs, StatusCallback cb) {
+  auto executor = stub_.GetExecutor();
+  bool ok = executor->Execute([this, &start_key, &end_key, limit, &kvs, cb]() {
+    cb(Scan(start_key, end_key, limit, kvs));
+  });
+  if (!ok) {
+    std::string msg = fmt::format("Fail execute scan, executor:{}", executor->Name());
+    DINGO_LOG(WARNING) << msg;
+    cb(Status::Aborted(msg));
+  }
+}
+
 }  // namespace sdk
 }  // namespace dingodb
\ No newline at end of file
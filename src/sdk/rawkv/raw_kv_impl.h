@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <utility>
 
 #include "proto/store.pb.h"
 #include "sdk/client.h"
@@ -24,6 +25,7 @@
 #include "sdk/meta_cache.h"
 #include "sdk/status.h"
 #include "sdk/region_scanner.h"
+#include "sdk/utils/callback.h"
 
 namespace dingodb {
 namespace sdk {
@@ -65,6 +67,34 @@ class RawKV::RawKVImpl {
   // TODO: maybe enable concurrent
   Status Scan(const std::string& start_key, const std::string& end_key,  uint64_t limit, std::vector<KVPair>& kvs);
 
+  void AsyncGet(const std::string& key, std::string& value, StatusCallback cb);
+
+  void AsyncBatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& kvs, StatusCallback cb);
+
+  void AsyncPut(const std::string& key, const std::string& value, StatusCallback cb);
+
+  void AsyncBatchPut(const std::vector<KVPair>& kvs, StatusCallback cb);
+
+  void AsyncPutIfAbsent(const std::string& key, const std::string& value, bool& state, StatusCallback cb);
+
+  void AsyncBatchPutIfAbsent(const std::vector<KVPair>& kvs, std::vector<KeyOpState>& states, StatusCallback cb);
+
+  void AsyncDelete(const std::string& key, StatusCallback cb);
+
+  void AsyncBatchDelete(const std::vector<std::string>& keys, StatusCallback cb);
+
+  void AsyncCompareAndSet(const std::string& key, const std::string& value, const std::string& expected_value,
+                          bool& state, StatusCallback cb);
+
+  void AsyncBatchCompareAndSet(const std::vector<KVPair>& kvs, const std::vector<std::string>& expected_values,
+                               std::vector<KeyOpState>& states, StatusCallback cb);
+
+  const ClientStub& GetStub() const { return stub_; }
+
+  // scan is sync inside, so run it on the sdk executor
+  void AsyncScan(const std::string& start_key, const std::string& end_key, uint64_t limit, std::vector<KVPair>& kvs,
+                 StatusCallback cb);
+
  private:
   struct SubBatchState {
     Rpc* rpc;
@@ -82,6 +112,14 @@ class RawKV::RawKVImpl {
 
   void ProcessSubBatchCompareAndSet(SubBatchState* sub);
 
+  // The task is owned by its callback, RawKvTask::FireCallback release the callback after it returns,
+  // so the task is deleted at the end of FireCallback on the thread which fires cb.
+  template <class TaskType, class... Args>
+  void AsyncRunTask(StatusCallback cb, Args&&... args) {
+    auto task = std::make_shared<TaskType>(stub_, std::forward<Args>(args)...);
+    task->AsyncRun([task, cb = std::move(cb)](const Status& status) { cb(status); });
+  }
+
   const ClientStub& stub_;
 };
 }  // namespace sdk
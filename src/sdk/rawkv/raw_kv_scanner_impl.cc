@@ -0,0 +1,298 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/rawkv/raw_kv_scanner_impl.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "sdk/client.h"
+#include "sdk/meta_cache.h"
+#include "sdk/status.h"
+
+namespace dingodb {
+namespace sdk {
+
+RawKVScanner::RawKVScannerImpl::RawKVScannerImpl(const ClientStub& stub, std::string start_key, std::string end_key,
+                                                 const ScanOptions& options)
+    : stub_(stub), start_key_(std::move(start_key)), end_key_(std::move(end_key)), options_(options) {
+  options_.prefetch_batch_num = std::max(options_.prefetch_batch_num, static_cast<int64_t>(1));
+  options_.parallel_region_num = std::max(options_.parallel_region_num, static_cast<int64_t>(1));
+}
+
+RawKVScanner::RawKVScannerImpl::~RawKVScannerImpl() {
+  std::unique_lock<std::mutex> lk(lock_);
+  closed_ = true;
+  while (pending_ > 0) {
+    cv_.wait(lk);
+  }
+}
+
+Status RawKVScanner::RawKVScannerImpl::Open() {
+  if (start_key_.empty() || end_key_.empty()) {
+    return Status::InvalidArgument("start_key and end_key must not empty, check params");
+  }
+
+  if (start_key_ >= end_key_) {
+    return Status::InvalidArgument("end_key must greater than start_key, check params");
+  }
+
+  std::vector<std::shared_ptr<Region>> regions;
+  Status ret = stub_.GetMetaCache()->ScanRegionsBetweenRange(start_key_, end_key_, 0, regions);
+  if (!ret.IsOK()) {
+    if (ret.IsNotFound()) {
+      DINGO_LOG(WARNING) << fmt::format("region not found between [{},{}), no need retry, status:{}", start_key_,
+                                        end_key_, ret.ToString());
+    } else {
+      DINGO_LOG(WARNING) << fmt::format("lookup region fail between [{},{}), need retry, status:{}", start_key_,
+                                        end_key_, ret.ToString());
+    }
+    return ret;
+  }
+
+  std::sort(regions.begin(), regions.end(), [](const std::shared_ptr<Region>& a, const std::shared_ptr<Region>& b) {
+    return a->Range().start_key() < b->Range().start_key();
+  });
+
+  std::unique_lock<std::mutex> lk(lock_);
+  for (auto& region : regions) {
+    regions_.push_back(std::make_unique<RegionState>(std::move(region)));
+  }
+  ActivateRegionsUnlocked();
+
+  DINGO_LOG(INFO) << fmt::format("scanner open between [{},{}), region num:{}, parallel:{}, ordered:{}", start_key_,
+                                 end_key_, regions_.size(), options_.parallel_region_num, options_.ordered);
+  return Status::OK();
+}
+
+bool RawKVScanner::RawKVScannerImpl::HasMore() {
+  if (cur_index_ < cur_kvs_.size()) {
+    return true;
+  }
+
+  if (!has_more_) {
+    return false;
+  }
+
+  Status ret = FillBatch();
+  // let Next return the fail status
+  return !ret.IsOK() || cur_index_ < cur_kvs_.size();
+}
+
+Status RawKVScanner::RawKVScannerImpl::Next(KVPair& kv) {
+  if (cur_index_ >= cur_kvs_.size() && has_more_) {
+    DINGO_RETURN_NOT_OK(FillBatch());
+  }
+
+  if (cur_index_ >= cur_kvs_.size()) {
+    return Status::NotFound("scanner has no more kv");
+  }
+
+  kv = std::move(cur_kvs_[cur_index_++]);
+  return Status::OK();
+}
+
+Status RawKVScanner::RawKVScannerImpl::FillBatch() {
+  std::vector<std::unique_ptr<RegionScanner>> done_scanners;
+
+  std::unique_lock<std::mutex> lk(lock_);
+  while (status_.IsOK()) {
+    // drop the finished regions and activate the following ones
+    for (auto iter = active_regions_.begin(); iter != active_regions_.end();) {
+      RegionState* state = *iter;
+      if (state->done && !state->fetching && state->batches.empty()) {
+        done_scanners.push_back(std::move(state->scanner));
+        iter = active_regions_.erase(iter);
+      } else {
+        iter++;
+      }
+    }
+    ActivateRegionsUnlocked();
+
+    if (active_regions_.empty()) {
+      has_more_ = false;
+      break;
+    }
+
+    // the first region maybe changed, which is allowed to fetch when ordered
+    for (auto* state : active_regions_) {
+      MaybeFetchUnlocked(state);
+    }
+
+    // only the first active region can be consumed when ordered
+    RegionState* picked = nullptr;
+    for (auto* state : active_regions_) {
+      if (!state->batches.empty()) {
+        picked = state;
+        break;
+      }
+      if (options_.ordered) {
+        break;
+      }
+    }
+
+    if (picked != nullptr) {
+      cur_kvs_ = std::move(picked->batches.front());
+      cur_index_ = 0;
+      picked->batches.pop_front();
+      buffered_bytes_ -= KvsBytes(cur_kvs_);
+
+      for (auto* state : active_regions_) {
+        MaybeFetchUnlocked(state);
+      }
+      break;
+    }
+
+    cv_.wait(lk);
+  }
+
+  Status ret = status_;
+  lk.unlock();
+
+  // release the region scanners out of lock
+  done_scanners.clear();
+  return ret;
+}
+
+void RawKVScanner::RawKVScannerImpl::ActivateRegionsUnlocked() {
+  while (static_cast<int64_t>(active_regions_.size()) < options_.parallel_region_num &&
+         next_region_index_ < regions_.size()) {
+    RegionState* state = regions_[next_region_index_++].get();
+    active_regions_.push_back(state);
+    MaybeFetchUnlocked(state);
+  }
+}
+
+bool RawKVScanner::RawKVScannerImpl::CanFetchUnlocked(RegionState* state) const {
+  if (closed_ || state->done || state->fetching ||
+      static_cast<int64_t>(state->batches.size()) >= options_.prefetch_batch_num) {
+    return false;
+  }
+
+  // the first region is always allowed when ordered, otherwise caller may wait for it forever
+  return buffered_bytes_ < options_.max_buffer_bytes || (options_.ordered && state == active_regions_.front());
+}
+
+void RawKVScanner::RawKVScannerImpl::MaybeFetchUnlocked(RegionState* state) {
+  if (!CanFetchUnlocked(state)) {
+    return;
+  }
+
+  state->fetching = true;
+  pending_++;
+  auto executor = stub_.GetExecutor();
+  bool ok = executor->Execute([this, state]() { DoFetch(state); });
+  if (!ok) {
+    std::string msg = fmt::format("Fail execute scan fetch, executor:{}", executor->Name());
+    DINGO_LOG(WARNING) << msg;
+    state->fetching = false;
+    state->done = true;
+    pending_--;
+    if (status_.IsOK()) {
+      status_ = Status::Aborted(msg);
+    }
+  }
+}
+
+Status RawKVScanner::RawKVScannerImpl::OpenRegionScanner(RegionState* state) {
+  // only scan the part of region within [start_key_, end_key_)
+  const auto& range = state->region->Range();
+  std::string start_key = std::max(start_key_, range.start_key());
+  std::string end_key = std::min(end_key_, range.end_key());
+
+  std::unique_ptr<RegionScanner> scanner;
+  CHECK(stub_.GetRegionScannerFactory()->NewRegionScanner(stub_, state->region, start_key, end_key, scanner).IsOK());
+  if (options_.batch_size > 0) {
+    scanner->SetBatchSize(options_.batch_size);
+  }
+
+  Status ret = scanner->Open();
+  if (!ret.IsOK()) {
+    DINGO_LOG(WARNING) << fmt::format("region scanner open fail, region:{}, status:{}", state->region->RegionId(),
+                                      ret.ToString());
+    return ret;
+  }
+
+  state->scanner = std::move(scanner);
+  return Status::OK();
+}
+
+// only one fetch of the region is in flight, so the region scanner and fetching_kvs are used without lock
+void RawKVScanner::RawKVScannerImpl::DoFetch(RegionState* state) {
+  if (state->scanner == nullptr) {
+    Status ret = OpenRegionScanner(state);
+    if (!ret.IsOK()) {
+      FetchDone(state, ret);
+      return;
+    }
+  }
+
+  if (!state->scanner->HasMore()) {
+    FetchDone(state, Status::OK());
+    return;
+  }
+
+  state->scanner->AsyncNextBatch(state->fetching_kvs,
+                                 [this, state](const Status& status) { FetchDone(state, status); });
+}
+
+void RawKVScanner::RawKVScannerImpl::FetchDone(RegionState* state, const Status& status) {
+  std::unique_lock<std::mutex> lk(lock_);
+  state->fetching = false;
+
+  if (!status.IsOK()) {
+    DINGO_LOG(WARNING) << fmt::format("region scanner fetch fail, region:{}, status:{}", state->region->RegionId(),
+                                      status.ToString());
+    state->done = true;
+    if (status_.IsOK()) {
+      // only return first fail status
+      status_ = status;
+    }
+  } else {
+    std::vector<KVPair> kvs;
+    kvs.swap(state->fetching_kvs);
+
+    if (state->scanner == nullptr || !state->scanner->HasMore()) {
+      state->done = true;
+    }
+
+    if (!kvs.empty()) {
+      buffered_bytes_ += KvsBytes(kvs);
+      state->batches.push_back(std::move(kvs));
+    }
+
+    MaybeFetchUnlocked(state);
+  }
+
+  pending_--;
+  cv_.notify_all();
+}
+
+int64_t RawKVScanner::RawKVScannerImpl::KvsBytes(const std::vector<KVPair>& kvs) {
+  int64_t bytes = 0;
+  for (const auto& kv : kvs) {
+    bytes += kv.key.size() + kv.value.size();
+  }
+  return bytes;
+}
+
+}  // namespace sdk
+}  // namespace dingodb
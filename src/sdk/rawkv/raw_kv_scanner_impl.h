@@ -0,0 +1,112 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_RAW_KV_SCANNER_IMPL_H_
+#define DINGODB_SDK_RAW_KV_SCANNER_IMPL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sdk/client.h"
+#include "sdk/client_stub.h"
+#include "sdk/region.h"
+#include "sdk/region_scanner.h"
+#include "sdk/status.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Scan the regions in [start_key, end_key) with RegionScanner, each active region keeps fetching the next batch on
+// the sdk executor until prefetch_batch_num batches are buffered or the buffered size reach max_buffer_bytes.
+// A region scanner only supports one rpc at the same time, so the batches of one region are fetched one by one,
+// and parallel_region_num regions are fetched at the same time.
+class RawKVScanner::RawKVScannerImpl {
+ public:
+  RawKVScannerImpl(const RawKVScannerImpl&) = delete;
+  const RawKVScannerImpl& operator=(const RawKVScannerImpl&) = delete;
+
+  explicit RawKVScannerImpl(const ClientStub& stub, std::string start_key, std::string end_key,
+                            const ScanOptions& options);
+
+  // wait the in flight rpc done
+  ~RawKVScannerImpl();
+
+  // check params, lookup the regions and start fetching
+  Status Open();
+
+  bool HasMore();
+
+  Status Next(KVPair& kv);
+
+ private:
+  struct RegionState {
+    explicit RegionState(std::shared_ptr<Region> p_region) : region(std::move(p_region)) {}
+
+    std::shared_ptr<Region> region;
+    // created and opened by the first fetch
+    std::unique_ptr<RegionScanner> scanner;
+    std::deque<std::vector<KVPair>> batches;
+    // filled by the in flight fetch
+    std::vector<KVPair> fetching_kvs;
+    bool fetching{false};
+    bool done{false};
+  };
+
+  // fill cur_kvs_ with next batch, wait if no batch is ready
+  Status FillBatch();
+
+  // start fetching regions until parallel_region_num regions are active
+  void ActivateRegionsUnlocked();
+  // post a fetch of the region to executor if it's allowed
+  void MaybeFetchUnlocked(RegionState* state);
+  bool CanFetchUnlocked(RegionState* state) const;
+
+  void DoFetch(RegionState* state);
+  Status OpenRegionScanner(RegionState* state);
+  void FetchDone(RegionState* state, const Status& status);
+
+  static int64_t KvsBytes(const std::vector<KVPair>& kvs);
+
+  const ClientStub& stub_;
+  const std::string start_key_;
+  const std::string end_key_;
+  ScanOptions options_;
+
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::vector<std::unique_ptr<RegionState>> regions_;
+  size_t next_region_index_{0};
+  // active regions in key order
+  std::deque<RegionState*> active_regions_;
+  int64_t buffered_bytes_{0};
+  // in flight fetch num
+  int64_t pending_{0};
+  bool closed_{false};
+  // first fail status of all regions
+  Status status_;
+
+  // only used by caller thread
+  std::vector<KVPair> cur_kvs_;
+  size_t cur_index_{0};
+  bool has_more_{true};
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+#endif  // DINGODB_SDK_RAW_KV_SCANNER_IMPL_H_
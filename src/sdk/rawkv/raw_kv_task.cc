@@ -85,7 +85,11 @@ void RawKvTask::FireCallback() {
   if (!status_.ok()) {
     DINGO_LOG(WARNING) << "Fail task:" << Name() << ", status:" << status_.ToString() << ", error_msg:" << ErrorMsg();
   }
-  call_back_(status_);
+
+  // The callback maybe own this task, release it after it returns, don't touch member after that.
+  StatusCallback cb;
+  cb.swap(call_back_);
+  cb(status_);
 }
 
 void RawKvTask::PostProcess() {}
@@ -31,6 +31,7 @@ class RawKvTask {
   virtual ~RawKvTask() = default;
 
   Status Run();
+  // cb can own this task, the task is released after cb returns.
   void AsyncRun(StatusCallback cb);
 
  protected:
@@ -103,6 +103,25 @@ void RegionScannerImpl::PrepareScanContinueRpc(KvScanContinueRpc& rpc) {
   request->set_max_fetch_cnt(batch_size_);
 }
 
+void RegionScannerImpl::ProcessScanContinueResponse(const KvScanContinueRpc& rpc, std::vector<KVPair>& kvs) {
+  const auto* response = rpc.Response();
+  std::vector<KVPair> tmp_kvs;
+  if (response->kvs_size() == 0) {
+    // scan to region end_key
+    has_more_ = false;
+  } else {
+    for (const auto& kv : response->kvs()) {
+      if (kv.key() < end_key_) {
+        tmp_kvs.push_back({kv.key(), kv.value()});
+      } else {
+        has_more_ = false;
+      }
+    }
+  }
+
+  kvs = std::move(tmp_kvs);
+}
+
 Status RegionScannerImpl::NextBatch(std::vector<KVPair>& kvs) {
   CHECK(opened_);
   CHECK(!scan_id_.empty());
@@ -112,22 +131,7 @@ Status RegionScannerImpl::NextBatch(std::vector<KVPair>& kvs) {
   StoreRpcController controller(stub, rpc, region);
   Status ret = controller.Call();
   if (ret.IsOK()) {
-    const auto* response = rpc.Response();
-    std::vector<KVPair> tmp_kvs;
-    if (response->kvs_size() == 0) {
-      // scan to region end_key
-      has_more_ = false;
-    } else {
-      for (const auto& kv : response->kvs()) {
-        if (kv.key() < end_key_) {
-          tmp_kvs.push_back({kv.key(), kv.value()});
-        } else {
-          has_more_ = false;
-        }
-      }
-    }
-
-    kvs = std::move(tmp_kvs);
+    ProcessScanContinueResponse(rpc, kvs);
   } else {
     DINGO_LOG(WARNING) << "scanner_id:" << scan_id_ << " scan continue fail region:" << region->RegionId()
                        << ", fail:" << ret.ToString();
@@ -136,6 +140,24 @@ Status RegionScannerImpl::NextBatch(std::vector<KVPair>& kvs) {
   return ret;
 }
 
+void RegionScannerImpl::AsyncNextBatch(std::vector<KVPair>& kvs, StatusCallback cb) {
+  CHECK(opened_);
+  CHECK(!scan_id_.empty());
+  continue_rpc_ = std::make_unique<KvScanContinueRpc>();
+  PrepareScanContinueRpc(*continue_rpc_);
+
+  continue_controller_ = std::make_unique<StoreRpcController>(stub, *continue_rpc_, region);
+  continue_controller_->AsyncCall([this, &kvs, cb = std::move(cb)](const Status& status) {
+    if (status.IsOK()) {
+      ProcessScanContinueResponse(*continue_rpc_, kvs);
+    } else {
+      DINGO_LOG(WARNING) << "scanner_id:" << scan_id_ << " async scan continue fail region:" << region->RegionId()
+                         << ", fail:" << status.ToString();
+    }
+    cb(status);
+  });
+}
+
 Status RegionScannerImpl::SetBatchSize(int64_t size) {
   uint64_t to_size = size;
   if (size <= kMinScanBatchSize) {
@@ -162,5 +184,14 @@ Status RegionScannerFactoryImpl::NewRegionScanner(const ClientStub& stub, std::s
   return Status::OK();
 }
 
+Status RegionScannerFactoryImpl::NewRegionScanner(const ClientStub& stub, std::shared_ptr<Region> region,
+                                                  const std::string& start_key, const std::string& end_key,
+                                                  std::unique_ptr<RegionScanner>& scanner) {
+  std::unique_ptr<RegionScanner> tmp(new RegionScannerImpl(stub, std::move(region), start_key, end_key));
+  scanner = std::move(tmp);
+
+  return Status::OK();
+}
+
 }  // namespace sdk
 }  // namespace dingodb
\ No newline at end of file
@@ -24,6 +24,8 @@
 #include "sdk/client_stub.h"
 #include "sdk/region_scanner.h"
 #include "sdk/store/store_rpc.h"
+#include "sdk/store/store_rpc_controller.h"
+#include "sdk/utils/callback.h"
 
 namespace dingodb {
 namespace sdk {
@@ -45,6 +47,8 @@ class RegionScannerImpl : public RegionScanner {
 
   Status NextBatch(std::vector<KVPair>& kvs) override;
 
+  void AsyncNextBatch(std::vector<KVPair>& kvs, StatusCallback cb) override;
+
   bool HasMore() const override;
 
   Status SetBatchSize(int64_t size) override;
@@ -62,12 +66,18 @@ class RegionScannerImpl : public RegionScanner {
 
   void PrepareScanReleaseRpc(KvScanReleaseRpc& rpc);
 
+  void ProcessScanContinueResponse(const KvScanContinueRpc& rpc, std::vector<KVPair>& kvs);
+
   std::string start_key_;
   std::string end_key_;
   int64_t batch_size_;
   bool opened_;
   std::string scan_id_;
   bool has_more_;
+
+  // rpc of the in flight AsyncNextBatch, kept until next AsyncNextBatch
+  std::unique_ptr<KvScanContinueRpc> continue_rpc_;
+  std::unique_ptr<StoreRpcController> continue_controller_;
 };
 
 class RegionScannerFactoryImpl final : public RegionScannerFactory {
@@ -78,6 +88,9 @@ class RegionScannerFactoryImpl final : public RegionScannerFactory {
 
   Status NewRegionScanner(const ClientStub& stub, std::shared_ptr<Region> region,
                           std::unique_ptr<RegionScanner>& scanner) override;
+
+  Status NewRegionScanner(const ClientStub& stub, std::shared_ptr<Region> region, const std::string& start_key,
+                          const std::string& end_key, std::unique_ptr<RegionScanner>& scanner) override;
 };
 
 }  // namespace sdk
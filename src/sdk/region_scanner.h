@@ -18,10 +18,12 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "sdk/client.h"
 #include "sdk/region.h"
+#include "sdk/utils/callback.h"
 namespace dingodb {
 namespace sdk {
 
@@ -41,6 +43,10 @@ class RegionScanner {
 
   virtual Status NextBatch(std::vector<KVPair>& kvs) = 0;
 
+  // Same as NextBatch but not wait for the rpc, cb is called when kvs is filled.
+  // Only one NextBatch or AsyncNextBatch is allowed at the same time.
+  virtual void AsyncNextBatch(std::vector<KVPair>& kvs, StatusCallback cb) { cb(NextBatch(kvs)); }
+
   virtual bool HasMore() const = 0;
 
   virtual Status SetBatchSize(int64_t size) = 0;
@@ -78,6 +84,17 @@ class RegionScannerFactory {
   virtual Status NewRegionScanner(const ClientStub& stub, std::shared_ptr<Region> region,
                                   std::unique_ptr<RegionScanner>& scanner) = 0;
 
+  // Scan [start_key, end_key) of the region, the range must be within the region range.
+  virtual Status NewRegionScanner(const ClientStub& stub, std::shared_ptr<Region> region, const std::string& start_key,
+                                  const std::string& end_key, std::unique_ptr<RegionScanner>& scanner) {
+    (void)stub;
+    (void)region;
+    (void)start_key;
+    (void)end_key;
+    (void)scanner;
+    return Status::NotSupported("no implement");
+  }
+
   virtual Status NewRegionScanner(const ScannerOptions& options, std::unique_ptr<RegionScanner>& scanner) {
     // TODO: check options
     (void)options;
@@ -15,8 +15,12 @@
 #include "sdk/transaction/txn_impl.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -239,16 +243,7 @@ Status Transaction::TxnImpl::DoTxnBatchGet(const std::vector<std::string>& keys,
   DCHECK_EQ(rpcs.size(), region_keys.size());
   DCHECK_EQ(rpcs.size(), sub_tasks.size());
 
-  std::vector<std::thread> thread_pool;
-  for (auto i = 1; i < sub_tasks.size(); i++) {
-    thread_pool.emplace_back(&Transaction::TxnImpl::ProcessTxnBatchGetSubTask, this, &sub_tasks[i]);
-  }
-
-  ProcessTxnBatchGetSubTask(sub_tasks.data());
-
-  for (auto& thread : thread_pool) {
-    thread.join();
-  }
+  ProcessSubTasks(sub_tasks, &Transaction::TxnImpl::ProcessTxnBatchGetSubTask);
 
   Status result;
   std::vector<KVPair> tmp_kvs;
@@ -665,16 +660,7 @@ Status Transaction::TxnImpl::PreCommit() {
   DCHECK_EQ(rpcs.size(), region_mutations.size());
   DCHECK_EQ(rpcs.size(), sub_tasks.size());
 
-  std::vector<std::thread> thread_pool;
-  for (auto i = 1; i < sub_tasks.size(); i++) {
-    thread_pool.emplace_back(&Transaction::TxnImpl::ProcessTxnPrewriteSubTask, this, &sub_tasks[i]);
-  }
-
-  ProcessTxnPrewriteSubTask(sub_tasks.data());
-
-  for (auto& thread : thread_pool) {
-    thread.join();
-  }
+  ProcessSubTasks(sub_tasks, &Transaction::TxnImpl::ProcessTxnPrewriteSubTask);
 
   Status result;
   for (auto& state : sub_tasks) {
@@ -851,16 +837,7 @@ Status Transaction::TxnImpl::Commit() {
       DCHECK_EQ(rpcs.size(), region_commit_keys.size());
       DCHECK_EQ(rpcs.size(), sub_tasks.size());
 
-      std::vector<std::thread> thread_pool;
-      for (auto i = 1; i < sub_tasks.size(); i++) {
-        thread_pool.emplace_back(&Transaction::TxnImpl::ProcessTxnCommitSubTask, this, &sub_tasks[i]);
-      }
-
-      ProcessTxnCommitSubTask(sub_tasks.data());
-
-      for (auto& thread : thread_pool) {
-        thread.join();
-      }
+      ProcessSubTasks(sub_tasks, &Transaction::TxnImpl::ProcessTxnCommitSubTask);
 
       for (auto& state : sub_tasks) {
         // ignore
@@ -1000,16 +977,7 @@ Status Transaction::TxnImpl::Rollback() {
     DCHECK_EQ(rpcs.size(), region_rollback_keys.size());
     DCHECK_EQ(rpcs.size(), sub_tasks.size());
 
-    std::vector<std::thread> thread_pool;
-    for (auto i = 1; i < sub_tasks.size(); i++) {
-      thread_pool.emplace_back(&Transaction::TxnImpl::ProcessBatchRollbackSubTask, this, &sub_tasks[i]);
-    }
-
-    ProcessBatchRollbackSubTask(sub_tasks.data());
-
-    for (auto& thread : thread_pool) {
-      thread.join();
-    }
+    ProcessSubTasks(sub_tasks, &Transaction::TxnImpl::ProcessBatchRollbackSubTask);
 
     for (auto& state : sub_tasks) {
       // ignore
@@ -1023,6 +991,84 @@ Status Transaction::TxnImpl::Rollback() {
   return Status::OK();
 }
 
+void Transaction::TxnImpl::AsyncPreCommit(StatusCallback cb) {
+  AsyncExecute([this]() { return PreCommit(); }, std::move(cb));
+}
+
+void Transaction::TxnImpl::AsyncCommit(StatusCallback cb) {
+  AsyncExecute([this]() { return Commit(); }, std::move(cb));
+}
+
+void Transaction::TxnImpl::AsyncRollback(StatusCallback cb) {
+  AsyncExecute([this]() { return Rollback(); }, std::move(cb));
+}
+
+void Transaction::TxnImpl::AsyncExecute(std::function<Status()> op, StatusCallback cb) {
+  auto executor = stub_.GetExecutor();
+  bool ok = executor->Execute([op, cb]() { cb(op()); });
+  if (!ok) {
+    std::string msg = fmt::format("Fail execute txn op, executor:{}", executor->Name());
+    DINGO_LOG(WARNING) << msg;
+    cb(Status::Aborted(msg));
+  }
+}
+
+void Transaction::TxnImpl::ProcessSubTasks(std::vector<TxnSubTask>& sub_tasks,
+                                           void (Transaction::TxnImpl::*process)(TxnSubTask*)) {
+  if (sub_tasks.empty()) {
+    return;
+  }
+
+  struct RunnerState {
+    std::mutex lock;
+    std::condition_variable cv;
+    // set when the calling thread has taken all sub tasks, runners not started yet just exit
+    bool closed{false};
+    int64_t running{0};
+    std::atomic<size_t> next_index{0};
+  };
+  auto state = std::make_shared<RunnerState>();
+
+  // every runner takes the next sub task until all sub tasks are taken
+  auto run_sub_tasks = [this, &sub_tasks, process, state]() {
+    for (size_t i = state->next_index.fetch_add(1); i < sub_tasks.size(); i = state->next_index.fetch_add(1)) {
+      (this->*process)(&sub_tasks[i]);
+    }
+  };
+
+  int64_t runner_num = std::min(static_cast<int64_t>(sub_tasks.size()), kTxnMaxSubTaskConcurrency);
+  auto executor = stub_.GetExecutor();
+  for (int64_t i = 1; i < runner_num; i++) {
+    bool ok = executor->Execute([state, run_sub_tasks]() {
+      {
+        std::unique_lock<std::mutex> lk(state->lock);
+        if (state->closed) {
+          return;
+        }
+        state->running++;
+      }
+
+      run_sub_tasks();
+
+      std::unique_lock<std::mutex> lk(state->lock);
+      if (--state->running == 0) {
+        state->cv.notify_all();
+      }
+    });
+    if (!ok) {
+      DINGO_LOG(WARNING) << "Fail execute txn sub task runner, executor:" << executor->Name();
+    }
+  }
+
+  run_sub_tasks();
+
+  std::unique_lock<std::mutex> lk(state->lock);
+  state->closed = true;
+  while (state->running > 0) {
+    state->cv.wait(lk);
+  }
+}
+
 bool Transaction::TxnImpl::NeedRetryAndInc(int& times) {
   bool retry = times < kTxnOpMaxRetry;
   times++;
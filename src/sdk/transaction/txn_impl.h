@@ -16,6 +16,7 @@
 #define DINGODB_SDK_TRANSACTION_IMPL_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 #include "proto/meta.pb.h"
@@ -26,6 +27,7 @@
 #include "sdk/store/store_rpc.h"
 #include "sdk/transaction/txn_buffer.h"
 #include "sdk/transaction/txn_common.h"
+#include "sdk/utils/callback.h"
 
 namespace dingodb {
 namespace sdk {
@@ -100,6 +102,12 @@ class Transaction::TxnImpl {
 
   Status Rollback();
 
+  void AsyncPreCommit(StatusCallback cb);
+
+  void AsyncCommit(StatusCallback cb);
+
+  void AsyncRollback(StatusCallback cb);
+
   TransactionState TEST_GetTransactionState() { return state_; }         // NOLINT
   int64_t TEST_GetStartTs() { return start_ts_; }                        // NOLINT
   int64_t TEST_GetCommitTs() { return commit_ts_; }                      // NOLINT
@@ -142,6 +150,14 @@ class Transaction::TxnImpl {
   void CheckAndLogTxnBatchRollbackResponse(const pb::store::TxnBatchRollbackResponse* response) const;
   void ProcessBatchRollbackSubTask(TxnSubTask* sub_task);
 
+  // Run sub tasks on the sdk executor and wait all of them done, at most kTxnMaxSubTaskConcurrency sub tasks of
+  // this txn run at the same time. The calling thread runs sub tasks too, and only waits runners already started,
+  // so it makes progress when executor is busy, even if the calling thread is an executor thread.
+  void ProcessSubTasks(std::vector<TxnSubTask>& sub_tasks, void (TxnImpl::*process)(TxnSubTask*));
+
+  // Run the sync op on the sdk executor and call cb with its status.
+  void AsyncExecute(std::function<Status()> op, StatusCallback cb);
+
   Status HeartBeat();
 
   static bool NeedRetryAndInc(int& times);
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/tso_client.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "common/logging.h"
+#include "glog/logging.h"
+#include "sdk/common/param_config.h"
+#include "sdk/status.h"
+
+namespace dingodb {
+namespace sdk {
+
+TsoClient::TsoClient(std::shared_ptr<CoordinatorProxy> coordinator_proxy) : coordinator_proxy_(coordinator_proxy) {}
+
+Status TsoClient::GenTso(pb::meta::TsoTimestamp& tso_timestamp) {
+  Waiter waiter;
+
+  std::unique_lock<std::mutex> lk(mutex_);
+  waiters_.push_back(&waiter);
+  while (!waiter.done) {
+    if (fetching_) {
+      cv_.wait(lk);
+      continue;
+    }
+
+    // no rpc in flight, this thread send the rpc for all waiters
+    fetching_ = true;
+    std::vector<Waiter*> batch;
+    while (!waiters_.empty() && static_cast<int64_t>(batch.size()) < kTsoBatchMaxSize) {
+      batch.push_back(waiters_.front());
+      waiters_.pop_front();
+    }
+
+    lk.unlock();
+    FetchTso(batch);
+    lk.lock();
+
+    for (auto* batch_waiter : batch) {
+      batch_waiter->done = true;
+    }
+    fetching_ = false;
+    cv_.notify_all();
+  }
+
+  if (waiter.status.IsOK()) {
+    tso_timestamp = waiter.tso_timestamp;
+  }
+
+  return waiter.status;
+}
+
+void TsoClient::FetchTso(std::vector<Waiter*>& waiters) {
+  pb::meta::TsoRequest request;
+  pb::meta::TsoResponse response;
+
+  request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
+  request.set_count(waiters.size());
+
+  auto status = coordinator_proxy_->TsoService(request, response);
+  if (!status.IsOK()) {
+    DINGO_LOG(WARNING) << "Fail tsoService request fail, status:" << status.ToString()
+                       << ", response:" << response.DebugString();
+    for (auto* waiter : waiters) {
+      waiter->status = status;
+    }
+    return;
+  }
+
+  CHECK(response.has_start_timestamp());
+  const auto& start_timestamp = response.start_timestamp();
+  DINGO_LOG(DEBUG) << "tso timestamp: " << start_timestamp.DebugString() << ", count: " << waiters.size();
+
+  // the logical range [start_timestamp.logical, start_timestamp.logical + count) is reserved for this rpc
+  for (size_t i = 0; i < waiters.size(); ++i) {
+    waiters[i]->tso_timestamp.set_physical(start_timestamp.physical());
+    waiters[i]->tso_timestamp.set_logical(start_timestamp.logical() + static_cast<int64_t>(i));
+    waiters[i]->status = Status::OK();
+  }
+}
+
+}  // namespace sdk
+}  // namespace dingodb
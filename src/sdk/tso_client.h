@@ -0,0 +1,68 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_TSO_CLIENT_H_
+#define DINGODB_SDK_TSO_CLIENT_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "proto/meta.pb.h"
+#include "sdk/coordinator_proxy.h"
+#include "sdk/status.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Coalesce concurrent tso requests into one OP_GEN_TSO rpc.
+// At most one rpc is in flight, the requests arrive during the round trip wait and are sent together by the
+// next rpc with count = number of requests, each request gets one logical of the returned range.
+// The range is not prefetched: a timestamp fetched before the request arrives may be smaller than the commit ts of
+// a transaction which has finished before, so it can't be used as start ts or commit ts.
+class TsoClient {
+ public:
+  TsoClient(const TsoClient&) = delete;
+  const TsoClient& operator=(const TsoClient&) = delete;
+
+  explicit TsoClient(std::shared_ptr<CoordinatorProxy> coordinator_proxy);
+
+  ~TsoClient() = default;
+
+  Status GenTso(pb::meta::TsoTimestamp& tso_timestamp);
+
+ private:
+  struct Waiter {
+    pb::meta::TsoTimestamp tso_timestamp;
+    Status status;
+    bool done{false};
+  };
+
+  void FetchTso(std::vector<Waiter*>& waiters);
+
+  std::shared_ptr<CoordinatorProxy> coordinator_proxy_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // true when a tso rpc is in flight
+  bool fetching_{false};
+  std::deque<Waiter*> waiters_;
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+#endif  // DINGODB_SDK_TSO_CLIENT_H_
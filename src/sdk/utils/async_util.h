@@ -17,6 +17,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 
@@ -60,6 +61,31 @@ class Synchronizer {
   bool fire_;
 };
 
+// Wait until CountDown is called count times.
+class CountDownLatch {
+ public:
+  explicit CountDownLatch(int64_t count) : count_(count) {}
+
+  void CountDown() {
+    std::unique_lock<std::mutex> lk(lock_);
+    if (count_ > 0 && --count_ == 0) {
+      cv_.notify_all();
+    }
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lk(lock_);
+    while (count_ > 0) {
+      cv_.wait(lk);
+    }
+  }
+
+ private:
+  std::mutex lock_;
+  std::condition_variable cv_;
+  int64_t count_;
+};
+
 }  // namespace sdk
 
 }  // namespace dingodb
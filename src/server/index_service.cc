@@ -358,7 +358,8 @@ static butil::Status ValidateVectorAddRequest(StoragePtr storage, const pb::inde
         vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT ||
         vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE ||
         vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
-        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ ||
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN) {
       if (vector.vector().float_values().size() != dimension) {
         return butil::Status(
             pb::error::EILLEGAL_PARAMTETERS,
@@ -1017,9 +1018,10 @@ void DoVectorSearchDebug(StoragePtr storage, google::protobuf::RpcController* co
   int64_t deserialization_id_time_us = 0;
   int64_t scan_scalar_time_us = 0;
   int64_t search_time_us = 0;
+  std::string filter_strategy;
   std::vector<pb::index::VectorWithDistanceResult> vector_results;
   status = storage->VectorBatchSearchDebug(ctx, vector_results, deserialization_id_time_us, scan_scalar_time_us,
-                                           search_time_us);
+                                           search_time_us, filter_strategy);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -1032,6 +1034,7 @@ void DoVectorSearchDebug(StoragePtr storage, google::protobuf::RpcController* co
   response->set_deserialization_id_time_us(deserialization_id_time_us);
   response->set_scan_scalar_time_us(scan_scalar_time_us);
   response->set_search_time_us(search_time_us);
+  response->set_filter_strategy(filter_strategy);
 }
 
 void IndexServiceImpl::VectorSearchDebug(google::protobuf::RpcController* controller,
@@ -1428,7 +1431,8 @@ static butil::Status ValidateTxnPrewriteRequest(StoragePtr storage, const pb::st
           vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT ||
           vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE ||
           vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
-          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ ||
+          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN) {
         if (vector.vector().float_values().size() != dimension) {
           return butil::Status(
               pb::error::EILLEGAL_PARAMTETERS,
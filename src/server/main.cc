@@ -73,7 +73,7 @@ DEFINE_uint32(h2_server_connection_window_size, 1024 * 1024 * 1024, "connection
 DEFINE_uint32(h2_server_max_frame_size, 16384, "max frame size");
 DEFINE_uint32(h2_server_max_header_list_size, UINT32_MAX, "max header list size");
 
-DEFINE_int32(omp_num_threads, 1, "omp num threads");
+DECLARE_int32(omp_num_threads);
 DEFINE_int32(read_worker_num, 10, "read service worker num");
 DEFINE_int32(write_worker_num, 10, "write service worker num");
 DEFINE_int64(read_worker_max_pending_num, 0, "read service worker num");
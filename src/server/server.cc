@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <any>
 #include <cassert>
+#include <cctype>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
@@ -34,6 +35,7 @@
 #include "coordinator/coordinator_control.h"
 #include "engine/bdb_raw_engine.h"
 #include "engine/engine.h"
+#include "engine/mem_engine.h"
 #include "engine/raft_store_engine.h"
 #include "engine/rocks_raw_engine.h"
 #ifdef ENABLE_XDPROCKS
@@ -54,11 +56,17 @@ DEFINE_string(coor_url, "",
               "coor service name, e.g. file://<path>, list://<addr1>,<addr2>..., bns://<bns-name>, "
               "consul://<service-name>, http://<url>, https://<url>");
 
+DECLARE_bool(enable_shared_raft_log);
+DECLARE_int64(shared_raft_log_max_file_size);
+
 namespace dingodb {
 
 DECLARE_int64(compaction_retention_rev_count);
 DECLARE_bool(auto_compaction);
 
+// Data of memory raw engine is lost on restart, it's for the regions which can be rebuilt, e.g. test and benchmark.
+DEFINE_bool(enable_mem_raw_engine, false, "enable memory raw engine for the region of RAW_ENG_MEMORY");
+
 DEFINE_bool(ip2hostname, false, "resolve ip to hostname for get map api");
 DEFINE_bool(enable_ip2hostname_cache, true, "enable ip2hostname cache");
 DEFINE_int64(ip2hostname_cache_seconds, 300, "ip2hostname cache seconds");
@@ -212,6 +220,16 @@ bool Server::InitEngine() {
     return false;
   }
 
+  // init memory
+  std::shared_ptr<MemEngine> raw_mem_engine;
+  if (FLAGS_enable_mem_raw_engine) {
+    raw_mem_engine = std::make_shared<MemEngine>();
+    if (!raw_mem_engine->Init(config, Helper::GetColumnFamilyNamesByRole())) {
+      DINGO_LOG(ERROR) << "Init MemEngine Failed with Config[" << config->ToString();
+      return false;
+    }
+  }
+
   // cooridnator
   if (GetRole() == pb::common::ClusterRole::COORDINATOR) {
     // 1.init CoordinatorController
@@ -229,7 +247,7 @@ bool Server::InitEngine() {
     }
 
     // init raft_meta_engine
-    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine);
+    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine, raw_mem_engine);
 
     // set raft_meta_engine to coordinator_control
     coordinator_control_->SetKvEngine(raft_engine_);
@@ -279,7 +297,7 @@ bool Server::InitEngine() {
     tso_control_->SetKvEngine(raft_engine_);
 
   } else {
-    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine);
+    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine, raw_mem_engine);
     if (!raft_engine_->Init(config)) {
       DINGO_LOG(ERROR) << "Init RaftStoreEngine failed with Config[" << config->ToString() << "]";
       return false;
@@ -355,8 +373,54 @@ bool Server::InitCoordinatorInteractionForAutoIncrement() {
   }
 }
 
+// Segment log of region is in raft_log_path/{region_id}.
+static std::vector<std::string> GetSegmentLogDirs(const std::string& raft_log_path) {
+  std::vector<std::string> region_dirs;
+  for (const auto& name : Helper::TraverseDirectory(raft_log_path, false, true)) {
+    if (!name.empty() && std::all_of(name.begin(), name.end(), ::isdigit)) {
+      region_dirs.push_back(name);
+    }
+  }
+
+  return region_dirs;
+}
+
 bool Server::InitLogStorageManager() {
   log_storage_ = std::make_shared<LogStorageManager>();
+
+  // Coordinator region keep segment log, only store/index region use shared log.
+  if (GetRole() == pb::common::ClusterRole::COORDINATOR) {
+    return true;
+  }
+
+  // There is no migration between segment log and shared log, switching enable_shared_raft_log on a store
+  // which already has raft log would lose the log of existing regions, so refuse to start.
+  std::string shared_log_path = fmt::format("{}/shared", GetRaftLogPath());
+  if (FLAGS_enable_shared_raft_log) {
+    auto region_dirs = GetSegmentLogDirs(GetRaftLogPath());
+    if (!region_dirs.empty()) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "Found {} region segment log dirs in {}, e.g. {}, can't enable shared raft log on a store which already "
+          "has segment log.",
+          region_dirs.size(), GetRaftLogPath(), region_dirs[0]);
+      return false;
+    }
+  } else {
+    if (!Helper::TraverseDirectory(shared_log_path).empty()) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "Found shared raft log in {}, can't disable shared raft log on a store which already has shared log.",
+          shared_log_path);
+      return false;
+    }
+  }
+
+  if (FLAGS_enable_shared_raft_log) {
+    if (!log_storage_->InitSharedLogEngine(shared_log_path, FLAGS_shared_raft_log_max_file_size)) {
+      DINGO_LOG(ERROR) << "Init shared raft log engine failed, path: " << shared_log_path;
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -367,7 +431,17 @@ bool Server::InitStorage() {
 
 bool Server::InitStoreMetaManager() {
   store_meta_manager_ = std::make_shared<StoreMetaManager>(meta_reader_, meta_writer_);
-  return store_meta_manager_->Init();
+  if (!store_meta_manager_->Init()) {
+    return false;
+  }
+
+  // For txn mvcc gc on compaction.
+  auto raw_engine = GetRawEngine(pb::common::RAW_ENG_ROCKSDB);
+  if (raw_engine != nullptr) {
+    raw_engine->SetGcSafePoint(store_meta_manager_->GetGCSafePoint());
+  }
+
+  return true;
 }
 
 static int32_t GetInterval(std::shared_ptr<Config> config, const std::string& config_name,  // NOLINT
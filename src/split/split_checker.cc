@@ -31,6 +31,7 @@
 #include "config/config_helper.h"
 #include "engine/iterator.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
@@ -40,6 +41,8 @@
 #include "vector/codec.h"
 #include "vector/vector_index_manager.h"
 
+DEFINE_bool(split_check_use_range_properties, true, "split check use sst range properties instead of scan region");
+
 namespace dingodb {
 
 MergedIterator::MergedIterator(RawEnginePtr raw_engine, const std::vector<std::string>& cf_names,
@@ -96,9 +99,125 @@ void MergedIterator::Next(IteratorPtr iter, int iter_pos) {
   }
 }
 
+bool SplitChecker::GetRangeProperties(RawEnginePtr raw_engine, const pb::common::Range& range,
+                                      const std::vector<std::string>& cf_names,
+                                      RawEngine::RangeProperties& properties) {
+  if (!FLAGS_split_check_use_range_properties) {
+    return false;
+  }
+
+  for (const auto& cf_name : cf_names) {
+    RawEngine::RangeProperties cf_properties;
+    auto status = raw_engine->GetRangeProperties(cf_name, range, cf_properties);
+    if (!status.ok()) {
+      DINGO_LOG(DEBUG) << fmt::format("[split.check] get range properties failed, cf({}) error: {}", cf_name,
+                                      status.error_str());
+      return false;
+    }
+
+    for (auto& sample : cf_properties.samples) {
+      properties.samples.push_back(std::move(sample));
+    }
+    properties.memtable_size += cf_properties.memtable_size;
+    properties.memtable_keys += cf_properties.memtable_keys;
+  }
+
+  // All data in memtable, scan is cheap.
+  if (properties.samples.empty()) {
+    return false;
+  }
+
+  std::sort(properties.samples.begin(), properties.samples.end(),
+            [](const RawEngine::RangeProperties::Sample& lhs, const RawEngine::RangeProperties::Sample& rhs) {
+              return lhs.key < rhs.key;
+            });
+
+  return true;
+}
+
+std::string SplitChecker::FindSampleKeyBySize(const RawEngine::RangeProperties& properties, int64_t position) {
+  int64_t sst_size = 0;
+  for (const auto& sample : properties.samples) {
+    sst_size += sample.size;
+  }
+
+  // Scale position to sst, memtable data is not sampled.
+  double sst_position = static_cast<double>(position) * sst_size / (sst_size + properties.memtable_size);
+  int64_t size = 0;
+  for (const auto& sample : properties.samples) {
+    size += sample.size;
+    if (size >= sst_position) {
+      return sample.key;
+    }
+  }
+
+  return "";
+}
+
+std::string SplitChecker::FindSampleKeyByKeys(const RawEngine::RangeProperties& properties, int64_t position) {
+  int64_t sst_keys = 0;
+  for (const auto& sample : properties.samples) {
+    sst_keys += sample.keys;
+  }
+
+  double sst_position = static_cast<double>(position) * sst_keys / (sst_keys + properties.memtable_keys);
+  int64_t keys = 0;
+  for (const auto& sample : properties.samples) {
+    keys += sample.keys;
+    if (keys >= sst_position) {
+      return sample.key;
+    }
+  }
+
+  return "";
+}
+
+static void SumRangeProperties(const RawEngine::RangeProperties& properties, int64_t& size, int64_t& keys) {
+  size = properties.memtable_size;
+  keys = properties.memtable_keys;
+  for (const auto& sample : properties.samples) {
+    size += sample.size;
+    keys += sample.keys;
+  }
+}
+
 // base physics key, contain key of multi version.
 std::string HalfSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
                                        const std::vector<std::string>& cf_names, uint32_t& count) {
+  RawEngine::RangeProperties properties;
+  if (GetRangeProperties(raw_engine_, physical_range, cf_names, properties)) {
+    return SplitKeyByProperties(region, properties, count);
+  }
+
+  return SplitKeyByScan(region, physical_range, cf_names, count);
+}
+
+std::string HalfSplitChecker::SplitKeyByProperties(store::RegionPtr region,
+                                                   const RawEngine::RangeProperties& properties, uint32_t& count) {
+  int64_t size = 0;
+  int64_t keys = 0;
+  SumRangeProperties(properties, size, keys);
+  count = keys;
+
+  bool is_split = size >= split_threshold_size_;
+  std::string split_key = FindSampleKeyBySize(properties, size / 2);
+
+  // Is transaction, truncate key ts.
+  if (Helper::IsClientTxn(region->Range().start_key()) || Helper::IsExecutorTxn(region->Range().start_key())) {
+    // split_key = Helper::TruncateTxnKeyTs(split_key);
+    split_key = Helper::GetUserKeyFromTxnKey(split_key);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[split.check][region({})] policy(HALF) by range properties split_threshold_size({}) approximate_size({}) "
+      "approximate_count({}) sample_count({})",
+      region->Id(), split_threshold_size_, size, count, properties.samples.size());
+
+  return is_split ? split_key : "";
+}
+
+std::string HalfSplitChecker::SplitKeyByScan(store::RegionPtr region, const pb::common::Range& physical_range,
+                                             const std::vector<std::string>& cf_names, uint32_t& count) {
   MergedIterator iter(raw_engine_, cf_names, region->Range().end_key());
   iter.Seek(physical_range.start_key());
 
@@ -143,6 +262,40 @@ std::string HalfSplitChecker::SplitKey(store::RegionPtr region, const pb::common
 // base physics key, contain key of multi version.
 std::string SizeSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
                                        const std::vector<std::string>& cf_names, uint32_t& count) {
+  RawEngine::RangeProperties properties;
+  if (GetRangeProperties(raw_engine_, physical_range, cf_names, properties)) {
+    return SplitKeyByProperties(region, properties, count);
+  }
+
+  return SplitKeyByScan(region, physical_range, cf_names, count);
+}
+
+std::string SizeSplitChecker::SplitKeyByProperties(store::RegionPtr region,
+                                                   const RawEngine::RangeProperties& properties, uint32_t& count) {
+  int64_t size = 0;
+  int64_t keys = 0;
+  SumRangeProperties(properties, size, keys);
+  count = keys;
+
+  bool is_split = size >= split_size_;
+  std::string split_key = FindSampleKeyBySize(properties, static_cast<int64_t>(split_size_ * split_ratio_));
+
+  // Is transaction, truncate key ts.
+  if (Helper::IsClientTxn(region->Range().start_key()) || Helper::IsExecutorTxn(region->Range().start_key())) {
+    // split_key = Helper::TruncateTxnKeyTs(split_key);
+    split_key = Helper::GetUserKeyFromTxnKey(split_key);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[split.check][region({})] policy(SIZE) by range properties split_size({}) split_ratio({}) approximate_size({}) "
+      "approximate_count({}) sample_count({})",
+      region->Id(), split_size_, split_ratio_, size, count, properties.samples.size());
+
+  return is_split ? split_key : "";
+}
+
+std::string SizeSplitChecker::SplitKeyByScan(store::RegionPtr region, const pb::common::Range& physical_range,
+                                             const std::vector<std::string>& cf_names, uint32_t& count) {
   MergedIterator iter(raw_engine_, cf_names, region->Range().end_key());
   iter.Seek(physical_range.start_key());
 
@@ -181,6 +334,42 @@ std::string SizeSplitChecker::SplitKey(store::RegionPtr region, const pb::common
 // base logic key, ignore key of multi version.
 std::string KeysSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
                                        const std::vector<std::string>& cf_names, uint32_t& count) {
+  RawEngine::RangeProperties properties;
+  if (GetRangeProperties(raw_engine_, physical_range, cf_names, properties)) {
+    return SplitKeyByProperties(region, properties, count);
+  }
+
+  return SplitKeyByScan(region, physical_range, cf_names, count);
+}
+
+// Sst sample count physics key, approximate logic key.
+std::string KeysSplitChecker::SplitKeyByProperties(store::RegionPtr region,
+                                                   const RawEngine::RangeProperties& properties, uint32_t& count) {
+  int64_t size = 0;
+  int64_t keys = 0;
+  SumRangeProperties(properties, size, keys);
+  count = keys;
+
+  bool is_split = keys >= split_keys_number_;
+  std::string split_key =
+      FindSampleKeyByKeys(properties, static_cast<int64_t>(split_keys_number_ * split_keys_ratio_));
+
+  // Is transaction, truncate key ts.
+  if (Helper::IsClientTxn(region->Range().start_key()) || Helper::IsExecutorTxn(region->Range().start_key())) {
+    // split_key = Helper::TruncateTxnKeyTs(split_key);
+    split_key = Helper::GetUserKeyFromTxnKey(split_key);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[split.check][region({})] policy(KEYS) by range properties split_key_number({}) split_key_ratio({}) "
+      "approximate_size({}) approximate_count({}) sample_count({})",
+      region->Id(), split_keys_number_, split_keys_ratio_, size, count, properties.samples.size());
+
+  return is_split ? split_key : "";
+}
+
+std::string KeysSplitChecker::SplitKeyByScan(store::RegionPtr region, const pb::common::Range& physical_range,
+                                             const std::vector<std::string>& cf_names, uint32_t& count) {
   MergedIterator iter(raw_engine_, cf_names, region->Range().end_key());
   iter.Seek(physical_range.start_key());
 
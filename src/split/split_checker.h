@@ -89,6 +89,17 @@ class SplitChecker {
   virtual std::string SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
                                const std::vector<std::string>& cf_names, uint32_t& count) = 0;
 
+ protected:
+  // Merge sst range properties of all column family, avoid scan region.
+  // Return false when properties is unavailable, need fallback to scan.
+  static bool GetRangeProperties(RawEnginePtr raw_engine, const pb::common::Range& range,
+                                 const std::vector<std::string>& cf_names, RawEngine::RangeProperties& properties);
+
+  // Find the first sample key which accumulated size/keys reach position, the memtable data is
+  // assumed same distribution as sst.
+  static std::string FindSampleKeyBySize(const RawEngine::RangeProperties& properties, int64_t position);
+  static std::string FindSampleKeyByKeys(const RawEngine::RangeProperties& properties, int64_t position);
+
  private:
   Policy policy_;
 };
@@ -108,6 +119,11 @@ class HalfSplitChecker : public SplitChecker {
                        const std::vector<std::string>& cf_names, uint32_t& count) override;
 
  private:
+  std::string SplitKeyByScan(store::RegionPtr region, const pb::common::Range& physical_range,
+                             const std::vector<std::string>& cf_names, uint32_t& count);
+  std::string SplitKeyByProperties(store::RegionPtr region, const RawEngine::RangeProperties& properties,
+                                   uint32_t& count);
+
   // Split region when exceed the split_threshold_size.
   uint32_t split_threshold_size_;
   // Sampling chunk size.
@@ -130,6 +146,11 @@ class SizeSplitChecker : public SplitChecker {
                        const std::vector<std::string>& cf_names, uint32_t& count) override;
 
  private:
+  std::string SplitKeyByScan(store::RegionPtr region, const pb::common::Range& physical_range,
+                             const std::vector<std::string>& cf_names, uint32_t& count);
+  std::string SplitKeyByProperties(store::RegionPtr region, const RawEngine::RangeProperties& properties,
+                                   uint32_t& count);
+
   // Split when region exceed the split_size.
   uint32_t split_size_;
   // Split key position.
@@ -152,6 +173,11 @@ class KeysSplitChecker : public SplitChecker {
                        const std::vector<std::string>& cf_names, uint32_t& count) override;
 
  private:
+  std::string SplitKeyByScan(store::RegionPtr region, const pb::common::Range& physical_range,
+                             const std::vector<std::string>& cf_names, uint32_t& count);
+  std::string SplitKeyByProperties(store::RegionPtr region, const RawEngine::RangeProperties& properties,
+                                   uint32_t& count);
+
   // Split when region key number exceed split_key_number.
   uint32_t split_keys_number_;
   // Split key position.
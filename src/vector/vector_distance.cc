@@ -0,0 +1,218 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_distance.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define DINGO_VECTOR_DISTANCE_X86 1
+#endif
+
+namespace dingodb {
+
+#ifdef DINGO_VECTOR_DISTANCE_X86
+
+__attribute__((target("avx2,fma"))) static inline float HorizontalSumAvx2(__m256 v) {
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_add_ps(lo, hi);
+  lo = _mm_hadd_ps(lo, lo);
+  lo = _mm_hadd_ps(lo, lo);
+  return _mm_cvtss_f32(lo);
+}
+
+// Two accumulators hide the fma latency.
+__attribute__((target("avx2,fma"))) static float L2SqrAvx2(const float* x, const float* y, size_t d) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    __m256 diff0 = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+    __m256 diff1 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8));
+    sum0 = _mm256_fmadd_ps(diff0, diff0, sum0);
+    sum1 = _mm256_fmadd_ps(diff1, diff1, sum1);
+  }
+  for (; i + 8 <= d; i += 8) {
+    __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+    sum0 = _mm256_fmadd_ps(diff, diff, sum0);
+  }
+
+  float result = HorizontalSumAvx2(_mm256_add_ps(sum0, sum1));
+  for (; i < d; ++i) {
+    float diff = x[i] - y[i];
+    result += diff * diff;
+  }
+
+  return result;
+}
+
+__attribute__((target("avx2,fma"))) static float InnerProductAvx2(const float* x, const float* y, size_t d) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+  }
+  for (; i + 8 <= d; i += 8) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+  }
+
+  float result = HorizontalSumAvx2(_mm256_add_ps(sum0, sum1));
+  for (; i < d; ++i) {
+    result += x[i] * y[i];
+  }
+
+  return result;
+}
+
+// The tail is handled by masked load, so no scalar loop.
+__attribute__((target("avx512f"))) static float L2SqrAvx512(const float* x, const float* y, size_t d) {
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 32 <= d; i += 32) {
+    __m512 diff0 = _mm512_sub_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i));
+    __m512 diff1 = _mm512_sub_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16));
+    sum0 = _mm512_fmadd_ps(diff0, diff0, sum0);
+    sum1 = _mm512_fmadd_ps(diff1, diff1, sum1);
+  }
+  for (; i + 16 <= d; i += 16) {
+    __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i));
+    sum0 = _mm512_fmadd_ps(diff, diff, sum0);
+  }
+  if (i < d) {
+    __mmask16 mask = static_cast<__mmask16>((1U << (d - i)) - 1);
+    __m512 diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+    sum1 = _mm512_fmadd_ps(diff, diff, sum1);
+  }
+
+  return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f"))) static float InnerProductAvx512(const float* x, const float* y, size_t d) {
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 32 <= d; i += 32) {
+    sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+    sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), sum1);
+  }
+  for (; i + 16 <= d; i += 16) {
+    sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+  }
+  if (i < d) {
+    __mmask16 mask = static_cast<__mmask16>((1U << (d - i)) - 1);
+    sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), sum1);
+  }
+
+  return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+#endif  // DINGO_VECTOR_DISTANCE_X86
+
+// Constant initialized, so kernels called from other static initializers are still valid.
+VectorDistance::SimdLevel VectorDistance::simd_level = VectorDistance::SimdLevel::kScalar;
+VectorDistance::DistanceFunc VectorDistance::l2_sqr_func = &VectorDistance::L2SqrScalar;
+VectorDistance::DistanceFunc VectorDistance::inner_product_func = &VectorDistance::InnerProductScalar;
+bool VectorDistance::inited = VectorDistance::SetSimdLevel(VectorDistance::DetectSimdLevel());
+
+float VectorDistance::L2SqrScalar(const float* x, const float* y, size_t d) {
+  float result = 0.0f;
+  for (size_t i = 0; i < d; ++i) {
+    float diff = x[i] - y[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+float VectorDistance::InnerProductScalar(const float* x, const float* y, size_t d) {
+  float result = 0.0f;
+  for (size_t i = 0; i < d; ++i) {
+    result += x[i] * y[i];
+  }
+  return result;
+}
+
+void VectorDistance::Normalize(float* x, size_t d) {
+  static const float kFloatAccuracy = 0.00001;
+
+  float norm_l2_sqr = InnerProduct(x, x, d);
+  if (norm_l2_sqr > 0 && std::abs(1.0f - norm_l2_sqr) > kFloatAccuracy) {
+    float norm_l2 = std::sqrt(norm_l2_sqr);
+    for (size_t i = 0; i < d; ++i) {
+      x[i] = x[i] / norm_l2;
+    }
+  }
+}
+
+std::string VectorDistance::GetSimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return "scalar";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    case SimdLevel::kAvx512:
+      return "avx512";
+    default:
+      return "unknown";
+  }
+}
+
+VectorDistance::SimdLevel VectorDistance::DetectSimdLevel() {
+#ifdef DINGO_VECTOR_DISTANCE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::kAvx2;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+bool VectorDistance::SetSimdLevel(SimdLevel level) {
+  if (level > DetectSimdLevel()) {
+    return false;
+  }
+
+  switch (level) {
+#ifdef DINGO_VECTOR_DISTANCE_X86
+    case SimdLevel::kAvx512:
+      l2_sqr_func = &L2SqrAvx512;
+      inner_product_func = &InnerProductAvx512;
+      break;
+    case SimdLevel::kAvx2:
+      l2_sqr_func = &L2SqrAvx2;
+      inner_product_func = &InnerProductAvx2;
+      break;
+#endif
+    default:
+      level = SimdLevel::kScalar;
+      l2_sqr_func = &L2SqrScalar;
+      inner_product_func = &InnerProductScalar;
+      break;
+  }
+  simd_level = level;
+
+  return true;
+}
+
+}  // namespace dingodb
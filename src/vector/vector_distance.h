@@ -0,0 +1,64 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_DISTANCE_H_  // NOLINT
+#define DINGODB_VECTOR_DISTANCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace dingodb {
+
+// Float distance kernels for brute force search.
+// The AVX-512/AVX2 version is chosen once at runtime by cpu feature, the scalar version is the fallback,
+// so the binary can be built without -mavx2 and still run on any x86_64 or arm machine.
+class VectorDistance {
+ public:
+  enum class SimdLevel {
+    kScalar = 0,
+    kAvx2 = 1,
+    kAvx512 = 2,
+  };
+
+  using DistanceFunc = float (*)(const float* x, const float* y, size_t d);
+
+  // Squared L2 distance.
+  static float L2Sqr(const float* x, const float* y, size_t d) { return l2_sqr_func(x, y, d); }
+  // Inner product.
+  static float InnerProduct(const float* x, const float* y, size_t d) { return inner_product_func(x, y, d); }
+  // Normalize x to unit length like VectorIndexUtils::NormalizeVectorForFaiss, cosine is 1 - ip of normalized vectors.
+  static void Normalize(float* x, size_t d);
+
+  static float L2SqrScalar(const float* x, const float* y, size_t d);
+  static float InnerProductScalar(const float* x, const float* y, size_t d);
+
+  static SimdLevel GetSimdLevel() { return simd_level; }
+  static std::string GetSimdLevelName(SimdLevel level);
+
+  // Only for test and benchmark, force kernel to the level, return false if cpu not support the level.
+  static bool SetSimdLevel(SimdLevel level);
+
+ private:
+  static SimdLevel DetectSimdLevel();
+
+  static SimdLevel simd_level;
+  static DistanceFunc l2_sqr_func;
+  static DistanceFunc inner_product_func;
+  static bool inited;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_DISTANCE_H_  // NOLINT
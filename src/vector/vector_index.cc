@@ -36,6 +36,8 @@
 
 namespace dingodb {
 
+DECLARE_bool(vector_search_batch_enable);
+
 VectorIndex::VectorIndex(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                          const pb::common::RegionEpoch& epoch, const pb::common::Range& range)
     : id(id),
@@ -122,6 +124,8 @@ VectorIndexWrapper::VectorIndexWrapper(int64_t id, pb::common::VectorIndexParame
       saving_num_(0),
       save_snapshot_threshold_write_key_num_(save_snapshot_threshold_write_key_num) {
   snapshot_set_ = vector_index::SnapshotMetaSet::New(id);
+  scalar_index_ = VectorScalarIndex::New(id);
+  search_batcher_ = VectorSearchBatcher::New(id);
   bthread_mutex_init(&vector_index_mutex_, nullptr);
   DINGO_LOG(DEBUG) << fmt::format("[new.VectorIndexWrapper][id({})]", id_);
 }
@@ -156,6 +160,7 @@ bool VectorIndexWrapper::Init() { return true; }  // NOLINT
 void VectorIndexWrapper::Destroy() {
   DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})] vector index destroy.", Id());
   stop_.store(true);
+  scalar_index_->Reset();
 }
 
 bool VectorIndexWrapper::Recover() {
@@ -830,6 +835,28 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
+
+  // Only search without filter can be merged, filter of every search is different.
+  if (FLAGS_vector_search_batch_enable && filters.empty()) {
+    return search_batcher_->Search(
+        VectorSearchBatcher::GenKey(topk, reconstruct, region_range, parameter), vector_with_ids,
+        [&](const std::vector<pb::common::VectorWithId>& batch_vector_with_ids,
+            std::vector<pb::index::VectorWithDistanceResult>& batch_results) -> butil::Status {
+          std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> batch_filters;
+          return DoSearch(batch_vector_with_ids, topk, region_range, batch_filters, reconstruct, parameter,
+                          batch_results);
+        },
+        results);
+  }
+
+  return DoSearch(vector_with_ids, topk, region_range, filters, reconstruct, parameter, results);
+}
+
+butil::Status VectorIndexWrapper::DoSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                           uint32_t topk, const pb::common::Range& region_range,
+                                           std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                           bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                           std::vector<pb::index::VectorWithDistanceResult>& results) {
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
@@ -955,6 +982,8 @@ butil::Status VectorIndexWrapper::SetVectorIndexFilter(
     } else {
       // do nothing
     }
+  } else if (vector_index->VectorIndexType() == pb::common::VECTOR_INDEX_TYPE_DISKANN) {
+    filters.push_back(std::make_shared<VectorIndex::RangeFilterFunctor>(min_vector_id, max_vector_id));
   }
 
   return butil::Status::OK();
@@ -41,6 +41,8 @@
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_snapshot.h"
+#include "vector/vector_scalar_index.h"
+#include "vector/vector_search_batcher.h"
 
 namespace dingodb {
 
@@ -212,6 +214,9 @@ class VectorIndex {
   virtual butil::Status Train(const std::vector<float>& train_datas) = 0;
   virtual butil::Status Train(const std::vector<pb::common::VectorWithId>& vectors) = 0;
   virtual bool NeedToRebuild() = 0;
+  // Called once after all vectors are added when building vector index from vector data,
+  // for the index which build its structure from the whole data set, e.g. diskann.
+  virtual butil::Status Build() { return butil::Status::OK(); }
   virtual bool NeedTrain() { return false; }
   virtual bool IsTrained() { return true; }
   virtual bool NeedToSave(int64_t last_save_log_behind) = 0;
@@ -362,6 +367,9 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   VectorIndexPtr SiblingVectorIndex();
   void SetSiblingVectorIndex(VectorIndexPtr vector_index);
 
+  // Scalar inverted index for scalar pre filter search.
+  VectorScalarIndexPtr ScalarIndex() { return scalar_index_; }
+
   bool ExecuteTask(TaskRunnablePtr task);
 
   int32_t PendingTaskNum();
@@ -412,6 +420,12 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
       int64_t min_vector_id, int64_t max_vector_id);
 
  private:
+  butil::Status DoSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                         const pb::common::Range& region_range,
+                         std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, bool reconstruct,
+                         const pb::common::VectorSearchParameter& parameter,
+                         std::vector<pb::index::VectorWithDistanceResult>& results);
+
   // vector index id
   int64_t id_;
   // vector index version
@@ -453,6 +467,12 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   // Snapshot set
   vector_index::SnapshotMetaSetPtr snapshot_set_;
 
+  // Scalar inverted index, independent of vector index.
+  VectorScalarIndexPtr scalar_index_;
+
+  // Merge concurrent search.
+  VectorSearchBatcherPtr search_batcher_;
+
   std::atomic<int32_t> pending_task_num_;
   // vector index loadorbuilding num
   std::atomic<int32_t> loadorbuilding_num_;
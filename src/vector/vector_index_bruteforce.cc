@@ -14,28 +14,42 @@
 
 #include "vector/vector_index_bruteforce.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <future>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include "bthread/mutex.h"
 #include "butil/status.h"
+#include "common/constant.h"
+#include "common/logging.h"
 #include "common/synchronization.h"
+#include "gflags/gflags.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_distance.h"
 
 namespace dingodb {
 
 DEFINE_int64(bruteforce_need_save_count, 10000, "bruteforce need save count");
+DEFINE_int64(vector_index_max_range_search_result_count, 1024, "max range search result count");
+DEFINE_int64(vector_index_bruteforce_batch_count, 2048, "bruteforce batch count");
 
 VectorIndexBruteforce::VectorIndexBruteforce(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                              const pb::common::RegionEpoch& epoch, const pb::common::Range& range)
@@ -114,4 +128,480 @@ bool VectorIndexBruteforce::NeedToSave(int64_t last_save_log_behind) {
   return last_save_log_behind > FLAGS_bruteforce_need_save_count;
 }
 
+// Float buffer aligned to cache line, every vector row is padded to kStrideAlignment floats with zero,
+// zero padding not change L2 and IP, so the kernels always run on full simd width without tail.
+class AlignedFloatBuffer {
+ public:
+  static constexpr size_t kAlignment = 64;
+  static constexpr size_t kStrideAlignment = kAlignment / sizeof(float);
+
+  explicit AlignedFloatBuffer(size_t size) {
+    size_t bytes = std::max((size * sizeof(float) + kAlignment - 1) / kAlignment * kAlignment, kAlignment);
+    data_ = static_cast<float*>(std::aligned_alloc(kAlignment, bytes));
+    if (data_ != nullptr) {
+      memset(data_, 0, bytes);
+    }
+  }
+  ~AlignedFloatBuffer() { std::free(data_); }
+
+  AlignedFloatBuffer(const AlignedFloatBuffer&) = delete;
+  AlignedFloatBuffer& operator=(const AlignedFloatBuffer&) = delete;
+
+  static size_t Stride(int32_t dimension) {
+    return (dimension + kStrideAlignment - 1) / kStrideAlignment * kStrideAlignment;
+  }
+
+  float* Data() { return data_; }
+
+ private:
+  float* data_{nullptr};
+};
+
+// Fixed-size max heap of (distance, id), the worst result is on the top, so one compare can drop most candidates.
+class TopkHeap {
+ public:
+  using Item = std::pair<float, int64_t>;
+
+  explicit TopkHeap(uint32_t topk) : topk_(topk) { items_.reserve(topk); }
+
+  void Push(float distance, int64_t id) {
+    if (items_.size() < topk_) {
+      items_.emplace_back(distance, id);
+      std::push_heap(items_.begin(), items_.end());
+    } else if (topk_ > 0 && Item(distance, id) < items_.front()) {
+      std::pop_heap(items_.begin(), items_.end());
+      items_.back() = Item(distance, id);
+      std::push_heap(items_.begin(), items_.end());
+    }
+  }
+
+  // Sorted by distance ascending, the heap is destroyed.
+  const std::vector<Item>& Sort() {
+    std::sort_heap(items_.begin(), items_.end());
+    return items_;
+  }
+
+ private:
+  uint32_t topk_;
+  std::vector<Item> items_;
+};
+
+static butil::Status CheckParameter(pb::common::MetricType metric_type, int32_t dimension) {
+  if (dimension <= 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("invalid dimension {}", dimension));
+  }
+  if (metric_type != pb::common::MetricType::METRIC_TYPE_L2 &&
+      metric_type != pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT &&
+      metric_type != pb::common::MetricType::METRIC_TYPE_COSINE) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("not support metric type {}", pb::common::MetricType_Name(metric_type)));
+  }
+
+  return butil::Status::OK();
+}
+
+static bool CheckFilters(const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, int64_t vector_id) {
+  for (const auto& filter : filters) {
+    if (!filter->Check(vector_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Copy query vectors into aligned buffer, normalize for cosine.
+static butil::Status CopyQueryVectors(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                      int32_t dimension, size_t stride, bool normalize, AlignedFloatBuffer& buffer) {
+  if (buffer.Data() == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "allocate query vector buffer failed");
+  }
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    const auto& float_values = vector_with_ids[i].vector().float_values();
+    if (float_values.size() != dimension) {
+      return butil::Status(
+          pb::error::EVECTOR_INVALID,
+          fmt::format("vector dimension is not equal to index dimension, float_value_size: {}, index dimension: {}",
+                      float_values.size(), dimension));
+    }
+
+    float* query = buffer.Data() + i * stride;
+    memcpy(query, float_values.data(), dimension * sizeof(float));
+    if (normalize) {
+      VectorDistance::Normalize(query, dimension);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+// Distance of one query to a block of vectors, same as faiss index result, L2 is squared and IP/COSINE is 1-ip.
+static void ComputeDistances(bool is_l2, const float* query, const float* vectors, size_t count, size_t stride,
+                             float* distances) {
+  if (is_l2) {
+    for (size_t i = 0; i < count; ++i) {
+      distances[i] = VectorDistance::L2Sqr(query, vectors + i * stride, stride);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      distances[i] = 1.0F - VectorDistance::InnerProduct(query, vectors + i * stride, stride);
+    }
+  }
+}
+
+static void AddVectorWithDistance(int64_t vector_id, float distance, pb::common::MetricType metric_type,
+                                  int32_t dimension, pb::index::VectorWithDistanceResult& result) {
+  auto* vector_with_distance = result.add_vector_with_distances();
+
+  auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+  vector_with_id->set_id(vector_id);
+  vector_with_id->mutable_vector()->set_dimension(dimension);
+  vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+  vector_with_distance->set_distance(distance);
+  vector_with_distance->set_metric_type(metric_type);
+}
+
+// Scan vector data of range, decode FLAGS_vector_index_bruteforce_batch_count vectors into one block,
+// handler(ids, block) is called for every block. Vector which not pass filters is skipped before decode.
+template <typename Handler>
+static butil::Status ScanVectorBlocks(RawEngine::ReaderPtr reader, const pb::common::Range& range, int32_t dimension,
+                                      size_t stride, bool normalize,
+                                      const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                      Handler&& handler) {
+  size_t block_count = std::max(FLAGS_vector_index_bruteforce_batch_count, static_cast<int64_t>(1));
+  AlignedFloatBuffer block(block_count * stride);
+  if (block.Data() == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "allocate vector block buffer failed");
+  }
+
+  std::vector<int64_t> vector_ids;
+  vector_ids.reserve(block_count);
+
+  IteratorOptions options;
+  options.lower_bound = range.start_key();
+  options.upper_bound = range.end_key();
+  auto iter = reader->NewIterator(Constant::kVectorDataCF, options);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "new iterator failed");
+  }
+
+  for (iter->Seek(range.start_key()); iter->Valid(); iter->Next()) {
+    int64_t vector_id = VectorCodec::DecodeVectorId(std::string(iter->Key()));
+    if (vector_id == 0 || vector_id == INT64_MAX || vector_id < 0) {
+      continue;
+    }
+    if (!CheckFilters(filters, vector_id)) {
+      continue;
+    }
+
+    float* vector = block.Data() + vector_ids.size() * stride;
+    auto status = VectorIndexBruteforce::DecodeFloatVector(iter->Value(), dimension, vector);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.bruteforce] decode vector {} failed, error: {}", vector_id,
+                                      status.error_str());
+      return status;
+    }
+    if (normalize) {
+      VectorDistance::Normalize(vector, dimension);
+    }
+
+    vector_ids.push_back(vector_id);
+    if (vector_ids.size() == block_count) {
+      handler(vector_ids, block.Data());
+      vector_ids.clear();
+    }
+  }
+
+  if (!vector_ids.empty()) {
+    handler(vector_ids, block.Data());
+  }
+
+  return butil::Status::OK();
+}
+
+// Read vector data of the candidate ids by multi get, decode them into blocks same as ScanVectorBlocks.
+// Id out of range or not found is skipped, it may be deleted after the candidate ids are collected.
+template <typename Handler>
+static butil::Status ReadVectorBlocks(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                      const std::vector<int64_t>& candidate_ids, int32_t dimension, size_t stride,
+                                      bool normalize, Handler&& handler) {
+  size_t block_count = std::max(FLAGS_vector_index_bruteforce_batch_count, static_cast<int64_t>(1));
+  AlignedFloatBuffer block(block_count * stride);
+  if (block.Data() == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "allocate vector block buffer failed");
+  }
+
+  char prefix = range.start_key()[0];
+  int64_t partition_id = VectorCodec::DecodePartitionId(range.start_key());
+
+  // Sorted ids give ordered keys to multi get, and duplicated id is read once.
+  std::vector<int64_t> sorted_ids(candidate_ids);
+  std::sort(sorted_ids.begin(), sorted_ids.end());
+  sorted_ids.erase(std::unique(sorted_ids.begin(), sorted_ids.end()), sorted_ids.end());
+
+  std::vector<int64_t> block_ids;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  std::vector<bool> founds;
+  std::vector<int64_t> vector_ids;
+  vector_ids.reserve(block_count);
+
+  for (size_t start = 0; start < sorted_ids.size(); start += block_count) {
+    size_t end = std::min(start + block_count, sorted_ids.size());
+
+    block_ids.clear();
+    keys.clear();
+    for (size_t i = start; i < end; ++i) {
+      std::string key;
+      VectorCodec::EncodeVectorKey(prefix, partition_id, sorted_ids[i], key);
+      if (key < range.start_key() || key >= range.end_key()) {
+        continue;
+      }
+      block_ids.push_back(sorted_ids[i]);
+      keys.push_back(std::move(key));
+    }
+    if (keys.empty()) {
+      continue;
+    }
+
+    auto status = reader->KvMultiGet(Constant::kVectorDataCF, keys, values, founds);
+    if (!status.ok()) {
+      return status;
+    }
+
+    vector_ids.clear();
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (!founds[i]) {
+        continue;
+      }
+
+      float* vector = block.Data() + vector_ids.size() * stride;
+      status = VectorIndexBruteforce::DecodeFloatVector(values[i], dimension, vector);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("[vector_index.bruteforce] decode vector {} failed, error: {}", block_ids[i],
+                                        status.error_str());
+        return status;
+      }
+      if (normalize) {
+        VectorDistance::Normalize(vector, dimension);
+      }
+      vector_ids.push_back(block_ids[i]);
+    }
+
+    if (!vector_ids.empty()) {
+      handler(vector_ids, block.Data());
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexBruteforce::DecodeFloatVector(std::string_view value, int32_t dimension, float* buffer) {
+  using google::protobuf::internal::WireFormatLite;
+
+  google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(value.data()),
+                                               static_cast<int>(value.size()));
+  int32_t count = 0;
+  for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+    if (WireFormatLite::GetTagFieldNumber(tag) == pb::common::Vector::kFloatValuesFieldNumber) {
+      auto wire_type = WireFormatLite::GetTagWireType(tag);
+      if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+        // Packed floats are little endian on wire, same as memory layout of x86 and arm.
+        uint32_t length = 0;
+        if (!input.ReadVarint32(&length) || length % sizeof(float) != 0 ||
+            count + length / sizeof(float) > static_cast<size_t>(dimension) || !input.ReadRaw(buffer + count, length)) {
+          return butil::Status(pb::error::EVECTOR_INVALID,
+                               fmt::format("float values not match dimension {}", dimension));
+        }
+        count += length / sizeof(float);
+        continue;
+      } else if (wire_type == WireFormatLite::WIRETYPE_FIXED32) {
+        uint32_t bits = 0;
+        if (count >= dimension || !input.ReadLittleEndian32(&bits)) {
+          return butil::Status(pb::error::EVECTOR_INVALID,
+                               fmt::format("float values not match dimension {}", dimension));
+        }
+        memcpy(buffer + count, &bits, sizeof(float));
+        ++count;
+        continue;
+      }
+    }
+
+    if (!WireFormatLite::SkipField(&input, tag)) {
+      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+    }
+  }
+
+  if (count != dimension) {
+    return butil::Status(
+        pb::error::EVECTOR_INVALID,
+        fmt::format("vector dimension is not equal to index dimension, float_value_size: {}, index dimension: {}",
+                    count, dimension));
+  }
+
+  return butil::Status::OK();
+}
+
+// Top-k search of queries over the vector blocks from read_blocks(stride, normalize, handler).
+template <typename BlockReader>
+static butil::Status SearchBlocks(pb::common::MetricType metric_type, int32_t dimension,
+                                  const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                  BlockReader&& read_blocks,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+  auto status = CheckParameter(metric_type, dimension);
+  if (!status.ok()) {
+    return status;
+  }
+
+  bool is_l2 = metric_type == pb::common::MetricType::METRIC_TYPE_L2;
+  bool normalize = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  size_t stride = AlignedFloatBuffer::Stride(dimension);
+
+  AlignedFloatBuffer queries(vector_with_ids.size() * stride);
+  status = CopyQueryVectors(vector_with_ids, dimension, stride, normalize, queries);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::vector<TopkHeap> heaps(vector_with_ids.size(), TopkHeap(topk));
+  std::vector<float> distances;
+
+  status = read_blocks(stride, normalize, [&](const std::vector<int64_t>& vector_ids, const float* block) {
+    distances.resize(vector_ids.size());
+    for (size_t i = 0; i < heaps.size(); ++i) {
+      ComputeDistances(is_l2, queries.Data() + i * stride, block, vector_ids.size(), stride, distances.data());
+
+      auto& heap = heaps[i];
+      for (size_t j = 0; j < vector_ids.size(); ++j) {
+        heap.Push(distances[j], vector_ids[j]);
+      }
+    }
+  });
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (auto& heap : heaps) {
+    auto& result = results.emplace_back();
+    for (const auto& [distance, vector_id] : heap.Sort()) {
+      AddVectorWithDistance(vector_id, distance, metric_type, dimension, result);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+// Range search of queries over the vector blocks from read_blocks(stride, normalize, handler).
+template <typename BlockReader>
+static butil::Status RangeSearchBlocks(pb::common::MetricType metric_type, int32_t dimension,
+                                       const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+                                       BlockReader&& read_blocks,
+                                       std::vector<pb::index::VectorWithDistanceResult>& results) {
+  auto status = CheckParameter(metric_type, dimension);
+  if (!status.ok()) {
+    return status;
+  }
+
+  bool is_l2 = metric_type == pb::common::MetricType::METRIC_TYPE_L2;
+  bool normalize = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  size_t stride = AlignedFloatBuffer::Stride(dimension);
+
+  AlignedFloatBuffer queries(vector_with_ids.size() * stride);
+  status = CopyQueryVectors(vector_with_ids, dimension, stride, normalize, queries);
+  if (!status.ok()) {
+    return status;
+  }
+
+  size_t result_offset = results.size();
+  results.resize(result_offset + vector_with_ids.size());
+  std::vector<bool> exceed_limits(vector_with_ids.size(), false);
+  std::vector<float> distances;
+
+  status = read_blocks(stride, normalize, [&](const std::vector<int64_t>& vector_ids, const float* block) {
+    distances.resize(vector_ids.size());
+    for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+      if (exceed_limits[i]) {
+        continue;
+      }
+
+      ComputeDistances(is_l2, queries.Data() + i * stride, block, vector_ids.size(), stride, distances.data());
+
+      auto& result = results[result_offset + i];
+      for (size_t j = 0; j < vector_ids.size(); ++j) {
+        if (distances[j] >= radius) {
+          continue;
+        }
+        if (result.vector_with_distances_size() >= FLAGS_vector_index_max_range_search_result_count) {
+          DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}",
+                                            FLAGS_vector_index_max_range_search_result_count);
+          exceed_limits[i] = true;
+          break;
+        }
+        AddVectorWithDistance(vector_ids[j], distances[j], metric_type, dimension, result);
+      }
+    }
+  });
+  if (!status.ok()) {
+    results.resize(result_offset);
+    return status;
+  }
+
+  return butil::Status::OK();
+}
+
+
+butil::Status VectorIndexBruteforce::ScanSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                                pb::common::MetricType metric_type, int32_t dimension,
+                                                const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                uint32_t topk,
+                                                const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                                std::vector<pb::index::VectorWithDistanceResult>& results) {
+  return SearchBlocks(
+      metric_type, dimension, vector_with_ids, topk,
+      [&](size_t stride, bool normalize, auto&& handler) {
+        return ScanVectorBlocks(reader, range, dimension, stride, normalize, filters, handler);
+      },
+      results);
+}
+
+butil::Status VectorIndexBruteforce::ScanRangeSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                                     pb::common::MetricType metric_type, int32_t dimension,
+                                                     const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                     float radius,
+                                                     const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                                     std::vector<pb::index::VectorWithDistanceResult>& results) {
+  return RangeSearchBlocks(
+      metric_type, dimension, vector_with_ids, radius,
+      [&](size_t stride, bool normalize, auto&& handler) {
+        return ScanVectorBlocks(reader, range, dimension, stride, normalize, filters, handler);
+      },
+      results);
+}
+
+butil::Status VectorIndexBruteforce::CandidateSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                                     pb::common::MetricType metric_type, int32_t dimension,
+                                                     const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                     uint32_t topk, const std::vector<int64_t>& candidate_ids,
+                                                     std::vector<pb::index::VectorWithDistanceResult>& results) {
+  return SearchBlocks(
+      metric_type, dimension, vector_with_ids, topk,
+      [&](size_t stride, bool normalize, auto&& handler) {
+        return ReadVectorBlocks(reader, range, candidate_ids, dimension, stride, normalize, handler);
+      },
+      results);
+}
+
+butil::Status VectorIndexBruteforce::CandidateRangeSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                                          pb::common::MetricType metric_type, int32_t dimension,
+                                                          const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                          float radius, const std::vector<int64_t>& candidate_ids,
+                                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
+  return RangeSearchBlocks(
+      metric_type, dimension, vector_with_ids, radius,
+      [&](size_t stride, bool normalize, auto&& handler) {
+        return ReadVectorBlocks(reader, range, candidate_ids, dimension, stride, normalize, handler);
+      },
+      results);
+}
+
 }  // namespace dingodb
@@ -22,23 +22,27 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "bthread/mutex.h"
 #include "butil/status.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "engine/raw_engine.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "proto/index.pb.h"
 #include "vector/vector_index.h"
 
 namespace dingodb {
 
 // VectorIndexBruteforce is a simple vector index implementation
 // which is used for testing and benchmarking.
-// In this vector index, we do not implement any index structure, any vector index add, del, search or range search
-// All of them are done by brute force, which is processed by VectorReader.
+// In this vector index, we do not implement any index structure, vector data only live in raw engine.
+// Search and range search are done by ScanSearch/ScanRangeSearch, which stream the region vector data
+// from kVectorDataCF into a block buffer and compute distance with simd kernels(VectorDistance).
 class VectorIndexBruteforce : public VectorIndex {
  public:
   explicit VectorIndexBruteforce(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
@@ -89,6 +93,38 @@ class VectorIndexBruteforce : public VectorIndex {
 
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  // Brute force top-k search over the vector data of range, keep a fixed-size top-k heap per query.
+  // The result of every query is sorted by distance, distance is same as faiss index(L2 is squared, IP/COSINE is 1-ip).
+  static butil::Status ScanSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                  pb::common::MetricType metric_type, int32_t dimension,
+                                  const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                  const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  // Brute force range search over the vector data of range, return the vectors whose distance less than radius,
+  // at most FLAGS_vector_index_max_range_search_result_count per query.
+  static butil::Status ScanRangeSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                       pb::common::MetricType metric_type, int32_t dimension,
+                                       const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+                                       const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                       std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  // Same as ScanSearch/ScanRangeSearch, but only the candidate ids are read by point lookup instead of scanning
+  // the whole range, used when a very selective pre filter give a short candidate list.
+  static butil::Status CandidateSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                       pb::common::MetricType metric_type, int32_t dimension,
+                                       const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                       const std::vector<int64_t>& candidate_ids,
+                                       std::vector<pb::index::VectorWithDistanceResult>& results);
+  static butil::Status CandidateRangeSearch(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                                            pb::common::MetricType metric_type, int32_t dimension,
+                                            const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+                                            const std::vector<int64_t>& candidate_ids,
+                                            std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  // Decode float values of pb::common::Vector wire data into buffer without creating message.
+  static butil::Status DecodeFloatVector(std::string_view value, int32_t dimension, float* buffer);
+
  private:
   // Dimension of the elements
   faiss::idx_t dimension_;
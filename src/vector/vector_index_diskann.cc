@@ -0,0 +1,706 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_diskann.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "disk_utils.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "linux_aligned_file_reader.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "server/server.h"
+#include "vector/vector_distance.h"
+#include "vector/vector_index_utils.h"
+#include "vector/vector_search_executor.h"
+
+namespace dingodb {
+
+DEFINE_string(diskann_work_path, "", "diskann data and index file path, default is {vector.index_path}/diskann");
+DEFINE_int64(diskann_min_build_count, 10000, "diskann keep vectors in memory without disk index below the count");
+DEFINE_int32(diskann_build_list_size, 100, "diskann default candidate list size of building graph");
+DEFINE_double(diskann_build_dram_budget_gb, 4.0, "diskann memory budget of building graph in GB");
+DEFINE_int32(diskann_search_list_size, 100, "diskann default candidate list size of search");
+DEFINE_int32(diskann_search_beam_width, 4, "diskann default beam width of search");
+DEFINE_int32(diskann_search_filter_expand_factor, 4, "diskann expand topk by the factor when search with filter");
+DEFINE_int64(diskann_cache_node_num, 4096, "diskann cached graph node num around the entry point");
+DEFINE_double(diskann_rebuild_delta_ratio, 0.2, "diskann rebuild when delta and deleted count exceed the ratio");
+DEFINE_int64(diskann_need_save_count, 10000, "diskann need save count");
+
+DECLARE_int32(vector_search_executor_thread_num);
+
+// Meta file of snapshot: dimension, disk ids, deleted ids, delta vectors.
+static constexpr uint32_t kDiskAnnMetaVersion = 1;
+
+template <typename T>
+static bool WriteValue(std::ofstream& file, const T& value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  return file.good();
+}
+
+template <typename T>
+static bool ReadValue(std::ifstream& file, T& value) {
+  file.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return file.good();
+}
+
+static bool CheckFilters(const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, int64_t vector_id) {
+  for (const auto& filter : filters) {
+    if (!filter->Check(vector_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static diskann::Metric ToDiskAnnMetric(pb::common::MetricType metric_type) {
+  // Cosine is L2 of normalized vectors.
+  return metric_type == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT ? diskann::Metric::INNER_PRODUCT
+                                                                          : diskann::Metric::L2;
+}
+
+// Hard link file, copy it when link is not possible, e.g. cross device.
+// It may run in the forked child process, so no log here.
+static bool LinkOrCopyFile(const std::string& src_path, const std::string& dst_path) {
+  if (::link(src_path.c_str(), dst_path.c_str()) == 0) {
+    return true;
+  }
+
+  std::error_code ec;
+  std::filesystem::copy_file(src_path, dst_path, std::filesystem::copy_options::overwrite_existing, ec);
+  return !ec;
+}
+
+VectorIndexDiskAnn::VectorIndexDiskAnn(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                                       const pb::common::RegionEpoch& epoch, const pb::common::Range& range)
+    : VectorIndex(id, vector_index_parameter, epoch, range) {
+  const auto& diskann_parameter = vector_index_parameter.diskann_parameter();
+  dimension_ = diskann_parameter.dimension();
+  metric_type_ = diskann_parameter.metric_type();
+  normalize_ = metric_type_ == pb::common::MetricType::METRIC_TYPE_COSINE;
+
+  std::string root_path = FLAGS_diskann_work_path.empty() ? fmt::format("{}/diskann", Server::GetIndexPath())
+                                                          : FLAGS_diskann_work_path;
+  work_path_ = fmt::format("{}/{}_{}", root_path, id, Helper::TimestampNs());
+  auto status = Helper::CreateDirectories(work_path_);
+  if (!status.ok()) {
+    throw std::runtime_error(fmt::format("create diskann work path {} failed, {}", work_path_, status.error_str()));
+  }
+
+  data_file_.open(DataFilePath(), std::ios::binary | std::ios::trunc);
+  int32_t count = 0;
+  int32_t dimension = dimension_;
+  if (!data_file_.is_open() || !WriteValue(data_file_, count) || !WriteValue(data_file_, dimension)) {
+    throw std::runtime_error(fmt::format("open diskann data file {} failed", DataFilePath()));
+  }
+}
+
+VectorIndexDiskAnn::~VectorIndexDiskAnn() {
+  disk_index_.reset();
+  reader_.reset();
+  if (data_file_.is_open()) {
+    data_file_.close();
+  }
+
+  Helper::RemoveAllFileOrDirectory(work_path_);
+}
+
+butil::Status VectorIndexDiskAnn::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return AddOrUpsert(vector_with_ids, false);
+}
+
+butil::Status VectorIndexDiskAnn::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return AddOrUpsert(vector_with_ids, true);
+}
+
+butil::Status VectorIndexDiskAnn::AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                              bool /*is_upsert*/) {
+  if (vector_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndCopyVectorData(vector_with_ids, dimension_, normalize_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    const float* vector = vectors.get() + i * dimension_;
+    if (!built_) {
+      auto stage_status = StageVector(vector_with_ids[i].id(), vector);
+      if (!stage_status.ok()) {
+        return stage_status;
+      }
+    } else {
+      UpsertDelta(vector_with_ids[i].id(), vector);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::StageVector(int64_t vector_id, const float* vector) {
+  // Disk index point is located by binary search of ascending ids, out of order id goes to delta.
+  if (!disk_ids_.empty() && vector_id <= disk_ids_.back()) {
+    UpsertDelta(vector_id, vector);
+    return butil::Status::OK();
+  }
+
+  data_file_.write(reinterpret_cast<const char*>(vector), dimension_ * sizeof(float));
+  if (!data_file_.good()) {
+    std::string s = fmt::format("[vector_index.diskann][id({})] write data file {} failed", Id(), DataFilePath());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+  disk_ids_.push_back(vector_id);
+
+  return butil::Status::OK();
+}
+
+void VectorIndexDiskAnn::UpsertDelta(int64_t vector_id, const float* vector) {
+  if (IsInDiskIndex(vector_id)) {
+    deleted_ids_.insert(vector_id);
+  }
+  delta_vectors_[vector_id].assign(vector, vector + dimension_);
+}
+
+butil::Status VectorIndexDiskAnn::Delete(const std::vector<int64_t>& delete_ids) {
+  if (delete_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  for (auto vector_id : delete_ids) {
+    delta_vectors_.erase(vector_id);
+    if (IsInDiskIndex(vector_id)) {
+      deleted_ids_.insert(vector_id);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+bool VectorIndexDiskAnn::IsInDiskIndex(int64_t vector_id) const {
+  return std::binary_search(disk_ids_.begin(), disk_ids_.end(), vector_id);
+}
+
+butil::Status VectorIndexDiskAnn::Build() {
+  RWLockWriteGuard guard(&rw_lock_);
+  if (built_) {
+    return butil::Status::OK();
+  }
+
+  auto status = BuildDiskIndex();
+  if (!status.ok()) {
+    return status;
+  }
+
+  built_ = true;
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::BuildDiskIndex() {
+  int64_t start_time = Helper::TimestampMs();
+
+  // DiskANN data file header: int32 point count, int32 dimension.
+  int32_t count = static_cast<int32_t>(disk_ids_.size());
+  data_file_.seekp(0);
+  WriteValue(data_file_, count);
+  data_file_.close();
+  if (data_file_.fail()) {
+    std::string s = fmt::format("[vector_index.diskann][id({})] close data file {} failed", Id(), DataFilePath());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  if (count < FLAGS_diskann_min_build_count) {
+    // Too few vectors to train PQ and build graph, keep them in memory until rebuild.
+    std::ifstream data_file(DataFilePath(), std::ios::binary);
+    data_file.seekg(2 * sizeof(int32_t));
+    std::vector<float> vector(dimension_);
+    for (auto vector_id : disk_ids_) {
+      data_file.read(reinterpret_cast<char*>(vector.data()), dimension_ * sizeof(float));
+      if (!data_file.good()) {
+        std::string s = fmt::format("[vector_index.diskann][id({})] read data file {} failed", Id(), DataFilePath());
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(pb::error::Errno::EINTERNAL, s);
+      }
+      // Deleted or overwritten by a newer delta vector.
+      if (deleted_ids_.count(vector_id) == 0) {
+        delta_vectors_.emplace(vector_id, vector);
+      }
+    }
+    disk_ids_.clear();
+    deleted_ids_.clear();
+    Helper::RemoveFileOrDirectory(DataFilePath());
+
+    DINGO_LOG(INFO) << fmt::format("[vector_index.diskann][id({})] skip build disk index, count({}) delta({})", Id(),
+                                   count, delta_vectors_.size());
+    return butil::Status::OK();
+  }
+
+  const auto& diskann_parameter = vector_index_parameter.diskann_parameter();
+  uint32_t num_neighbors = diskann_parameter.num_neighbors();
+  uint32_t build_list_size = diskann_parameter.build_list_size() > 0
+                                 ? diskann_parameter.build_list_size()
+                                 : std::max(static_cast<uint32_t>(FLAGS_diskann_build_list_size), num_neighbors);
+  // DiskANN derive the PQ chunk num from search memory budget / point count, so the budget is made from pq bytes.
+  double search_dram_budget_gb = (PqBytes() + 0.5) * count / (1024.0 * 1024.0 * 1024.0);
+  std::string build_parameters =
+      fmt::format("{} {} {:.9f} {} {}", num_neighbors, build_list_size, search_dram_budget_gb,
+                  FLAGS_diskann_build_dram_budget_gb, diskann_parameter.num_threads());
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.diskann][id({})] build disk index, count({}) parameters({})", Id(),
+                                 count, build_parameters);
+
+  int ret = -1;
+  try {
+    ret = diskann::build_disk_index<float>(DataFilePath().c_str(), DiskIndexPrefix().c_str(),
+                                           build_parameters.c_str(), ToDiskAnnMetric(metric_type_));
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.diskann][id({})] build disk index exception: {}", Id(), e.what());
+  }
+  Helper::RemoveFileOrDirectory(DataFilePath());
+  if (ret != 0) {
+    std::string s = fmt::format("[vector_index.diskann][id({})] build disk index failed, ret: {}", Id(), ret);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  auto status = LoadDiskIndex();
+  if (!status.ok()) {
+    return status;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.diskann][id({})] build disk index finish, count({}) elapsed time({}ms)",
+                                 Id(), count, Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::LoadDiskIndex() {
+  // The number of search scratch, one search thread hold one scratch, so it is same as search executor.
+  uint32_t num_threads = std::max(FLAGS_vector_search_executor_thread_num, 1);
+
+  try {
+    reader_ = std::make_shared<LinuxAlignedFileReader>();
+    disk_index_ = std::make_unique<diskann::PQFlashIndex<float>>(reader_, ToDiskAnnMetric(metric_type_));
+    int ret = disk_index_->load(num_threads, DiskIndexPrefix().c_str());
+    if (ret != 0) {
+      disk_index_.reset();
+      std::string s = fmt::format("[vector_index.diskann][id({})] load disk index failed, ret: {}", Id(), ret);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    if (disk_index_->get_num_points() != disk_ids_.size()) {
+      std::string s = fmt::format("[vector_index.diskann][id({})] disk index point num({}) not match id num({})", Id(),
+                                  disk_index_->get_num_points(), disk_ids_.size());
+      disk_index_.reset();
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    // Cache the graph nodes near the entry point, which are visited by every search.
+    if (FLAGS_diskann_cache_node_num > 0) {
+      std::vector<uint32_t> node_list;
+      disk_index_->cache_bfs_levels(std::min(static_cast<uint64_t>(FLAGS_diskann_cache_node_num),
+                                             static_cast<uint64_t>(disk_ids_.size())),
+                                    node_list);
+      disk_index_->load_cache_list(node_list);
+    }
+  } catch (std::exception& e) {
+    disk_index_.reset();
+    std::string s = fmt::format("[vector_index.diskann][id({})] load disk index exception: {}", Id(), e.what());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::Search(std::vector<pb::common::VectorWithId> vector_with_ids, uint32_t topk,
+                                         std::vector<std::shared_ptr<FilterFunctor>> filters, bool,
+                                         const pb::common::VectorSearchParameter& parameter,
+                                         std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    DINGO_LOG(WARNING) << "vector_with_ids is empty";
+    return butil::Status::OK();
+  }
+
+  if (topk == 0) {
+    DINGO_LOG(WARNING) << "topk is invalid";
+    return butil::Status::OK();
+  }
+
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndCopyVectorData(vector_with_ids, dimension_, normalize_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  const auto& diskann_parameter = parameter.diskann();
+  uint32_t search_list_size = diskann_parameter.search_list_size() > 0 ? diskann_parameter.search_list_size()
+                                                                       : FLAGS_diskann_search_list_size;
+  uint32_t beam_width =
+      diskann_parameter.beam_width() > 0 ? diskann_parameter.beam_width() : FLAGS_diskann_search_beam_width;
+
+  std::vector<std::vector<DistanceIdPair>> search_results(vector_with_ids.size());
+
+  RWLockReadGuard guard(&rw_lock_);
+  if (!built_) {
+    return butil::Status(pb::error::Errno::EVECTOR_INDEX_NOT_READY, "diskann index is not built");
+  }
+
+  if (disk_index_ != nullptr) {
+    // Disk index search block on disk io, so use vector search executor instead of bthread worker.
+    auto status2 = VectorSearchExecutor::GetInstance().Execute([&]() {
+      for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+        SearchDiskIndex(vectors.get() + i * dimension_, topk, search_list_size, beam_width, filters,
+                        search_results[i]);
+      }
+    });
+    if (!status2.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("VectorIndexDiskAnn::Search failed. error : {}", status2.error_str());
+      return status2;
+    }
+  }
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    auto& search_result = search_results[i];
+    SearchDelta(vectors.get() + i * dimension_, filters, search_result);
+
+    size_t result_size = std::min(search_result.size(), static_cast<size_t>(topk));
+    std::partial_sort(search_result.begin(), search_result.begin() + result_size, search_result.end());
+
+    auto& result = results.emplace_back();
+    for (size_t j = 0; j < result_size; ++j) {
+      auto* vector_with_distance = result.add_vector_with_distances();
+      auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+      vector_with_id->set_id(search_result[j].second);
+      vector_with_id->mutable_vector()->set_dimension(dimension_);
+      vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+      vector_with_distance->set_distance(search_result[j].first);
+      vector_with_distance->set_metric_type(metric_type_);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+void VectorIndexDiskAnn::SearchDiskIndex(const float* query, uint32_t topk, uint32_t search_list_size,
+                                         uint32_t beam_width,
+                                         const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                         std::vector<DistanceIdPair>& result) {
+  // Deleted and filtered points are dropped after search, so search more points to keep topk.
+  uint64_t point_num = disk_ids_.size();
+  uint64_t k_search = static_cast<uint64_t>(topk) * (filters.empty() ? 1 : FLAGS_diskann_search_filter_expand_factor) +
+                      deleted_ids_.size();
+  k_search = std::min(k_search, point_num);
+  if (k_search == 0) {
+    return;
+  }
+  uint64_t l_search = std::max(static_cast<uint64_t>(search_list_size), k_search);
+
+  std::vector<uint64_t> labels(k_search, std::numeric_limits<uint64_t>::max());
+  std::vector<float> distances(k_search, 0.0f);
+  disk_index_->cached_beam_search(query, k_search, l_search, labels.data(), distances.data(), beam_width);
+
+  for (uint64_t i = 0; i < k_search && result.size() < topk; ++i) {
+    if (labels[i] >= point_num) {
+      continue;
+    }
+    int64_t vector_id = disk_ids_[labels[i]];
+    if (deleted_ids_.count(vector_id) > 0 || !CheckFilters(filters, vector_id)) {
+      continue;
+    }
+    result.emplace_back(ConvertDiskDistance(distances[i]), vector_id);
+  }
+}
+
+void VectorIndexDiskAnn::SearchDelta(const float* query, const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                     std::vector<DistanceIdPair>& result) {
+  for (const auto& [vector_id, vector] : delta_vectors_) {
+    if (!CheckFilters(filters, vector_id)) {
+      continue;
+    }
+    result.emplace_back(CalcDistance(query, vector.data()), vector_id);
+  }
+}
+
+float VectorIndexDiskAnn::CalcDistance(const float* x, const float* y) const {
+  if (metric_type_ == pb::common::MetricType::METRIC_TYPE_L2) {
+    return VectorDistance::L2Sqr(x, y, dimension_);
+  }
+  return 1.0f - VectorDistance::InnerProduct(x, y, dimension_);
+}
+
+float VectorIndexDiskAnn::ConvertDiskDistance(float disk_distance) const {
+  switch (metric_type_) {
+    case pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT:
+      // DiskANN return the inner product.
+      return 1.0f - disk_distance;
+    case pb::common::MetricType::METRIC_TYPE_COSINE:
+      // Squared L2 of normalized vectors is 2 - 2cos.
+      return disk_distance / 2.0f;
+    default:
+      return disk_distance;
+  }
+}
+
+uint32_t VectorIndexDiskAnn::PqBytes() const {
+  int32_t pq_bytes = vector_index_parameter.diskann_parameter().pq_bytes();
+  return pq_bytes > 0 ? pq_bytes : std::max(dimension_ / 4, 1U);
+}
+
+butil::Status VectorIndexDiskAnn::RangeSearch(std::vector<pb::common::VectorWithId> /*vector_with_ids*/,
+                                              float /*radius*/,
+                                              std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> /*filters*/,
+                                              bool /*reconstruct*/,
+                                              const pb::common::VectorSearchParameter& /*parameter*/,
+                                              std::vector<pb::index::VectorWithDistanceResult>& /*results*/) {
+  return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "diskann not support range search");
+}
+
+butil::Status VectorIndexDiskAnn::Save(const std::string& path) {
+  // Save is called in the forked child process with write lock, so no lock and no log here.
+  if (BAIDU_UNLIKELY(path.empty())) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "path empty. not support");
+  }
+  if (!built_) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_TRAIN, "diskann index is not built");
+  }
+
+  std::ofstream meta_file(path, std::ios::binary | std::ios::trunc);
+  if (!meta_file.is_open()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("open meta file {} failed", path));
+  }
+
+  bool ok = WriteValue(meta_file, kDiskAnnMetaVersion) && WriteValue(meta_file, dimension_) &&
+            WriteValue(meta_file, static_cast<uint64_t>(disk_ids_.size()));
+  meta_file.write(reinterpret_cast<const char*>(disk_ids_.data()), disk_ids_.size() * sizeof(int64_t));
+  ok = ok && WriteValue(meta_file, static_cast<uint64_t>(deleted_ids_.size()));
+  for (auto vector_id : deleted_ids_) {
+    ok = ok && WriteValue(meta_file, vector_id);
+  }
+  ok = ok && WriteValue(meta_file, static_cast<uint64_t>(delta_vectors_.size()));
+  for (const auto& [vector_id, vector] : delta_vectors_) {
+    ok = ok && WriteValue(meta_file, vector_id);
+    meta_file.write(reinterpret_cast<const char*>(vector.data()), dimension_ * sizeof(float));
+  }
+  meta_file.close();
+  if (!ok || meta_file.fail()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("write meta file {} failed", path));
+  }
+
+  if (disk_index_ == nullptr) {
+    return butil::Status::OK();
+  }
+
+  // Disk index files are read only after build, so hard link them, e.g. index_disk.index -> {path}_disk.index.
+  std::string index_prefix = std::filesystem::path(DiskIndexPrefix()).filename().string();
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(work_path_, ec)) {
+    std::string filename = entry.path().filename().string();
+    if (filename.rfind(index_prefix, 0) != 0) {
+      continue;
+    }
+    std::string dst_path = path + filename.substr(index_prefix.size());
+    if (!LinkOrCopyFile(entry.path().string(), dst_path)) {
+      return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("link index file {} failed", dst_path));
+    }
+  }
+  if (ec) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("traverse {} failed, {}", work_path_, ec.message()));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::Load(const std::string& path) {
+  if (BAIDU_UNLIKELY(path.empty())) {
+    std::string s = fmt::format("path empty. not support");
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  std::ifstream meta_file(path, std::ios::binary);
+  uint32_t version = 0;
+  uint32_t dimension = 0;
+  uint64_t disk_count = 0;
+  if (!meta_file.is_open() || !ReadValue(meta_file, version) || !ReadValue(meta_file, dimension) ||
+      !ReadValue(meta_file, disk_count)) {
+    std::string s = fmt::format("[vector_index.diskann][id({})] read meta file {} failed", Id(), path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+  if (version != kDiskAnnMetaVersion || dimension != dimension_) {
+    std::string s = fmt::format("[vector_index.diskann][id({})] meta file {} not match, version({}) dimension({}/{})",
+                                Id(), path, version, dimension, dimension_);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+
+  disk_ids_.resize(disk_count);
+  meta_file.read(reinterpret_cast<char*>(disk_ids_.data()), disk_count * sizeof(int64_t));
+  uint64_t deleted_count = 0;
+  bool ok = meta_file.good() && ReadValue(meta_file, deleted_count);
+  for (uint64_t i = 0; ok && i < deleted_count; ++i) {
+    int64_t vector_id = 0;
+    ok = ReadValue(meta_file, vector_id);
+    deleted_ids_.insert(vector_id);
+  }
+  uint64_t delta_count = 0;
+  ok = ok && ReadValue(meta_file, delta_count);
+  for (uint64_t i = 0; ok && i < delta_count; ++i) {
+    int64_t vector_id = 0;
+    ok = ReadValue(meta_file, vector_id);
+    auto& vector = delta_vectors_[vector_id];
+    vector.resize(dimension_);
+    meta_file.read(reinterpret_cast<char*>(vector.data()), dimension_ * sizeof(float));
+    ok = ok && meta_file.good();
+  }
+  if (!ok) {
+    std::string s = fmt::format("[vector_index.diskann][id({})] read meta file {} failed", Id(), path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  // Loaded index does not stage vectors.
+  data_file_.close();
+  Helper::RemoveFileOrDirectory(DataFilePath());
+
+  if (disk_count > 0) {
+    // Link snapshot files into own work path, the snapshot may be removed when the index is still in use.
+    std::filesystem::path snapshot_path(path);
+    std::string snapshot_prefix = snapshot_path.filename().string();
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(snapshot_path.parent_path(), ec)) {
+      std::string filename = entry.path().filename().string();
+      if (filename.size() <= snapshot_prefix.size() || filename.rfind(snapshot_prefix, 0) != 0) {
+        continue;
+      }
+      std::string dst_path = DiskIndexPrefix() + filename.substr(snapshot_prefix.size());
+      if (!LinkOrCopyFile(entry.path().string(), dst_path)) {
+        std::string s = fmt::format("[vector_index.diskann][id({})] link index file {} failed", Id(), dst_path);
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(pb::error::Errno::EINTERNAL, s);
+      }
+    }
+    if (ec) {
+      std::string s = fmt::format("[vector_index.diskann][id({})] traverse {} failed, {}", Id(),
+                                  snapshot_path.parent_path().string(), ec.message());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    auto status = LoadDiskIndex();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  built_ = true;
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.diskann][id({})] load finish, path({}) disk({}) deleted({}) delta({})",
+                                 Id(), path, disk_ids_.size(), deleted_ids_.size(), delta_vectors_.size());
+
+  return butil::Status::OK();
+}
+
+void VectorIndexDiskAnn::LockWrite() { rw_lock_.LockWrite(); }
+
+void VectorIndexDiskAnn::UnlockWrite() { rw_lock_.UnlockWrite(); }
+
+bool VectorIndexDiskAnn::IsTrained() {
+  RWLockReadGuard guard(&rw_lock_);
+  return built_;
+}
+
+bool VectorIndexDiskAnn::SupportSave() { return true; }
+
+int32_t VectorIndexDiskAnn::GetDimension() { return this->dimension_; }
+
+pb::common::MetricType VectorIndexDiskAnn::GetMetricType() { return this->metric_type_; }
+
+butil::Status VectorIndexDiskAnn::GetCount(int64_t& count) {
+  RWLockReadGuard guard(&rw_lock_);
+  count = disk_ids_.size() - deleted_ids_.size() + delta_vectors_.size();
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::GetDeletedCount(int64_t& deleted_count) {
+  RWLockReadGuard guard(&rw_lock_);
+  deleted_count = deleted_ids_.size();
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::GetMemorySize(int64_t& memory_size) {
+  RWLockReadGuard guard(&rw_lock_);
+  // PQ codes and id map of disk index, the graph and full precision vectors are on disk.
+  int64_t disk_memory_size = disk_index_ != nullptr ? disk_ids_.size() * (PqBytes() + sizeof(int64_t)) : 0;
+  memory_size = disk_memory_size + deleted_ids_.size() * sizeof(int64_t) +
+                delta_vectors_.size() * (dimension_ * sizeof(float) + sizeof(int64_t));
+  return butil::Status::OK();
+}
+
+bool VectorIndexDiskAnn::IsExceedsMaxElements() { return false; }
+
+bool VectorIndexDiskAnn::NeedToRebuild() {
+  RWLockReadGuard guard(&rw_lock_);
+  if (!built_) {
+    return false;
+  }
+
+  // Delta is brute force searched and deleted points expand the disk search, rebuild to merge them into disk index.
+  int64_t change_count = delta_vectors_.size() + deleted_ids_.size();
+  return change_count > std::max(FLAGS_diskann_min_build_count,
+                                 static_cast<int64_t>(disk_ids_.size() * FLAGS_diskann_rebuild_delta_ratio));
+}
+
+bool VectorIndexDiskAnn::NeedToSave(int64_t last_save_log_behind) {
+  RWLockReadGuard guard(&rw_lock_);
+  if (!built_ || (disk_ids_.empty() && delta_vectors_.empty())) {
+    return false;
+  }
+
+  return last_save_log_behind > FLAGS_diskann_need_save_count;
+}
+
+}  // namespace dingodb
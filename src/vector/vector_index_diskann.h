@@ -0,0 +1,159 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_DISKANN_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_DISKANN_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "aligned_file_reader.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "pq_flash_index.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+
+namespace dingodb {
+
+// SSD resident vector index based on DiskANN.
+// The graph and the full precision vectors live in the disk index file, only the PQ compressed vectors
+// are kept in memory to guide the graph search, the final candidates are re-ranked by full precision vectors on disk.
+//
+// DiskANN build the graph from the whole data set and the disk index is read only, so:
+//   1. Before Build(), Add() stages the vectors into a data file in the work path instead of memory.
+//   2. Build() builds the disk index from the data file, small data set is kept in memory without disk index.
+//   3. After Build(), upserted vectors live in the in-memory delta, deleted or overwritten disk vectors are
+//      marked deleted. Search merges disk index and delta, NeedToRebuild() when delta is too large.
+// Distance is same as faiss index, L2 is squared, IP/COSINE is 1-ip.
+class VectorIndexDiskAnn : public VectorIndex {
+ public:
+  explicit VectorIndexDiskAnn(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                              const pb::common::RegionEpoch& epoch, const pb::common::Range& range);
+
+  ~VectorIndexDiskAnn() override;
+
+  VectorIndexDiskAnn(const VectorIndexDiskAnn& rhs) = delete;
+  VectorIndexDiskAnn& operator=(const VectorIndexDiskAnn& rhs) = delete;
+  VectorIndexDiskAnn(VectorIndexDiskAnn&& rhs) = delete;
+  VectorIndexDiskAnn& operator=(VectorIndexDiskAnn&& rhs) = delete;
+
+  // Save write the meta(ids and delta) to path, and hard link the disk index files beside it with path as prefix.
+  butil::Status Save(const std::string& path) override;
+  butil::Status Load(const std::string& path) override;
+
+  butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+
+  butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+
+  butil::Status Delete(const std::vector<int64_t>& delete_ids) override;
+
+  butil::Status Search(std::vector<pb::common::VectorWithId> vector_with_ids, uint32_t topk,
+                       std::vector<std::shared_ptr<FilterFunctor>> filters, bool reconstruct,
+                       const pb::common::VectorSearchParameter& parameter,
+                       std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  butil::Status RangeSearch(std::vector<pb::common::VectorWithId> vector_with_ids, float radius,
+                            std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters, bool reconstruct,
+                            const pb::common::VectorSearchParameter& parameter,
+                            std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  void LockWrite() override;
+  void UnlockWrite() override;
+  butil::Status Build() override;
+  bool IsTrained() override;
+  bool SupportSave() override;
+
+  int32_t GetDimension() override;
+  pb::common::MetricType GetMetricType() override;
+  butil::Status GetCount(int64_t& count) override;
+  butil::Status GetDeletedCount(int64_t& deleted_count) override;
+  butil::Status GetMemorySize(int64_t& memory_size) override;
+  bool IsExceedsMaxElements() override;
+  butil::Status Train([[maybe_unused]] const std::vector<float>& train_datas) override { return butil::Status::OK(); }
+  butil::Status Train([[maybe_unused]] const std::vector<pb::common::VectorWithId>& vectors) override {
+    return butil::Status::OK();
+  }
+
+  bool NeedToRebuild() override;
+
+  bool NeedToSave(int64_t last_save_log_behind) override;
+
+ private:
+  using DistanceIdPair = std::pair<float, int64_t>;
+
+  std::string DataFilePath() const { return work_path_ + "/data.bin"; }
+  std::string DiskIndexPrefix() const { return work_path_ + "/index"; }
+
+  butil::Status AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_upsert);
+  butil::Status StageVector(int64_t vector_id, const float* vector);
+  void UpsertDelta(int64_t vector_id, const float* vector);
+
+  // Build disk index from data file, or move the staged vectors into delta when the data set is small.
+  butil::Status BuildDiskIndex();
+  butil::Status LoadDiskIndex();
+
+  // Search disk index and delta of one query, result is not sorted.
+  void SearchDiskIndex(const float* query, uint32_t topk, uint32_t search_list_size, uint32_t beam_width,
+                       const std::vector<std::shared_ptr<FilterFunctor>>& filters, std::vector<DistanceIdPair>& result);
+  void SearchDelta(const float* query, const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                   std::vector<DistanceIdPair>& result);
+
+  bool IsInDiskIndex(int64_t vector_id) const;
+  float CalcDistance(const float* x, const float* y) const;
+  float ConvertDiskDistance(float disk_distance) const;
+  uint32_t PqBytes() const;
+
+  // Dimension of the elements
+  uint32_t dimension_;
+
+  pb::common::MetricType metric_type_;
+
+  // Cosine is built as L2 of normalized vectors.
+  bool normalize_;
+
+  // The own directory of data file and disk index files, removed when vector index destroy.
+  std::string work_path_;
+
+  RWLock rw_lock_;
+
+  bool built_{false};
+
+  // Staged vectors before Build(), the header(int32 count, int32 dimension) is written at Build().
+  std::ofstream data_file_;
+
+  // Vector id of disk index point, disk_ids_[i] is the vector id of point i, ascending.
+  // Before Build(), it is the vector id of staged vectors.
+  std::vector<int64_t> disk_ids_;
+
+  std::shared_ptr<AlignedFileReader> reader_;
+  std::unique_ptr<diskann::PQFlashIndex<float>> disk_index_;
+
+  // Disk index vectors which are deleted or overwritten by upsert.
+  std::unordered_set<int64_t> deleted_ids_;
+
+  // Vectors upserted after Build(), searched by brute force.
+  std::unordered_map<int64_t, std::vector<float>> delta_vectors_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_DISKANN_H_  // NOLINT
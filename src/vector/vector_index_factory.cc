@@ -29,6 +29,9 @@
 #include "server/server.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_bruteforce.h"
+#ifdef ENABLE_DISKANN
+#include "vector/vector_index_diskann.h"
+#endif
 #include "vector/vector_index_flat.h"
 #include "vector/vector_index_hnsw.h"
 #include "vector/vector_index_ivf_flat.h"
@@ -64,8 +67,13 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
       break;
     }
     case pb::common::VECTOR_INDEX_TYPE_DISKANN: {
-      DINGO_LOG(ERROR) << "vector_index_parameter = diskann not implement, type=" << index_parameter.vector_index_type()
-                       << ", id=" << id << ", parameter=" << index_parameter.ShortDebugString();
+#ifdef ENABLE_DISKANN
+      vector_index = NewDiskAnn(id, index_parameter, epoch, range);
+#else
+      DINGO_LOG(ERROR) << "vector_index_parameter = diskann not enabled, build with WITH_DISKANN, type="
+                       << index_parameter.vector_index_type() << ", id=" << id
+                       << ", parameter=" << index_parameter.ShortDebugString();
+#endif
       break;
     }
     case pb::common::VectorIndexType_INT_MIN_SENTINEL_DO_NOT_USE_:
@@ -110,6 +118,10 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewHnsw(int64_t id,
     DINGO_LOG(ERROR) << "vector_index_parameter is illegal, nlinks is 0";
     return nullptr;
   }
+  if (!pb::common::HnswQuantizerType_IsValid(hnsw_parameter.quantizer_type())) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, quantizer_type is invalid";
+    return nullptr;
+  }
 
   // create index may throw exeception, so we need to catch it
   try {
@@ -324,4 +336,42 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewIvfPq(int64_t id,
   }
 }
 
+#ifdef ENABLE_DISKANN
+std::shared_ptr<VectorIndex> VectorIndexFactory::NewDiskAnn(int64_t id,
+                                                            const pb::common::VectorIndexParameter& index_parameter,
+                                                            const pb::common::RegionEpoch& epoch,
+                                                            const pb::common::Range& range) {
+  const auto& diskann_parameter = index_parameter.diskann_parameter();
+
+  if (diskann_parameter.dimension() == 0) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, dimension is 0";
+    return nullptr;
+  }
+  if (diskann_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_NONE) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, metric_type is NONE";
+    return nullptr;
+  }
+  if (diskann_parameter.num_neighbors() <= 0) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, num_neighbors <= 0";
+    return nullptr;
+  }
+  if (diskann_parameter.num_threads() <= 0) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, num_threads <= 0";
+    return nullptr;
+  }
+
+  // create index may throw exception, so we need to catch it
+  try {
+    auto new_diskann_index = std::make_shared<VectorIndexDiskAnn>(id, index_parameter, epoch, range);
+    DINGO_LOG(INFO) << "create diskann index success, id=" << id
+                    << ", parameter=" << index_parameter.ShortDebugString();
+    return new_diskann_index;
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << "create diskann index failed of exception occurred, " << e.what() << ", id=" << id
+                     << ", parameter=" << index_parameter.ShortDebugString();
+    return nullptr;
+  }
+}
+#endif
+
 }  // namespace dingodb
@@ -60,6 +60,11 @@ class VectorIndexFactory {
   static std::shared_ptr<VectorIndex> NewBruteForce(int64_t id, const pb::common::VectorIndexParameter& index_parameter,
                                                     const pb::common::RegionEpoch& epoch,
                                                     const pb::common::Range& range);
+
+#ifdef ENABLE_DISKANN
+  static std::shared_ptr<VectorIndex> NewDiskAnn(int64_t id, const pb::common::VectorIndexParameter& index_parameter,
+                                                 const pb::common::RegionEpoch& epoch, const pb::common::Range& range);
+#endif
 };
 
 }  // namespace dingodb
@@ -41,6 +41,7 @@
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_utils.h"
+#include "vector/vector_search_executor.h"
 
 namespace dingodb {
 
@@ -195,8 +196,8 @@ butil::Status VectorIndexFlat::Search(std::vector<pb::common::VectorWithId> vect
 
   {
     RWLockReadGuard guard(&rw_lock_);
-    // use std::thread to call faiss functions
-    std::thread t([&]() {
+    // use vector search executor to call faiss functions
+    auto status2 = VectorSearchExecutor::GetInstance().Execute([&]() {
       if (!filters.empty()) {
         //   // Build array index list.
         //   for (auto& filter : filters) {
@@ -215,7 +216,10 @@ butil::Status VectorIndexFlat::Search(std::vector<pb::common::VectorWithId> vect
         index_id_map2_->search(vector_with_ids.size(), vectors2.get(), topk, distances.data(), labels.data());
       }
     });
-    t.join();
+    if (!status2.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("VectorIndexFlat::Search failed. error : {}", status2.error_str());
+      return status2;
+    }
   }
 
   VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -254,32 +258,16 @@ butil::Status VectorIndexFlat::RangeSearch(std::vector<pb::common::VectorWithId>
 
   {
     RWLockReadGuard guard(&rw_lock_);
-    // use std::thread to call faiss functions
-    std::promise<butil::Status> promise_status;
-    std::future<butil::Status> future_status = promise_status.get_future();
-    // use std::thread to call faiss functions
-    std::thread t(
-        [&](std::promise<butil::Status>& promise_status) {
-          try {
-            if (!filters.empty()) {
-              DoRangeSearch(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(), filters);
-            } else {
-              index_id_map2_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get());
-            }
-            promise_status.set_value(butil::Status());
-          } catch (std::exception& e) {
-            std::string s = fmt::format("VectorIndexFlat::RangeSearch failed. error : {}", e.what());
-            promise_status.set_value(butil::Status(pb::error::Errno::EINTERNAL, s));
-          }
-        },
-        std::ref(promise_status));
-
-    butil::Status status2 = future_status.get();
-
-    t.join();
-
+    // use vector search executor to call faiss functions
+    auto status2 = VectorSearchExecutor::GetInstance().Execute([&]() {
+      if (!filters.empty()) {
+        DoRangeSearch(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(), filters);
+      } else {
+        index_id_map2_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get());
+      }
+    });
     if (!status2.ok()) {
-      DINGO_LOG(ERROR) << status2.error_cstr();
+      DINGO_LOG(ERROR) << fmt::format("VectorIndexFlat::RangeSearch failed. error : {}", status2.error_str());
       return status2;
     }
   }
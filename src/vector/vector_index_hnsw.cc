@@ -19,9 +19,11 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
+#include <queue>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -55,6 +57,7 @@ DEFINE_uint32(hnsw_max_init_max_elements, 100000, "hnsw max init max elements");
 DEFINE_uint32(hnsw_vector_batch_size_per_task, 64, "hnsw vector batch size per task");
 
 DECLARE_int64(vector_max_batch_count);
+DECLARE_int64(vector_index_max_range_search_result_count);
 
 // Filter vecotr id used by region range.
 class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
@@ -120,7 +123,10 @@ inline void ParallelFor(size_t start, size_t end, bool is_priority, Function fn)
 
 VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                  const pb::common::RegionEpoch& epoch, const pb::common::Range& range)
-    : VectorIndex(id, vector_index_parameter, epoch, range), hnsw_space_(nullptr), hnsw_index_(nullptr) {
+    : VectorIndex(id, vector_index_parameter, epoch, range),
+      hnsw_space_(nullptr),
+      quantized_space_(nullptr),
+      hnsw_index_(nullptr) {
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
     const auto& hnsw_parameter = vector_index_parameter.hnsw_parameter();
     assert(hnsw_parameter.dimension() > 0);
@@ -133,10 +139,17 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
 
     normalize_ = false;
 
-    if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
+    if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE) {
+      normalize_ = true;
+    }
+
+    quantized_space_ = HnswQuantizedSpace::New(hnsw_parameter.quantizer_type(), hnsw_parameter.metric_type(),
+                                               hnsw_parameter.dimension());
+    if (quantized_space_ != nullptr) {
+      hnsw_space_ = quantized_space_;
+    } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
       hnsw_space_ = new hnswlib::InnerProductSpace(hnsw_parameter.dimension());
     } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE) {
-      normalize_ = true;
       hnsw_space_ = new hnswlib::InnerProductSpace(hnsw_parameter.dimension());
     } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_L2) {
       hnsw_space_ = new hnswlib::L2Space(hnsw_parameter.dimension());
@@ -149,10 +162,10 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.hnsw][id({})] create index, init_max_elements={} max_element_limit={} nlinks={} "
         "efconstruction={} "
-        "metric_type={} dimension={}",
+        "metric_type={} dimension={} quantizer_type={}",
         Id(), FLAGS_hnsw_max_init_max_elements, max_element_limit_, hnsw_parameter.nlinks(),
         hnsw_parameter.efconstruction(), pb::common::MetricType_Name(hnsw_parameter.metric_type()),
-        hnsw_parameter.dimension());
+        hnsw_parameter.dimension(), pb::common::HnswQuantizerType_Name(hnsw_parameter.quantizer_type()));
 
     hnsw_index_ =
         new hnswlib::HierarchicalNSW<float>(hnsw_space_, FLAGS_hnsw_max_init_max_elements, hnsw_parameter.nlinks(),
@@ -205,21 +218,13 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
       hnsw_index_->resizeIndex(new_max_elements);
     }
 
-    if (!normalize_) {
-      ParallelFor(0, vector_with_ids.size(), is_priority, [&](size_t row) {
-        this->hnsw_index_->addPoint((void*)vector_with_ids[row].vector().float_values().data(),
-                                    vector_with_ids[row].id(), false);
-      });
-    } else {
-      ParallelFor(0, vector_with_ids.size(), is_priority, [&](size_t row) {
-        // normalize vector
-        std::vector<float> norm_array(dimension_);
-        VectorIndexUtils::NormalizeVectorForHnsw((float*)vector_with_ids[row].vector().float_values().data(),
-                                                 dimension_, norm_array.data());
-
-        this->hnsw_index_->addPoint((void*)norm_array.data(), vector_with_ids[row].id(), false);
-      });
-    }
+    ParallelFor(0, vector_with_ids.size(), is_priority, [&](size_t row) {
+      std::vector<float> norm_array;
+      std::vector<uint8_t> code;
+      const void* data = ConvertVector(vector_with_ids[row].vector().float_values().data(), norm_array, code);
+
+      this->hnsw_index_->addPoint(data, vector_with_ids[row].id(), false);
+    });
     return butil::Status();
   } catch (std::runtime_error& e) {
     int64_t current_element_count = hnsw_index_->getCurrentElementCount();
@@ -414,51 +419,240 @@ butil::Status VectorIndexHnsw::Search(std::vector<pb::common::VectorWithId> vect
     hnsw_index_->setEf(search_parameter.hnsw().efsearch());
   }
 
-  if (!normalize_) {
-    ParallelFor(0, vector_with_ids.size(), true, [&](size_t row) {
-      std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+  // The data in index is normalized or quantized, can not reconstruct from index, force reconstruct false,
+  // the caller get vector data from raw engine.
+  if (normalize_ || IsQuantized()) {
+    reconstruct = false;
+  }
+
+  ParallelFor(0, vector_with_ids.size(), true, [&](size_t row) {
+    std::vector<float> norm_array;
+    std::vector<uint8_t> code;
+    const void* query = ConvertVector(data.get() + dimension_ * row, norm_array, code);
+
+    std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+
+    try {
+      result = hnsw_index_->searchKnn(query, topk, hnsw_filter.get());
+    } catch (std::runtime_error& e) {
+      std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
+      LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+      statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+      return;
+    }
+
+    statuses[row] = lambda_reverse_rse_result_function(result, row, topk);
+    if (statuses[row].ok()) {
+      statuses[row] = lambda_fill_results_function(row, topk, reconstruct);
+    }
+  });
+
+  // check
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+const void* VectorIndexHnsw::ConvertVector(const float* vector, std::vector<float>& norm_array,
+                                           std::vector<uint8_t>& code) const {
+  if (normalize_) {
+    norm_array.resize(dimension_);
+    VectorIndexUtils::NormalizeVectorForHnsw(vector, dimension_, norm_array.data());
+    vector = norm_array.data();
+  }
+
+  if (quantized_space_ == nullptr) {
+    return vector;
+  }
+
+  code.resize(quantized_space_->get_data_size());
+  quantized_space_->Encode(vector, code.data());
+  return code.data();
+}
 
-      try {
-        result = hnsw_index_->searchKnn(data.get() + dimension_ * row, topk, hnsw_filter.get());
-      } catch (std::runtime_error& e) {
-        std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
-        LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
-        statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
-        return;
+// Range search one query on the hnsw graph, the upper layers are descended greedily like searchKnn, then layer 0 is
+// expanded best first from the entry point. A neighbor is expanded when it is within radius or among the ef nearest
+// visited points, the search stops when the nearest candidate is farther than both, so the ef points outside the
+// radius keep the search from stopping at a local minimum. Result is (distance, label) ascending, at most max_count.
+static void HnswRangeSearchOne(hnswlib::HierarchicalNSW<float>* index, const void* query, float radius, size_t ef,
+                               hnswlib::BaseFilterFunctor* filter, size_t max_count,
+                               std::vector<std::pair<float, hnswlib::labeltype>>& result) {
+  if (index->cur_element_count == 0 || max_count == 0) {
+    return;
+  }
+
+  auto distance = [index, query](hnswlib::tableint internal_id) {
+    return index->fstdistfunc_(query, index->getDataByInternalId(internal_id), index->dist_func_param_);
+  };
+
+  hnswlib::tableint cur_obj = index->enterpoint_node_;
+  float cur_dist = distance(cur_obj);
+  for (int level = index->maxlevel_; level > 0; level--) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      auto* data = reinterpret_cast<hnswlib::linklistsizeint*>(index->get_linklist(cur_obj, level));
+      int size = index->getListCount(data);
+      auto* neighbors = reinterpret_cast<hnswlib::tableint*>(data + 1);
+      for (int i = 0; i < size; i++) {
+        float dist = distance(neighbors[i]);
+        if (dist < cur_dist) {
+          cur_dist = dist;
+          cur_obj = neighbors[i];
+          changed = true;
+        }
       }
+    }
+  }
+
+  using DistanceIdPair = std::pair<float, hnswlib::tableint>;
+  std::priority_queue<DistanceIdPair, std::vector<DistanceIdPair>, std::greater<>> candidates;
+  std::priority_queue<DistanceIdPair> top_candidates;
+
+  auto bound = [&top_candidates, radius, ef]() {
+    return top_candidates.size() < ef ? std::numeric_limits<float>::max()
+                                      : std::max(radius, top_candidates.top().first);
+  };
+
+  auto visit = [&](hnswlib::tableint internal_id, float dist) {
+    candidates.emplace(dist, internal_id);
+    top_candidates.emplace(dist, internal_id);
+    if (top_candidates.size() > ef) {
+      top_candidates.pop();
+    }
+
+    if (dist >= radius || index->isMarkedDeleted(internal_id)) {
+      return;
+    }
+    hnswlib::labeltype label = index->getExternalLabel(internal_id);
+    if (filter == nullptr || (*filter)(label)) {
+      result.emplace_back(dist, label);
+    }
+  };
+
+  auto* visited_list = index->visited_list_pool_->getFreeVisitedList();
+  hnswlib::vl_type* visited = visited_list->mass;
+  hnswlib::vl_type visited_tag = visited_list->curV;
+
+  visited[cur_obj] = visited_tag;
+  visit(cur_obj, cur_dist);
 
-      statuses[row] = lambda_reverse_rse_result_function(result, row, topk);
-      if (statuses[row].ok()) {
-        statuses[row] = lambda_fill_results_function(row, topk, reconstruct);
+  while (!candidates.empty() && result.size() < max_count) {
+    auto [dist, internal_id] = candidates.top();
+    if (dist > bound()) {
+      break;
+    }
+    candidates.pop();
+
+    auto* data = index->get_linklist0(internal_id);
+    int size = index->getListCount(data);
+    auto* neighbors = reinterpret_cast<hnswlib::tableint*>(data + 1);
+    for (int i = 0; i < size; i++) {
+      hnswlib::tableint neighbor = neighbors[i];
+      if (visited[neighbor] == visited_tag) {
+        continue;
       }
-    });
-  } else {  // normalize_
-    ParallelFor(0, vector_with_ids.size(), true, [&](size_t row) {
-      std::vector<float> norm_array(dimension_);
-      VectorIndexUtils::NormalizeVectorForHnsw((float*)(data.get() + dimension_ * row), dimension_,  // NOLINT
-                                               norm_array.data());
-
-      std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
-
-      try {
-        result = hnsw_index_->searchKnn(norm_array.data(), topk, hnsw_filter.get());
-      } catch (std::runtime_error& e) {
-        std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
-        LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
-        statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
-        return;
+      visited[neighbor] = visited_tag;
+
+      float neighbor_dist = distance(neighbor);
+      if (neighbor_dist < bound()) {
+        visit(neighbor, neighbor_dist);
       }
+    }
+  }
 
-      statuses[row] = lambda_reverse_rse_result_function(result, row, topk);
+  index->visited_list_pool_->releaseVisitedList(visited_list);
 
-      // force  reconstruct false
-      if (statuses[row].ok()) {
-        statuses[row] = lambda_fill_results_function(row, topk, false);
-      }
-    });
+  std::sort(result.begin(), result.end());
+  if (result.size() > max_count) {
+    result.resize(max_count);
   }
+}
+
+butil::Status VectorIndexHnsw::RangeSearch(std::vector<pb::common::VectorWithId> vector_with_ids, float radius,
+                                           std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters,
+                                           bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                           std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  if (parameter.hnsw().efsearch() < 0 || parameter.hnsw().efsearch() > 1024) {
+    std::string s = fmt::format("efsearch is illegal, {}, must between 0 and 1024", parameter.hnsw().efsearch());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  // Normalize and quantize is done by ConvertVector.
+  const auto& [data, status] = VectorIndexUtils::CheckAndCopyVectorData(vector_with_ids, dimension_, false);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), status.error_str());
+    return status;
+  }
+  const float* data_ptr = data.get();
+
+  size_t max_count = std::max(FLAGS_vector_index_max_range_search_result_count, static_cast<int64_t>(0));
+  auto hnsw_filter = filters.empty() ? nullptr : std::make_shared<HnswRangeFilterFunctor>(filters);
+
+  results.resize(vector_with_ids.size());
+  std::vector<butil::Status> statuses(vector_with_ids.size(), butil::Status::OK());
+
+  RWLockReadGuard guard(&rw_lock_);
+
+  // Not setEf() on the shared index, the concurrent searches may use different efsearch.
+  size_t ef = parameter.hnsw().efsearch() > 0 ? parameter.hnsw().efsearch() : hnsw_index_->ef_;
+
+  // The data in index is normalized or quantized, can not reconstruct from index.
+  if (normalize_ || IsQuantized()) {
+    reconstruct = false;
+  }
+
+  ParallelFor(0, vector_with_ids.size(), true, [&](size_t row) {
+    std::vector<float> norm_array;
+    std::vector<uint8_t> code;
+    const void* query = ConvertVector(data_ptr + dimension_ * row, norm_array, code);
+
+    std::vector<std::pair<float, hnswlib::labeltype>> result;
+    try {
+      HnswRangeSearchOne(hnsw_index_, query, radius, ef, hnsw_filter.get(), max_count, result);
+    } catch (std::runtime_error& e) {
+      std::string s = fmt::format("parallel range search vector failed, error: {}", e.what());
+      LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+      statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+      return;
+    }
+
+    for (const auto& [distance, label] : result) {
+      auto* vector_with_distance = results[row].add_vector_with_distances();
+      vector_with_distance->set_distance(distance);
+      vector_with_distance->set_metric_type(this->vector_index_parameter.hnsw_parameter().metric_type());
+
+      auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+      vector_with_id->set_id(label);
+      vector_with_id->mutable_vector()->set_dimension(dimension_);
+      vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+
+      if (reconstruct) {
+        try {
+          std::vector<float> vector = hnsw_index_->getDataByLabel<float>(label);
+          for (auto& value : vector) {
+            vector_with_id->mutable_vector()->add_float_values(value);
+          }
+        } catch (std::exception& e) {
+          std::string s = fmt::format("getDataByLabel failed, label: {}  err: {}", label, e.what());
+          LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+          statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+          return;
+        }
+      }
+    }
+  });
 
-  // check
   for (const auto& status : statuses) {
     if (!status.ok()) {
       DINGO_LOG(ERROR) << status.error_cstr();
@@ -469,13 +663,6 @@ butil::Status VectorIndexHnsw::Search(std::vector<pb::common::VectorWithId> vect
   return butil::Status::OK();
 }
 
-butil::Status VectorIndexHnsw::RangeSearch(std::vector<pb::common::VectorWithId> /*vector_with_ids*/, float /*radius*/,
-                                           std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> /*filters*/,
-                                           bool /*reconstruct*/, const pb::common::VectorSearchParameter& /*parameter*/,
-                                           std::vector<pb::index::VectorWithDistanceResult>& /*results*/) {
-  return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "RangeSearch not support in Hnsw!!!");
-}
-
 void VectorIndexHnsw::LockWrite() { rw_lock_.LockWrite(); }
 
 void VectorIndexHnsw::UnlockWrite() { rw_lock_.UnlockWrite(); }
@@ -581,12 +768,14 @@ bool VectorIndexHnsw::NeedToSave(int64_t last_save_log_behind) {
 }
 
 // calc hnsw count from memory
-uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks) {
+uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+                                                  pb::common::HnswQuantizerType quantizer_type) {
   // size_links_level0_ = maxM0_ * sizeof(tableint) + sizeof(linklistsizeint);
   int64_t size_links_level0 = nlinks * 2 + sizeof(int64_t) + sizeof(int64_t);
 
   // int64_t size_data_per_element_ = size_links_level0_ + data_size_ + sizeof(labeltype);
-  int64_t size_data_per_element = size_links_level0 + sizeof(float_t) * dimension + sizeof(int64_t);
+  int64_t data_size = HnswQuantizedSpace::CodeSize(quantizer_type, dimension);
+  int64_t size_data_per_element = size_links_level0 + data_size + sizeof(int64_t);
 
   // int64_t size_link_list_per_element =  sizeof(void*);
   int64_t size_link_list_per_element = sizeof(int64_t);
@@ -614,7 +803,7 @@ butil::Status VectorIndexHnsw::CheckAndSetHnswParameter(pb::common::CreateHnswPa
   }
 
   auto max_element_limit = CalcHnswCountFromMemory(FLAGS_max_hnsw_memory_size_of_region, hnsw_parameter.dimension(),
-                                                   hnsw_parameter.nlinks());
+                                                   hnsw_parameter.nlinks(), hnsw_parameter.quantizer_type());
   hnsw_parameter.set_max_elements(max_element_limit);
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.hnsw] calc max element limit is {}, paramiter max_hnsw_memory_size_of_region({}) dimension({}) "
@@ -33,6 +33,7 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_hnsw_space.h"
 
 namespace dingodb {
 
@@ -43,7 +44,8 @@ class VectorIndexHnsw : public VectorIndex {
 
   ~VectorIndexHnsw() override;
 
-  static uint32_t CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks);
+  static uint32_t CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+                                          pb::common::HnswQuantizerType quantizer_type);
   static butil::Status CheckAndSetHnswParameter(pb::common::CreateHnswParam& hnsw_parameter);
 
   VectorIndexHnsw(const VectorIndexHnsw& rhs) = delete;
@@ -99,10 +101,18 @@ class VectorIndexHnsw : public VectorIndex {
 
   // void NormalizeVector(const float* data, float* norm_array) const;
 
+  bool IsQuantized() const { return quantized_space_ != nullptr; }
+
  private:
+  // Convert float vector to the format stored in hnsw index, normalize for cosine and encode for quantizer.
+  // The return pointer point to vector, norm_array or code.
+  const void* ConvertVector(const float* vector, std::vector<float>& norm_array, std::vector<uint8_t>& code) const;
+
   // hnsw members
   hnswlib::HierarchicalNSW<float>* hnsw_index_;
   hnswlib::SpaceInterface<float>* hnsw_space_;
+  // Same object as hnsw_space_ when vectors are quantized, otherwise nullptr.
+  HnswQuantizedSpace* quantized_space_;
 
   // Dimension of the elements
   uint32_t dimension_;
@@ -0,0 +1,253 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_hnsw_space.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+HnswQuantizedSpace* HnswQuantizedSpace::New(pb::common::HnswQuantizerType quantizer_type,
+                                            pb::common::MetricType metric_type, size_t dimension) {
+  switch (quantizer_type) {
+    case pb::common::HNSW_QUANTIZER_FP16:
+      return new HnswFp16Space(metric_type, dimension);
+    case pb::common::HNSW_QUANTIZER_SQ8:
+      return new HnswSq8Space(metric_type, dimension);
+    default:
+      return nullptr;
+  }
+}
+
+size_t HnswQuantizedSpace::CodeSize(pb::common::HnswQuantizerType quantizer_type, size_t dimension) {
+  switch (quantizer_type) {
+    case pb::common::HNSW_QUANTIZER_FP16:
+      return dimension * sizeof(uint16_t);
+    case pb::common::HNSW_QUANTIZER_SQ8:
+      return HnswSq8Space::kHeaderSize + dimension;
+    default:
+      return dimension * sizeof(float);
+  }
+}
+
+// fp16
+// Conversion with round to nearest even, handle subnormal/inf/nan like hardware.
+uint16_t HnswFp16Space::FloatToFp16(float value) {
+  constexpr uint32_t kF32Infinity = 255U << 23;
+  constexpr uint32_t kF16Max = (127U + 16U) << 23;
+  constexpr uint32_t kDenormMagic = ((127U - 15U) + (23U - 10U) + 1U) << 23;
+
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint32_t sign = bits & 0x80000000U;
+  bits ^= sign;
+
+  uint16_t result;
+  if (bits >= kF16Max) {
+    // overflow to inf, keep nan
+    result = bits > kF32Infinity ? 0x7e00 : 0x7c00;
+  } else if (bits < (113U << 23)) {
+    // subnormal or zero, let float add do the rounding
+    float magic;
+    memcpy(&magic, &kDenormMagic, sizeof(magic));
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    f += magic;
+    memcpy(&bits, &f, sizeof(bits));
+    result = static_cast<uint16_t>(bits - kDenormMagic);
+  } else {
+    uint32_t mant_odd = (bits >> 13) & 1;
+    bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff;
+    bits += mant_odd;
+    result = static_cast<uint16_t>(bits >> 13);
+  }
+
+  return static_cast<uint16_t>(result | (sign >> 16));
+}
+
+float HnswFp16Space::Fp16ToFloat(uint16_t value) {
+  constexpr uint32_t kShiftedExp = 0x7c00U << 13;
+  constexpr uint32_t kMagic = 113U << 23;
+
+  uint32_t bits = (value & 0x7fffU) << 13;
+  uint32_t exp = kShiftedExp & bits;
+  bits += (127U - 15U) << 23;
+
+  if (exp == kShiftedExp) {
+    // inf or nan
+    bits += (128U - 16U) << 23;
+  } else if (exp == 0) {
+    // zero or subnormal, renormalize
+    bits += 1U << 23;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    float magic;
+    memcpy(&magic, &kMagic, sizeof(magic));
+    f -= magic;
+    memcpy(&bits, &f, sizeof(bits));
+  }
+
+  bits |= static_cast<uint32_t>(value & 0x8000U) << 16;
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+static float Fp16L2Sqr(const void* x, const void* y, const void* param) {
+  const auto* a = static_cast<const uint16_t*>(x);
+  const auto* b = static_cast<const uint16_t*>(y);
+  size_t dimension = *static_cast<const size_t*>(param);
+
+  float sum = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    float diff = HnswFp16Space::Fp16ToFloat(a[i]) - HnswFp16Space::Fp16ToFloat(b[i]);
+    sum += diff * diff;
+  }
+  return sum;
+}
+
+static float Fp16InnerProductDistance(const void* x, const void* y, const void* param) {
+  const auto* a = static_cast<const uint16_t*>(x);
+  const auto* b = static_cast<const uint16_t*>(y);
+  size_t dimension = *static_cast<const size_t*>(param);
+
+  float sum = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    sum += HnswFp16Space::Fp16ToFloat(a[i]) * HnswFp16Space::Fp16ToFloat(b[i]);
+  }
+  return 1.0f - sum;
+}
+
+HnswFp16Space::HnswFp16Space(pb::common::MetricType metric_type, size_t dimension)
+    : HnswQuantizedSpace(pb::common::HNSW_QUANTIZER_FP16, dimension) {
+  dist_func_ = metric_type == pb::common::METRIC_TYPE_L2 ? Fp16L2Sqr : Fp16InnerProductDistance;
+}
+
+void HnswFp16Space::Encode(const float* vector, uint8_t* code) const {
+  auto* values = reinterpret_cast<uint16_t*>(code);
+  for (size_t i = 0; i < Dimension(); ++i) {
+    values[i] = FloatToFp16(vector[i]);
+  }
+}
+
+void HnswFp16Space::Decode(const uint8_t* code, float* vector) const {
+  const auto* values = reinterpret_cast<const uint16_t*>(code);
+  for (size_t i = 0; i < Dimension(); ++i) {
+    vector[i] = Fp16ToFloat(values[i]);
+  }
+}
+
+// sq8
+struct Sq8Header {
+  float min;
+  float scale;
+  float code_sum;
+  float norm_sqr;
+};
+
+static_assert(sizeof(Sq8Header) == HnswSq8Space::kHeaderSize);
+
+// Hnswlib does not promise the alignment of data, so copy the header out.
+static inline Sq8Header ReadSq8Header(const uint8_t* code) {
+  Sq8Header header;
+  memcpy(&header, code, sizeof(header));
+  return header;
+}
+
+// The loop is simple enough to be vectorized by compiler, codes dot product is at most
+// 255 * 255 * kVectorMaxDimension(32768), it does not overflow uint32.
+static inline uint32_t Sq8CodeDot(const uint8_t* a, const uint8_t* b, size_t dimension) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < dimension; ++i) {
+    sum += static_cast<uint32_t>(a[i]) * static_cast<uint32_t>(b[i]);
+  }
+  return sum;
+}
+
+// sum((min_a + scale_a * a_i) * (min_b + scale_b * b_i))
+static inline float Sq8InnerProduct(const void* x, const void* y, size_t dimension) {
+  const auto* a = static_cast<const uint8_t*>(x);
+  const auto* b = static_cast<const uint8_t*>(y);
+  auto header_a = ReadSq8Header(a);
+  auto header_b = ReadSq8Header(b);
+
+  float code_dot =
+      static_cast<float>(Sq8CodeDot(a + HnswSq8Space::kHeaderSize, b + HnswSq8Space::kHeaderSize, dimension));
+
+  return static_cast<float>(dimension) * header_a.min * header_b.min +
+         header_a.min * header_b.scale * header_b.code_sum + header_b.min * header_a.scale * header_a.code_sum +
+         header_a.scale * header_b.scale * code_dot;
+}
+
+static float Sq8L2Sqr(const void* x, const void* y, const void* param) {
+  size_t dimension = *static_cast<const size_t*>(param);
+  float norm_sqr = ReadSq8Header(static_cast<const uint8_t*>(x)).norm_sqr +
+                   ReadSq8Header(static_cast<const uint8_t*>(y)).norm_sqr;
+  return std::max(norm_sqr - 2.0f * Sq8InnerProduct(x, y, dimension), 0.0f);
+}
+
+static float Sq8InnerProductDistance(const void* x, const void* y, const void* param) {
+  size_t dimension = *static_cast<const size_t*>(param);
+  return 1.0f - Sq8InnerProduct(x, y, dimension);
+}
+
+HnswSq8Space::HnswSq8Space(pb::common::MetricType metric_type, size_t dimension)
+    : HnswQuantizedSpace(pb::common::HNSW_QUANTIZER_SQ8, dimension) {
+  dist_func_ = metric_type == pb::common::METRIC_TYPE_L2 ? Sq8L2Sqr : Sq8InnerProductDistance;
+}
+
+void HnswSq8Space::Encode(const float* vector, uint8_t* code) const {
+  size_t dimension = Dimension();
+  Sq8Header header = {0.0f, 0.0f, 0.0f, 0.0f};
+  uint8_t* values = code + kHeaderSize;
+  if (dimension == 0) {
+    memcpy(code, &header, sizeof(header));
+    return;
+  }
+
+  auto [min_it, max_it] = std::minmax_element(vector, vector + dimension);
+  header.min = *min_it;
+  header.scale = (*max_it - *min_it) / 255.0f;
+
+  uint32_t code_sum = 0;
+  float norm_sqr = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    float value = header.scale > 0.0f ? std::round((vector[i] - header.min) / header.scale) : 0.0f;
+    values[i] = static_cast<uint8_t>(std::clamp(value, 0.0f, 255.0f));
+    code_sum += values[i];
+
+    float decoded = header.min + header.scale * values[i];
+    norm_sqr += decoded * decoded;
+  }
+  header.code_sum = static_cast<float>(code_sum);
+  header.norm_sqr = norm_sqr;
+
+  memcpy(code, &header, sizeof(header));
+}
+
+void HnswSq8Space::Decode(const uint8_t* code, float* vector) const {
+  auto header = ReadSq8Header(code);
+  const uint8_t* values = code + kHeaderSize;
+  for (size_t i = 0; i < Dimension(); ++i) {
+    vector[i] = header.min + header.scale * values[i];
+  }
+}
+
+}  // namespace dingodb
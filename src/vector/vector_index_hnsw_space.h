@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_HNSW_SPACE_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_HNSW_SPACE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hnswlib/hnswlib.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Hnswlib space which stores quantized vector in the graph instead of float vector.
+// Hnswlib pass the stored data and the query to the distance function in the same format,
+// so the query must be encoded by Encode() too.
+// Distance is same as hnswlib float space, L2 is squared, IP is 1-ip.
+class HnswQuantizedSpace : public hnswlib::SpaceInterface<float> {
+ public:
+  HnswQuantizedSpace(pb::common::HnswQuantizerType quantizer_type, size_t dimension)
+      : quantizer_type_(quantizer_type), dimension_(dimension) {}
+  ~HnswQuantizedSpace() override = default;
+
+  // Return nullptr if quantizer_type is HNSW_QUANTIZER_NONE or not support.
+  // For METRIC_TYPE_COSINE, the caller must normalize vector before Encode().
+  static HnswQuantizedSpace* New(pb::common::HnswQuantizerType quantizer_type, pb::common::MetricType metric_type,
+                                 size_t dimension);
+
+  // Code size of one vector.
+  static size_t CodeSize(pb::common::HnswQuantizerType quantizer_type, size_t dimension);
+
+  // code must have get_data_size() bytes.
+  virtual void Encode(const float* vector, uint8_t* code) const = 0;
+  virtual void Decode(const uint8_t* code, float* vector) const = 0;
+
+  size_t get_data_size() override { return CodeSize(quantizer_type_, dimension_); }
+  void* get_dist_func_param() override { return &dimension_; }
+
+  pb::common::HnswQuantizerType QuantizerType() const { return quantizer_type_; }
+  size_t Dimension() const { return dimension_; }
+
+ private:
+  pb::common::HnswQuantizerType quantizer_type_;
+  size_t dimension_;
+};
+
+// Store every value as IEEE half float, 2 bytes per dimension.
+class HnswFp16Space : public HnswQuantizedSpace {
+ public:
+  HnswFp16Space(pb::common::MetricType metric_type, size_t dimension);
+
+  void Encode(const float* vector, uint8_t* code) const override;
+  void Decode(const uint8_t* code, float* vector) const override;
+
+  hnswlib::DISTFUNC<float> get_dist_func() override { return dist_func_; }
+
+  static uint16_t FloatToFp16(float value);
+  static float Fp16ToFloat(uint16_t value);
+
+ private:
+  hnswlib::DISTFUNC<float> dist_func_;
+};
+
+// 8-bit scalar quantization with the value range of each vector, no training is needed.
+// Code layout: float min, float scale, float code sum, float decoded squared norm, then uint8 code per dimension.
+// Decoded value is min + scale * code, so the distance of two codes is computed by the integer dot product of codes.
+class HnswSq8Space : public HnswQuantizedSpace {
+ public:
+  HnswSq8Space(pb::common::MetricType metric_type, size_t dimension);
+
+  void Encode(const float* vector, uint8_t* code) const override;
+  void Decode(const uint8_t* code, float* vector) const override;
+
+  hnswlib::DISTFUNC<float> get_dist_func() override { return dist_func_; }
+
+  static constexpr size_t kHeaderSize = 4 * sizeof(float);
+
+ private:
+  hnswlib::DISTFUNC<float> dist_func_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_HNSW_SPACE_H_  // NOLINT
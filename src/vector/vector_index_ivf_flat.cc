@@ -43,10 +43,13 @@
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_utils.h"
+#include "vector/vector_search_executor.h"
 
 namespace dingodb {
 DEFINE_int64(ivf_flat_need_save_count, 10000, "ivf flat need save count");
 
+DECLARE_bool(vector_index_load_snapshot_mmap);
+
 VectorIndexIvfFlat::VectorIndexIvfFlat(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                        const pb::common::RegionEpoch& epoch, const pb::common::Range& range)
     : VectorIndex(id, vector_index_parameter, epoch, range) {
@@ -106,6 +109,8 @@ butil::Status VectorIndexIvfFlat::AddOrUpsert(const std::vector<pb::common::Vect
   }
 
   std::thread([&]() {
+    // the lists loaded by mmap are read only.
+    VectorIndexUtils::MaterializeInvertedLists(index_.get());
     if (is_upsert) {
       faiss::IDSelectorArray sel(vector_with_ids.size(), ids2.get());
       index_->remove_ids(sel);
@@ -167,7 +172,10 @@ butil::Status VectorIndexIvfFlat::Delete(const std::vector<int64_t>& delete_ids)
       return butil::Status::OK();
     }
 
-    std::thread([&]() { remove_count = index_->remove_ids(sel); }).join();
+    std::thread([&]() {
+      VectorIndexUtils::MaterializeInvertedLists(index_.get());
+      remove_count = index_->remove_ids(sel);
+    }).join();
   }
 
   if (0 == remove_count) {
@@ -239,8 +247,8 @@ butil::Status VectorIndexIvfFlat::Search(std::vector<pb::common::VectorWithId> v
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
-    // use std::thread to call faiss functions
-    std::thread t([&]() {
+    // use vector search executor to call faiss functions
+    auto status2 = VectorSearchExecutor::GetInstance().Execute([&]() {
       if (!filters.empty()) {
         auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
         ivf_search_parameters.sel = ivf_flat_filter.get();
@@ -251,7 +259,10 @@ butil::Status VectorIndexIvfFlat::Search(std::vector<pb::common::VectorWithId> v
                        &ivf_search_parameters);
       }
     });
-    t.join();
+    if (!status2.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("VectorIndexIvfFlat::Search failed. error : {}", status2.error_str());
+      return status2;
+    }
   }
 
   VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -320,35 +331,20 @@ butil::Status VectorIndexIvfFlat::RangeSearch(std::vector<pb::common::VectorWith
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
-    std::promise<butil::Status> promise_status;
-    std::future<butil::Status> future_status = promise_status.get_future();
-    // use std::thread to call faiss functions
-    std::thread t(
-        [&](std::promise<butil::Status>& promise_status) {
-          try {
-            if (!filters.empty()) {
-              auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
-              ivf_search_parameters.sel = ivf_flat_filter.get();
-              index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
-                                   &ivf_search_parameters);
-            } else {
-              index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
-                                   &ivf_search_parameters);
-            }
-            promise_status.set_value(butil::Status());
-          } catch (std::exception& e) {
-            std::string s = fmt::format("VectorIndexIvfFlat::RangeSearch failed. error : {}", e.what());
-            promise_status.set_value(butil::Status(pb::error::Errno::EINTERNAL, s));
-          }
-        },
-        std::ref(promise_status));
-
-    butil::Status status2 = future_status.get();
-
-    t.join();
-
+    // use vector search executor to call faiss functions
+    auto status2 = VectorSearchExecutor::GetInstance().Execute([&]() {
+      if (!filters.empty()) {
+        auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
+        ivf_search_parameters.sel = ivf_flat_filter.get();
+        index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
+                             &ivf_search_parameters);
+      } else {
+        index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
+                             &ivf_search_parameters);
+      }
+    });
     if (!status2.ok()) {
-      DINGO_LOG(ERROR) << status2.error_cstr();
+      DINGO_LOG(ERROR) << fmt::format("VectorIndexIvfFlat::RangeSearch failed. error : {}", status2.error_str());
       return status2;
     }
   }
@@ -385,6 +381,8 @@ butil::Status VectorIndexIvfFlat::Save(const std::string& path) {
   std::thread t(
       [&](std::promise<butil::Status>& promise_status) {
         try {
+          // the mapped lists is written as a reference to the loaded snapshot file, which will be removed.
+          VectorIndexUtils::MaterializeInvertedLists(index_.get());
           faiss::write_index(index_.get(), path.c_str());
           promise_status.set_value(butil::Status());
         } catch (std::exception& e) {
@@ -423,7 +421,9 @@ butil::Status VectorIndexIvfFlat::Load(const std::string& path) {
       [&](std::promise<std::pair<faiss::Index*, butil::Status>>& promise_status) {
         faiss::Index* internal_raw_index = nullptr;
         try {
-          internal_raw_index = faiss::read_index(path.c_str(), 0);
+          // mmap the inverted lists, the lists is copied into memory at the first write.
+          int io_flags = FLAGS_vector_index_load_snapshot_mmap ? faiss::IO_FLAG_MMAP : 0;
+          internal_raw_index = faiss::read_index(path.c_str(), io_flags);
           promise_status.set_value(std::pair<faiss::Index*, butil::Status>(internal_raw_index, butil::Status()));
         } catch (std::exception& e) {
           std::string s =
@@ -529,7 +529,8 @@ butil::Status VectorIndexIvfFlat::Load(const std::string& path) {
     normalize_ = true;
   }
 
-  DINGO_LOG(INFO) << fmt::format("VectorIndexIvfFlat::Load success. path : {}", path);
+  DINGO_LOG(INFO) << fmt::format("VectorIndexIvfFlat::Load success. path : {} mmap : {}", path,
+                                 FLAGS_vector_index_load_snapshot_mmap);
 
   return butil::Status::OK();
 }
@@ -22,11 +22,16 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/binary_printer.h"
 #include "butil/status.h"
+#include "butil/time.h"
+#include "bvar/bvar.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
@@ -49,6 +54,9 @@
 #include "vector/vector_index_snapshot_manager.h"
 
 DEFINE_int64(catchup_log_min_gap, 8, "catch up log min gap");
+DEFINE_int64(vector_index_replay_wal_chunk_size, 4096, "replay wal read and decode log entry count per chunk");
+DEFINE_int32(vector_index_replay_wal_parallel_num, 4, "replay wal read and decode chunk parallel num");
+DEFINE_int64(vector_index_replay_wal_batch_size, 32768, "replay wal coalesced vector count per upsert/delete batch");
 
 namespace dingodb {
 
@@ -482,42 +490,59 @@ butil::Status VectorIndexManager::ParallelLoadOrBuildVectorIndex(std::vector<sto
   return butil::Status();
 }
 
-// Replay vector index from WAL
-butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_index, int64_t start_log_id,
-                                                         int64_t end_log_id) {
-  assert(vector_index != nullptr);
-
-  if (start_log_id >= end_log_id) {
-    return butil::Status();
+static bvar::Adder<int64_t> g_vector_index_replay_wal_log_count("dingo_vector_index_replay_wal_log_count");
+static bvar::PerSecond<bvar::Adder<int64_t>> g_vector_index_replay_wal_log_per_second(
+    "dingo_vector_index_replay_wal_log_per_second", &g_vector_index_replay_wal_log_count);
+static bvar::Adder<int64_t> g_vector_index_replay_wal_vector_count("dingo_vector_index_replay_wal_vector_count");
+static bvar::PerSecond<bvar::Adder<int64_t>> g_vector_index_replay_wal_vector_per_second(
+    "dingo_vector_index_replay_wal_vector_per_second", &g_vector_index_replay_wal_vector_count);
+static bvar::Adder<int64_t> g_vector_index_replay_wal_coalesced_count(
+    "dingo_vector_index_replay_wal_coalesced_count");
+static bvar::LatencyRecorder g_vector_index_replay_wal_batch_latency("dingo_vector_index_replay_wal_batch");
+
+// Vector operations coalesced by vector id, the last write wins, so upserts and deletes are disjoint
+// and can be applied to the vector index in any order.
+struct ReplayWalBatch {
+  void Upsert(pb::common::VectorWithId& vector) {
+    auto vector_id = vector.id();
+    deletes.erase(vector_id);
+    upserts[vector_id].Swap(&vector);
+  }
+
+  void Delete(int64_t vector_id) {
+    upserts.erase(vector_id);
+    deletes.insert(vector_id);
+  }
+
+  // Merge the later batch into this batch.
+  void Merge(ReplayWalBatch& later) {
+    for (auto vector_id : later.deletes) {
+      Delete(vector_id);
+    }
+    for (auto& [_, vector] : later.upserts) {
+      Upsert(vector);
+    }
   }
 
-  DINGO_LOG(INFO) << fmt::format("[vector_index.replaywal][index_id({})] replay wal log({}-{})", vector_index->Id(),
-                                 start_log_id, end_log_id);
+  size_t Size() const { return upserts.size() + deletes.size(); }
 
-  int64_t start_time = Helper::TimestampMs();
-  auto engine = Server::GetInstance().GetEngine();
-  if (engine->GetID() != pb::common::StorageEngine::STORE_ENG_RAFT_STORE) {
-    return butil::Status(pb::error::Errno::EINTERNAL, "Engine is not raft store.");
-  }
-  auto raft_kv_engine = std::dynamic_pointer_cast<RaftStoreEngine>(engine);
-  auto node = raft_kv_engine->GetNode(vector_index->Id());
-  if (node == nullptr) {
-    return butil::Status(pb::error::Errno::ERAFT_NOT_FOUND, fmt::format("Not found node {}", vector_index->Id()));
-  }
+  std::unordered_map<int64_t, pb::common::VectorWithId> upserts;
+  std::unordered_set<int64_t> deletes;
+};
 
-  auto log_stroage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(vector_index->Id());
-  if (log_stroage == nullptr) {
-    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("Not found log stroage {}", vector_index->Id()));
-  }
+// Log entries [start_log_id, end_log_id] read and decoded by one bthread.
+struct ReplayWalChunk {
+  int64_t start_log_id{0};
+  int64_t end_log_id{0};
 
-  int64_t min_vector_id = 0, max_vector_id = 0;
-  VectorCodec::DecodeRangeToVectorId(vector_index->Range(), min_vector_id, max_vector_id);
-  std::vector<pb::common::VectorWithId> vectors;
-  vectors.reserve(Constant::kBuildVectorIndexBatchSize);
-  std::vector<int64_t> ids;
-  ids.reserve(Constant::kBuildVectorIndexBatchSize);
-  int64_t last_log_id = vector_index->ApplyLogId();
-  auto log_entrys = log_stroage->GetEntrys(start_log_id, end_log_id);
+  int64_t last_log_id{0};
+  int64_t op_count{0};
+  ReplayWalBatch batch;
+};
+
+static void DecodeReplayWalChunk(std::shared_ptr<RaftLogStorage> log_storage, int64_t min_vector_id,
+                                 int64_t max_vector_id, ReplayWalChunk& chunk) {
+  auto log_entrys = log_storage->GetEntrys(chunk.start_log_id, chunk.end_log_id);
   for (const auto& log_entry : log_entrys) {
     auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
     butil::IOBufAsZeroCopyInputStream wrapper(log_entry->data);
@@ -525,38 +550,21 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
     for (auto& request : *raft_cmd->mutable_requests()) {
       switch (request.cmd_type()) {
         case pb::raft::VECTOR_ADD: {
-          if (!ids.empty()) {
-            vector_index->Delete(ids, false);
-            ids.clear();
-          }
-
           for (auto& vector : *request.mutable_vector_add()->mutable_vectors()) {
             if (vector.id() >= min_vector_id && vector.id() < max_vector_id) {
-              vectors.push_back(vector);
+              chunk.batch.Upsert(vector);
+              ++chunk.op_count;
             }
           }
-
-          if (vectors.size() >= Constant::kBuildVectorIndexBatchSize) {
-            vector_index->Upsert(vectors, false);
-            vectors.clear();
-          }
           break;
         }
         case pb::raft::VECTOR_DELETE: {
-          if (!vectors.empty()) {
-            vector_index->Upsert(vectors, false);
-            vectors.clear();
-          }
-
           for (auto vector_id : request.vector_delete().ids()) {
             if (vector_id >= min_vector_id && vector_id < max_vector_id) {
-              ids.push_back(vector_id);
+              chunk.batch.Delete(vector_id);
+              ++chunk.op_count;
             }
           }
-          if (ids.size() >= Constant::kBuildVectorIndexBatchSize) {
-            vector_index->Delete(ids, false);
-            ids.clear();
-          }
           break;
         }
         default:
@@ -564,22 +572,143 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
       }
     }
 
-    last_log_id = log_entry->index;
+    chunk.last_log_id = log_entry->index;
   }
-  if (!vectors.empty()) {
+
+  g_vector_index_replay_wal_log_count << log_entrys.size();
+}
+
+static void ApplyReplayWalBatch(VectorIndexPtr vector_index, ReplayWalBatch& batch) {
+  if (batch.Size() == 0) {
+    return;
+  }
+
+  int64_t start_time = butil::gettimeofday_us();
+
+  if (!batch.upserts.empty()) {
+    std::vector<pb::common::VectorWithId> vectors;
+    vectors.reserve(batch.upserts.size());
+    for (auto& [_, vector] : batch.upserts) {
+      vectors.push_back(std::move(vector));
+    }
     vector_index->Upsert(vectors, false);
-  } else if (!ids.empty()) {
+  }
+
+  if (!batch.deletes.empty()) {
+    std::vector<int64_t> ids(batch.deletes.begin(), batch.deletes.end());
     vector_index->Delete(ids, false);
   }
 
+  g_vector_index_replay_wal_vector_count << batch.Size();
+  g_vector_index_replay_wal_batch_latency << butil::gettimeofday_us() - start_time;
+
+  batch.upserts.clear();
+  batch.deletes.clear();
+}
+
+// Replay vector index from WAL
+// Replay is a pipeline, chunks of log entries are read and decoded in parallel bthreads, and merged in log order
+// into one coalesced batch, which is applied by the parallel Upsert/Delete of vector index when it is large enough.
+butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_index, int64_t start_log_id,
+                                                         int64_t end_log_id) {
+  assert(vector_index != nullptr);
+
+  if (start_log_id >= end_log_id) {
+    return butil::Status();
+  }
+
+  auto engine = Server::GetInstance().GetEngine();
+  if (engine->GetID() != pb::common::StorageEngine::STORE_ENG_RAFT_STORE) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "Engine is not raft store.");
+  }
+  auto raft_kv_engine = std::dynamic_pointer_cast<RaftStoreEngine>(engine);
+  auto node = raft_kv_engine->GetNode(vector_index->Id());
+  if (node == nullptr) {
+    return butil::Status(pb::error::Errno::ERAFT_NOT_FOUND, fmt::format("Not found node {}", vector_index->Id()));
+  }
+
+  auto log_stroage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(vector_index->Id());
+  if (log_stroage == nullptr) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("Not found log stroage {}", vector_index->Id()));
+  }
+
+  return ReplayWalToVectorIndex(vector_index, log_stroage, start_log_id, end_log_id);
+}
+
+butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_index,
+                                                         std::shared_ptr<RaftLogStorage> log_storage,
+                                                         int64_t start_log_id, int64_t end_log_id) {
+  assert(vector_index != nullptr);
+  assert(log_storage != nullptr);
+
+  if (start_log_id >= end_log_id) {
+    return butil::Status();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.replaywal][index_id({})] replay wal log({}-{})", vector_index->Id(),
+                                 start_log_id, end_log_id);
+
+  int64_t start_time = Helper::TimestampMs();
+  int64_t min_vector_id = 0, max_vector_id = 0;
+  VectorCodec::DecodeRangeToVectorId(vector_index->Range(), min_vector_id, max_vector_id);
+
+  int64_t chunk_size = std::max(FLAGS_vector_index_replay_wal_chunk_size, static_cast<int64_t>(1));
+  size_t parallel_num = std::max(FLAGS_vector_index_replay_wal_parallel_num, 1);
+  size_t batch_size = std::max(FLAGS_vector_index_replay_wal_batch_size, static_cast<int64_t>(1));
+
+  std::vector<std::unique_ptr<ReplayWalChunk>> chunks;
+  for (int64_t log_id = start_log_id; log_id <= end_log_id; log_id += chunk_size) {
+    auto chunk = std::make_unique<ReplayWalChunk>();
+    chunk->start_log_id = log_id;
+    chunk->end_log_id = std::min(log_id + chunk_size - 1, end_log_id);
+    chunks.push_back(std::move(chunk));
+  }
+
+  // At most parallel_num chunks are decoding ahead of the chunk being merged and applied.
+  std::vector<Bthread> decoders(chunks.size());
+  size_t launched = 0;
+  auto launch = [&](size_t end) {
+    for (; launched < std::min(end, chunks.size()); ++launched) {
+      auto* chunk = chunks[launched].get();
+      decoders[launched].Run([log_storage, min_vector_id, max_vector_id, chunk]() {
+        DecodeReplayWalChunk(log_storage, min_vector_id, max_vector_id, *chunk);
+      });
+    }
+  };
+
+  int64_t last_log_id = vector_index->ApplyLogId();
+  int64_t op_count = 0;
+  int64_t apply_count = 0;
+  ReplayWalBatch batch;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    launch(i + parallel_num);
+    decoders[i].Join();
+
+    auto& chunk = chunks[i];
+    batch.Merge(chunk->batch);
+    op_count += chunk->op_count;
+    if (chunk->last_log_id > 0) {
+      last_log_id = chunk->last_log_id;
+    }
+    chunk.reset();
+
+    if (batch.Size() >= batch_size) {
+      apply_count += batch.Size();
+      ApplyReplayWalBatch(vector_index, batch);
+    }
+  }
+  apply_count += batch.Size();
+  ApplyReplayWalBatch(vector_index, batch);
+  g_vector_index_replay_wal_coalesced_count << op_count - apply_count;
+
   if (last_log_id > vector_index->ApplyLogId()) {
     vector_index->SetApplyLogId(last_log_id);
   }
 
   DINGO_LOG(INFO) << fmt::format(
-      "[vector_index.replaywal][index_id({})] replay wal finish, log({}-{}) last_log_id({}) vector_id({}-{}) elapsed "
-      "time({}ms)",
-      vector_index->Id(), start_log_id, end_log_id, last_log_id, min_vector_id, max_vector_id,
+      "[vector_index.replaywal][index_id({})] replay wal finish, log({}-{}) last_log_id({}) vector_id({}-{}) "
+      "op_count({}) apply_count({}) elapsed time({}ms)",
+      vector_index->Id(), start_log_id, end_log_id, last_log_id, min_vector_id, max_vector_id, op_count, apply_count,
       Helper::TimestampMs() - start_time);
 
   return butil::Status();
@@ -715,6 +844,14 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
     upsert_use_time += (Helper::TimestampMs() - upsert_start_time);
   }
 
+  // Build the index structure from all added vectors, e.g. diskann.
+  auto status = vector_index->Build();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.build][index_id({})][trace({})] Build failed, error: {} {}",
+                                    vector_index_id, trace, status.error_code(), status.error_cstr());
+    return {};
+  }
+
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.build][index_id({})][trace({})] Build vector index finish, parallel({}) count({}) epoch({}) "
       "range({}) "
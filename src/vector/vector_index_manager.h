@@ -24,6 +24,7 @@
 #include "butil/status.h"
 #include "common/helper.h"
 #include "common/safe_map.h"
+#include "log/raft_log_storage.h"
 #include "log/segment_log_storage.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
@@ -137,6 +138,11 @@ class VectorIndexManager {
 
   static butil::Status ScrubVectorIndex();
 
+  // Replay log [start_log_id, end_log_id] of log storage to vector index, the log storage is given by caller.
+  static butil::Status ReplayWalToVectorIndex(std::shared_ptr<VectorIndex> vector_index,
+                                              std::shared_ptr<RaftLogStorage> log_storage, int64_t start_log_id,
+                                              int64_t end_log_id);
+
   static std::atomic<int> vector_index_task_running_num;
   static int GetVectorIndexTaskRunningNum() { return vector_index_task_running_num.load(); }
   static void IncVectorIndexTaskRunningNum() { vector_index_task_running_num.fetch_add(1); }
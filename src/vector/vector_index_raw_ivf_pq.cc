@@ -44,11 +44,14 @@
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_utils.h"
+#include "vector/vector_search_executor.h"
 
 namespace dingodb {
 
 DEFINE_int64(ivf_pq_need_save_count, 10000, "ivf pq need save count");
 
+DECLARE_bool(vector_index_load_snapshot_mmap);
+
 VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                          const pb::common::RegionEpoch& epoch, const pb::common::Range& range)
     : VectorIndex(id, vector_index_parameter, epoch, range) {
@@ -123,6 +126,8 @@ butil::Status VectorIndexRawIvfPq::AddOrUpsert(const std::vector<pb::common::Vec
   }
 
   std::thread([&]() {
+    // the lists loaded by mmap are read only.
+    VectorIndexUtils::MaterializeInvertedLists(index_.get());
     if (is_upsert) {
       faiss::IDSelectorArray sel(vector_with_ids.size(), ids2.get());
       index_->remove_ids(sel);
@@ -184,7 +189,10 @@ butil::Status VectorIndexRawIvfPq::Delete(const std::vector<int64_t>& delete_ids
       return butil::Status::OK();
     }
 
-    std::thread([&]() { remove_count = index_->remove_ids(sel); }).join();
+    std::thread([&]() {
+      VectorIndexUtils::MaterializeInvertedLists(index_.get());
+      remove_count = index_->remove_ids(sel);
+    }).join();
   }
 
   if (0 == remove_count) {
@@ -253,8 +261,8 @@ butil::Status VectorIndexRawIvfPq::Search(std::vector<pb::common::VectorWithId>
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
-    // use std::thread to call faiss functions
-    std::thread t([&]() {
+    // use vector search executor to call faiss functions
+    auto status2 = VectorSearchExecutor::GetInstance().Execute([&]() {
       if (!filters.empty()) {
         auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
         ivf_search_parameters.sel = ivf_pq_filter.get();
@@ -265,7 +273,10 @@ butil::Status VectorIndexRawIvfPq::Search(std::vector<pb::common::VectorWithId>
                        &ivf_search_parameters);
       }
     });
-    t.join();
+    if (!status2.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("VectorIndexRawIvfPq::Search failed. error : {}", status2.error_str());
+      return status2;
+    }
   }
 
   VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -333,36 +344,21 @@ butil::Status VectorIndexRawIvfPq::RangeSearch(std::vector<pb::common::VectorWit
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
-    std::promise<butil::Status> promise_status;
-    std::future<butil::Status> future_status = promise_status.get_future();
-    // use std::thread to call faiss functions
-    std::thread t(
-        [&](std::promise<butil::Status>& promise_status) {
-          try {
-            if (!filters.empty()) {
-              auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
-              ivf_search_parameters.sel = ivf_pq_filter.get();
-
-              index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
-                                   &ivf_search_parameters);
-            } else {
-              index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
-                                   &ivf_search_parameters);
-            }
-            promise_status.set_value(butil::Status());
-          } catch (std::exception& e) {
-            std::string s = fmt::format("VectorIndexIvfPq::RangeSearch failed. error : {}", e.what());
-            promise_status.set_value(butil::Status(pb::error::Errno::EINTERNAL, s));
-          }
-        },
-        std::ref(promise_status));
-
-    butil::Status status2 = future_status.get();
-
-    t.join();
+    // use vector search executor to call faiss functions
+    auto status2 = VectorSearchExecutor::GetInstance().Execute([&]() {
+      if (!filters.empty()) {
+        auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
+        ivf_search_parameters.sel = ivf_pq_filter.get();
 
+        index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
+                             &ivf_search_parameters);
+      } else {
+        index_->range_search(vector_with_ids.size(), vectors2.get(), radius, range_search_result.get(),
+                             &ivf_search_parameters);
+      }
+    });
     if (!status2.ok()) {
-      DINGO_LOG(ERROR) << status2.error_cstr();
+      DINGO_LOG(ERROR) << fmt::format("VectorIndexRawIvfPq::RangeSearch failed. error : {}", status2.error_str());
       return status2;
     }
   }
@@ -399,6 +395,8 @@ butil::Status VectorIndexRawIvfPq::Save(const std::string& path) {
   std::thread t(
       [&](std::promise<butil::Status>& promise_status) {
         try {
+          // the mapped lists is written as a reference to the loaded snapshot file, which will be removed.
+          VectorIndexUtils::MaterializeInvertedLists(index_.get());
           faiss::write_index(index_.get(), path.c_str());
           promise_status.set_value(butil::Status());
         } catch (std::exception& e) {
@@ -437,7 +435,9 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
       [&](std::promise<std::pair<faiss::Index*, butil::Status>>& promise_status) {
         faiss::Index* internal_raw_index = nullptr;
         try {
-          internal_raw_index = faiss::read_index(path.c_str(), 0);
+          // mmap the inverted lists, the lists is copied into memory at the first write.
+          int io_flags = FLAGS_vector_index_load_snapshot_mmap ? faiss::IO_FLAG_MMAP : 0;
+          internal_raw_index = faiss::read_index(path.c_str(), io_flags);
           promise_status.set_value(std::pair<faiss::Index*, butil::Status>(internal_raw_index, butil::Status()));
         } catch (std::exception& e) {
           std::string s =
@@ -559,7 +559,8 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
     normalize_ = true;
   }
 
-  DINGO_LOG(INFO) << fmt::format("VectorIndexRawIvfPq::Load success. path : {}", path);
+  DINGO_LOG(INFO) << fmt::format("VectorIndexRawIvfPq::Load success. path : {} mmap : {}", path,
+                                 FLAGS_vector_index_load_snapshot_mmap);
 
   return butil::Status::OK();
 }
@@ -54,6 +54,8 @@
 namespace dingodb {
 
 DEFINE_bool(vector_index_snapshot_use_fork, true, "Use fork to save vector index snapshot.");
+DEFINE_bool(vector_index_load_snapshot_mmap, false,
+            "Load ivf vector index snapshot with mmap, the inverted lists are copied into memory at the first write.");
 
 // Get all snapshot path, except tmp dir.
 static std::vector<std::string> GetSnapshotPaths(std::string path) {
@@ -27,6 +27,8 @@
 #include "common/constant.h"
 #include "common/logging.h"
 #include "faiss/MetricType.h"
+#include "faiss/invlists/InvertedLists.h"
+#include "faiss/invlists/OnDiskInvertedLists.h"
 #include "faiss/utils/extra_distances-inl.h"
 #include "fmt/core.h"
 #include "hnswlib/hnswlib.h"
@@ -626,6 +628,11 @@ butil::Status VectorIndexUtils::CheckVectorIndexParameterCompatibility(const pb:
       return butil::Status(pb::error::EMERGE_VECTOR_INDEX_PARAMETER_NOT_MATCH,
                            "source_hnsw_parameter.metric_type() != target_hnsw_parameter.metric_type()");
     }
+    if (source_hnsw_parameter.quantizer_type() != target_hnsw_parameter.quantizer_type()) {
+      DINGO_LOG(INFO) << "source_hnsw_parameter.quantizer_type() != target_hnsw_parameter.quantizer_type()";
+      return butil::Status(pb::error::EMERGE_VECTOR_INDEX_PARAMETER_NOT_MATCH,
+                           "source_hnsw_parameter.quantizer_type() != target_hnsw_parameter.quantizer_type()");
+    }
     return butil::Status::OK();
   } else if (source.vector_index_type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT) {
     const auto& source_ivf_flat_parameter = source.ivf_flat_parameter();
@@ -740,6 +747,13 @@ butil::Status VectorIndexUtils::ValidateVectorIndexParameter(
       return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS,
                            "hnsw_parameter.nlinks is illegal " + std::to_string(hnsw_parameter.nlinks()));
     }
+
+    // check hnsw_parameter.quantizer_type
+    if (!pb::common::HnswQuantizerType_IsValid(hnsw_parameter.quantizer_type())) {
+      DINGO_LOG(ERROR) << "hnsw_parameter.quantizer_type is illegal " << hnsw_parameter.quantizer_type();
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "hnsw_parameter.quantizer_type is illegal " +
+                                                                       std::to_string(hnsw_parameter.quantizer_type()));
+    }
   }
 
   // if vector_index_type is FLAT, check flat_parameter is set
@@ -951,6 +965,26 @@ butil::Status VectorIndexUtils::ValidateVectorIndexParameter(
                                                                        std::to_string(diskann_parameter.num_threads()));
     }
 
+    // check diskann_parameter.build_list_size
+    // The candidate list size of graph building, 0 means default. It must not be less than num_neighbors.
+    if (diskann_parameter.build_list_size() < 0 ||
+        (diskann_parameter.build_list_size() > 0 &&
+         diskann_parameter.build_list_size() < diskann_parameter.num_neighbors())) {
+      DINGO_LOG(ERROR) << "diskann_parameter.build_list_size is illegal " << diskann_parameter.build_list_size();
+      return butil::Status(
+          pb::error::Errno::EILLEGAL_PARAMTETERS,
+          "diskann_parameter.build_list_size is illegal " + std::to_string(diskann_parameter.build_list_size()));
+    }
+
+    // check diskann_parameter.pq_bytes
+    // The PQ code size of one vector, 0 means default. It must not be greater than dimension.
+    if (diskann_parameter.pq_bytes() < 0 ||
+        diskann_parameter.pq_bytes() > static_cast<int32_t>(diskann_parameter.dimension())) {
+      DINGO_LOG(ERROR) << "diskann_parameter.pq_bytes is illegal " << diskann_parameter.pq_bytes();
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS,
+                           "diskann_parameter.pq_bytes is illegal " + std::to_string(diskann_parameter.pq_bytes()));
+    }
+
     // If all checks pass, return a butil::Status object with no error.
     return butil::Status::OK();
   }
@@ -958,4 +992,28 @@ butil::Status VectorIndexUtils::ValidateVectorIndexParameter(
   return butil::Status::OK();
 }
 
+bool VectorIndexUtils::MaterializeInvertedLists(faiss::IndexIVF* index) {
+  auto* mmap_lists = dynamic_cast<faiss::OnDiskInvertedLists*>(index->invlists);
+  if (mmap_lists == nullptr) {
+    return false;
+  }
+
+  auto* array_lists = new faiss::ArrayInvertedLists(mmap_lists->nlist, mmap_lists->code_size);
+  for (size_t list_no = 0; list_no < mmap_lists->nlist; ++list_no) {
+    size_t list_size = mmap_lists->list_size(list_no);
+    if (list_size == 0) {
+      continue;
+    }
+
+    faiss::InvertedLists::ScopedIds ids(mmap_lists, list_no);
+    faiss::InvertedLists::ScopedCodes codes(mmap_lists, list_no);
+    array_lists->add_entries(list_no, list_size, ids.get(), codes.get());
+  }
+
+  // own the new lists, the mapped lists is released and the snapshot file is unmapped.
+  index->replace_invlists(array_lists, true);
+
+  return true;
+}
+
 }  // namespace dingodb
@@ -26,6 +26,7 @@
 #include "butil/status.h"
 #include "common/logging.h"
 #include "faiss/Index.h"
+#include "faiss/IndexIVF.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "proto/index.pb.h"
 
@@ -186,6 +187,10 @@ class VectorIndexUtils {
   static butil::Status CheckVectorIndexParameterCompatibility(const pb::common::VectorIndexParameter& source,
                                                               const pb::common::VectorIndexParameter& target);
   static butil::Status ValidateVectorIndexParameter(const pb::common::VectorIndexParameter& vector_index_parameter);
+
+  // Inverted lists loaded with faiss::IO_FLAG_MMAP are read only and reference the snapshot file,
+  // copy them into memory before modify or save the index. Return true if the lists are copied.
+  static bool MaterializeInvertedLists(faiss::IndexIVF* index);
 };
 
 }  // namespace dingodb
@@ -14,9 +14,12 @@
 
 #include "vector/vector_reader.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -28,14 +31,25 @@
 #include "proto/common.pb.h"
 #include "server/server.h"
 #include "vector/codec.h"
+#include "vector/vector_distance.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_bruteforce.h"
 #include "vector/vector_index_factory.h"
-#include "vector/vector_index_flat.h"
 
 namespace dingodb {
 
-DEFINE_int64(vector_index_max_range_search_result_count, 1024, "max range search result count");
-DEFINE_int64(vector_index_bruteforce_batch_count, 2048, "bruteforce batch count");
+DEFINE_bool(vector_scalar_index_enable, true, "enable scalar inverted index for scalar pre filter search");
+DEFINE_int32(hnsw_quantizer_rerank_factor, 2,
+             "quantized hnsw search top_n * factor candidates and re-rank them by float vector data, 1 means no "
+             "re-rank");
+DEFINE_int64(vector_filter_bruteforce_max_candidate_count, 2048,
+             "pre filter with candidates not more than it is searched by brute force over the candidates");
+DEFINE_double(vector_filter_bruteforce_max_selectivity, 0.01,
+              "pre filter with selectivity not more than it is searched by brute force over the candidates");
+DEFINE_double(vector_filter_post_filter_min_selectivity, 0.5,
+              "pre filter with selectivity not less than it is searched by vector index then post filtered");
+DEFINE_double(vector_filter_post_filter_expand_factor, 1.5,
+              "post filter search topk is top_n / selectivity * factor, cover the candidates dropped by filter");
 
 butil::Status VectorReader::QueryVectorWithId(const pb::common::Range& region_range, int64_t partition_id,
                                               int64_t vector_id, bool with_vector_data,
@@ -703,11 +717,10 @@ butil::Status VectorReader::DoVectorSearchForVectorIdPreFilter(  // NOLINT
     VectorIndexWrapperPtr vector_index, const std::vector<pb::common::VectorWithId>& vector_with_ids,
     const pb::common::VectorSearchParameter& parameter, const pb::common::Range& region_range,
     std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
-  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
-  VectorReader::SetVectorIndexFilter(vector_index, filters, Helper::PbRepeatedToVector(parameter.vector_ids()));
-
-  butil::Status status = VectorReader::SearchAndRangeSearchWrapper(
-      vector_index, region_range, vector_with_ids, parameter, vector_with_distance_results, parameter.top_n(), filters);
+  FilterStrategy strategy = FilterStrategy::kNone;
+  butil::Status status =
+      SearchWithCandidates(vector_index, region_range, vector_with_ids, parameter,
+                           Helper::PbRepeatedToVector(parameter.vector_ids()), vector_with_distance_results, strategy);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -722,6 +735,14 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
     std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {  // NOLINT
 
   // scalar pre filter search
+  // Get vector ids from scalar inverted index first, scan the scalar data when the index is not available.
+  std::vector<int64_t> vector_ids;
+  if (FLAGS_vector_scalar_index_enable &&
+      vector_index->ScalarIndex()->Search(reader_, region_range, vector_with_ids[0].scalar_data(), vector_ids)) {
+    FilterStrategy strategy = FilterStrategy::kNone;
+    return SearchWithCandidates(vector_index, region_range, vector_with_ids, parameter, vector_ids,
+                                vector_with_distance_results, strategy);
+  }
 
   const auto& std_vector_scalar = vector_with_ids[0].scalar_data();
   auto lambda_scalar_compare_function =
@@ -756,7 +777,6 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
     return butil::Status(pb::error::Errno::EINTERNAL, "New iterator failed");
   }
 
-  std::vector<int64_t> vector_ids;
   vector_ids.reserve(1024);
   for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
     pb::common::VectorScalardata internal_vector_scalar;
@@ -777,11 +797,9 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
     }
   }
 
-  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
-  VectorReader::SetVectorIndexFilter(vector_index, filters, vector_ids);
-
-  butil::Status status = VectorReader::SearchAndRangeSearchWrapper(
-      vector_index, region_range, vector_with_ids, parameter, vector_with_distance_results, parameter.top_n(), filters);
+  FilterStrategy strategy = FilterStrategy::kNone;
+  butil::Status status = SearchWithCandidates(vector_index, region_range, vector_with_ids, parameter, vector_ids,
+                                              vector_with_distance_results, strategy);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -803,11 +821,13 @@ butil::Status VectorReader::DoVectorSearchForTableCoprocessor(  // NOLINT(*stati
 butil::Status VectorReader::VectorBatchSearchDebug(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                                    std::vector<pb::index::VectorWithDistanceResult>& results,
                                                    int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
-                                                   int64_t& search_time_us) {  // NOLINT
+                                                   int64_t& search_time_us, std::string& filter_strategy) {  // NOLINT
   // Search vectors by vectors
+  FilterStrategy strategy = FilterStrategy::kNone;
   auto status =
       SearchVectorDebug(ctx->partition_id, ctx->vector_index, ctx->region_range, ctx->vector_with_ids, ctx->parameter,
-                        results, deserialization_id_time_us, scan_scalar_time_us, search_time_us);
+                        results, deserialization_id_time_us, scan_scalar_time_us, search_time_us, strategy);
+  filter_strategy = FilterStrategyName(strategy);
   if (!status.ok()) {
     return status;
   }
@@ -836,7 +856,7 @@ butil::Status VectorReader::SearchVectorDebug(
     int64_t partition_id, VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
     std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, int64_t& deserialization_id_time_us,
-    int64_t& scan_scalar_time_us, int64_t& search_time_us) {
+    int64_t& scan_scalar_time_us, int64_t& search_time_us, FilterStrategy& strategy) {
   if (vector_with_ids.empty()) {
     DINGO_LOG(WARNING) << "Empty vector with ids";
     return butil::Status();
@@ -907,9 +927,10 @@ butil::Status VectorReader::SearchVectorDebug(
       scan_scalar_time_us = lambda_time_diff_microseconds_function(start_kv_get, end_kv_get);
     }
   } else if (dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER == vector_filter) {  // vector id array search
-    butil::Status status = DoVectorSearchForVectorIdPreFilterDebug(vector_index, vector_with_ids, parameter,
-                                                                   region_range, vector_with_distance_results,
-                                                                   deserialization_id_time_us, search_time_us);
+    butil::Status status =
+        DoVectorSearchForVectorIdPreFilterDebug(vector_index, vector_with_ids, parameter, region_range,
+                                                vector_with_distance_results, deserialization_id_time_us,
+                                                search_time_us, strategy);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForVectorIdPreFilterDebug failed");
       return status;
@@ -918,9 +939,9 @@ butil::Status VectorReader::SearchVectorDebug(
   } else if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
              dingodb::pb::common::VectorFilterType::QUERY_PRE == vector_filter_type) {  // scalar pre filter search
 
-    butil::Status status =
-        DoVectorSearchForScalarPreFilterDebug(vector_index, region_range, vector_with_ids, parameter,
-                                              vector_with_distance_results, scan_scalar_time_us, search_time_us);
+    butil::Status status = DoVectorSearchForScalarPreFilterDebug(vector_index, region_range, vector_with_ids,
+                                                                 parameter, vector_with_distance_results,
+                                                                 scan_scalar_time_us, search_time_us, strategy);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForScalarPreFilterDebug failed ");
       return status;
@@ -963,23 +984,22 @@ butil::Status VectorReader::DoVectorSearchForVectorIdPreFilterDebug(  // NOLINT
     VectorIndexWrapperPtr vector_index, const std::vector<pb::common::VectorWithId>& vector_with_ids,
     const pb::common::VectorSearchParameter& parameter, const pb::common::Range& region_range,
     std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, int64_t& deserialization_id_time_us,
-    int64_t& search_time_us) {
+    int64_t& search_time_us, FilterStrategy& strategy) {
   auto lambda_time_now_function = []() { return std::chrono::steady_clock::now(); };
   auto lambda_time_diff_microseconds_function = [](auto start, auto end) {
     return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
   };
 
-  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
   auto start_ids = lambda_time_now_function();
-  VectorReader::SetVectorIndexFilter(vector_index, filters, Helper::PbRepeatedToVector(parameter.vector_ids()));
+  std::vector<int64_t> vector_ids = Helper::PbRepeatedToVector(parameter.vector_ids());
 
   auto end_ids = lambda_time_now_function();
   deserialization_id_time_us = lambda_time_diff_microseconds_function(start_ids, end_ids);
 
   auto start_search = lambda_time_now_function();
 
-  butil::Status status = VectorReader::SearchAndRangeSearchWrapper(
-      vector_index, region_range, vector_with_ids, parameter, vector_with_distance_results, parameter.top_n(), filters);
+  butil::Status status = SearchWithCandidates(vector_index, region_range, vector_with_ids, parameter, vector_ids,
+                                              vector_with_distance_results, strategy);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -995,7 +1015,7 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterDebug(
     VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
     std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, int64_t& scan_scalar_time_us,
-    int64_t& search_time_us) {
+    int64_t& search_time_us, FilterStrategy& strategy) {
   // scalar pre filter search
 
   const auto& std_vector_scalar = vector_with_ids[0].scalar_data();
@@ -1060,14 +1080,10 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterDebug(
   auto end_iter = lambda_time_now_function();
   scan_scalar_time_us = lambda_time_diff_microseconds_function(start_iter, end_iter);
 
-  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
-
-  VectorReader::SetVectorIndexFilter(vector_index, filters, vector_ids);
-
   auto start_search = lambda_time_now_function();
 
-  butil::Status status = VectorReader::SearchAndRangeSearchWrapper(
-      vector_index, region_range, vector_with_ids, parameter, vector_with_distance_results, parameter.top_n(), filters);
+  butil::Status status = SearchWithCandidates(vector_index, region_range, vector_with_ids, parameter, vector_ids,
+                                              vector_with_distance_results, strategy);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -1095,10 +1111,139 @@ butil::Status VectorReader::SetVectorIndexFilter(VectorIndexWrapperPtr vector_in
     } else {
       // do nothing
     }
+  } else if (vector_index->Type() == pb::common::VECTOR_INDEX_TYPE_DISKANN) {
+    filters.push_back(std::make_shared<VectorIndex::HnswListFilterFunctor>(vector_ids));
   }
   return butil::Status::OK();
 }
 
+const char* VectorReader::FilterStrategyName(FilterStrategy strategy) {
+  switch (strategy) {
+    case FilterStrategy::kNone:
+      return "none";
+    case FilterStrategy::kFilteredAnn:
+      return "filtered_ann";
+    case FilterStrategy::kBruteForce:
+      return "brute_force";
+    case FilterStrategy::kAnnPostFilter:
+      return "ann_post_filter";
+  }
+  return "unknown";
+}
+
+VectorReader::FilterStrategy VectorReader::PlanFilterStrategy(VectorIndexWrapperPtr vector_index,
+                                                              size_t candidate_count,
+                                                              const pb::common::VectorSearchParameter& parameter) {
+  // Brute force over candidates never read more vectors than brute force over the region.
+  int64_t max_candidate_count = std::max(FLAGS_vector_filter_bruteforce_max_candidate_count, static_cast<int64_t>(0));
+  if (parameter.use_brute_force() || candidate_count <= static_cast<size_t>(max_candidate_count)) {
+    return FilterStrategy::kBruteForce;
+  }
+
+  int64_t vector_count = 0;
+  auto status = vector_index->GetCount(vector_count);
+  if (!status.ok() || vector_count <= 0) {
+    return FilterStrategy::kFilteredAnn;
+  }
+
+  double selectivity = std::min(static_cast<double>(candidate_count) / vector_count, 1.0);
+  if (selectivity <= FLAGS_vector_filter_bruteforce_max_selectivity) {
+    return FilterStrategy::kBruteForce;
+  }
+
+  // Range search result is not limited by top_n, post filter can not enlarge it.
+  if (!parameter.enable_range_search() && selectivity >= FLAGS_vector_filter_post_filter_min_selectivity) {
+    return FilterStrategy::kAnnPostFilter;
+  }
+
+  return FilterStrategy::kFilteredAnn;
+}
+
+// Very selective filter make vector index walk huge parts of the graph to find top_n candidates, loose filter make
+// filtered search pay the filter check for almost nothing. So the candidate list is searched by the planned strategy,
+// post filter fall back to filtered search when the enlarged topk still can not give top_n results.
+butil::Status VectorReader::SearchWithCandidates(
+    VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+    const std::vector<int64_t>& candidate_ids,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, FilterStrategy& strategy) {
+  strategy = PlanFilterStrategy(vector_index, candidate_ids.size(), parameter);
+
+  if (strategy == FilterStrategy::kBruteForce) {
+    auto status =
+        parameter.enable_range_search()
+            ? VectorIndexBruteforce::CandidateRangeSearch(reader_, region_range, vector_index->GetMetricType(),
+                                                          vector_index->GetDimension(), vector_with_ids,
+                                                          parameter.radius(), candidate_ids,
+                                                          vector_with_distance_results)
+            : VectorIndexBruteforce::CandidateSearch(reader_, region_range, vector_index->GetMetricType(),
+                                                     vector_index->GetDimension(), vector_with_ids, parameter.top_n(),
+                                                     candidate_ids, vector_with_distance_results);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Brute force search candidates failed, id: {} error: {} {}", vector_index->Id(),
+                                      status.error_code(), status.error_str());
+    }
+    return status;
+  }
+
+  if (strategy == FilterStrategy::kAnnPostFilter) {
+    int64_t vector_count = 0;
+    vector_index->GetCount(vector_count);
+    double selectivity = static_cast<double>(candidate_ids.size()) / std::max(vector_count, static_cast<int64_t>(1));
+    uint32_t top_n = parameter.top_n();
+    uint32_t topk = static_cast<uint32_t>(std::min(
+        std::ceil(top_n / selectivity * std::max(FLAGS_vector_filter_post_filter_expand_factor, 1.0)),
+        static_cast<double>(std::max(vector_count, static_cast<int64_t>(top_n)))));
+
+    // Hnsw search with ef max(efsearch, topk), the enlarged topk enlarge ef too.
+    std::vector<pb::index::VectorWithDistanceResult> tmp_results;
+    auto status = SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter, tmp_results,
+                                              topk, {});
+    if (!status.ok()) {
+      return status;
+    }
+
+    std::unordered_set<int64_t> candidate_set(candidate_ids.begin(), candidate_ids.end());
+    bool enough = true;
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    for (auto& tmp_result : tmp_results) {
+      auto& result = results.emplace_back();
+      for (auto& vector_with_distance : *tmp_result.mutable_vector_with_distances()) {
+        if (static_cast<uint32_t>(result.vector_with_distances_size()) >= top_n) {
+          break;
+        }
+        if (candidate_set.count(vector_with_distance.vector_with_id().id()) > 0) {
+          result.add_vector_with_distances()->Swap(&vector_with_distance);
+        }
+      }
+
+      // The vector index return less than topk means no more vectors, the result is complete.
+      if (static_cast<uint32_t>(result.vector_with_distances_size()) < top_n &&
+          static_cast<uint32_t>(tmp_result.vector_with_distances_size()) >= topk) {
+        enough = false;
+        break;
+      }
+    }
+
+    if (enough) {
+      for (auto& result : results) {
+        vector_with_distance_results.push_back(std::move(result));
+      }
+      return butil::Status::OK();
+    }
+
+    DINGO_LOG(DEBUG) << fmt::format("Post filter search not enough result, fall back to filtered search, id: {}",
+                                    vector_index->Id());
+    strategy = FilterStrategy::kFilteredAnn;
+  }
+
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  VectorReader::SetVectorIndexFilter(vector_index, filters, candidate_ids);
+
+  return SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                     vector_with_distance_results, parameter.top_n(), filters);
+}
+
 butil::Status VectorReader::SearchAndRangeSearchWrapper(
     VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
@@ -1144,8 +1289,9 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
         return status;
       }
     } else {
-      status = vector_index->Search(vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
-                                    vector_with_distance_results);
+      int32_t rerank_factor = GetRerankFactor(vector_index, parameter);
+      status = vector_index->Search(vector_with_ids, topk * rerank_factor, region_range, filters, with_vector_data,
+                                    parameter, vector_with_distance_results);
       if (status.error_code() == pb::error::Errno::EVECTOR_NOT_SUPPORT) {
         DINGO_LOG(INFO) << "Search vector index not support, try brute force, id: " << vector_index->Id();
         return BruteForceSearch(vector_index, vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
@@ -1155,351 +1301,152 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
                                         status.error_str());
         return status;
       }
+
+      if (rerank_factor > 1) {
+        status = RerankSearchResult(vector_index, region_range, vector_with_ids, topk, with_vector_data,
+                                    vector_with_distance_results);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("Rerank search result failed, error: {} {}", status.error_code(),
+                                          status.error_str());
+          return status;
+        }
+      }
     }
   }
 
   return butil::Status::OK();
 }
 
-// DistanceResult
-// This class is used for priority queue to merge the search result from many batch scan data from raw engine.
-class DistanceResult {
- public:
-  float distance{0};
-  pb::common::VectorWithDistance vector_with_distance{};
-  DistanceResult() = default;
-  DistanceResult(float distance, pb::common::VectorWithDistance vector_with_distance)
-      : distance(distance), vector_with_distance(vector_with_distance) {}
-};
-
-// Overload the < operator.
-bool operator<(const DistanceResult& result1, const DistanceResult& result2) {
-  if (result1.distance != result2.distance) {
-    return result1.distance > result2.distance;
-  } else {
-    return result1.vector_with_distance.vector_with_id().id() > result2.vector_with_distance.vector_with_id().id();
-  }
-}
-// Overload the > operator.
-bool operator>(const DistanceResult& result1, const DistanceResult& result2) {
-  if (result1.distance != result2.distance) {
-    return result1.distance < result2.distance;
-  } else {
-    return result1.vector_with_distance.vector_with_id().id() < result2.vector_with_distance.vector_with_id().id();
-  }
-}
-
-// ScanData from raw engine, build vector index and search
+// Stream vector data from raw engine and search by brute force.
 butil::Status VectorReader::BruteForceSearch(VectorIndexWrapperPtr vector_index,
                                              std::vector<pb::common::VectorWithId> vector_with_ids, uint32_t topk,
                                              const pb::common::Range& region_range,
                                              std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
-                                             bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                             bool /*reconstruct*/,
+                                             const pb::common::VectorSearchParameter& /*parameter*/,
                                              std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto metric_type = vector_index->GetMetricType();
-  auto dimension = vector_index->GetDimension();
-
-  pb::common::RegionEpoch epoch;
-  pb::common::VectorIndexParameter index_parameter;
-  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
-  index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
-
-  IteratorOptions options;
-  options.lower_bound = region_range.start_key();
-  options.upper_bound = region_range.end_key();
-  auto iterator = reader_->NewIterator(Constant::kVectorDataCF, options);
-
-  iterator->Seek(region_range.start_key());
-  if (!iterator->Valid()) {
-    return butil::Status();
-  }
-
-  // topk results
-  std::vector<std::priority_queue<DistanceResult>> top_rsults;
-  top_rsults.resize(vector_with_ids.size());
-
-  int64_t count = 0;
-  std::vector<pb::common::VectorWithId> vector_with_id_batch;
-  std::vector<pb::index::VectorWithDistanceResult> results_batch;
-
-  // scan data from raw engine
-  while (iterator->Valid()) {
-    std::string key(iterator->Key());
-    auto vector_id = VectorCodec::DecodeVectorId(key);
-    if (vector_id == 0 || vector_id == INT64_MAX || vector_id < 0) {
-      iterator->Next();
-      continue;
-    }
-
-    auto value = iterator->Value();
-
-    pb::common::Vector vector;
-    if (!vector.ParseFromArray(value.data(), value.size())) {
-      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
-    }
-    pb::common::VectorWithId vector_with_id;
-    vector_with_id.mutable_vector()->Swap(&vector);
-    vector_with_id.set_id(vector_id);
-
-    vector_with_id_batch.push_back(vector_with_id);
-
-    if (vector_with_id_batch.size() == FLAGS_vector_index_bruteforce_batch_count) {
-      auto flat_index = std::make_shared<VectorIndexFlat>(INT64_MAX, index_parameter, epoch, region_range);
-      if (flat_index == nullptr) {
-        DINGO_LOG(FATAL) << "flat_index is nullptr";
-      }
-
-      auto ret = flat_index->Add(vector_with_id_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                        ret.error_str());
-        return ret;
-      }
-
-      ret = flat_index->Search(vector_with_ids, topk, filters, reconstruct, parameter, results_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Search vector index failed, error: {} {}", ret.error_code(), ret.error_str());
-        return ret;
-      }
-
-      CHECK(results_batch.size() == vector_with_ids.size());
-
-      for (int i = 0; i < results_batch.size(); i++) {
-        auto& result = results_batch[i];
-        auto& top_result = top_rsults[i];
-
-        for (const auto& vector_with_distance : result.vector_with_distances()) {
-          auto& top_result = top_rsults[i];
-          if (top_result.size() < topk) {
-            top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-          } else {
-            if (top_result.top().distance > vector_with_distance.distance()) {
-              top_result.pop();
-              top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-            }
-          }
-        }
-      }
-
-      results_batch.clear();
-      vector_with_id_batch.clear();
-    }
-
-    iterator->Next();
-  }
-
-  if (!vector_with_id_batch.empty()) {
-    auto flat_index = std::make_shared<VectorIndexFlat>(INT64_MAX, index_parameter, epoch, region_range);
-    if (flat_index == nullptr) {
-      DINGO_LOG(FATAL) << "flat_index is nullptr";
-    }
-
-    auto ret = flat_index->Add(vector_with_id_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                      ret.error_str());
-      return ret;
-    }
-
-    ret = flat_index->Search(vector_with_ids, topk, filters, reconstruct, parameter, results_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Search vector index failed, error: {} {}", ret.error_code(), ret.error_str());
-      return ret;
-    }
-
-    CHECK(results_batch.size() == vector_with_ids.size());
-
-    for (int i = 0; i < results_batch.size(); i++) {
-      auto& result = results_batch[i];
-      auto& top_result = top_rsults[i];
-
-      for (const auto& vector_with_distance : result.vector_with_distances()) {
-        auto& top_result = top_rsults[i];
-        if (top_result.size() < topk) {
-          top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-        } else {
-          if (top_result.top().distance > vector_with_distance.distance()) {
-            top_result.pop();
-            top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-          }
-        }
-      }
-    }
-
-    results_batch.clear();
-    vector_with_id_batch.clear();
-  }
-
-  // copy top_results to results
-  // we don't do sorting by distance here
-  // the client will do sorting by distance
-  results.resize(top_rsults.size());
-  for (int i = 0; i < top_rsults.size(); i++) {
-    auto& top_result = top_rsults[i];
-    auto& result = results[i];
-
-    while (!top_result.empty()) {
-      auto top = top_result.top();
-      auto& vector_with_distance = *result.add_vector_with_distances();
-      vector_with_distance.Swap(&top.vector_with_distance);
-      top_result.pop();
-    }
+  auto status =
+      VectorIndexBruteforce::ScanSearch(reader_, region_range, vector_index->GetMetricType(),
+                                        vector_index->GetDimension(), vector_with_ids, topk, filters, results);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("BruteForceSearch failed, id: {} error: {} {}", vector_index->Id(),
+                                    status.error_code(), status.error_str());
   }
 
-  return butil::Status::OK();
+  return status;
 }
 
 butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_index,
                                                   std::vector<pb::common::VectorWithId> vector_with_ids, float radius,
                                                   const pb::common::Range& region_range,
                                                   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters,
-                                                  bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                                  bool /*reconstruct*/,
+                                                  const pb::common::VectorSearchParameter& /*parameter*/,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto metric_type = vector_index->GetMetricType();
-  auto dimension = vector_index->GetDimension();
-
-  pb::common::RegionEpoch epoch;
-  pb::common::VectorIndexParameter index_parameter;
-  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
-  index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
+  auto status =
+      VectorIndexBruteforce::ScanRangeSearch(reader_, region_range, vector_index->GetMetricType(),
+                                             vector_index->GetDimension(), vector_with_ids, radius, filters, results);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("BruteForceRangeSearch failed, id: {} error: {} {}", vector_index->Id(),
+                                    status.error_code(), status.error_str());
+  }
 
-  IteratorOptions options;
-  options.lower_bound = region_range.start_key();
-  options.upper_bound = region_range.end_key();
-  auto iterator = reader_->NewIterator(Constant::kVectorDataCF, options);
+  return status;
+}
 
-  iterator->Seek(region_range.start_key());
-  if (!iterator->Valid()) {
-    return butil::Status();
+int32_t VectorReader::GetRerankFactor(VectorIndexWrapperPtr vector_index,
+                                      const pb::common::VectorSearchParameter& parameter) {
+  if (vector_index->Type() != pb::common::VECTOR_INDEX_TYPE_HNSW ||
+      vector_index->IndexParameter().hnsw_parameter().quantizer_type() == pb::common::HNSW_QUANTIZER_NONE) {
+    return 1;
   }
 
-  // range search results
-  std::vector<std::vector<std::pair<float, pb::common::VectorWithDistance>>> range_rsults;
-  range_rsults.resize(vector_with_ids.size());
+  int32_t rerank_factor =
+      parameter.hnsw().rerank_factor() > 0 ? parameter.hnsw().rerank_factor() : FLAGS_hnsw_quantizer_rerank_factor;
+  return std::max(rerank_factor, 1);
+}
 
-  int64_t count = 0;
-  std::vector<pb::common::VectorWithId> vector_with_id_batch;
-  std::vector<pb::index::VectorWithDistanceResult> results_batch;
+// Quantized hnsw distance is approximate, the float vector data in raw engine give the exact distance.
+butil::Status VectorReader::RerankSearchResult(VectorIndexWrapperPtr vector_index,
+                                               const pb::common::Range& region_range,
+                                               const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                               uint32_t topk, bool reconstruct,
+                                               std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (results.size() != vector_with_ids.size()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("search result size({}) not match query size({})",
+                                                           results.size(), vector_with_ids.size()));
+  }
 
-  // scan data from raw engine
-  while (iterator->Valid()) {
-    std::string key(iterator->Key());
-    auto vector_id = VectorCodec::DecodeVectorId(key);
-    if (vector_id == 0 || vector_id == INT64_MAX || vector_id < 0) {
-      iterator->Next();
-      continue;
+  auto metric_type = vector_index->GetMetricType();
+  int32_t dimension = vector_index->GetDimension();
+  char prefix = region_range.start_key()[0];
+  int64_t partition_id = VectorCodec::DecodePartitionId(region_range.start_key());
+
+  std::vector<float> query(dimension);
+  std::vector<float> vector(dimension);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  std::vector<bool> founds;
+  for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+    const auto& float_values = vector_with_ids[row].vector().float_values();
+    if (float_values.size() != dimension) {
+      return butil::Status(pb::error::EVECTOR_INVALID,
+                           fmt::format("vector dimension is not match, input={}, index={}", float_values.size(),
+                                       dimension));
     }
-
-    auto value = iterator->Value();
-
-    pb::common::Vector vector;
-    if (!vector.ParseFromArray(value.data(), value.size())) {
-      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+    std::copy(float_values.begin(), float_values.end(), query.begin());
+    if (metric_type == pb::common::METRIC_TYPE_COSINE) {
+      VectorDistance::Normalize(query.data(), dimension);
     }
-    pb::common::VectorWithId vector_with_id;
-    vector_with_id.mutable_vector()->Swap(&vector);
-    vector_with_id.set_id(vector_id);
 
-    vector_with_id_batch.push_back(vector_with_id);
+    auto* vector_with_distances = results[row].mutable_vector_with_distances();
+    keys.resize(vector_with_distances->size());
+    for (int i = 0; i < vector_with_distances->size(); ++i) {
+      VectorCodec::EncodeVectorKey(prefix, partition_id, vector_with_distances->Get(i).vector_with_id().id(), keys[i]);
+    }
+    auto status = reader_->KvMultiGet(Constant::kVectorDataCF, keys, values, founds);
+    if (!status.ok()) {
+      return status;
+    }
 
-    if (vector_with_id_batch.size() == FLAGS_vector_index_bruteforce_batch_count) {
-      auto flat_index = std::make_shared<VectorIndexFlat>(INT64_MAX, index_parameter, epoch, region_range);
-      if (flat_index == nullptr) {
-        DINGO_LOG(FATAL) << "flat_index is nullptr";
+    // The vector may be deleted after searched from index, drop it and keep the others.
+    int valid_count = 0;
+    for (int i = 0; i < vector_with_distances->size(); ++i) {
+      if (!founds[i]) {
+        continue;
       }
-
-      auto ret = flat_index->Add(vector_with_id_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                        ret.error_str());
-        return ret;
+      status = VectorIndexBruteforce::DecodeFloatVector(values[i], dimension, vector.data());
+      if (!status.ok()) {
+        return status;
       }
 
-      ret = flat_index->RangeSearch(vector_with_ids, radius, filters, reconstruct, parameter, results_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("RangeSearch vector index failed, error: {} {}", ret.error_code(),
-                                        ret.error_str());
-        return ret;
+      auto* vector_with_distance = vector_with_distances->Mutable(i);
+      // The vector data is read anyway, fill it to avoid read again.
+      if (reconstruct) {
+        auto* vector_values = vector_with_distance->mutable_vector_with_id()->mutable_vector()->mutable_float_values();
+        vector_values->Assign(vector.begin(), vector.end());
       }
 
-      CHECK(results_batch.size() == vector_with_ids.size());
-
-      for (int i = 0; i < results_batch.size(); i++) {
-        auto& result = results_batch[i];
-        auto& top_result = range_rsults[i];
-
-        for (const auto& vector_with_distance : result.vector_with_distances()) {
-          auto& top_result = range_rsults[i];
-          if (top_result.size() < FLAGS_vector_index_max_range_search_result_count) {
-            top_result.emplace_back(vector_with_distance.distance(), vector_with_distance);
-          } else {
-            DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, actual: {}",
-                                              FLAGS_vector_index_max_range_search_result_count, top_result.size() + 1);
-            break;
-          }
+      if (metric_type == pb::common::METRIC_TYPE_L2) {
+        vector_with_distance->set_distance(VectorDistance::L2Sqr(query.data(), vector.data(), dimension));
+      } else {
+        if (metric_type == pb::common::METRIC_TYPE_COSINE) {
+          VectorDistance::Normalize(vector.data(), dimension);
         }
+        vector_with_distance->set_distance(1.0f - VectorDistance::InnerProduct(query.data(), vector.data(), dimension));
       }
 
-      results_batch.clear();
-      vector_with_id_batch.clear();
-    }
-
-    iterator->Next();
-  }
-
-  if (!vector_with_id_batch.empty()) {
-    auto flat_index = std::make_shared<VectorIndexFlat>(INT64_MAX, index_parameter, epoch, region_range);
-    if (flat_index == nullptr) {
-      DINGO_LOG(FATAL) << "flat_index is nullptr";
-    }
-
-    auto ret = flat_index->Add(vector_with_id_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                      ret.error_str());
-      return ret;
-    }
-
-    ret = flat_index->RangeSearch(vector_with_ids, radius, filters, reconstruct, parameter, results_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("RangeSearch vector index failed, error: {} {}", ret.error_code(),
-                                      ret.error_str());
-      return ret;
-    }
-
-    CHECK(results_batch.size() == vector_with_ids.size());
-
-    for (int i = 0; i < results_batch.size(); i++) {
-      auto& result = results_batch[i];
-      auto& top_result = range_rsults[i];
-
-      for (const auto& vector_with_distance : result.vector_with_distances()) {
-        auto& top_result = range_rsults[i];
-        if (top_result.size() < FLAGS_vector_index_max_range_search_result_count) {
-          top_result.emplace_back(vector_with_distance.distance(), vector_with_distance);
-        } else {
-          DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, actual: {}",
-                                            FLAGS_vector_index_max_range_search_result_count, top_result.size() + 1);
-          break;
-        }
+      if (valid_count != i) {
+        vector_with_distances->SwapElements(valid_count, i);
       }
+      ++valid_count;
     }
+    vector_with_distances->DeleteSubrange(valid_count, vector_with_distances->size() - valid_count);
 
-    results_batch.clear();
-    vector_with_id_batch.clear();
-  }
-
-  // copy top_results to results
-  // we don't do sorting by distance here
-  // the client will do sorting by distance
-  results.resize(range_rsults.size());
-  for (int i = 0; i < range_rsults.size(); i++) {
-    auto& top_result = range_rsults[i];
-    auto& result = results[i];
-
-    for (auto& top : top_result) {
-      auto& vector_with_distance = *result.add_vector_with_distances();
-      vector_with_distance.Swap(&top.second);
+    std::stable_sort(vector_with_distances->pointer_begin(), vector_with_distances->pointer_end(),
+                     [](const auto* lhs, const auto* rhs) { return lhs->distance() < rhs->distance(); });
+    if (vector_with_distances->size() > static_cast<int>(topk)) {
+      vector_with_distances->DeleteSubrange(topk, vector_with_distances->size() - topk);
     }
   }
 
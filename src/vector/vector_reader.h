@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "butil/status.h"
@@ -59,7 +60,25 @@ class VectorReader {
   butil::Status VectorBatchSearchDebug(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                        std::vector<pb::index::VectorWithDistanceResult>& results,
                                        int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
-                                       int64_t& search_time_us);
+                                       int64_t& search_time_us, std::string& filter_strategy);
+
+  // How to search with a pre filter candidate list, chosen by the selectivity of the filter.
+  enum class FilterStrategy {
+    // No pre filter candidate list.
+    kNone,
+    // Pass the candidate list as filter into vector index search.
+    kFilteredAnn,
+    // Compute the distance of every candidate by brute force, for very selective filter.
+    kBruteForce,
+    // Search vector index with enlarged topk, then drop the result not in candidate list, for loose filter.
+    kAnnPostFilter,
+  };
+
+  static const char* FilterStrategyName(FilterStrategy strategy);
+
+  // Estimate the selectivity of filter by candidate count and vector count of index, and choose the strategy.
+  static FilterStrategy PlanFilterStrategy(VectorIndexWrapperPtr vector_index, size_t candidate_count,
+                                           const pb::common::VectorSearchParameter& parameter);
 
  private:
   butil::Status QueryVectorWithId(const pb::common::Range& region_range, int64_t partition_id, int64_t vector_id,
@@ -114,21 +133,21 @@ class VectorReader {
                                   const pb::common::VectorSearchParameter& parameter,
                                   std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results,
                                   int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
-                                  int64_t& search_time_us);
+                                  int64_t& search_time_us, FilterStrategy& strategy);
 
   // This function is for testing only
   butil::Status DoVectorSearchForVectorIdPreFilterDebug(
       VectorIndexWrapperPtr vector_index, const std::vector<pb::common::VectorWithId>& vector_with_ids,
       const pb::common::VectorSearchParameter& parameter, const pb::common::Range& region_range,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results,
-      int64_t& deserialization_id_time_us, int64_t& search_time_us);
+      int64_t& deserialization_id_time_us, int64_t& search_time_us, FilterStrategy& strategy);
 
   // This function is for testing only
   butil::Status DoVectorSearchForScalarPreFilterDebug(
       VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
       const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, int64_t& scan_scalar_time_us,
-      int64_t& search_time_us);  // NOLINT
+      int64_t& search_time_us, FilterStrategy& strategy);  // NOLINT
 
   static butil::Status SetVectorIndexFilter(
       VectorIndexWrapperPtr vector_index,
@@ -141,6 +160,14 @@ class VectorReader {
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, uint32_t topk,  // NOLINT
       std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters);
 
+  // Search with the pre filter candidate list by the planned strategy.
+  butil::Status SearchWithCandidates(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                     const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                     const pb::common::VectorSearchParameter& parameter,
+                                     const std::vector<int64_t>& candidate_ids,
+                                     std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results,
+                                     FilterStrategy& strategy);
+
   butil::Status BruteForceSearch(VectorIndexWrapperPtr vector_index,
                                  std::vector<pb::common::VectorWithId> vector_with_ids, uint32_t topk,
                                  const pb::common::Range& region_range,
@@ -155,6 +182,14 @@ class VectorReader {
                                       bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                       std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  // Re-rank factor of quantized hnsw search, return 1 if not need re-rank.
+  static int32_t GetRerankFactor(VectorIndexWrapperPtr vector_index,
+                                 const pb::common::VectorSearchParameter& parameter);
+  // Recompute the distance of candidates by float vector data and keep the top k.
+  butil::Status RerankSearchResult(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                   const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                   bool reconstruct, std::vector<pb::index::VectorWithDistanceResult>& results);
+
   RawEngine::ReaderPtr reader_;
 };
 
@@ -0,0 +1,501 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_scalar_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "vector/codec.h"
+
+namespace dingodb {
+
+void VectorIdBitmap::Container::Add(uint16_t low) {
+  if (IsBitset()) {
+    uint64_t mask = 1ULL << (low & 63);
+    if ((bits[low >> 6] & mask) == 0) {
+      bits[low >> 6] |= mask;
+      ++cardinality;
+    }
+    return;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low) {
+    return;
+  }
+  array.insert(it, low);
+  ++cardinality;
+  if (cardinality > kMaxArraySize) {
+    ToBitset();
+  }
+}
+
+void VectorIdBitmap::Container::Remove(uint16_t low) {
+  if (IsBitset()) {
+    uint64_t mask = 1ULL << (low & 63);
+    if ((bits[low >> 6] & mask) != 0) {
+      bits[low >> 6] &= ~mask;
+      --cardinality;
+      if (cardinality <= kMaxArraySize) {
+        ToArray();
+      }
+    }
+    return;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low) {
+    array.erase(it);
+    --cardinality;
+  }
+}
+
+bool VectorIdBitmap::Container::Contains(uint16_t low) const {
+  if (IsBitset()) {
+    return (bits[low >> 6] & (1ULL << (low & 63))) != 0;
+  }
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+void VectorIdBitmap::Container::ToBitset() {
+  bits.assign(kBitsetWords, 0);
+  for (auto low : array) {
+    bits[low >> 6] |= 1ULL << (low & 63);
+  }
+  std::vector<uint16_t>().swap(array);
+}
+
+void VectorIdBitmap::Container::ToArray() {
+  std::vector<uint16_t> new_array;
+  new_array.reserve(cardinality);
+  for (int32_t i = 0; i < kBitsetWords; ++i) {
+    uint64_t word = bits[i];
+    while (word != 0) {
+      new_array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(word)));
+      word &= word - 1;
+    }
+  }
+  array.swap(new_array);
+  std::vector<uint64_t>().swap(bits);
+}
+
+VectorIdBitmap::Container VectorIdBitmap::Container::And(const Container& lhs, const Container& rhs) {
+  Container result;
+  if (!lhs.IsBitset() && !rhs.IsBitset()) {
+    std::set_intersection(lhs.array.begin(), lhs.array.end(), rhs.array.begin(), rhs.array.end(),
+                          std::back_inserter(result.array));
+    result.cardinality = result.array.size();
+
+  } else if (lhs.IsBitset() && rhs.IsBitset()) {
+    result.bits.resize(kBitsetWords);
+    for (int32_t i = 0; i < kBitsetWords; ++i) {
+      result.bits[i] = lhs.bits[i] & rhs.bits[i];
+      result.cardinality += __builtin_popcountll(result.bits[i]);
+    }
+    if (result.cardinality <= kMaxArraySize) {
+      result.ToArray();
+    }
+
+  } else {
+    const auto& array_container = lhs.IsBitset() ? rhs : lhs;
+    const auto& bitset_container = lhs.IsBitset() ? lhs : rhs;
+    for (auto low : array_container.array) {
+      if (bitset_container.Contains(low)) {
+        result.array.push_back(low);
+      }
+    }
+    result.cardinality = result.array.size();
+  }
+
+  return result;
+}
+
+void VectorIdBitmap::Add(int64_t id) { containers_[id >> 16].Add(static_cast<uint16_t>(id & 0xFFFF)); }
+
+void VectorIdBitmap::Remove(int64_t id) {
+  auto it = containers_.find(id >> 16);
+  if (it == containers_.end()) {
+    return;
+  }
+
+  it->second.Remove(static_cast<uint16_t>(id & 0xFFFF));
+  if (it->second.cardinality == 0) {
+    containers_.erase(it);
+  }
+}
+
+bool VectorIdBitmap::Contains(int64_t id) const {
+  auto it = containers_.find(id >> 16);
+  return it != containers_.end() && it->second.Contains(static_cast<uint16_t>(id & 0xFFFF));
+}
+
+int64_t VectorIdBitmap::Cardinality() const {
+  int64_t cardinality = 0;
+  for (const auto& [_, container] : containers_) {
+    cardinality += container.cardinality;
+  }
+  return cardinality;
+}
+
+int64_t VectorIdBitmap::MemorySize() const {
+  int64_t memory_size = sizeof(VectorIdBitmap);
+  for (const auto& [_, container] : containers_) {
+    memory_size += sizeof(int64_t) + sizeof(Container) + container.array.capacity() * sizeof(uint16_t) +
+                   container.bits.capacity() * sizeof(uint64_t);
+  }
+  return memory_size;
+}
+
+void VectorIdBitmap::And(const VectorIdBitmap& other) {
+  auto it = containers_.begin();
+  auto other_it = other.containers_.begin();
+  while (it != containers_.end()) {
+    while (other_it != other.containers_.end() && other_it->first < it->first) {
+      ++other_it;
+    }
+
+    if (other_it == other.containers_.end() || other_it->first != it->first) {
+      it = containers_.erase(it);
+      continue;
+    }
+
+    it->second = Container::And(it->second, other_it->second);
+    if (it->second.cardinality == 0) {
+      it = containers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void VectorIdBitmap::ToVector(std::vector<int64_t>& ids) const {
+  ids.reserve(ids.size() + Cardinality());
+  for (const auto& [high, container] : containers_) {
+    int64_t base = high << 16;
+    if (!container.IsBitset()) {
+      for (auto low : container.array) {
+        ids.push_back(base | low);
+      }
+      continue;
+    }
+
+    for (int32_t i = 0; i < kBitsetWords; ++i) {
+      uint64_t word = container.bits[i];
+      while (word != 0) {
+        ids.push_back(base | (i * 64 + __builtin_ctzll(word)));
+        word &= word - 1;
+      }
+    }
+  }
+}
+
+template <typename T>
+static void AppendFixed(T value, std::string& term) {
+  term.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void AppendBytes(const std::string& value, std::string& term) {
+  AppendFixed(static_cast<uint32_t>(value.size()), term);
+  term.append(value);
+}
+
+bool VectorScalarIndex::EncodeTerm(const std::string& key, const pb::common::ScalarValue& value, std::string& term) {
+  term.clear();
+  AppendBytes(key, term);
+  AppendFixed(static_cast<int32_t>(value.field_type()), term);
+  AppendFixed(static_cast<int32_t>(value.fields_size()), term);
+
+  for (const auto& field : value.fields()) {
+    switch (value.field_type()) {
+      case pb::common::ScalarFieldType::BOOL:
+        AppendFixed(static_cast<uint8_t>(field.bool_data()), term);
+        break;
+      case pb::common::ScalarFieldType::INT8:
+      case pb::common::ScalarFieldType::INT16:
+      case pb::common::ScalarFieldType::INT32:
+        AppendFixed(field.int_data(), term);
+        break;
+      case pb::common::ScalarFieldType::INT64:
+        AppendFixed(field.long_data(), term);
+        break;
+      case pb::common::ScalarFieldType::FLOAT32:
+        // +0.0 == -0.0 and NaN never equal.
+        if (std::isnan(field.float_data())) {
+          return false;
+        }
+        AppendFixed(field.float_data() == 0.0F ? 0.0F : field.float_data(), term);
+        break;
+      case pb::common::ScalarFieldType::DOUBLE:
+        if (std::isnan(field.double_data())) {
+          return false;
+        }
+        AppendFixed(field.double_data() == 0.0 ? 0.0 : field.double_data(), term);
+        break;
+      case pb::common::ScalarFieldType::STRING:
+        AppendBytes(field.string_data(), term);
+        break;
+      case pb::common::ScalarFieldType::BYTES:
+        AppendBytes(field.bytes_data(), term);
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+void VectorScalarIndex::Data::Upsert(int64_t vector_id, const pb::common::VectorScalardata& scalar_data) {
+  Delete(vector_id);
+
+  auto& term_ids = forwards_[vector_id];
+  std::string term;
+  for (const auto& [key, value] : scalar_data.scalar_data()) {
+    if (!EncodeTerm(key, value, term)) {
+      continue;
+    }
+
+    auto [it, inserted] = term_ids_.try_emplace(term, postings_.size());
+    if (inserted) {
+      postings_.emplace_back();
+    }
+    postings_[it->second].Add(vector_id);
+    term_ids.push_back(it->second);
+  }
+
+  all_ids_.Add(vector_id);
+}
+
+void VectorScalarIndex::Data::Delete(int64_t vector_id) {
+  auto it = forwards_.find(vector_id);
+  if (it == forwards_.end()) {
+    return;
+  }
+
+  for (auto term_id : it->second) {
+    postings_[term_id].Remove(vector_id);
+  }
+  forwards_.erase(it);
+  all_ids_.Remove(vector_id);
+}
+
+void VectorScalarIndex::Data::Search(const pb::common::VectorScalardata& scalar_data,
+                                     std::vector<int64_t>& vector_ids) {
+  // Intersect from the shortest inverted list, so the result shrink fast.
+  std::vector<const VectorIdBitmap*> bitmaps;
+  std::string term;
+  for (const auto& [key, value] : scalar_data.scalar_data()) {
+    if (!EncodeTerm(key, value, term)) {
+      return;
+    }
+    auto it = term_ids_.find(term);
+    if (it == term_ids_.end() || postings_[it->second].Empty()) {
+      return;
+    }
+    bitmaps.push_back(&postings_[it->second]);
+  }
+
+  if (bitmaps.empty()) {
+    all_ids_.ToVector(vector_ids);
+    return;
+  }
+
+  std::sort(bitmaps.begin(), bitmaps.end(), [](const VectorIdBitmap* lhs, const VectorIdBitmap* rhs) {
+    return lhs->Cardinality() < rhs->Cardinality();
+  });
+
+  VectorIdBitmap result = *bitmaps[0];
+  for (size_t i = 1; i < bitmaps.size() && !result.Empty(); ++i) {
+    result.And(*bitmaps[i]);
+  }
+  result.ToVector(vector_ids);
+}
+
+int64_t VectorScalarIndex::Data::MemorySize() {
+  int64_t memory_size = all_ids_.MemorySize();
+  for (const auto& [term, _] : term_ids_) {
+    memory_size += term.capacity() + sizeof(uint32_t);
+  }
+  for (const auto& posting : postings_) {
+    memory_size += posting.MemorySize();
+  }
+  for (const auto& [_, term_ids] : forwards_) {
+    memory_size += sizeof(int64_t) + term_ids.capacity() * sizeof(uint32_t);
+  }
+  return memory_size;
+}
+
+VectorScalarIndex::VectorScalarIndex(int64_t id) : id_(id) { bthread_mutex_init(&mutex_, nullptr); }
+
+VectorScalarIndex::~VectorScalarIndex() { bthread_mutex_destroy(&mutex_); }
+
+void VectorScalarIndex::Upsert(const google::protobuf::RepeatedPtrField<pb::common::VectorWithId>& vector_with_ids) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (state_ == State::kReady) {
+    for (const auto& vector_with_id : vector_with_ids) {
+      data_->Upsert(vector_with_id.id(), vector_with_id.scalar_data());
+    }
+  } else if (state_ == State::kBuilding) {
+    for (const auto& vector_with_id : vector_with_ids) {
+      pending_ops_.emplace_back(vector_with_id.id(), vector_with_id.scalar_data());
+    }
+  }
+}
+
+void VectorScalarIndex::Delete(const std::vector<int64_t>& vector_ids) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (state_ == State::kReady) {
+    for (auto vector_id : vector_ids) {
+      data_->Delete(vector_id);
+    }
+  } else if (state_ == State::kBuilding) {
+    for (auto vector_id : vector_ids) {
+      pending_ops_.emplace_back(vector_id, std::nullopt);
+    }
+  }
+}
+
+void VectorScalarIndex::Reset() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  state_ = State::kNone;
+  ++generation_;
+  data_ = nullptr;
+  pending_ops_.clear();
+}
+
+bool VectorScalarIndex::IsReady() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return state_ == State::kReady;
+}
+
+int64_t VectorScalarIndex::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return data_ != nullptr ? data_->MemorySize() : 0;
+}
+
+butil::Status VectorScalarIndex::Build(RawEngine::ReaderPtr reader, const pb::common::Range& range, Data& data) {
+  IteratorOptions options;
+  options.upper_bound = range.end_key();
+
+  auto iter = reader->NewIterator(Constant::kVectorScalarCF, options);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "New iterator failed");
+  }
+
+  for (iter->Seek(range.start_key()); iter->Valid(); iter->Next()) {
+    pb::common::VectorScalardata scalar_data;
+    if (!scalar_data.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+      return butil::Status(pb::error::EINTERNAL, "Internal error, decode VectorScalar failed");
+    }
+
+    std::string key(iter->Key());
+    int64_t vector_id = VectorCodec::DecodeVectorId(key);
+    if (vector_id == 0) {
+      return butil::Status(pb::error::EINTERNAL,
+                           fmt::format("VectorCodec::DecodeVectorId failed key : {}", Helper::StringToHex(key)));
+    }
+
+    data.Upsert(vector_id, scalar_data);
+  }
+
+  return butil::Status::OK();
+}
+
+bool VectorScalarIndex::Search(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+                               const pb::common::VectorScalardata& scalar_data, std::vector<int64_t>& vector_ids) {
+  int64_t generation = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+
+    // Region split or merge change the range.
+    if (state_ == State::kReady &&
+        (range_.start_key() != range.start_key() || range_.end_key() != range.end_key())) {
+      DINGO_LOG(INFO) << fmt::format("[vector_index.scalar][index_id({})] region range changed, build again.", id_);
+      state_ = State::kNone;
+      data_ = nullptr;
+    }
+
+    if (state_ == State::kReady) {
+      data_->Search(scalar_data, vector_ids);
+      return true;
+    }
+
+    if (state_ == State::kBuilding) {
+      return false;
+    }
+
+    // Updates during scan are recorded to pending_ops_ since now.
+    state_ = State::kBuilding;
+    generation = generation_;
+    range_ = range;
+    pending_ops_.clear();
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  auto data = std::make_unique<Data>();
+  auto status = Build(reader, range, *data);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (generation != generation_) {
+    // Reset during building.
+    return false;
+  }
+
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.scalar][index_id({})] build scalar index failed, error: {}", id_,
+                                    status.error_str());
+    state_ = State::kNone;
+    pending_ops_.clear();
+    return false;
+  }
+
+  for (auto& [vector_id, op_scalar_data] : pending_ops_) {
+    if (op_scalar_data.has_value()) {
+      data->Upsert(vector_id, op_scalar_data.value());
+    } else {
+      data->Delete(vector_id);
+    }
+  }
+  pending_ops_.clear();
+
+  data_ = std::move(data);
+  state_ = State::kReady;
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.scalar][index_id({})] build scalar index finish, memory: {} cost: {}ms",
+                                 id_, data_->MemorySize(), Helper::TimestampMs() - start_time);
+
+  data_->Search(scalar_data, vector_ids);
+  return true;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,156 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SCALAR_INDEX_H_  // NOLINT
+#define DINGODB_VECTOR_SCALAR_INDEX_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "google/protobuf/repeated_ptr_field.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Compressed bitmap of vector id, same layout as roaring bitmap.
+// Ids are grouped by the high 48 bits, a group use a sorted uint16 array when it is sparse,
+// and a 65536 bits bitset when it has more than kMaxArraySize ids.
+class VectorIdBitmap {
+ public:
+  static constexpr int32_t kMaxArraySize = 4096;
+
+  void Add(int64_t id);
+  void Remove(int64_t id);
+  bool Contains(int64_t id) const;
+
+  int64_t Cardinality() const;
+  bool Empty() const { return containers_.empty(); }
+  int64_t MemorySize() const;
+
+  // this = this & other
+  void And(const VectorIdBitmap& other);
+
+  // Append all ids in ascending order.
+  void ToVector(std::vector<int64_t>& ids) const;
+
+ private:
+  static constexpr int32_t kBitsetWords = 65536 / 64;
+
+  struct Container {
+    // Sorted low 16 bits, used when bits is empty.
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bits;
+    int32_t cardinality{0};
+
+    bool IsBitset() const { return !bits.empty(); }
+    void Add(uint16_t low);
+    void Remove(uint16_t low);
+    bool Contains(uint16_t low) const;
+    void ToBitset();
+    void ToArray();
+    static Container And(const Container& lhs, const Container& rhs);
+  };
+
+  std::map<int64_t, Container> containers_;
+};
+
+// In-memory inverted index of vector scalar data for one region, (scalar key, scalar value) -> VectorIdBitmap.
+// It is built from kVectorScalarCF by the first scalar pre filter search, and kept in sync by raft apply
+// (VectorAddHandler/VectorDeleteHandler). It is not persisted, so it is built again after restart or raft
+// snapshot load.
+class VectorScalarIndex {
+ public:
+  explicit VectorScalarIndex(int64_t id);
+  ~VectorScalarIndex();
+
+  VectorScalarIndex(const VectorScalarIndex&) = delete;
+  VectorScalarIndex& operator=(const VectorScalarIndex&) = delete;
+
+  static std::shared_ptr<VectorScalarIndex> New(int64_t id) { return std::make_shared<VectorScalarIndex>(id); }
+
+  int64_t Id() const { return id_; }
+
+  // Apply vector add/delete, do nothing when the index is not built.
+  void Upsert(const google::protobuf::RepeatedPtrField<pb::common::VectorWithId>& vector_with_ids);
+  void Delete(const std::vector<int64_t>& vector_ids);
+
+  // Drop the index, the next search build it again.
+  void Reset();
+
+  // Get vector ids whose scalar data contain all the key-value of scalar_data, ids are in ascending order.
+  // Build the index when it is not built or the region range changed.
+  // Return false when the index is not available(e.g. building by other search), caller should scan scalar data.
+  bool Search(RawEngine::ReaderPtr reader, const pb::common::Range& range,
+              const pb::common::VectorScalardata& scalar_data, std::vector<int64_t>& vector_ids);
+
+  bool IsReady();
+  int64_t MemorySize();
+
+  // Encode scalar key and value to term of inverted list, value with same term is equal by
+  // Helper::IsEqualVectorScalarValue. Return false when field type is not support or value is NaN, such value
+  // never equal to any value.
+  static bool EncodeTerm(const std::string& key, const pb::common::ScalarValue& value, std::string& term);
+
+ private:
+  enum class State {
+    kNone = 0,
+    kBuilding = 1,
+    kReady = 2,
+  };
+
+  // Inverted lists and forward lists.
+  class Data {
+   public:
+    void Upsert(int64_t vector_id, const pb::common::VectorScalardata& scalar_data);
+    void Delete(int64_t vector_id);
+    void Search(const pb::common::VectorScalardata& scalar_data, std::vector<int64_t>& vector_ids);
+    int64_t MemorySize();
+
+   private:
+    std::unordered_map<std::string, uint32_t> term_ids_;
+    std::vector<VectorIdBitmap> postings_;
+    // vector id -> term ids, for remove old scalar data when upsert.
+    std::unordered_map<int64_t, std::vector<uint32_t>> forwards_;
+    // All vector ids, result of empty scalar data.
+    VectorIdBitmap all_ids_;
+  };
+
+  butil::Status Build(RawEngine::ReaderPtr reader, const pb::common::Range& range, Data& data);
+
+  int64_t id_;
+
+  bthread_mutex_t mutex_;
+  State state_{State::kNone};
+  // Increase by Reset, discard the building data of old generation.
+  int64_t generation_{0};
+  pb::common::Range range_;
+  std::unique_ptr<Data> data_;
+  // Apply during building, replay to the new data after scan, nullopt means delete.
+  std::vector<std::pair<int64_t, std::optional<pb::common::VectorScalardata>>> pending_ops_;
+};
+
+using VectorScalarIndexPtr = std::shared_ptr<VectorScalarIndex>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SCALAR_INDEX_H_  // NOLINT
@@ -0,0 +1,196 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_search_batcher.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(vector_search_batch_enable, false, "merge concurrent vector searches of one vector index into one search");
+DEFINE_int64(vector_search_batch_window_us, 200, "max wait time of the first search for other searches in a batch");
+DEFINE_int32(vector_search_batch_max_vector_count, 64, "max query vector count of a batch");
+
+static bvar::LatencyRecorder g_vector_search_batch_size("dingo_vector_search_batch_size");
+static bvar::LatencyRecorder g_vector_search_batch_wait_time("dingo_vector_search_batch_wait_time");
+
+VectorSearchBatcher::VectorSearchBatcher(int64_t id) : id_(id) { bthread_mutex_init(&mutex_, nullptr); }
+
+VectorSearchBatcher::~VectorSearchBatcher() { bthread_mutex_destroy(&mutex_); }
+
+std::string VectorSearchBatcher::GenKey(uint32_t topk, bool reconstruct, const pb::common::Range& region_range,
+                                        const pb::common::VectorSearchParameter& parameter) {
+  // Only the parameters used by VectorIndex::Search.
+  pb::common::VectorSearchParameter search_parameter;
+  search_parameter.set_top_n(topk);
+  search_parameter.set_without_vector_data(!reconstruct);
+  switch (parameter.search_case()) {
+    case pb::common::VectorSearchParameter::kFlat:
+      *search_parameter.mutable_flat() = parameter.flat();
+      break;
+    case pb::common::VectorSearchParameter::kIvfFlat:
+      *search_parameter.mutable_ivf_flat() = parameter.ivf_flat();
+      break;
+    case pb::common::VectorSearchParameter::kIvfPq:
+      *search_parameter.mutable_ivf_pq() = parameter.ivf_pq();
+      break;
+    case pb::common::VectorSearchParameter::kHnsw:
+      *search_parameter.mutable_hnsw() = parameter.hnsw();
+      break;
+    case pb::common::VectorSearchParameter::kDiskann:
+      *search_parameter.mutable_diskann() = parameter.diskann();
+      break;
+    default:
+      break;
+  }
+
+  std::string range_str = region_range.SerializeAsString();
+  return fmt::format("{}:{}{}", range_str.size(), range_str, search_parameter.SerializeAsString());
+}
+
+butil::Status VectorSearchBatcher::Search(const std::string& key,
+                                          const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                          SearchFunc search_func,
+                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
+  int32_t max_vector_count = FLAGS_vector_search_batch_max_vector_count;
+  int32_t running_num = running_num_.fetch_add(1);
+  if (running_num == 0 || static_cast<int32_t>(vector_with_ids.size()) >= max_vector_count) {
+    auto status = search_func(vector_with_ids, results);
+    running_num_.fetch_sub(1);
+    return status;
+  }
+
+  auto request = std::make_shared<Request>();
+  request->vector_with_ids = &vector_with_ids;
+  request->results = &results;
+  request->start_time_us = butil::gettimeofday_us();
+
+  BatchPtr batch;
+  bool is_leader = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = open_batches_.find(key);
+    if (it != open_batches_.end() &&
+        it->second->vector_count + static_cast<int32_t>(vector_with_ids.size()) <= max_vector_count) {
+      // Join the batch, the leader search for me.
+      batch = it->second;
+      batch->requests.push_back(request);
+      batch->vector_count += vector_with_ids.size();
+      request->cond.Increase();
+      if (batch->vector_count >= max_vector_count) {
+        batch->full = true;
+        open_batches_.erase(it);
+        batch->full_cond.DecreaseSignal();
+      }
+
+    } else {
+      // Be leader of a new batch, the old batch which can not hold me is still waiting its leader.
+      batch = std::make_shared<Batch>();
+      batch->requests.push_back(request);
+      batch->vector_count = vector_with_ids.size();
+      open_batches_[key] = batch;
+      is_leader = true;
+    }
+  }
+
+  if (!is_leader) {
+    request->cond.Wait();
+    running_num_.fetch_sub(1);
+    return request->status;
+  }
+
+  // Window timeout is the normal path of a not full batch.
+  batch->full_cond.QuietTimedWait(FLAGS_vector_search_batch_window_us);
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (!batch->full) {
+      auto it = open_batches_.find(key);
+      if (it != open_batches_.end() && it->second == batch) {
+        open_batches_.erase(it);
+      }
+    }
+  }
+
+  ExecuteBatch(batch, search_func);
+  running_num_.fetch_sub(1);
+  return request->status;
+}
+
+void VectorSearchBatcher::ExecuteBatch(BatchPtr batch, SearchFunc& search_func) {
+  int64_t now_us = butil::gettimeofday_us();
+  for (const auto& request : batch->requests) {
+    g_vector_search_batch_wait_time << (now_us - request->start_time_us);
+  }
+  g_vector_search_batch_size << batch->vector_count;
+
+  if (batch->requests.size() == 1) {
+    auto& request = batch->requests[0];
+    request->status = search_func(*request->vector_with_ids, *request->results);
+    return;
+  }
+
+  std::vector<pb::common::VectorWithId> batch_vector_with_ids;
+  batch_vector_with_ids.reserve(batch->vector_count);
+  for (const auto& request : batch->requests) {
+    batch_vector_with_ids.insert(batch_vector_with_ids.end(), request->vector_with_ids->begin(),
+                                 request->vector_with_ids->end());
+  }
+
+  std::vector<pb::index::VectorWithDistanceResult> batch_results;
+  auto status = search_func(batch_vector_with_ids, batch_results);
+  if (status.ok() && batch_results.size() != batch_vector_with_ids.size()) {
+    status = butil::Status(pb::error::EINTERNAL, fmt::format("batch search result size({}) not match query size({})",
+                                                             batch_results.size(), batch_vector_with_ids.size()));
+  }
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.batcher][index_id({})] batch search failed, size: {} error: {}", id_,
+                                    batch->vector_count, status.error_str());
+  }
+
+  // Split results back, the leader is the first one and it is not waiting.
+  size_t offset = 0;
+  for (size_t i = 0; i < batch->requests.size(); ++i) {
+    auto& request = batch->requests[i];
+    size_t count = request->vector_with_ids->size();
+    request->status = status;
+    if (status.ok()) {
+      request->results->reserve(request->results->size() + count);
+      for (size_t j = offset; j < offset + count; ++j) {
+        request->results->push_back(std::move(batch_results[j]));
+      }
+    }
+    offset += count;
+
+    if (i > 0) {
+      request->cond.DecreaseSignal();
+    }
+  }
+}
+
+}  // namespace dingodb
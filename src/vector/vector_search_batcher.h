@@ -0,0 +1,95 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SEARCH_BATCHER_H_  // NOLINT
+#define DINGODB_VECTOR_SEARCH_BATCHER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Merge concurrent top-k searches of one vector index into one VectorIndex::Search call,
+// faiss and hnswlib search a batch of queries much faster than the same queries one by one.
+// There is no background thread, the first search of a batch is the leader, it waits a short window
+// for others with the same key, then searches all queries and splits the results back.
+// When no other search is running, the search is executed at once without waiting.
+class VectorSearchBatcher {
+ public:
+  using SearchFunc = std::function<butil::Status(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                 std::vector<pb::index::VectorWithDistanceResult>& results)>;
+
+  explicit VectorSearchBatcher(int64_t id);
+  ~VectorSearchBatcher();
+
+  VectorSearchBatcher(const VectorSearchBatcher&) = delete;
+  VectorSearchBatcher& operator=(const VectorSearchBatcher&) = delete;
+
+  static std::shared_ptr<VectorSearchBatcher> New(int64_t id) { return std::make_shared<VectorSearchBatcher>(id); }
+
+  // Searches with the same key can be merged.
+  static std::string GenKey(uint32_t topk, bool reconstruct, const pb::common::Range& region_range,
+                            const pb::common::VectorSearchParameter& parameter);
+
+  // search_func must return one result per query in order.
+  butil::Status Search(const std::string& key, const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                       SearchFunc search_func, std::vector<pb::index::VectorWithDistanceResult>& results);
+
+ private:
+  struct Request {
+    const std::vector<pb::common::VectorWithId>* vector_with_ids{nullptr};
+    std::vector<pb::index::VectorWithDistanceResult>* results{nullptr};
+    int64_t start_time_us{0};
+    butil::Status status;
+    BthreadCond cond;
+  };
+  using RequestPtr = std::shared_ptr<Request>;
+
+  struct Batch {
+    std::vector<RequestPtr> requests;
+    int32_t vector_count{0};
+    // Leader wait on it, signal when the batch is full.
+    BthreadCond full_cond{1};
+    bool full{false};
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  void ExecuteBatch(BatchPtr batch, SearchFunc& search_func);
+
+  int64_t id_;
+
+  // Running search num, batch only when it is not the only one.
+  std::atomic<int32_t> running_num_{0};
+
+  bthread_mutex_t mutex_;
+  // Batch waiting more searches, key -> batch.
+  std::map<std::string, BatchPtr> open_batches_;
+};
+
+using VectorSearchBatcherPtr = std::shared_ptr<VectorSearchBatcher>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SEARCH_BATCHER_H_  // NOLINT
@@ -0,0 +1,202 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_search_executor.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "butil/time.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+extern "C" {
+extern void omp_set_num_threads(int) noexcept;  // NOLINT
+}
+
+// Process OpenMP thread budget, set up in server main.
+DEFINE_int32(omp_num_threads, 1, "omp num threads");
+
+namespace dingodb {
+
+DEFINE_int32(vector_search_executor_thread_num, 8, "vector search executor thread num");
+DEFINE_int32(vector_search_executor_omp_num_threads, 0,
+             "omp num threads of each vector search executor thread, 0 means omp_num_threads / thread num");
+DEFINE_int64(vector_search_executor_max_pending_num, 1024,
+             "vector search executor max pending task num, reject search when exceed, 0 means no limit");
+DEFINE_bool(vector_search_executor_pin_cpu, false, "pin vector search executor thread to cpu");
+
+// Share the process OpenMP thread budget among executor threads.
+static int32_t GetOmpNumThreads(int32_t thread_num) {
+  if (FLAGS_vector_search_executor_omp_num_threads > 0) {
+    return FLAGS_vector_search_executor_omp_num_threads;
+  }
+
+  return std::max(FLAGS_omp_num_threads / std::max(thread_num, 1), 1);
+}
+
+VectorSearchExecutor& VectorSearchExecutor::GetInstance() {
+  static VectorSearchExecutor instance;
+  return instance;
+}
+
+VectorSearchExecutor::VectorSearchExecutor()
+    : total_task_count_metrics_("dingo_vector_search_executor_total_task_count"),
+      pending_task_count_metrics_("dingo_vector_search_executor_pending_task_count"),
+      running_task_count_metrics_("dingo_vector_search_executor_running_task_count"),
+      reject_task_count_metrics_("dingo_vector_search_executor_reject_task_count"),
+      queue_latency_metrics_("dingo_vector_search_executor_queue_latency"),
+      execute_latency_metrics_("dingo_vector_search_executor_execute_latency") {
+  int32_t thread_num = std::max(FLAGS_vector_search_executor_thread_num, 1);
+  int32_t omp_num_threads = GetOmpNumThreads(thread_num);
+  for (int32_t i = 0; i < thread_num; ++i) {
+    workers_.emplace_back([this, i, omp_num_threads] { Run(i, omp_num_threads); });
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_search_executor] start, thread num: {} omp num threads: {} pin cpu: {}",
+                                 thread_num, omp_num_threads, FLAGS_vector_search_executor_pin_cpu);
+}
+
+VectorSearchExecutor::~VectorSearchExecutor() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  cond_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+// Worker i own the cpus [i * omp_num_threads, (i + 1) * omp_num_threads) of the process cpu set,
+// OpenMP threads started by the worker inherit the affinity, so they do not fight with other workers.
+static void PinCpu(int32_t index, int32_t omp_num_threads) {
+  cpu_set_t allowed_set;
+  CPU_ZERO(&allowed_set);
+  if (sched_getaffinity(0, sizeof(allowed_set), &allowed_set) != 0) {
+    DINGO_LOG(WARNING) << "[vector_search_executor] sched_getaffinity failed.";
+    return;
+  }
+
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed_set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  if (cpus.empty()) {
+    return;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int32_t i = 0; i < omp_num_threads; ++i) {
+    CPU_SET(cpus[(static_cast<size_t>(index) * omp_num_threads + i) % cpus.size()], &cpu_set);
+  }
+
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (ret != 0) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_search_executor] pthread_setaffinity_np failed, ret: {}", ret);
+  }
+}
+
+void VectorSearchExecutor::Run(int32_t index, int32_t omp_num_threads) {
+  pthread_setname_np(pthread_self(), fmt::format("vec_search_{}", index).c_str());
+
+  if (FLAGS_vector_search_executor_pin_cpu) {
+    PinCpu(index, omp_num_threads);
+  }
+  // The OpenMP nthreads is per thread, every parallel region start by this thread use it.
+  omp_set_num_threads(omp_num_threads);
+
+  for (;;) {
+    std::shared_ptr<Task> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (stop_ && tasks_.empty()) {
+        return;
+      }
+
+      task = tasks_.front();
+      tasks_.pop_front();
+    }
+
+    pending_task_count_metrics_ << -1;
+    running_task_count_metrics_ << 1;
+
+    int64_t start_time_us = butil::gettimeofday_us();
+    queue_latency_metrics_ << (start_time_us - task->enqueue_time_us);
+
+    try {
+      task->func();
+    } catch (std::exception& e) {
+      task->status = butil::Status(pb::error::EINTERNAL, fmt::format("vector search failed, error: {}", e.what()));
+    } catch (...) {
+      task->status = butil::Status(pb::error::EINTERNAL, "vector search failed, unknown exception");
+    }
+
+    execute_latency_metrics_ << (butil::gettimeofday_us() - start_time_us);
+    running_task_count_metrics_ << -1;
+
+    task->cond.DecreaseSignal();
+  }
+}
+
+butil::Status VectorSearchExecutor::Execute(const std::function<void()>& func) {
+  auto task = std::make_shared<Task>();
+  task->func = func;
+  task->enqueue_time_us = butil::gettimeofday_us();
+  task->cond.Increase();
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stop_) {
+      return butil::Status(pb::error::EINTERNAL, "vector search executor is stopped");
+    }
+
+    if (FLAGS_vector_search_executor_max_pending_num > 0 &&
+        static_cast<int64_t>(tasks_.size()) >= FLAGS_vector_search_executor_max_pending_num) {
+      reject_task_count_metrics_ << 1;
+      return butil::Status(pb::error::EREQUEST_FULL,
+                           fmt::format("vector search executor pending task exceed {}, please retry later",
+                                       FLAGS_vector_search_executor_max_pending_num));
+    }
+
+    tasks_.push_back(task);
+    pending_task_count_metrics_ << 1;
+  }
+
+  total_task_count_metrics_ << 1;
+  cond_.notify_one();
+
+  task->cond.Wait();
+
+  return task->status;
+}
+
+}  // namespace dingodb
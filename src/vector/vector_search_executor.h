@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SEARCH_EXECUTOR_H_  // NOLINT
+#define DINGODB_VECTOR_SEARCH_EXECUTOR_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "common/synchronization.h"
+
+namespace dingodb {
+
+// Fixed pthread pool for faiss search.
+// faiss use OpenMP inside, it must not run on bthread worker, so search used to create and join a std::thread
+// per call. The executor keep long running pthreads instead, each one has its own share of the process OpenMP
+// thread budget(omp_num_threads) and can be pinned to cpus, the caller bthread wait by BthreadCond without
+// blocking the bthread worker.
+class VectorSearchExecutor {
+ public:
+  static VectorSearchExecutor& GetInstance();
+
+  VectorSearchExecutor(const VectorSearchExecutor&) = delete;
+  VectorSearchExecutor& operator=(const VectorSearchExecutor&) = delete;
+
+  // Run func on executor thread and wait it finish.
+  // Return EREQUEST_FULL when too many pending tasks, EINTERNAL when func throw exception.
+  butil::Status Execute(const std::function<void()>& func);
+
+  int32_t WorkerNum() const { return workers_.size(); }
+  int64_t PendingTaskCount() { return pending_task_count_metrics_.get_value(); }
+
+ private:
+  VectorSearchExecutor();
+  ~VectorSearchExecutor();
+
+  struct Task {
+    std::function<void()> func;
+    butil::Status status;
+    int64_t enqueue_time_us{0};
+    BthreadCond cond;
+  };
+
+  void Run(int32_t index, int32_t omp_num_threads);
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::shared_ptr<Task>> tasks_;
+  bool stop_{false};
+
+  // metrics
+  bvar::Adder<uint64_t> total_task_count_metrics_;
+  bvar::Adder<int64_t> pending_task_count_metrics_;
+  bvar::Adder<int64_t> running_task_count_metrics_;
+  bvar::Adder<uint64_t> reject_task_count_metrics_;
+  bvar::LatencyRecorder queue_latency_metrics_;
+  bvar::LatencyRecorder execute_latency_metrics_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SEARCH_EXECUTOR_H_  // NOLINT
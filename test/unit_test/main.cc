@@ -16,8 +16,12 @@
 
 #include <iostream>
 
+#include "gflags/gflags.h"
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
+  // e.g. row count of the disabled benchmark cases
+  google::ParseCommandLineFlags(&argc, &argv, true);
 
   if (testing::FLAGS_gtest_filter == "*") {
     std::string default_run_case;
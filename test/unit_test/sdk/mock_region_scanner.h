@@ -17,6 +17,7 @@
 #define DINGODB_SDK_TEST_MOCK_REGION_SCANNER_H_
 
 #include <memory>
+#include <string>
 
 #include "gmock/gmock.h"
 #include "region.h"
@@ -55,6 +56,11 @@ class MockRegionScannerFactory : public RegionScannerFactory {
   MOCK_METHOD(Status, NewRegionScanner,
               (const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner),
               (override));
+
+  MOCK_METHOD(Status, NewRegionScanner,
+              (const ClientStub& stub, std::shared_ptr<Region> region, const std::string& start_key,
+               const std::string& end_key, std::unique_ptr<RegionScanner>& scanner),
+              (override));
 };
 
 }  // namespace sdk
@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include <cstdint>
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -31,6 +34,7 @@
 #include "store/store_rpc.h"
 #include "test_base.h"
 #include "test_common.h"
+#include "utils/async_util.h"
 
 namespace dingodb {
 namespace sdk {
@@ -968,7 +972,7 @@ TEST_F(RawKVTest, ScanLookUpRegionFail) {
 }
 
 TEST_F(RawKVTest, ScanOpenFail) {
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -986,7 +990,7 @@ TEST_F(RawKVTest, ScanOpenFail) {
 }
 
 TEST_F(RawKVTest, ScanNoData) {
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -1014,7 +1018,7 @@ TEST_F(RawKVTest, ScanOneRegion) {
 
   int iter = 0;
 
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -1050,7 +1054,7 @@ TEST_F(RawKVTest, ScanOneRegionWithLimit) {
   std::vector<std::string> a2c_fake_datas = {"a001", "a002", "a003"};
   int a2c_iter = 0;
 
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -1090,7 +1094,7 @@ TEST_F(RawKVTest, ScanTwoRegion) {
   std::vector<std::string> c2e_fake_datas = {"c001", "c002", "c003"};
   int c2e_iter = 0;
 
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -1147,7 +1151,7 @@ TEST_F(RawKVTest, ScanTwoRegionWithLimit) {
   std::vector<std::string> c2e_fake_datas = {"c001", "c002", "c003"};
   int c2e_iter = 0;
 
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -1208,7 +1212,7 @@ TEST_F(RawKVTest, ScanRegionDiscontinuous) {
   std::vector<std::string> l2n_fake_datas = {"m001", "m002", "m003"};
   int l2n_iter = 0;
 
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -1286,7 +1290,7 @@ TEST_F(RawKVTest, ScanRegionDiscontinuousWithLimit) {
   std::vector<std::string> l2n_fake_datas = {"m001", "m002", "m003"};
   int l2n_iter = 0;
 
-  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_))
       .WillOnce([&](const ClientStub& stub, std::shared_ptr<Region> region, std::unique_ptr<RegionScanner>& scanner) {
         auto mock_scanner = std::make_unique<MockRegionScanner>(stub, std::move(region));
 
@@ -1354,5 +1358,212 @@ TEST_F(RawKVTest, ScanRegionDiscontinuousWithLimit) {
     EXPECT_EQ(kv.key, kv.value);
   }
 }
+
+TEST_F(RawKVTest, ScannerInvalid) {
+  std::shared_ptr<RawKVScanner> scanner;
+  Status ret = raw_kv->NewScanner("d", "b", ScanOptions(), scanner);
+  EXPECT_TRUE(ret.IsInvalidArgument());
+}
+
+// Like store, only the datas within [start_key, end_key) are returned.
+static void MockScannerWithDatas(const ClientStub& stub, std::shared_ptr<Region> region, const std::string& start_key,
+                                 const std::string& end_key, std::unique_ptr<RegionScanner>& scanner,
+                                 std::unordered_map<int64_t, std::vector<std::string>>& region_datas) {
+  auto mock_scanner = std::make_unique<MockRegionScanner>(stub, region);
+  std::vector<std::string> datas;
+  for (const auto& data : region_datas[region->RegionId()]) {
+    if (data >= start_key && data < end_key) {
+      datas.push_back(data);
+    }
+  }
+  auto iter = std::make_shared<int>(0);
+
+  EXPECT_CALL(*mock_scanner, Open).WillOnce(testing::Return(Status::OK()));
+
+  EXPECT_CALL(*mock_scanner, HasMore).WillRepeatedly([iter, datas]() { return *iter < datas.size(); });
+
+  EXPECT_CALL(*mock_scanner, NextBatch).WillRepeatedly([iter, datas](std::vector<KVPair>& kvs) {
+    if (*iter < datas.size()) {
+      kvs.push_back({datas[*iter], datas[*iter]});
+      (*iter)++;
+    }
+    return Status::OK();
+  });
+
+  scanner = std::move(mock_scanner);
+}
+
+TEST_F(RawKVTest, ScannerOrderedInTwoRegion) {
+  std::unordered_map<int64_t, std::vector<std::string>> region_datas;
+  region_datas[RegionA2C()->RegionId()] = {"a001", "b001", "b002"};
+  region_datas[RegionC2E()->RegionId()] = {"c001", "c002", "d001"};
+
+  EXPECT_CALL(*coordinator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            Region2ScanRegionInfo(RegionC2E(), response.add_regions());
+            Region2ScanRegionInfo(RegionA2C(), response.add_regions());
+            return Status::OK();
+          });
+
+  std::map<int64_t, std::pair<std::string, std::string>> scan_ranges;
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_, testing::_, testing::_))
+      .Times(2)
+      .WillRepeatedly([&](const ClientStub& stub, std::shared_ptr<Region> region, const std::string& start_key,
+                          const std::string& end_key, std::unique_ptr<RegionScanner>& scanner) {
+        scan_ranges[region->RegionId()] = {start_key, end_key};
+        MockScannerWithDatas(stub, std::move(region), start_key, end_key, scanner, region_datas);
+        return Status::OK();
+      });
+
+  ScanOptions options;
+  options.parallel_region_num = 2;
+  options.prefetch_batch_num = 2;
+
+  std::shared_ptr<RawKVScanner> scanner;
+  Status ret = raw_kv->NewScanner("b", "d", options, scanner);
+  EXPECT_TRUE(ret.IsOK());
+
+  std::vector<std::string> keys;
+  while (scanner->HasMore()) {
+    KVPair kv;
+    EXPECT_TRUE(scanner->Next(kv).IsOK());
+    EXPECT_EQ(kv.key, kv.value);
+    keys.push_back(kv.key);
+  }
+
+  std::vector<std::string> expected = {"b001", "b002", "c001", "c002"};
+  EXPECT_EQ(keys, expected);
+
+  // The first and last region are only scanned within [start_key, end_key).
+  EXPECT_EQ(scan_ranges[RegionA2C()->RegionId()], std::make_pair(std::string("b"), std::string("c")));
+  EXPECT_EQ(scan_ranges[RegionC2E()->RegionId()], std::make_pair(std::string("c"), std::string("d")));
+
+  KVPair kv;
+  EXPECT_TRUE(scanner->Next(kv).IsNotFound());
+}
+
+TEST_F(RawKVTest, ScannerUnorderedInTwoRegion) {
+  std::unordered_map<int64_t, std::vector<std::string>> region_datas;
+  region_datas[RegionA2C()->RegionId()] = {"b001", "b002", "b003"};
+  region_datas[RegionC2E()->RegionId()] = {"c001", "c002"};
+
+  EXPECT_CALL(*coordinator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            Region2ScanRegionInfo(RegionA2C(), response.add_regions());
+            Region2ScanRegionInfo(RegionC2E(), response.add_regions());
+            return Status::OK();
+          });
+
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner(testing::_, testing::_, testing::_, testing::_, testing::_))
+      .Times(2)
+      .WillRepeatedly([&](const ClientStub& stub, std::shared_ptr<Region> region, const std::string& start_key,
+                          const std::string& end_key, std::unique_ptr<RegionScanner>& scanner) {
+        MockScannerWithDatas(stub, std::move(region), start_key, end_key, scanner, region_datas);
+        return Status::OK();
+      });
+
+  ScanOptions options;
+  options.parallel_region_num = 2;
+  options.ordered = false;
+  options.max_buffer_bytes = 1;
+
+  std::shared_ptr<RawKVScanner> scanner;
+  Status ret = raw_kv->NewScanner("a", "e", options, scanner);
+  EXPECT_TRUE(ret.IsOK());
+
+  std::vector<std::string> keys;
+  while (scanner->HasMore()) {
+    KVPair kv;
+    EXPECT_TRUE(scanner->Next(kv).IsOK());
+    keys.push_back(kv.key);
+  }
+
+  std::sort(keys.begin(), keys.end());
+  std::vector<std::string> expected = {"b001", "b002", "b003", "c001", "c002"};
+  EXPECT_EQ(keys, expected);
+}
+
+TEST_F(RawKVTest, AsyncGet) {
+  std::string key = "b";
+  std::string value;
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillOnce([&](Rpc& rpc, std::function<void()> cb) {
+    auto* kv_get_rpc = dynamic_cast<KvGetRpc*>(&rpc);
+    CHECK_NOTNULL(kv_get_rpc);
+
+    kv_get_rpc->MutableResponse()->set_value("pong");
+    cb();
+  });
+
+  Status got;
+  Synchronizer sync;
+  raw_kv->AsyncGet(key, value, sync.AsStatusCallBack(got));
+  sync.Wait();
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(value, "pong");
+}
+
+TEST_F(RawKVTest, AsyncBatchPutInFlight) {
+  const int kBatchNum = 100;
+  std::vector<std::vector<KVPair>> batches(kBatchNum);
+  for (auto i = 0; i < kBatchNum; i++) {
+    batches[i].push_back({"b" + std::to_string(i), "b" + std::to_string(i)});
+    batches[i].push_back({"d" + std::to_string(i), "d" + std::to_string(i)});
+  }
+
+  std::atomic<int> rpc_count(0);
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* kv_batch_put_rpc = dynamic_cast<KvBatchPutRpc*>(&rpc);
+    CHECK_NOTNULL(kv_batch_put_rpc);
+
+    for (const auto& kv : kv_batch_put_rpc->Request()->kvs()) {
+      EXPECT_EQ(kv.key(), kv.value());
+    }
+
+    rpc_count.fetch_add(1);
+    cb();
+  });
+
+  std::atomic<int> ok_count(0);
+  CountDownLatch latch(kBatchNum);
+  for (auto i = 0; i < kBatchNum; i++) {
+    raw_kv->AsyncBatchPut(batches[i], [&](const Status& s) {
+      if (s.IsOK()) {
+        ok_count.fetch_add(1);
+      }
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+
+  EXPECT_EQ(ok_count.load(), kBatchNum);
+  EXPECT_EQ(rpc_count.load(), kBatchNum * 2);
+}
+
+TEST_F(RawKVTest, AsyncBatchCompareAndSetInvalid) {
+  std::vector<KVPair> kvs;
+  kvs.push_back({"a", "a"});
+
+  std::vector<std::string> expect_values;
+  std::vector<KeyOpState> key_state;
+
+  Status result;
+  Synchronizer sync;
+  raw_kv->AsyncBatchCompareAndSet(kvs, expect_values, key_state, sync.AsStatusCallBack(result));
+  sync.Wait();
+  EXPECT_TRUE(result.IsInvalidArgument());
+}
+
+TEST_F(RawKVTest, AsyncScanInvalid) {
+  std::vector<KVPair> kvs;
+
+  Status result;
+  Synchronizer sync;
+  raw_kv->AsyncScan("z", "a", 0, kvs, sync.AsStatusCallBack(result));
+  sync.Wait();
+  EXPECT_TRUE(result.IsInvalidArgument());
+}
 }  // namespace sdk
 }  // namespace dingodb
\ No newline at end of file
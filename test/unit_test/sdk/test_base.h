@@ -20,6 +20,7 @@
 #include "admin_tool.h"
 #include "client.h"
 #include "client_internal_data.h"
+#include "common/param_config.h"
 #include "glog/logging.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -32,6 +33,7 @@
 #include "test_common.h"
 #include "transaction/mock_txn_lock_resolver.h"
 #include "transaction/txn_impl.h"
+#include "utils/thread_pool_executor.h"
 
 namespace dingodb {
 namespace sdk {
@@ -69,11 +71,17 @@ class TestBase : public ::testing::Test {
     ON_CALL(*stub, GetTxnLockResolver).WillByDefault(testing::Return(txn_lock_resolver));
     EXPECT_CALL(*stub, GetTxnLockResolver).Times(testing::AnyNumber());
 
+    executor = std::make_shared<ThreadPoolExecutor>();
+    executor->Start(kExecutorThreadNum);
+    ON_CALL(*stub, GetExecutor).WillByDefault(testing::Return(executor));
+    EXPECT_CALL(*stub, GetExecutor).Times(testing::AnyNumber());
+
     client = new Client();
     client->data_->stub = std::move(tmp);
   }
 
   ~TestBase() override {
+    executor->Stop();
     store_rpc_interaction.reset();
     meta_cache.reset();
     delete client;
@@ -94,6 +102,7 @@ class TestBase : public ::testing::Test {
   std::shared_ptr<MockRegionScannerFactory> region_scanner_factory;
   std::shared_ptr<AdminTool> admin_tool;
   std::shared_ptr<MockTxnLockResolver> txn_lock_resolver;
+  std::shared_ptr<ThreadPoolExecutor> executor;
 
   // client own stub
   MockClientStub* stub;
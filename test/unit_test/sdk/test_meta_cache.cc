@@ -12,6 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "common/param_config.h"
 #include "coordinator_proxy.h"
 #include "gtest/gtest.h"
 #include "meta_cache.h"
@@ -455,5 +461,92 @@ TEST_F(MetaCacheTest, LookupRegionBetweenRangeNoPreetch) {
   EXPECT_EQ(tmp->Range().end_key(), a2c->Range().end_key());
 }
 
+TEST_F(MetaCacheTest, LookupRegionByKeyPrefetch) {
+  auto a2c = RegionA2C();
+  auto c2e = RegionC2E();
+
+  EXPECT_CALL(*cooridnator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            EXPECT_EQ(request.key(), "b");
+            EXPECT_EQ(request.range_end(), std::string(1, '\0'));
+            EXPECT_EQ(request.limit(), kPrefetchRegionCount);
+            Region2ScanRegionInfo(a2c, response.add_regions());
+            Region2ScanRegionInfo(c2e, response.add_regions());
+            return Status::OK();
+          });
+
+  std::shared_ptr<Region> tmp;
+  Status got = meta_cache->LookupRegionByKey("b", tmp);
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(tmp->RegionId(), a2c->RegionId());
+
+  // c2e is prefetched, no more rpc
+  got = meta_cache->LookupRegionByKey("d", tmp);
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(tmp->RegionId(), c2e->RegionId());
+}
+
+TEST_F(MetaCacheTest, LookupRegionByKeyStopAtCachedRegion) {
+  auto a2c = RegionA2C();
+  auto e2g = RegionE2G();
+  meta_cache->MaybeAddRegion(e2g);
+
+  EXPECT_CALL(*cooridnator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            EXPECT_EQ(request.key(), "b");
+            EXPECT_EQ(request.range_end(), "e");
+            Region2ScanRegionInfo(a2c, response.add_regions());
+            return Status::OK();
+          });
+
+  std::shared_ptr<Region> tmp;
+  Status got = meta_cache->LookupRegionByKey("b", tmp);
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(tmp->RegionId(), a2c->RegionId());
+}
+
+TEST_F(MetaCacheTest, LookupRegionByKeyConcurrentMiss) {
+  auto a2c = RegionA2C();
+  auto c2e = RegionC2E();
+
+  EXPECT_CALL(*cooridnator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            // wait other lookups miss
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            Region2ScanRegionInfo(a2c, response.add_regions());
+            Region2ScanRegionInfo(c2e, response.add_regions());
+            return Status::OK();
+          });
+
+  std::atomic<int> ok_count(0);
+  std::vector<std::thread> threads;
+  threads.emplace_back([&]() {
+    std::shared_ptr<Region> tmp;
+    if (meta_cache->LookupRegionByKey("a", tmp).IsOK() && tmp->RegionId() == a2c->RegionId()) {
+      ok_count++;
+    }
+  });
+  // make sure the first lookup is in flight
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  const std::vector<std::string> keys = {"b", "c", "d"};
+  for (const auto& key : keys) {
+    threads.emplace_back([&, key]() {
+      std::shared_ptr<Region> tmp;
+      if (meta_cache->LookupRegionByKey(key, tmp).IsOK()) {
+        ok_count++;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(ok_count.load(), 4);
+}
+
 }  // namespace sdk
 }  // namespace dingodb
\ No newline at end of file
@@ -0,0 +1,125 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/common.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mock_coordinator_proxy.h"
+#include "tso_client.h"
+
+namespace dingodb {
+namespace sdk {
+
+class TsoClientTest : public testing::Test {
+ public:
+  void SetUp() override {
+    coordinator_proxy = std::make_shared<MockCoordinatorProxy>();
+    tso_client = std::make_unique<TsoClient>(coordinator_proxy);
+  }
+
+  void TearDown() override {
+    tso_client.reset();
+    coordinator_proxy.reset();
+  }
+
+  std::shared_ptr<MockCoordinatorProxy> coordinator_proxy;
+  std::unique_ptr<TsoClient> tso_client;
+};
+
+TEST_F(TsoClientTest, GenTso) {
+  EXPECT_CALL(*coordinator_proxy, TsoService)
+      .WillOnce([&](const pb::meta::TsoRequest& request, pb::meta::TsoResponse& response) {
+        EXPECT_EQ(request.op_type(), pb::meta::OP_GEN_TSO);
+        EXPECT_EQ(request.count(), 1);
+        response.mutable_start_timestamp()->set_physical(100);
+        response.mutable_start_timestamp()->set_logical(7);
+        return Status::OK();
+      });
+
+  pb::meta::TsoTimestamp tso;
+  EXPECT_TRUE(tso_client->GenTso(tso).IsOK());
+  EXPECT_EQ(tso.physical(), 100);
+  EXPECT_EQ(tso.logical(), 7);
+}
+
+TEST_F(TsoClientTest, GenTsoFail) {
+  EXPECT_CALL(*coordinator_proxy, TsoService).WillOnce(testing::Return(Status::NetworkError("mock error")));
+
+  pb::meta::TsoTimestamp tso;
+  EXPECT_TRUE(tso_client->GenTso(tso).IsNetworkError());
+}
+
+TEST_F(TsoClientTest, ConcurrentGenTso) {
+  const int kThreadNum = 16;
+  const int kRequestPerThread = 100;
+
+  std::atomic<int64_t> rpc_count{0};
+  std::atomic<int64_t> tso_count{0};
+  std::mutex mutex;
+  int64_t next_logical = 0;
+  EXPECT_CALL(*coordinator_proxy, TsoService)
+      .WillRepeatedly([&](const pb::meta::TsoRequest& request, pb::meta::TsoResponse& response) {
+        EXPECT_GT(request.count(), 0);
+        rpc_count.fetch_add(1);
+        tso_count.fetch_add(request.count());
+        // simulate the round trip
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+        std::lock_guard<std::mutex> guard(mutex);
+        response.mutable_start_timestamp()->set_physical(1);
+        response.mutable_start_timestamp()->set_logical(next_logical);
+        next_logical += request.count();
+        return Status::OK();
+      });
+
+  std::vector<std::vector<int64_t>> thread_timestamps(kThreadNum);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < kRequestPerThread; ++j) {
+        pb::meta::TsoTimestamp tso;
+        EXPECT_TRUE(tso_client->GenTso(tso).IsOK());
+        thread_timestamps[i].push_back(Tso2Timestamp(tso));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::set<int64_t> timestamps;
+  for (const auto& thread_timestamp : thread_timestamps) {
+    for (size_t i = 1; i < thread_timestamp.size(); ++i) {
+      // timestamps got by one thread are monotonic
+      EXPECT_LT(thread_timestamp[i - 1], thread_timestamp[i]);
+    }
+    timestamps.insert(thread_timestamp.begin(), thread_timestamp.end());
+  }
+
+  EXPECT_EQ(timestamps.size(), kThreadNum * kRequestPerThread);
+  EXPECT_EQ(tso_count.load(), kThreadNum * kRequestPerThread);
+  EXPECT_LT(rpc_count.load(), kThreadNum * kRequestPerThread);
+}
+
+}  // namespace sdk
+}  // namespace dingodb
@@ -12,11 +12,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "client.h"
 #include "common/common.h"
+#include "common/param_config.h"
+#include "fmt/core.h"
 #include "glog/logging.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -30,6 +39,8 @@
 
 static const int64_t kStep = 10;
 
+static const int64_t kManyRegionNum = dingodb::sdk::kTxnMaxSubTaskConcurrency * 2;
+
 namespace dingodb {
 namespace sdk {
 
@@ -1014,5 +1025,175 @@ TEST_F(TxnImplTest, RollbackSecondKeysFail) {
   EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kRollbackted);
 }
 
+// add regions [h000, h001), [h001, h002)..., return the start key of each region
+static std::vector<std::string> FillManyRegions(const std::shared_ptr<MetaCache>& meta_cache) {
+  std::vector<std::string> keys;
+  for (int64_t i = 0; i < kManyRegionNum; i++) {
+    pb::common::Range range;
+    range.set_start_key(fmt::format("h{:03d}", i));
+    range.set_end_key(fmt::format("h{:03d}", i + 1));
+    pb::common::RegionEpoch epoch;
+    epoch.set_version(1);
+    epoch.set_conf_version(1);
+    meta_cache->MaybeAddRegion(GenRegion(1000 + i, range, epoch, pb::common::RegionType::STORE_REGION));
+    keys.push_back(range.start_key());
+  }
+  return keys;
+}
+
+TEST_F(TxnImplTest, BatchGetManyRegions) {
+  auto keys = FillManyRegions(meta_cache);
+
+  auto txn = NewTransactionImpl(options);
+
+  std::mutex lock;
+  std::multiset<int64_t> region_ids;
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* txn_rpc = dynamic_cast<TxnBatchGetRpc*>(&rpc);
+    CHECK_NOTNULL(txn_rpc);
+
+    {
+      std::unique_lock<std::mutex> lk(lock);
+      region_ids.insert(txn_rpc->Request()->context().region_id());
+    }
+
+    for (const auto& key : txn_rpc->Request()->keys()) {
+      auto* kv = txn_rpc->MutableResponse()->add_kvs();
+      kv->set_key(key);
+      kv->set_value(key);
+    }
+    cb();
+  });
+
+  std::vector<KVPair> kvs;
+  Status s = txn->BatchGet(keys, kvs);
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(kvs.size(), keys.size());
+  for (const auto& kv : kvs) {
+    EXPECT_EQ(kv.key, kv.value);
+  }
+
+  // every region sub task is processed exactly once
+  EXPECT_EQ(region_ids.size(), keys.size());
+  EXPECT_EQ(std::set<int64_t>(region_ids.begin(), region_ids.end()).size(), keys.size());
+}
+
+TEST_F(TxnImplTest, CommitManyRegions) {
+  auto keys = FillManyRegions(meta_cache);
+
+  auto txn = NewTransactionImpl(options);
+  for (const auto& key : keys) {
+    txn->Put(key, key);
+  }
+
+  std::mutex lock;
+  std::multiset<std::string> prewrite_keys;
+  std::multiset<std::string> commit_keys;
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    {
+      std::unique_lock<std::mutex> lk(lock);
+      auto* prewrite_rpc = dynamic_cast<TxnPrewriteRpc*>(&rpc);
+      if (prewrite_rpc != nullptr) {
+        for (const auto& mutation : prewrite_rpc->Request()->mutations()) {
+          prewrite_keys.insert(mutation.key());
+        }
+      } else {
+        auto* commit_rpc = dynamic_cast<TxnCommitRpc*>(&rpc);
+        CHECK_NOTNULL(commit_rpc);
+        for (const auto& key : commit_rpc->Request()->keys()) {
+          commit_keys.insert(key);
+        }
+      }
+    }
+    cb();
+  });
+
+  Status s = txn->PreCommit();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kPreCommitted);
+
+  s = txn->Commit();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kCommitted);
+
+  std::multiset<std::string> expected(keys.begin(), keys.end());
+  EXPECT_EQ(prewrite_keys, expected);
+  EXPECT_EQ(commit_keys, expected);
+}
+
+TEST_F(TxnImplTest, RollbackManyRegions) {
+  auto keys = FillManyRegions(meta_cache);
+
+  auto txn = NewTransactionImpl(options);
+  for (const auto& key : keys) {
+    txn->Put(key, key);
+  }
+
+  std::mutex lock;
+  std::multiset<std::string> rollback_keys;
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* rollback_rpc = dynamic_cast<TxnBatchRollbackRpc*>(&rpc);
+    if (rollback_rpc != nullptr) {
+      std::unique_lock<std::mutex> lk(lock);
+      for (const auto& key : rollback_rpc->Request()->keys()) {
+        rollback_keys.insert(key);
+      }
+    } else {
+      CHECK_NOTNULL(dynamic_cast<TxnPrewriteRpc*>(&rpc));
+    }
+    cb();
+  });
+
+  Status s = txn->PreCommit();
+  EXPECT_TRUE(s.ok());
+
+  s = txn->Rollback();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kRollbackted);
+
+  std::multiset<std::string> expected(keys.begin(), keys.end());
+  EXPECT_EQ(rollback_keys, expected);
+}
+
+TEST_F(TxnImplTest, BatchGetOnSaturatedExecutor) {
+  auto keys = FillManyRegions(meta_cache);
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* txn_rpc = dynamic_cast<TxnBatchGetRpc*>(&rpc);
+    CHECK_NOTNULL(txn_rpc);
+    for (const auto& key : txn_rpc->Request()->keys()) {
+      auto* kv = txn_rpc->MutableResponse()->add_kvs();
+      kv->set_key(key);
+      kv->set_value(key);
+    }
+    cb();
+  });
+
+  std::vector<std::unique_ptr<Transaction::TxnImpl>> txns;
+  for (int64_t i = 0; i < kExecutorThreadNum; i++) {
+    txns.push_back(NewTransactionImpl(options));
+  }
+
+  // every executor thread runs a batch get, so the sub task runners they post are queued behind them
+  std::atomic<int64_t> done_num(0);
+  std::atomic<int64_t> ok_num(0);
+  for (auto& txn : txns) {
+    auto* txn_ptr = txn.get();
+    CHECK(executor->Execute([&, txn_ptr]() {
+      std::vector<KVPair> kvs;
+      if (txn_ptr->BatchGet(keys, kvs).ok() && kvs.size() == keys.size()) {
+        ok_num++;
+      }
+      done_num++;
+    }));
+  }
+
+  for (int i = 0; i < 100 && done_num.load() < kExecutorThreadNum; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_EQ(done_num.load(), kExecutorThreadNum);
+  EXPECT_EQ(ok_num.load(), kExecutorThreadNum);
+}
+
 }  // namespace sdk
 }  // namespace dingodb
\ No newline at end of file
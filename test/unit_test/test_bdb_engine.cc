@@ -535,6 +535,38 @@ TEST_F(RawBdbEngineTest, KvGet) {
   }
 }
 
+TEST_F(RawBdbEngineTest, KvMultiGet) {
+  const std::string &cf_name = kDefaultCf;
+  auto reader = RawBdbEngineTest::engine->Reader();
+
+  // some key empty
+  {
+    std::vector<std::string> keys{"key3", ""};
+    std::vector<std::string> values;
+    std::vector<bool> founds;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, keys, values, founds);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  }
+
+  // unsorted keys with not exist key
+  {
+    std::vector<std::string> keys{"key3", "key10010", "key2"};
+    std::vector<std::string> values;
+    std::vector<bool> founds;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, keys, values, founds);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(values.size(), keys.size());
+    EXPECT_EQ(founds.size(), keys.size());
+    EXPECT_TRUE(founds[0]);
+    EXPECT_EQ(values[0], "value3");
+    EXPECT_FALSE(founds[1]);
+    EXPECT_TRUE(founds[2]);
+    EXPECT_EQ(values[2], "value2");
+  }
+}
+
 TEST_F(RawBdbEngineTest, KvScan) {
   const std::string &cf_name = kDefaultCf;
   auto reader = RawBdbEngineTest::engine->Reader();
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -33,11 +34,15 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "butil/time.h"
 #include "common/helper.h"
+#include "common/synchronization.h"
 #include "config/config.h"
 #include "config/yaml_config.h"
 #include "coprocessor/coprocessor.h"
 #include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store_internal.pb.h"
@@ -50,6 +55,10 @@
 #include "serial/schema/long_schema.h"
 #include "serial/schema/string_schema.h"
 
+DECLARE_int32(coprocessor_batch_size);
+
+DEFINE_int32(coprocessor_bench_row_count, 2 * 1000 * 1000, "row count of coprocessor throughput benchmark");
+
 namespace dingodb {
 
 static const std::string kDefaultCf = "default";
@@ -134,6 +143,9 @@ class CoprocessorTest : public testing::Test {
 
   void TearDown() override {}
 
+  // Scan rows with selection and aggregation, row by row and batch mode must return the same result.
+  static void ExecuteRowAndBatch(int row_count, bool print_throughput);
+
   static std::shared_ptr<RocksRawEngine> engine;
   static std::shared_ptr<Coprocessor> coprocessor;
 
@@ -3871,4 +3883,171 @@ TEST_F(CoprocessorTest, KvDeleteRangeForDisorder) {
   }
 }
 
+void CoprocessorTest::ExecuteRowAndBatch(int row_count, bool print_throughput) {
+  const int kBatchSize = 10000;
+  const long kCommonId = 1000;  // NOLINT
+
+  int32_t old_batch_size = FLAGS_coprocessor_batch_size;
+  DEFER(FLAGS_coprocessor_batch_size = old_batch_size);
+
+  auto schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  auto id_schema = std::make_shared<DingoSchema<std::optional<int64_t>>>();
+  id_schema->SetIsKey(true);
+  id_schema->SetAllowNull(false);
+  id_schema->SetIndex(0);
+  schemas->emplace_back(std::move(id_schema));
+  auto long_schema = std::make_shared<DingoSchema<std::optional<int64_t>>>();
+  long_schema->SetIsKey(false);
+  long_schema->SetAllowNull(true);
+  long_schema->SetIndex(1);
+  schemas->emplace_back(std::move(long_schema));
+  auto string_schema = std::make_shared<DingoSchema<std::optional<std::shared_ptr<std::string>>>>();
+  string_schema->SetIsKey(false);
+  string_schema->SetAllowNull(true);
+  string_schema->SetIndex(2);
+  schemas->emplace_back(std::move(string_schema));
+
+  RecordEncoder record_encoder(1, schemas, kCommonId);
+
+  std::string min_prefix;
+  std::string max_prefix;
+  record_encoder.EncodeMinKeyPrefix(min_prefix);
+  record_encoder.EncodeMaxKeyPrefix(max_prefix);
+
+  ON_SCOPE_EXIT([&]() {
+    pb::common::Range range;
+    range.set_start_key(min_prefix);
+    range.set_end_key(Helper::PrefixNext(max_prefix));
+    engine->Writer()->KvDeleteRange(kDefaultCf, range);
+  });
+
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.reserve(kBatchSize);
+  for (int i = 0; i < row_count; ++i) {
+    std::vector<std::any> record;
+    record.emplace_back(std::optional<int64_t>(i));
+    // some null value for aggregation.
+    record.emplace_back(i % 10 == 0 ? std::optional<int64_t>() : std::optional<int64_t>(i * 7));
+    record.emplace_back(
+        std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(fmt::format("value{:027}", i))));
+
+    pb::common::KeyValue kv;
+    ASSERT_EQ(0, record_encoder.Encode(record, kv));
+    kvs.push_back(std::move(kv));
+    if (kvs.size() == kBatchSize) {
+      ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(kDefaultCf, kvs, {}).ok());
+      kvs.clear();
+    }
+  }
+  ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(kDefaultCf, kvs, {}).ok());
+  kvs.clear();
+
+  // Scan all rows, return result count and keep the result of the last Execute.
+  auto scan = [&](const std::string &name, const pb::store::Coprocessor &pb_coprocessor, int batch_size,
+                  std::vector<pb::common::KeyValue> *last_kvs) -> size_t {
+    FLAGS_coprocessor_batch_size = batch_size;
+    coprocessor->Close();
+    butil::Status ok = coprocessor->Open(pb_coprocessor);
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+
+    IteratorOptions options;
+    options.upper_bound = Helper::PrefixNext(max_prefix);
+    auto iter = engine->Reader()->NewIterator(kDefaultCf, options);
+    iter->Seek(min_prefix);
+
+    butil::Timer timer;
+    timer.start();
+    size_t cnt = 0;
+    while (true) {
+      std::vector<pb::common::KeyValue> result_kvs;
+      ok = coprocessor->Execute(iter, false, 1000, INT64_MAX, &result_kvs);
+      EXPECT_EQ(ok.error_code(), pb::error::OK);
+      if (!ok.ok() || result_kvs.empty()) {
+        break;
+      }
+      cnt += result_kvs.size();
+      *last_kvs = std::move(result_kvs);
+    }
+    timer.stop();
+
+    if (print_throughput) {
+      std::cout << fmt::format("coprocessor {} batch_size({}) rows({}) elapsed time({}ms) rows/sec({})", name,
+                               batch_size, row_count, timer.m_elapsed(),
+                               row_count * 1000L / std::max(timer.m_elapsed(), static_cast<int64_t>(1)))
+                << '\n';
+    }
+    coprocessor->Close();
+    return cnt;
+  };
+
+  // selection all columns
+  pb::store::Coprocessor pb_coprocessor;
+  pb_coprocessor.set_schema_version(1);
+  auto *original_schema = pb_coprocessor.mutable_original_schema();
+  original_schema->set_common_id(kCommonId);
+  auto *result_schema = pb_coprocessor.mutable_result_schema();
+  result_schema->set_common_id(kCommonId);
+  for (auto *pb_schema : {original_schema, result_schema}) {
+    auto *schema1 = pb_schema->add_schema();
+    schema1->set_type(::dingodb::pb::common::Schema_Type::Schema_Type_LONG);
+    schema1->set_is_key(true);
+    schema1->set_is_nullable(false);
+    schema1->set_index(0);
+
+    auto *schema2 = pb_schema->add_schema();
+    schema2->set_type(::dingodb::pb::common::Schema_Type::Schema_Type_LONG);
+    schema2->set_is_key(false);
+    schema2->set_is_nullable(true);
+    schema2->set_index(1);
+
+    auto *schema3 = pb_schema->add_schema();
+    schema3->set_type(::dingodb::pb::common::Schema_Type::Schema_Type_STRING);
+    schema3->set_is_key(false);
+    schema3->set_is_nullable(true);
+    schema3->set_index(2);
+  }
+
+  std::vector<pb::common::KeyValue> row_kvs;
+  std::vector<pb::common::KeyValue> batch_kvs;
+  EXPECT_EQ(row_count, scan("selection", pb_coprocessor, 1, &row_kvs));
+  EXPECT_EQ(row_count, scan("selection", pb_coprocessor, 1024, &batch_kvs));
+  ASSERT_EQ(row_kvs.size(), batch_kvs.size());
+  for (size_t i = 0; i < row_kvs.size(); ++i) {
+    EXPECT_EQ(row_kvs[i].key(), batch_kvs[i].key());
+    EXPECT_EQ(row_kvs[i].value(), batch_kvs[i].value());
+  }
+
+  // SUM(c1), COUNT(*), MAX(c1), MIN(c1) without group by
+  result_schema->clear_schema();
+  for (auto oper : {pb::store::SUM, pb::store::COUNT, pb::store::MAX, pb::store::MIN}) {
+    auto *aggregation_operator = pb_coprocessor.add_aggregation_operators();
+    aggregation_operator->set_oper(oper);
+    aggregation_operator->set_index_of_column(oper == pb::store::COUNT ? -1 : 1);
+
+    auto *schema = result_schema->add_schema();
+    schema->set_type(::dingodb::pb::common::Schema_Type::Schema_Type_LONG);
+    schema->set_is_key(false);
+    schema->set_is_nullable(true);
+    schema->set_index(result_schema->schema_size() - 1);
+  }
+
+  row_kvs.clear();
+  batch_kvs.clear();
+  EXPECT_EQ(1, scan("aggregation", pb_coprocessor, 1, &row_kvs));
+  EXPECT_EQ(1, scan("aggregation", pb_coprocessor, 1024, &batch_kvs));
+  ASSERT_EQ(1, row_kvs.size());
+  ASSERT_EQ(1, batch_kvs.size());
+  EXPECT_EQ(row_kvs[0].value(), batch_kvs[0].value());
+}
+
+TEST_F(CoprocessorTest, ExecuteRowAndBatch) {  // NOLINT
+  ExecuteRowAndBatch(20 * 1000, false);
+}
+
+// It's a benchmark of rows/sec, run it with:
+//   --gtest_also_run_disabled_tests --gtest_filter=*ExecuteThroughput --coprocessor_bench_row_count=5000000
+TEST_F(CoprocessorTest, DISABLED_ExecuteThroughput) {  // NOLINT
+  ExecuteRowAndBatch(FLAGS_coprocessor_bench_row_count, true);
+}
+
 }  // namespace dingodb
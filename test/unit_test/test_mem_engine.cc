@@ -0,0 +1,290 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/mem_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+DECLARE_int64(mem_engine_auto_compact_min_count);
+
+namespace dingodb {
+
+static const std::string kDefaultCf = "default";
+static const std::string kMetaCf = "meta";
+
+class MemEngineTest : public testing::Test {
+ public:
+  void SetUp() override {
+    engine = std::make_shared<MemEngine>();
+    ASSERT_TRUE(engine->Init(nullptr, {kDefaultCf, kMetaCf}));
+  }
+
+  void TearDown() override {
+    engine->Close();
+    engine = nullptr;
+  }
+
+  static pb::common::KeyValue GenKv(const std::string& key, const std::string& value) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    return kv;
+  }
+
+  std::shared_ptr<MemEngine> engine;
+};
+
+TEST_F(MemEngineTest, GetName) {
+  EXPECT_EQ(engine->GetName(), "RAW_ENG_MEMORY");
+  EXPECT_EQ(engine->GetRawEngineType(), pb::common::RawEngine::RAW_ENG_MEMORY);
+}
+
+TEST_F(MemEngineTest, KvPutGetDelete) {
+  auto reader = engine->Reader();
+  auto writer = engine->Writer();
+
+  EXPECT_EQ(pb::error::EKEY_EMPTY, writer->KvPut(kDefaultCf, GenKv("", "value")).error_code());
+  EXPECT_EQ(pb::error::EILLEGAL_PARAMTETERS, writer->KvPut("unknown", GenKv("key", "value")).error_code());
+
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key1", "value1")).ok());
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key1", "value2")).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(kDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value2", value);
+
+  // Column family is isolated.
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kMetaCf, "key1", value).error_code());
+
+  EXPECT_TRUE(writer->KvDelete(kDefaultCf, "key1").ok());
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDefaultCf, "key1", value).error_code());
+
+  std::vector<std::string> values;
+  std::vector<bool> founds;
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key2", "value2")).ok());
+  EXPECT_TRUE(reader->KvMultiGet(kDefaultCf, {"key1", "key2"}, values, founds).ok());
+  EXPECT_FALSE(founds[0]);
+  EXPECT_TRUE(founds[1]);
+  EXPECT_EQ("value2", values[1]);
+}
+
+TEST_F(MemEngineTest, KvBatchWrite) {
+  auto reader = engine->Reader();
+  auto writer = engine->Writer();
+
+  RawEngine::WriteBatch batch;
+  batch.Put(kDefaultCf, "key1", "value1");
+  batch.Put(kMetaCf, "key1", "meta1");
+  batch.Delete(kDefaultCf, "key1");
+  batch.Put(kDefaultCf, "key1", "value2");
+  EXPECT_TRUE(writer->KvBatchWrite(batch).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(kDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value2", value);
+  EXPECT_TRUE(reader->KvGet(kMetaCf, "key1", value).ok());
+  EXPECT_EQ("meta1", value);
+
+  // Batch with bad op write nothing.
+  batch.Clear();
+  batch.Put(kDefaultCf, "key2", "value2");
+  batch.Put("unknown", "key2", "value2");
+  EXPECT_FALSE(writer->KvBatchWrite(batch).ok());
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDefaultCf, "key2", value).error_code());
+}
+
+TEST_F(MemEngineTest, Snapshot) {
+  auto reader = engine->Reader();
+  auto writer = engine->Writer();
+
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key1", "value1")).ok());
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key2", "value2")).ok());
+
+  auto snapshot = engine->GetSnapshot();
+  ASSERT_NE(nullptr, snapshot);
+
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key1", "value11")).ok());
+  EXPECT_TRUE(writer->KvDelete(kDefaultCf, "key2").ok());
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key3", "value3")).ok());
+
+  // Compact must keep versions visible to snapshot.
+  EXPECT_TRUE(engine->Compact(kDefaultCf).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(kDefaultCf, snapshot, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+  EXPECT_TRUE(reader->KvGet(kDefaultCf, snapshot, "key2", value).ok());
+  EXPECT_EQ("value2", value);
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDefaultCf, snapshot, "key3", value).error_code());
+
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount(kDefaultCf, snapshot, "key", "kez", count).ok());
+  EXPECT_EQ(2, count);
+  EXPECT_TRUE(reader->KvCount(kDefaultCf, "key", "kez", count).ok());
+  EXPECT_EQ(2, count);
+
+  std::vector<pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvScan(kDefaultCf, "key", "kez", kvs).ok());
+  ASSERT_EQ(2, kvs.size());
+  EXPECT_EQ("value11", kvs[0].value());
+  EXPECT_EQ("key3", kvs[1].key());
+
+  snapshot = nullptr;
+  EXPECT_TRUE(engine->Compact(kDefaultCf).ok());
+  EXPECT_TRUE(reader->KvGet(kDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value11", value);
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDefaultCf, "key2", value).error_code());
+}
+
+TEST_F(MemEngineTest, Iterator) {
+  auto reader = engine->Reader();
+  auto writer = engine->Writer();
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv(fmt::format("key{}", i), fmt::format("value{}", i))).ok());
+  }
+  EXPECT_TRUE(writer->KvDelete(kDefaultCf, "key3").ok());
+  EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv("key5", "value55")).ok());
+
+  IteratorOptions options;
+  options.lower_bound = "key2";
+  options.upper_bound = "key7";
+  auto iter = reader->NewIterator(kDefaultCf, options);
+  ASSERT_NE(nullptr, iter);
+
+  std::vector<std::string> keys;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    keys.emplace_back(iter->Key());
+  }
+  EXPECT_EQ(std::vector<std::string>({"key2", "key4", "key5", "key6"}), keys);
+
+  keys.clear();
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    keys.emplace_back(iter->Key());
+  }
+  EXPECT_EQ(std::vector<std::string>({"key6", "key5", "key4", "key2"}), keys);
+
+  iter->Seek("key0");
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ("key2", iter->Key());
+
+  iter->Seek("key5");
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ("value55", iter->Value());
+
+  iter->SeekForPrev("key3");
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ("key2", iter->Key());
+
+  iter->Seek("key7");
+  EXPECT_FALSE(iter->Valid());
+}
+
+TEST_F(MemEngineTest, KvDeleteRange) {
+  auto reader = engine->Reader();
+  auto writer = engine->Writer();
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(writer->KvPut(kDefaultCf, GenKv(fmt::format("key{}", i), "value")).ok());
+    EXPECT_TRUE(writer->KvPut(kMetaCf, GenKv(fmt::format("key{}", i), "value")).ok());
+  }
+
+  pb::common::Range range;
+  range.set_start_key("key3");
+  range.set_end_key("key6");
+  EXPECT_TRUE(writer->KvDeleteRange({kDefaultCf, kMetaCf}, range).ok());
+
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount(kDefaultCf, "key", "kez", count).ok());
+  EXPECT_EQ(7, count);
+  EXPECT_TRUE(reader->KvCount(kMetaCf, "key", "kez", count).ok());
+  EXPECT_EQ(7, count);
+
+  std::vector<pb::common::Range> ranges = {range};
+  range.set_start_key("key0");
+  range.set_end_key("kez");
+  ranges.push_back(range);
+  auto sizes = engine->GetApproximateSizes(kDefaultCf, ranges);
+  ASSERT_EQ(2, sizes.size());
+  EXPECT_EQ(0, sizes[0]);
+  EXPECT_EQ(7 * (4 + 5), sizes[1]);
+}
+
+TEST_F(MemEngineTest, ConcurrentReadWrite) {
+  auto reader = engine->Reader();
+  auto writer = engine->Writer();
+
+  const int kKeyCount = 1000;
+  std::thread write_thread([&]() {
+    for (int round = 0; round < 10; ++round) {
+      RawEngine::WriteBatch batch;
+      for (int i = 0; i < kKeyCount; ++i) {
+        batch.Put(kDefaultCf, fmt::format("key{:04}", i), std::to_string(round));
+      }
+      EXPECT_TRUE(writer->KvBatchWrite(batch).ok());
+      EXPECT_TRUE(engine->Compact(kDefaultCf).ok());
+    }
+  });
+
+  // Batch is atomic, so all keys of one read have the same round.
+  for (int i = 0; i < 100; ++i) {
+    std::vector<pb::common::KeyValue> kvs;
+    EXPECT_TRUE(reader->KvScan(kDefaultCf, "key", "kez", kvs).ok());
+    if (kvs.empty()) {
+      continue;
+    }
+    EXPECT_EQ(kKeyCount, kvs.size());
+    for (const auto& kv : kvs) {
+      EXPECT_EQ(kvs[0].value(), kv.value());
+    }
+  }
+
+  write_thread.join();
+}
+
+TEST_F(MemEngineTest, AutoCompact) {
+  int64_t old_min_count = FLAGS_mem_engine_auto_compact_min_count;
+  FLAGS_mem_engine_auto_compact_min_count = 100;
+
+  // Overwrite the same keys, the old versions are dropped by auto compact.
+  auto writer = engine->Writer();
+  for (int round = 0; round < 100; ++round) {
+    RawEngine::WriteBatch batch;
+    for (int i = 0; i < 10; ++i) {
+      batch.Put(kDefaultCf, fmt::format("key{:04}", i), std::to_string(round));
+    }
+    EXPECT_TRUE(writer->KvBatchWrite(batch).ok());
+  }
+
+  FLAGS_mem_engine_auto_compact_min_count = old_min_count;
+
+  EXPECT_LT(engine->GetColumnFamily(kDefaultCf)->GetList()->Count(), 100);
+
+  std::string value;
+  EXPECT_TRUE(engine->Reader()->KvGet(kDefaultCf, "key0009", value).ok());
+  EXPECT_EQ("99", value);
+}
+
+}  // namespace dingodb
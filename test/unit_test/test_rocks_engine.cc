@@ -28,10 +28,12 @@
 #include <memory>
 #include <numeric>
 #include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "butil/status.h"
+#include "bvar/variable.h"
 #include "common/context.h"
 #include "common/helper.h"
 #include "config/config.h"
@@ -592,6 +594,113 @@ TEST_F(RawRocksEngineTest, KvGet) {
   }
 }
 
+TEST_F(RawRocksEngineTest, KvMultiGet) {
+  const std::string &cf_name = kDefaultCf;
+  auto reader = RawRocksEngineTest::engine->Reader();
+
+  // some key empty
+  {
+    std::vector<std::string> keys{"key1", ""};
+    std::vector<std::string> values;
+    std::vector<bool> founds;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, keys, values, founds);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  }
+
+  // unsorted keys with not exist key
+  {
+    std::vector<std::string> keys{"key3", "key10010", "key1", "key2"};
+    std::vector<std::string> values;
+    std::vector<bool> founds;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, keys, values, founds);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(values.size(), keys.size());
+    EXPECT_EQ(founds.size(), keys.size());
+    EXPECT_TRUE(founds[0]);
+    EXPECT_EQ(values[0], "value3");
+    EXPECT_FALSE(founds[1]);
+    EXPECT_TRUE(founds[2]);
+    EXPECT_EQ(values[2], "value1");
+    EXPECT_TRUE(founds[3]);
+    EXPECT_EQ(values[3], "value2");
+  }
+
+  // with snapshot
+  {
+    auto snapshot = RawRocksEngineTest::engine->GetSnapshot();
+    std::vector<std::string> keys{"key1", "key1"};
+    std::vector<std::string> values;
+    std::vector<bool> founds;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, snapshot, keys, values, founds);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_TRUE(founds[0]);
+    EXPECT_TRUE(founds[1]);
+    EXPECT_EQ(values[0], values[1]);
+  }
+}
+
+TEST_F(RawRocksEngineTest, KvBatchWrite) {
+  const std::string &cf_name = kDefaultCf;
+  auto reader = RawRocksEngineTest::engine->Reader();
+  auto writer = RawRocksEngineTest::engine->Writer();
+
+  // empty batch
+  {
+    RawEngine::WriteBatch batch;
+    butil::Status ok = writer->KvBatchWrite(batch);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  // some key empty
+  {
+    RawEngine::WriteBatch batch;
+    batch.Put(cf_name, "batch_write_key1", "value1");
+    batch.Put(cf_name, "", "value2");
+    butil::Status ok = writer->KvBatchWrite(batch);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+
+    std::string value;
+    ok = reader->KvGet(cf_name, "batch_write_key1", value);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+  }
+
+  // ops apply in order
+  {
+    RawEngine::WriteBatch batch;
+    batch.Put(cf_name, "batch_write_key1", "value1");
+    batch.Put(cf_name, "batch_write_key2", "value2");
+    batch.Delete(cf_name, "batch_write_key1");
+    batch.Put(cf_name, "batch_write_key2", "value22");
+    batch.Put(cf_name, "batch_write_key3", "value3");
+    EXPECT_EQ(batch.Count(), 5);
+
+    butil::Status ok = writer->KvBatchWrite(batch);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::string value;
+    ok = reader->KvGet(cf_name, "batch_write_key1", value);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+    ok = reader->KvGet(cf_name, "batch_write_key2", value);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(value, "value22");
+    ok = reader->KvGet(cf_name, "batch_write_key3", value);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(value, "value3");
+  }
+
+  // clean up
+  {
+    RawEngine::WriteBatch batch;
+    batch.Delete(cf_name, "batch_write_key2");
+    batch.Delete(cf_name, "batch_write_key3");
+    butil::Status ok = writer->KvBatchWrite(batch);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+}
+
 #ifdef TEST_KV_BATCH_GET_SWITCH
 TEST_F(RawRocksEngineTest, KvBatchGet) {
   const std::string &cf_name = kDefaultCf;
@@ -1694,4 +1803,53 @@ TEST_F(RawRocksEngineTest, Iterator) {
 //   std::cout << "count after ingest: " << count << '\n';
 // }
 
+TEST(RocksSharedBlockCacheTest, Init) {
+  // Disable by default.
+  {
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kYamlConfigContent));
+
+    rocks::SharedBlockCache shared_block_cache;
+    EXPECT_TRUE(shared_block_cache.Init(config, "unit_test_disable"));
+    EXPECT_EQ(nullptr, shared_block_cache.GetCache());
+    EXPECT_EQ(nullptr, shared_block_cache.GetWriteBufferManager());
+  }
+
+  const std::string yaml_content = kYamlConfigContent +
+                                   "  block_cache:\n"
+                                   "    type: hyper_clock\n"
+                                   "    capacity: 67108864\n"
+                                   "  write_buffer_manager:\n"
+                                   "    buffer_size: 33554432\n"
+                                   "    cost_to_cache: true\n";
+  auto config = std::make_shared<YamlConfig>();
+  ASSERT_EQ(0, config->Load(yaml_content));
+
+  rocks::SharedBlockCache shared_block_cache;
+  EXPECT_TRUE(shared_block_cache.Init(config, "unit_test"));
+  ASSERT_NE(nullptr, shared_block_cache.GetCache());
+  EXPECT_EQ(67108864, shared_block_cache.GetCache()->GetCapacity());
+  ASSERT_NE(nullptr, shared_block_cache.GetWriteBufferManager());
+  EXPECT_EQ(33554432, shared_block_cache.GetWriteBufferManager()->buffer_size());
+  EXPECT_TRUE(shared_block_cache.GetWriteBufferManager()->cost_to_cache());
+
+  // Every column family wrap the same cache.
+  rocks::ColumnFamilyBlockCache default_cache(shared_block_cache.GetCache(), "unit_test", "default");
+  rocks::ColumnFamilyBlockCache meta_cache(shared_block_cache.GetCache(), "unit_test", "meta");
+  EXPECT_EQ(default_cache.GetCapacity(), meta_cache.GetCapacity());
+  EXPECT_EQ(nullptr, default_cache.Lookup("not_exist_key"));
+
+  // Bvar is scoped by metrics prefix, another engine in the same process expose its own.
+  rocks::SharedBlockCache other_shared_block_cache;
+  EXPECT_TRUE(other_shared_block_cache.Init(config, "unit_test_other"));
+  rocks::ColumnFamilyBlockCache other_default_cache(other_shared_block_cache.GetCache(), "unit_test_other", "default");
+
+  std::ostringstream oss;
+  EXPECT_EQ(0, bvar::Variable::describe_exposed("unit_test_block_cache_default_hit", oss));
+  EXPECT_EQ(0, bvar::Variable::describe_exposed("unit_test_other_block_cache_default_hit", oss));
+  EXPECT_EQ(0, bvar::Variable::describe_exposed("unit_test_block_cache_usage", oss));
+  EXPECT_EQ(0, bvar::Variable::describe_exposed("unit_test_other_block_cache_usage", oss));
+  EXPECT_EQ(0, bvar::Variable::describe_exposed("unit_test_other_memtable_usage", oss));
+}
+
 }  // namespace dingodb
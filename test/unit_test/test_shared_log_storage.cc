@@ -0,0 +1,224 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "log/shared_log_storage.h"
+
+const std::string kSharedLogPath = "./unit_test/shared_log";
+
+class SharedLogStorageTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { dingodb::Helper::CreateDirectories(kSharedLogPath); }
+  static void TearDownTestSuite() { dingodb::Helper::RemoveAllFileOrDirectory(kSharedLogPath); }
+
+  void SetUp() override {}
+  void TearDown() override {}
+
+ public:
+  static int AppendLogEntrys(std::shared_ptr<dingodb::SharedLogStorage> log_storage, int64_t begin_index,
+                             int64_t end_index, int64_t term = 1) {
+    std::vector<braft::LogEntry*> entries;
+    for (int64_t index = begin_index; index <= end_index; ++index) {
+      auto* log_entry = new braft::LogEntry();
+      log_entry->AddRef();
+      log_entry->type = braft::ENTRY_TYPE_DATA;
+      log_entry->id.term = term;
+      log_entry->id.index = index;
+      log_entry->data.append(fmt::format("region_{}_log_{}", log_storage->RegionId(), index));
+      entries.push_back(log_entry);
+    }
+
+    int count = log_storage->AppendEntries(entries, nullptr);
+    for (auto* log_entry : entries) {
+      log_entry->Release();
+    }
+
+    return count;
+  }
+};
+
+TEST_F(SharedLogStorageTest, AppendAndGet) {
+  std::string path = kSharedLogPath + "/append";
+  auto engine = std::make_shared<dingodb::SharedLogEngine>(path, 8 * 1024 * 1024);
+  ASSERT_TRUE(engine->Init());
+
+  auto log_storage1 = std::make_shared<dingodb::SharedLogStorage>(engine, 1001);
+  auto log_storage2 = std::make_shared<dingodb::SharedLogStorage>(engine, 1002);
+  ASSERT_EQ(0, log_storage1->Init(nullptr));
+  ASSERT_EQ(0, log_storage2->Init(nullptr));
+
+  EXPECT_EQ(100, AppendLogEntrys(log_storage1, 1, 100));
+  EXPECT_EQ(50, AppendLogEntrys(log_storage2, 1, 50, 2));
+
+  EXPECT_EQ(1, log_storage1->FirstLogIndex());
+  EXPECT_EQ(100, log_storage1->LastLogIndex());
+  EXPECT_EQ(50, log_storage2->LastLogIndex());
+  EXPECT_EQ(1, log_storage1->GetTerm(10));
+  EXPECT_EQ(2, log_storage2->GetTerm(10));
+  EXPECT_EQ(0, log_storage2->GetTerm(51));
+
+  auto* log_entry = log_storage2->GetEntry(20);
+  ASSERT_NE(nullptr, log_entry);
+  EXPECT_EQ(20, log_entry->id.index);
+  EXPECT_EQ("region_1002_log_20", log_entry->data.to_string());
+  log_entry->Release();
+
+  auto log_entrys = log_storage1->GetEntrys(91, INT64_MAX);
+  ASSERT_EQ(10, log_entrys.size());
+  EXPECT_EQ(91, log_entrys.front()->index);
+  EXPECT_EQ("region_1001_log_100", log_entrys.back()->data.to_string());
+
+  bool has = log_storage1->HasSpecificLog(0, INT64_MAX, [](const dingodb::LogEntry& log_entry) -> bool {
+    return log_entry.data.to_string() == "region_1001_log_66";
+  });
+  EXPECT_TRUE(has);
+
+  engine->Destroy();
+}
+
+TEST_F(SharedLogStorageTest, Truncate) {
+  std::string path = kSharedLogPath + "/truncate";
+  auto engine = std::make_shared<dingodb::SharedLogEngine>(path, 8 * 1024 * 1024);
+  ASSERT_TRUE(engine->Init());
+
+  auto log_storage = std::make_shared<dingodb::SharedLogStorage>(engine, 1001);
+  ASSERT_EQ(0, log_storage->Init(nullptr));
+  ASSERT_EQ(0, log_storage->Reset(1));
+  EXPECT_EQ(100, AppendLogEntrys(log_storage, 1, 100));
+
+  // Vector index still need the log, so it is kept.
+  ASSERT_EQ(0, log_storage->TruncatePrefix(30));
+  EXPECT_EQ(30, log_storage->FirstLogIndex());
+  EXPECT_EQ(1, log_storage->VectorIndexFirstLogIndex());
+  EXPECT_EQ(100, log_storage->GetEntrys(1, 100).size());
+
+  ASSERT_EQ(0, log_storage->TruncateVectorIndexPrefix(20));
+  EXPECT_EQ(20, log_storage->VectorIndexFirstLogIndex());
+  EXPECT_EQ(81, log_storage->GetEntrys(1, 100).size());
+
+  ASSERT_EQ(0, log_storage->TruncateVectorIndexPrefix(60));
+  EXPECT_EQ(71, log_storage->GetEntrys(1, 100).size());
+
+  ASSERT_EQ(0, log_storage->TruncateSuffix(80));
+  EXPECT_EQ(80, log_storage->LastLogIndex());
+  EXPECT_EQ(0, log_storage->GetTerm(81));
+  EXPECT_EQ(3, AppendLogEntrys(log_storage, 81, 83, 3));
+  EXPECT_EQ(3, log_storage->GetTerm(83));
+
+  ASSERT_EQ(0, log_storage->Reset(200));
+  EXPECT_EQ(200, log_storage->FirstLogIndex());
+  EXPECT_EQ(199, log_storage->LastLogIndex());
+  EXPECT_TRUE(log_storage->GetEntrys(1, INT64_MAX).empty());
+
+  engine->Destroy();
+}
+
+TEST_F(SharedLogStorageTest, Restart) {
+  std::string path = kSharedLogPath + "/restart";
+  {
+    auto engine = std::make_shared<dingodb::SharedLogEngine>(path, 8 * 1024 * 1024);
+    ASSERT_TRUE(engine->Init());
+
+    auto log_storage1 = std::make_shared<dingodb::SharedLogStorage>(engine, 1001);
+    auto log_storage2 = std::make_shared<dingodb::SharedLogStorage>(engine, 1002);
+    auto log_storage3 = std::make_shared<dingodb::SharedLogStorage>(engine, 1003);
+    ASSERT_EQ(0, log_storage1->Init(nullptr));
+    ASSERT_EQ(0, log_storage2->Init(nullptr));
+    ASSERT_EQ(0, log_storage3->Init(nullptr));
+
+    EXPECT_EQ(100, AppendLogEntrys(log_storage1, 1, 100));
+    EXPECT_EQ(100, AppendLogEntrys(log_storage2, 1, 100));
+    EXPECT_EQ(10, AppendLogEntrys(log_storage3, 1, 10));
+    ASSERT_EQ(0, log_storage1->TruncatePrefix(50));
+    ASSERT_EQ(0, log_storage2->TruncateSuffix(90));
+    ASSERT_TRUE(log_storage3->GcInstance(path).ok());
+
+    engine->Destroy();
+  }
+
+  auto engine = std::make_shared<dingodb::SharedLogEngine>(path, 8 * 1024 * 1024);
+  ASSERT_TRUE(engine->Init());
+  EXPECT_EQ(2, engine->RegionCount());
+
+  auto log_storage1 = std::make_shared<dingodb::SharedLogStorage>(engine, 1001);
+  auto log_storage2 = std::make_shared<dingodb::SharedLogStorage>(engine, 1002);
+  ASSERT_EQ(0, log_storage1->Init(nullptr));
+  ASSERT_EQ(0, log_storage2->Init(nullptr));
+
+  EXPECT_EQ(50, log_storage1->FirstLogIndex());
+  EXPECT_EQ(100, log_storage1->LastLogIndex());
+  EXPECT_EQ(1, log_storage2->FirstLogIndex());
+  EXPECT_EQ(90, log_storage2->LastLogIndex());
+
+  auto* log_entry = log_storage1->GetEntry(77);
+  ASSERT_NE(nullptr, log_entry);
+  EXPECT_EQ("region_1001_log_77", log_entry->data.to_string());
+  log_entry->Release();
+
+  engine->Destroy();
+}
+
+TEST_F(SharedLogStorageTest, Purge) {
+  std::string path = kSharedLogPath + "/purge";
+  // Small file size, make roll file frequently.
+  auto engine = std::make_shared<dingodb::SharedLogEngine>(path, 4 * 1024);
+  ASSERT_TRUE(engine->Init());
+
+  auto log_storage1 = std::make_shared<dingodb::SharedLogStorage>(engine, 1001);
+  auto log_storage2 = std::make_shared<dingodb::SharedLogStorage>(engine, 1002);
+  ASSERT_EQ(0, log_storage1->Init(nullptr));
+  ASSERT_EQ(0, log_storage2->Init(nullptr));
+
+  for (int64_t index = 1; index <= 1000; index += 10) {
+    EXPECT_EQ(10, AppendLogEntrys(log_storage1, index, index + 9));
+    EXPECT_EQ(10, AppendLogEntrys(log_storage2, index, index + 9));
+  }
+  size_t file_count = engine->FileCount();
+  EXPECT_GT(file_count, 2);
+
+  // Region 2 still reference the old file, so can't purge.
+  ASSERT_EQ(0, log_storage1->TruncatePrefix(1001));
+  engine->Purge();
+  EXPECT_EQ(file_count, engine->FileCount());
+
+  ASSERT_EQ(0, log_storage2->TruncatePrefix(990));
+  engine->Purge();
+  EXPECT_LT(engine->FileCount(), file_count);
+
+  EXPECT_EQ(1001, log_storage1->FirstLogIndex());
+  EXPECT_EQ(11, log_storage2->GetEntrys(990, INT64_MAX).size());
+
+  engine->Destroy();
+
+  // Recover from checkpoint and remaining files.
+  auto new_engine = std::make_shared<dingodb::SharedLogEngine>(path, 4 * 1024);
+  ASSERT_TRUE(new_engine->Init());
+  auto new_log_storage2 = std::make_shared<dingodb::SharedLogStorage>(new_engine, 1002);
+  ASSERT_EQ(0, new_log_storage2->Init(nullptr));
+  EXPECT_EQ(990, new_log_storage2->FirstLogIndex());
+  EXPECT_EQ(1000, new_log_storage2->LastLogIndex());
+  EXPECT_EQ(11, new_log_storage2->GetEntrys(990, INT64_MAX).size());
+
+  new_engine->Destroy();
+}
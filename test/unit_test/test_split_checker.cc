@@ -22,13 +22,17 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "butil/time.h"
 #include "common/helper.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "split/split_checker.h"
 
+DECLARE_bool(split_check_use_range_properties);
+
 namespace dingodb {  // NOLINT
 
 const std::string kRootPath = "./unit_test";
@@ -119,6 +123,9 @@ class SplitCheckerTest : public testing::Test {
     if (!engine->Init(config, kAllCFs)) {
       std::cout << "RocksRawEngine init failed" << '\n';
     }
+
+    // Exact split key by scan, range properties is tested separately.
+    FLAGS_split_check_use_range_properties = false;
   }
 
   static void TearDownTestSuite() {
@@ -308,4 +315,116 @@ TEST_F(SplitCheckerTest, KeysSplitKeys) {  // NOLINT
   writer->KvDeleteRange(kAllCFs, range);
 }
 
-}  // namespace dingodb
\ No newline at end of file
+TEST_F(SplitCheckerTest, RangeProperties) {  // NOLINT
+  auto writer = SplitCheckerTest::engine->Writer();
+  const std::vector<std::string> prefixs = {"pa", "pb", "pc", "pd", "pe", "pf", "pg", "ph", "pi", "pj"};
+  dingodb::pb::common::KeyValue kv;
+  for (int i = 0; i < (100 * 1000); ++i) {
+    int pos = i % prefixs.size();
+
+    kv.set_key(prefixs[pos] + GenRandomString(30));
+    kv.set_value(GenRandomString(256));
+    for (const auto& cf_name : kAllCFs) {
+      writer->KvPut(cf_name, kv);
+    }
+  }
+  for (const auto& cf_name : kAllCFs) {
+    SplitCheckerTest::engine->Flush(cf_name);
+  }
+
+  dingodb::pb::common::Range range;
+  range.set_start_key("pa");
+  range.set_end_key("pz");
+
+  RawEngine::RangeProperties properties;
+  auto status = SplitCheckerTest::engine->GetRangeProperties(kDefaultCf, range, properties);
+  EXPECT_TRUE(status.ok());
+  EXPECT_FALSE(properties.samples.empty());
+
+  int64_t keys = properties.memtable_keys;
+  for (const auto& sample : properties.samples) {
+    EXPECT_TRUE(sample.key >= range.start_key() && sample.key < range.end_key());
+    keys += sample.keys;
+  }
+  EXPECT_EQ(100 * 1000, keys);
+
+  FLAGS_split_check_use_range_properties = true;
+
+  uint32_t count = 0;
+  std::vector<std::string> raft_addrs;
+  auto region = BuildRegion(1001, "unit_test", raft_addrs, range.start_key(), range.end_key());
+  auto split_checker = std::make_shared<HalfSplitChecker>(SplitCheckerTest::engine, 16 * 1024 * 1024, 1024 * 1024);
+  auto split_key = split_checker->SplitKey(region, region->Range(), kAllCFs, count);
+  EXPECT_FALSE(split_key.empty());
+  EXPECT_EQ(100 * 1000 * kAllCFs.size(), count);
+
+  auto reader = SplitCheckerTest::engine->Reader();
+  int64_t left_count = 0;
+  reader->KvCount(kDefaultCf, range.start_key(), split_key, left_count);
+  int64_t right_count = 0;
+  reader->KvCount(kDefaultCf, split_key, range.end_key(), right_count);
+  std::cout << fmt::format("range properties split_key: {} sample_count: {} left_count: {} right_count: {}",
+                           split_key, properties.samples.size(), left_count, right_count)
+            << '\n';
+  // Precision is the sample distance.
+  EXPECT_TRUE(abs(static_cast<int>(left_count - right_count)) < 30000);
+
+  FLAGS_split_check_use_range_properties = false;
+
+  // Clean
+  writer->KvDeleteRange(kAllCFs, range);
+}
+
+// Compare split check latency of scan and range properties.
+TEST_F(SplitCheckerTest, SplitCheckLatency) {  // NOLINT
+  auto writer = SplitCheckerTest::engine->Writer();
+  const std::vector<std::string> prefixs = {"sa", "sb", "sc", "sd", "se", "sf", "sg", "sh", "si", "sj"};
+  dingodb::pb::common::KeyValue kv;
+  for (int i = 0; i < (100 * 1000); ++i) {
+    int pos = i % prefixs.size();
+
+    kv.set_key(prefixs[pos] + GenRandomString(30));
+    kv.set_value(GenRandomString(512));
+    for (const auto& cf_name : kAllCFs) {
+      writer->KvPut(cf_name, kv);
+    }
+  }
+  for (const auto& cf_name : kAllCFs) {
+    SplitCheckerTest::engine->Flush(cf_name);
+  }
+
+  std::vector<std::string> raft_addrs;
+  auto region = BuildRegion(1002, "unit_test", raft_addrs, "sa", "sz");
+  std::vector<std::shared_ptr<SplitChecker>> split_checkers = {
+      std::make_shared<HalfSplitChecker>(SplitCheckerTest::engine, 64 * 1024 * 1024, 1024 * 1024),
+      std::make_shared<SizeSplitChecker>(SplitCheckerTest::engine, 64 * 1024 * 1024, 0.5),
+      std::make_shared<KeysSplitChecker>(SplitCheckerTest::engine, 100 * 1000, 0.5)};
+
+  for (auto& split_checker : split_checkers) {
+    for (bool use_range_properties : {false, true}) {
+      FLAGS_split_check_use_range_properties = use_range_properties;
+
+      uint32_t count = 0;
+      butil::Timer timer;
+      timer.start();
+      auto split_key = split_checker->SplitKey(region, region->Range(), kAllCFs, count);
+      timer.stop();
+
+      std::cout << fmt::format("policy({}) range_properties({}) split_key({}) count({}) elapsed time({}us)",
+                               split_checker->GetPolicyName(), use_range_properties, Helper::StringToHex(split_key),
+                               count, timer.u_elapsed())
+                << '\n';
+      EXPECT_FALSE(split_key.empty());
+    }
+  }
+
+  FLAGS_split_check_use_range_properties = false;
+
+  // Clean
+  dingodb::pb::common::Range range;
+  range.set_start_key("sa");
+  range.set_end_key("sz");
+  writer->KvDeleteRange(kAllCFs, range);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,306 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "common/context.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "event/event.h"
+#include "event/store_state_machine_event.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/raft.pb.h"
+#include "proto/store.pb.h"
+#include "raft/state_machine.h"
+#include "raft/store_state_machine.h"
+
+DECLARE_bool(enable_raft_apply_log_batch);
+DECLARE_int32(raft_apply_log_batch_max_count);
+
+namespace dingodb {
+
+static const std::string kDefaultCf = "default";
+
+const std::string kRootPath = "./unit_test_store_state_machine";
+const std::string kStorePath = kRootPath + "/db";
+
+const std::string kYamlConfigContent =
+    "store:\n"
+    "  path: " +
+    kStorePath + "\n";
+
+// Record the logs applied by handler, and whether the key is visible in engine at that time.
+class RecordApplyListener : public EventListener {
+ public:
+  RecordApplyListener(std::shared_ptr<RawEngine> engine, std::string check_key)
+      : engine_(engine), check_key_(std::move(check_key)) {}
+  ~RecordApplyListener() override = default;
+
+  EventType GetType() override { return EventType::kSmApply; }
+  int OnEvent(std::shared_ptr<Event> event) override {
+    auto apply_event = std::dynamic_pointer_cast<SmApplyEvent>(event);
+    std::string value;
+    log_ids.push_back(apply_event->log_id);
+    key_visibles.push_back(engine_->Reader()->KvGet(kDefaultCf, check_key_, value).ok());
+    return 0;
+  }
+
+  std::vector<int64_t> log_ids;
+  std::vector<bool> key_visibles;
+
+ private:
+  std::shared_ptr<RawEngine> engine_;
+  std::string check_key_;
+};
+
+// Iterate the logs like braft::Iterator in on_apply, dones[i] is the closure of entries[i].
+class TestLogIterator : public StoreStateMachine::LogIterator {
+ public:
+  TestLogIterator(const std::vector<pb::raft::LogEntry>& entries, const std::vector<braft::Closure*>& dones)
+      : entries_(entries), dones_(dones) {
+    ResetData();
+  }
+  ~TestLogIterator() override = default;
+
+  bool Valid() const override { return pos_ < entries_.size(); }
+  void Next() override {
+    ++pos_;
+    ResetData();
+  }
+  int64_t Index() const override { return entries_[pos_].index(); }
+  int64_t Term() const override { return entries_[pos_].term(); }
+  const butil::IOBuf& Data() const override { return data_; }
+  braft::Closure* Done() const override { return dones_[pos_]; }
+
+ private:
+  void ResetData() {
+    data_.clear();
+    if (Valid()) {
+      data_.append(entries_[pos_].data());
+    }
+  }
+
+  const std::vector<pb::raft::LogEntry>& entries_;
+  const std::vector<braft::Closure*>& dones_;
+  size_t pos_{0};
+  butil::IOBuf data_;
+};
+
+class StoreStateMachineTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kStorePath);
+
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(config->Load(kYamlConfigContent), 0);
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, {kDefaultCf}));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  void SetUp() override {
+    FLAGS_enable_raft_apply_log_batch = true;
+
+    pb::common::RegionDefinition definition;
+    definition.set_id(kRegionId);
+    definition.mutable_epoch()->set_conf_version(1);
+    definition.mutable_epoch()->set_version(1);
+    definition.mutable_range()->set_start_key("a");
+    definition.mutable_range()->set_end_key("z");
+    region = store::Region::New(definition);
+  }
+
+  void TearDown() override {
+    FLAGS_enable_raft_apply_log_batch = false;
+    FLAGS_raft_apply_log_batch_max_count = 256;
+  }
+
+  std::shared_ptr<StoreStateMachine> NewStateMachine(std::shared_ptr<EventListener> listener) {
+    auto listeners = std::make_shared<EventListenerCollection>();
+    if (listener != nullptr) {
+      listeners->Register(listener);
+    }
+    return std::make_shared<StoreStateMachine>(engine, region, store::RaftMeta::New(kRegionId), nullptr, listeners);
+  }
+
+  std::shared_ptr<pb::raft::RaftCmdRequest> NewRaftCmd() {
+    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    raft_cmd->mutable_header()->set_region_id(kRegionId);
+    *raft_cmd->mutable_header()->mutable_epoch() = region->Epoch();
+    return raft_cmd;
+  }
+
+  std::shared_ptr<pb::raft::RaftCmdRequest> NewPutCmd(const std::string& key, const std::string& value) {
+    auto raft_cmd = NewRaftCmd();
+    auto* request = raft_cmd->add_requests();
+    request->set_cmd_type(pb::raft::CmdType::PUT);
+    request->mutable_put()->set_cf_name(kDefaultCf);
+    auto* kv = request->mutable_put()->add_kvs();
+    kv->set_key(key);
+    kv->set_value(value);
+    return raft_cmd;
+  }
+
+  std::shared_ptr<pb::raft::RaftCmdRequest> NewDeleteBatchCmd(const std::vector<std::string>& keys) {
+    auto raft_cmd = NewRaftCmd();
+    auto* request = raft_cmd->add_requests();
+    request->set_cmd_type(pb::raft::CmdType::DELETEBATCH);
+    request->mutable_delete_batch()->set_cf_name(kDefaultCf);
+    for (const auto& key : keys) {
+      request->mutable_delete_batch()->add_keys(key);
+    }
+    return raft_cmd;
+  }
+
+  // Not batchable, it's applied by the handler.
+  std::shared_ptr<pb::raft::RaftCmdRequest> NewDeleteRangeCmd(const std::string& start_key,
+                                                              const std::string& end_key) {
+    auto raft_cmd = NewRaftCmd();
+    auto* request = raft_cmd->add_requests();
+    request->set_cmd_type(pb::raft::CmdType::DELETERANGE);
+    request->mutable_delete_range()->set_cf_name(kDefaultCf);
+    auto* range = request->mutable_delete_range()->add_ranges();
+    range->set_start_key(start_key);
+    range->set_end_key(end_key);
+    return raft_cmd;
+  }
+
+  // Log index start from 1, keep it less than kSaveAppliedIndexStep, the raft meta is not persisted in test.
+  void AddLog(std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd, std::shared_ptr<Context> ctx) {
+    pb::raft::LogEntry entry;
+    entry.set_term(1);
+    entry.set_index(entries.size() + 1);
+    entry.set_data(raft_cmd->SerializeAsString());
+    entries.push_back(entry);
+    dones.push_back(new BaseClosure(ctx, raft_cmd));
+  }
+
+  // Apply the added logs through the same path as on_apply.
+  void ApplyLogs(std::shared_ptr<StoreStateMachine> state_machine) {
+    TestLogIterator iter(entries, dones);
+    state_machine->ApplyLogs(iter);
+  }
+
+  static bool IsKeyExist(const std::string& key) {
+    std::string value;
+    return engine->Reader()->KvGet(kDefaultCf, key, value).ok();
+  }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+
+  static constexpr int64_t kRegionId = 1001;
+  store::RegionPtr region;
+  std::vector<pb::raft::LogEntry> entries;
+  std::vector<braft::Closure*> dones;
+};
+
+std::shared_ptr<RocksRawEngine> StoreStateMachineTest::engine = nullptr;
+
+TEST_F(StoreStateMachineTest, FlushBeforeNotBatchableLog) {
+  auto listener = std::make_shared<RecordApplyListener>(engine, "a002");
+  auto state_machine = NewStateMachine(listener);
+
+  AddLog(NewPutCmd("a001", "v1"), std::make_shared<Context>());
+  AddLog(NewPutCmd("a002", "v2"), std::make_shared<Context>());
+  AddLog(NewDeleteRangeCmd("a100", "a200"), std::make_shared<Context>());
+  AddLog(NewPutCmd("a003", "v3"), std::make_shared<Context>());
+  ApplyLogs(state_machine);
+
+  // The batched puts are written before the delete range log is handled.
+  ASSERT_EQ(listener->log_ids.size(), 1);
+  EXPECT_EQ(listener->log_ids[0], 3);
+  EXPECT_TRUE(listener->key_visibles[0]);
+
+  EXPECT_TRUE(IsKeyExist("a001"));
+  EXPECT_TRUE(IsKeyExist("a003"));
+  EXPECT_EQ(state_machine->GetAppliedIndex(), 4);
+}
+
+TEST_F(StoreStateMachineTest, EpochNotMatchInBatch) {
+  auto state_machine = NewStateMachine(nullptr);
+
+  std::vector<std::shared_ptr<Context>> ctxs;
+  for (int i = 0; i < 3; ++i) {
+    ctxs.push_back(std::make_shared<Context>());
+  }
+
+  AddLog(NewPutCmd("b001", "v1"), ctxs[0]);
+  auto stale_cmd = NewPutCmd("b002", "v2");
+  stale_cmd->mutable_header()->mutable_epoch()->set_version(0);
+  AddLog(stale_cmd, ctxs[1]);
+  AddLog(NewPutCmd("b003", "v3"), ctxs[2]);
+  ApplyLogs(state_machine);
+
+  EXPECT_TRUE(ctxs[0]->Status().ok());
+  EXPECT_EQ(ctxs[1]->Status().error_code(), pb::error::EREGION_VERSION);
+  EXPECT_TRUE(ctxs[2]->Status().ok());
+
+  EXPECT_TRUE(IsKeyExist("b001"));
+  EXPECT_FALSE(IsKeyExist("b002"));
+  EXPECT_TRUE(IsKeyExist("b003"));
+  EXPECT_EQ(state_machine->GetAppliedIndex(), 3);
+}
+
+TEST_F(StoreStateMachineTest, AppliedIndexAdvance) {
+  FLAGS_raft_apply_log_batch_max_count = 2;
+  auto state_machine = NewStateMachine(nullptr);
+
+  for (int i = 1; i <= 5; ++i) {
+    AddLog(NewPutCmd(fmt::format("c00{}", i), "v1"), std::make_shared<Context>());
+  }
+  ApplyLogs(state_machine);
+  EXPECT_EQ(state_machine->GetAppliedIndex(), 5);
+
+  // The applied logs are skipped.
+  entries.clear();
+  dones.clear();
+  for (int i = 1; i <= 5; ++i) {
+    AddLog(NewPutCmd(fmt::format("c00{}", i), "v2"), std::make_shared<Context>());
+  }
+  auto delete_ctx = std::make_shared<Context>();
+  pb::store::KvBatchDeleteResponse response;
+  delete_ctx->SetResponse(&response);
+  AddLog(NewDeleteBatchCmd({"c001", "c009"}), delete_ctx);
+  ApplyLogs(state_machine);
+  EXPECT_EQ(state_machine->GetAppliedIndex(), 6);
+
+  std::string value;
+  ASSERT_TRUE(engine->Reader()->KvGet(kDefaultCf, "c002", value).ok());
+  EXPECT_EQ(value, "v1");
+  EXPECT_FALSE(IsKeyExist("c001"));
+
+  ASSERT_EQ(response.key_states_size(), 2);
+  EXPECT_TRUE(response.key_states(0));
+  EXPECT_FALSE(response.key_states(1));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,285 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "butil/time.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/synchronization.h"
+#include "config/yaml_config.h"
+#include "engine/raw_engine.h"
+#include "engine/rocks_raw_engine.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+DECLARE_bool(txn_batch_get_sorted);
+
+DEFINE_int32(txn_batch_get_bench_key_count, 100 * 1000, "key count of txn batch get latency benchmark");
+
+static const std::vector<std::string> kAllCFs = {Constant::kTxnWriteCF, Constant::kTxnDataCF, Constant::kTxnLockCF,
+                                                 Constant::kStoreDataCF};
+
+static const std::string kRootPath = "./unit_test_txn_engine_helper";  // NOLINT
+static const std::string kLogPath = kRootPath + "/log";                // NOLINT
+static const std::string kStorePath = kRootPath + "/db";               // NOLINT
+
+static const std::string kYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kLogPath +
+    "\n"
+    "store:\n"
+    "  path: " +
+    kStorePath + "\n";
+
+class TxnEngineHelperTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kStorePath);
+
+    config = std::make_shared<YamlConfig>();
+    if (config->Load(kYamlConfigContent) != 0) {
+      std::cout << "Load config failed" << '\n';
+      return;
+    }
+
+    engine = std::make_shared<RocksRawEngine>();
+    if (!engine->Init(config, kAllCFs)) {
+      std::cout << "RocksRawEngine init failed" << '\n';
+    }
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  static void PutWrite(const std::string& key, int64_t start_ts, int64_t commit_ts, pb::store::Op op,
+                       const std::string& value) {
+    auto writer = engine->Writer();
+
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(op);
+    if (op == pb::store::Op::Put) {
+      if (value.size() <= 16) {
+        write_info.set_short_value(value);
+      } else {
+        pb::common::KeyValue data_kv;
+        data_kv.set_key(Helper::EncodeTxnKey(key, start_ts));
+        data_kv.set_value(value);
+        writer->KvPut(Constant::kTxnDataCF, data_kv);
+      }
+    }
+
+    pb::common::KeyValue write_kv;
+    write_kv.set_key(Helper::EncodeTxnKey(key, commit_ts));
+    write_kv.set_value(write_info.SerializeAsString());
+    writer->KvPut(Constant::kTxnWriteCF, write_kv);
+  }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+  static std::shared_ptr<Config> config;
+};
+
+std::shared_ptr<RocksRawEngine> TxnEngineHelperTest::engine = nullptr;
+std::shared_ptr<Config> TxnEngineHelperTest::config = nullptr;
+
+TEST_F(TxnEngineHelperTest, BatchGet) {
+  PutWrite("tb_key1", 10, 11, pb::store::Op::Put, "value1");
+  PutWrite("tb_key1", 20, 21, pb::store::Op::Put, "value1_new");
+  PutWrite("tb_key2", 10, 11, pb::store::Op::Put, std::string(64, 'a'));
+  PutWrite("tb_key2", 12, 12, pb::store::Op::Rollback, "");
+  PutWrite("tb_key3", 10, 11, pb::store::Op::Put, "value3");
+  PutWrite("tb_key3", 12, 13, pb::store::Op::Delete, "");
+
+  // Unsorted and duplicate keys, result is aligned with keys.
+  std::vector<std::string> keys = {"tb_key3", "tb_key1", "tb_key0", "tb_key2", "tb_key1"};
+
+  bool old_sorted = FLAGS_txn_batch_get_sorted;
+  DEFER(FLAGS_txn_batch_get_sorted = old_sorted);
+
+  for (bool sorted : {true, false}) {
+    FLAGS_txn_batch_get_sorted = sorted;
+
+    std::vector<pb::common::KeyValue> kvs;
+    pb::store::TxnResultInfo txn_result_info;
+    auto status =
+        TxnEngineHelper::BatchGet(engine, pb::store::SnapshotIsolation, 15, keys, kvs, txn_result_info);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    ASSERT_EQ(keys.size(), kvs.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      EXPECT_EQ(keys[i], kvs[i].key());
+    }
+    EXPECT_EQ("", kvs[0].value());
+    EXPECT_EQ("value1", kvs[1].value());
+    EXPECT_EQ("", kvs[2].value());
+    EXPECT_EQ(std::string(64, 'a'), kvs[3].value());
+    EXPECT_EQ("value1", kvs[4].value());
+
+    kvs.clear();
+    status = TxnEngineHelper::BatchGet(engine, pb::store::ReadCommitted, 15, keys, kvs, txn_result_info);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    EXPECT_EQ("value1_new", kvs[1].value());
+    EXPECT_EQ("value1_new", kvs[4].value());
+  }
+}
+
+// Keys with many versions and values in data cf, sorted pass must return the same result as seek every key.
+TEST_F(TxnEngineHelperTest, BatchGetSortedSameAsUnsorted) {
+  const int kKeyCount = 1000;
+
+  ON_SCOPE_EXIT([&]() {
+    pb::common::Range range;
+    range.set_start_key(Helper::EncodeTxnKey(std::string("ts_key"), Constant::kMaxVer));
+    range.set_end_key(Helper::EncodeTxnKey(std::string("ts_kez"), Constant::kMaxVer));
+    engine->Writer()->KvDeleteRange(kAllCFs, range);
+  });
+
+  std::mt19937 rng(0);
+  for (int i = 0; i < kKeyCount; i += 2) {
+    std::string key = fmt::format("ts_key{:06}", i);
+    int version_count = rng() % 20;
+    for (int j = 0; j < version_count; ++j) {
+      auto op = (rng() % 5 == 0) ? pb::store::Op::Delete : pb::store::Op::Put;
+      PutWrite(key, 100 + j * 10, 101 + j * 10, op, rng() % 2 == 0 ? "short" : std::string(64, 'a' + j));
+    }
+  }
+
+  std::vector<std::string> keys;
+  for (int i = 0; i < kKeyCount; ++i) {
+    keys.push_back(fmt::format("ts_key{:06}", rng() % kKeyCount));
+  }
+
+  bool old_sorted = FLAGS_txn_batch_get_sorted;
+  DEFER(FLAGS_txn_batch_get_sorted = old_sorted);
+
+  for (int64_t start_ts : {50, 125, 155, 1000}) {
+    std::vector<pb::common::KeyValue> sorted_kvs;
+    std::vector<pb::common::KeyValue> unsorted_kvs;
+    pb::store::TxnResultInfo txn_result_info;
+
+    FLAGS_txn_batch_get_sorted = true;
+    auto status =
+        TxnEngineHelper::BatchGet(engine, pb::store::SnapshotIsolation, start_ts, keys, sorted_kvs, txn_result_info);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+
+    FLAGS_txn_batch_get_sorted = false;
+    status =
+        TxnEngineHelper::BatchGet(engine, pb::store::SnapshotIsolation, start_ts, keys, unsorted_kvs, txn_result_info);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+
+    ASSERT_EQ(keys.size(), sorted_kvs.size());
+    ASSERT_EQ(keys.size(), unsorted_kvs.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      EXPECT_EQ(keys[i], sorted_kvs[i].key());
+      EXPECT_EQ(unsorted_kvs[i].key(), sorted_kvs[i].key());
+      EXPECT_EQ(unsorted_kvs[i].value(), sorted_kvs[i].value())
+          << fmt::format("start_ts: {} key: {}", start_ts, keys[i]);
+    }
+  }
+}
+
+// Compare per key cost of batch get 1k keys with and without sorted pass.
+// It's a benchmark, run it with:
+//   --gtest_also_run_disabled_tests --gtest_filter=*BatchGetLatency --txn_batch_get_bench_key_count=1000000
+TEST_F(TxnEngineHelperTest, DISABLED_BatchGetLatency) {  // NOLINT
+  const int kKeyCount = FLAGS_txn_batch_get_bench_key_count;
+  const int kBatchSize = 1000;
+  const int kRound = 20;
+  ASSERT_GT(kKeyCount, kBatchSize * 2);
+
+  ON_SCOPE_EXIT([&]() {
+    pb::common::Range range;
+    range.set_start_key(Helper::EncodeTxnKey(std::string("tl_key"), Constant::kMaxVer));
+    range.set_end_key(Helper::EncodeTxnKey(std::string("tl_kez"), Constant::kMaxVer));
+    engine->Writer()->KvDeleteRange(kAllCFs, range);
+  });
+
+  for (int i = 0; i < kKeyCount; ++i) {
+    std::string key = fmt::format("tl_key{:08}", i);
+    // Some keys have many versions.
+    int version_count = (i % 10 == 0) ? 8 : 1;
+    for (int j = 0; j < version_count; ++j) {
+      PutWrite(key, 100 + j * 10, 101 + j * 10, pb::store::Op::Put, i % 2 == 0 ? "short" : std::string(64, 'v'));
+    }
+  }
+  for (const auto& cf_name : kAllCFs) {
+    engine->Flush(cf_name);
+  }
+
+  std::mt19937 rng(0);
+  std::vector<std::vector<std::string>> batches;
+  for (int r = 0; r < kRound; ++r) {
+    // Dense range keys in random order, like secondary index lookup.
+    int start = rng() % (kKeyCount - kBatchSize * 2);
+    std::vector<std::string> keys;
+    for (int i = 0; i < kBatchSize; ++i) {
+      keys.push_back(fmt::format("tl_key{:08}", start + i * 2));
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    batches.push_back(std::move(keys));
+  }
+
+  bool old_sorted = FLAGS_txn_batch_get_sorted;
+  DEFER(FLAGS_txn_batch_get_sorted = old_sorted);
+
+  for (bool sorted : {false, true}) {
+    FLAGS_txn_batch_get_sorted = sorted;
+
+    butil::Timer timer;
+    timer.start();
+    for (const auto& keys : batches) {
+      std::vector<pb::common::KeyValue> kvs;
+      pb::store::TxnResultInfo txn_result_info;
+      auto status =
+          TxnEngineHelper::BatchGet(engine, pb::store::SnapshotIsolation, 1000, keys, kvs, txn_result_info);
+      ASSERT_TRUE(status.ok()) << status.error_str();
+      ASSERT_EQ(keys.size(), kvs.size());
+      EXPECT_FALSE(kvs[0].value().empty());
+    }
+    timer.stop();
+
+    std::cout << fmt::format("sorted({}) key_count({}) batch_size({}) round({}) elapsed time({}us) per key({}ns)",
+                             sorted, kKeyCount, kBatchSize, kRound, timer.u_elapsed(),
+                             timer.n_elapsed() / (kBatchSize * kRound))
+              << '\n';
+  }
+}
+
+}  // namespace dingodb
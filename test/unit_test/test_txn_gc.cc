@@ -38,8 +38,10 @@
 #include "config/config.h"
 #include "config/yaml_config.h"
 #include "engine/raw_engine.h"
+#include "engine/rocks_gc_compaction_filter.h"
 #include "engine/rocks_raw_engine.h"
 #include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/store.pb.h"
 #include "proto/store_internal.pb.h"
@@ -1822,4 +1824,68 @@ TEST_F(TxnGcTest, DoGcSpanLock) {
   DeleteRange();
 }
 
+static std::string GenWriteInfo(pb::store::Op op, int64_t start_ts, const std::string &short_value) {
+  pb::store::WriteInfo write_info;
+  write_info.set_op(op);
+  write_info.set_start_ts(start_ts);
+  write_info.set_short_value(short_value);
+  return write_info.SerializeAsString();
+}
+
+TEST(TxnGcCompactionFilterTest, Filter) {
+  int64_t safe_point_ts = 100;
+  rocks::TxnWriteGcCompactionFilter filter(safe_point_ts, std::weak_ptr<rocksdb::DB>(), nullptr);
+
+  struct Version {
+    std::string key;
+    int64_t commit_ts;
+    pb::store::Op op;
+    bool expect_filter;
+  };
+
+  // Versions is ordered like write column family, key asc and commit_ts desc.
+  std::vector<Version> versions = {
+      // newer version than safe point is kept, the newest version <= safe point is kept.
+      {"key1", 120, pb::store::Put, false},
+      {"key1", 90, pb::store::Put, false},
+      {"key1", 80, pb::store::Rollback, true},
+      {"key1", 70, pb::store::Put, true},
+      // delete tombstone is kept for raft gc, the version under it is dropped.
+      {"key2", 90, pb::store::Delete, false},
+      {"key2", 80, pb::store::Put, true},
+      {"key2", 70, pb::store::Delete, true},
+      // only newer version than safe point.
+      {"key3", 150, pb::store::Put, false},
+      {"key3", 110, pb::store::Delete, false},
+  };
+
+  for (const auto &version : versions) {
+    std::string write_key = Helper::EncodeTxnKey(version.key, version.commit_ts);
+    std::string write_value = GenWriteInfo(version.op, version.commit_ts - 1, "value");
+    std::string new_value;
+    bool value_changed = false;
+    bool is_filter = filter.Filter(0, write_key, write_value, &new_value, &value_changed);
+    EXPECT_EQ(version.expect_filter, is_filter) << fmt::format("key: {} commit_ts: {}", version.key,
+                                                                version.commit_ts);
+  }
+}
+
+TEST(TxnGcCompactionFilterTest, KeepVersionIfDeleteDataFailed) {
+  int64_t safe_point_ts = 100;
+  // No data column family, delete data value always fails.
+  rocks::TxnWriteGcCompactionFilter filter(safe_point_ts, std::weak_ptr<rocksdb::DB>(), nullptr);
+
+  std::string new_value;
+  bool value_changed = false;
+  // The newest version <= safe point is kept.
+  EXPECT_FALSE(filter.Filter(0, Helper::EncodeTxnKey("key1", 90), GenWriteInfo(pb::store::Put, 89, ""), &new_value,
+                             &value_changed));
+  // The value is in data column family, the write record is kept because the data value is not deleted.
+  EXPECT_FALSE(filter.Filter(0, Helper::EncodeTxnKey("key1", 70), GenWriteInfo(pb::store::Put, 69, ""), &new_value,
+                             &value_changed));
+  // Short value has no data column family value, it's dropped.
+  EXPECT_TRUE(filter.Filter(0, Helper::EncodeTxnKey("key1", 60), GenWriteInfo(pb::store::Put, 59, "value"),
+                            &new_value, &value_changed));
+}
+
 }  // namespace dingodb
@@ -0,0 +1,359 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "butil/time.h"
+#include "common/constant.h"
+#include "engine/mem_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_distance.h"
+#include "vector/vector_index_bruteforce.h"
+#include "vector/vector_index_flat.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_index_bruteforce_batch_count);
+
+static const char kPrefix = 'r';
+static const int64_t kPartitionId = 1;
+
+class VectorIndexBruteforceTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    engine = std::make_shared<MemEngine>();
+    ASSERT_TRUE(engine->Init(nullptr, {Constant::kVectorDataCF}));
+
+    std::string start_key;
+    std::string end_key;
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, 0, start_key);
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, INT64_MAX, end_key);
+    range.set_start_key(start_key);
+    range.set_end_key(end_key);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> distrib(-1.0, 1.0);
+
+    auto writer = engine->Writer();
+    for (int64_t id = 1; id <= kDataCount; ++id) {
+      auto& vector_with_id = vector_with_ids.emplace_back();
+      vector_with_id.set_id(id);
+      vector_with_id.mutable_vector()->set_dimension(kDimension);
+      vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      for (int i = 0; i < kDimension; ++i) {
+        vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+      }
+
+      pb::common::KeyValue kv;
+      VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, id, *kv.mutable_key());
+      kv.set_value(vector_with_id.vector().SerializeAsString());
+      ASSERT_TRUE(writer->KvPut(Constant::kVectorDataCF, kv).ok());
+    }
+
+    for (int i = 0; i < kQueryCount; ++i) {
+      auto& query = queries.emplace_back();
+      for (int j = 0; j < kDimension; ++j) {
+        query.mutable_vector()->add_float_values(distrib(rng));
+      }
+    }
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine = nullptr;
+    vector_with_ids.clear();
+    queries.clear();
+  }
+
+  // Same search with faiss flat index, the result of brute force should be same.
+  static std::shared_ptr<VectorIndexFlat> NewFlatIndex(pb::common::MetricType metric_type) {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    index_parameter.mutable_flat_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
+
+    auto flat_index = std::make_shared<VectorIndexFlat>(1, index_parameter, pb::common::RegionEpoch(), range);
+    EXPECT_TRUE(flat_index->Add(vector_with_ids).ok());
+    return flat_index;
+  }
+
+  static constexpr int kDimension = 67;
+  static constexpr int kDataCount = 3000;
+  static constexpr int kQueryCount = 4;
+
+  static std::shared_ptr<MemEngine> engine;
+  static pb::common::Range range;
+  static std::vector<pb::common::VectorWithId> vector_with_ids;
+  static std::vector<pb::common::VectorWithId> queries;
+};
+
+std::shared_ptr<MemEngine> VectorIndexBruteforceTest::engine = nullptr;
+pb::common::Range VectorIndexBruteforceTest::range;
+std::vector<pb::common::VectorWithId> VectorIndexBruteforceTest::vector_with_ids;
+std::vector<pb::common::VectorWithId> VectorIndexBruteforceTest::queries;
+
+TEST_F(VectorIndexBruteforceTest, DistanceKernel) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distrib(-1.0, 1.0);
+
+  auto origin_level = VectorDistance::GetSimdLevel();
+  std::cout << "simd level: " << VectorDistance::GetSimdLevelName(origin_level) << '\n';
+
+  // Cover every tail length of avx2 and avx512.
+  for (int d = 1; d <= 70; ++d) {
+    std::vector<float> x(d);
+    std::vector<float> y(d);
+    for (int i = 0; i < d; ++i) {
+      x[i] = distrib(rng);
+      y[i] = distrib(rng);
+    }
+
+    float l2 = VectorDistance::L2SqrScalar(x.data(), y.data(), d);
+    float ip = VectorDistance::InnerProductScalar(x.data(), y.data(), d);
+    for (auto level : {VectorDistance::SimdLevel::kScalar, VectorDistance::SimdLevel::kAvx2,
+                       VectorDistance::SimdLevel::kAvx512}) {
+      if (!VectorDistance::SetSimdLevel(level)) {
+        continue;
+      }
+      EXPECT_NEAR(l2, VectorDistance::L2Sqr(x.data(), y.data(), d), 1e-3) << "dimension: " << d;
+      EXPECT_NEAR(ip, VectorDistance::InnerProduct(x.data(), y.data(), d), 1e-3) << "dimension: " << d;
+    }
+  }
+
+  ASSERT_TRUE(VectorDistance::SetSimdLevel(origin_level));
+}
+
+TEST_F(VectorIndexBruteforceTest, DecodeFloatVector) {
+  std::vector<float> buffer(kDimension + 1);
+  std::string value = vector_with_ids[0].vector().SerializeAsString();
+
+  ASSERT_TRUE(VectorIndexBruteforce::DecodeFloatVector(value, kDimension, buffer.data()).ok());
+  for (int i = 0; i < kDimension; ++i) {
+    EXPECT_EQ(vector_with_ids[0].vector().float_values(i), buffer[i]);
+  }
+
+  EXPECT_EQ(pb::error::EVECTOR_INVALID,
+            VectorIndexBruteforce::DecodeFloatVector(value, kDimension + 1, buffer.data()).error_code());
+  EXPECT_EQ(pb::error::EVECTOR_INVALID,
+            VectorIndexBruteforce::DecodeFloatVector(value, kDimension - 1, buffer.data()).error_code());
+}
+
+TEST_F(VectorIndexBruteforceTest, ScanSearch) {
+  const int topk = 10;
+  auto reader = engine->Reader();
+
+  for (auto metric_type : {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT,
+                           pb::common::MetricType::METRIC_TYPE_COSINE}) {
+    std::vector<pb::index::VectorWithDistanceResult> expect_results;
+    auto flat_index = NewFlatIndex(metric_type);
+    ASSERT_TRUE(flat_index->Search(queries, topk, {}, false, {}, expect_results).ok());
+
+    // Block size not divide data count.
+    for (int64_t batch_count : {7, 2048}) {
+      FLAGS_vector_index_bruteforce_batch_count = batch_count;
+
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status =
+          VectorIndexBruteforce::ScanSearch(reader, range, metric_type, kDimension, queries, topk, {}, results);
+      ASSERT_TRUE(status.ok()) << status.error_str();
+      ASSERT_EQ(kQueryCount, results.size());
+
+      for (int i = 0; i < kQueryCount; ++i) {
+        ASSERT_EQ(topk, results[i].vector_with_distances_size());
+        for (int j = 0; j < topk; ++j) {
+          const auto& expect = expect_results[i].vector_with_distances(j);
+          const auto& actual = results[i].vector_with_distances(j);
+          EXPECT_EQ(expect.vector_with_id().id(), actual.vector_with_id().id());
+          EXPECT_NEAR(expect.distance(), actual.distance(), 1e-3);
+          EXPECT_EQ(metric_type, actual.metric_type());
+        }
+      }
+    }
+  }
+
+  FLAGS_vector_index_bruteforce_batch_count = 2048;
+
+  // Filter is applied before distance compute.
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  filters.push_back(std::make_shared<VectorIndex::RangeFilterFunctor>(100, 200));
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(VectorIndexBruteforce::ScanSearch(reader, range, pb::common::MetricType::METRIC_TYPE_L2, kDimension,
+                                                queries, 200, filters, results)
+                  .ok());
+  for (const auto& result : results) {
+    EXPECT_EQ(100, result.vector_with_distances_size());
+    for (const auto& vector_with_distance : result.vector_with_distances()) {
+      EXPECT_GE(vector_with_distance.vector_with_id().id(), 100);
+      EXPECT_LT(vector_with_distance.vector_with_id().id(), 200);
+    }
+  }
+
+  // Dimension not match.
+  results.clear();
+  EXPECT_EQ(pb::error::EVECTOR_INVALID,
+            VectorIndexBruteforce::ScanSearch(reader, range, pb::common::MetricType::METRIC_TYPE_L2, kDimension + 1,
+                                              queries, topk, {}, results)
+                .error_code());
+}
+
+TEST_F(VectorIndexBruteforceTest, ScanRangeSearch) {
+  auto reader = engine->Reader();
+
+  for (auto metric_type : {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT,
+                           pb::common::MetricType::METRIC_TYPE_COSINE}) {
+    // About 5%~10% of data in radius, less than range search result limit.
+    float radius = 36.0F;
+    if (metric_type == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
+      radius = -3.0F;
+    } else if (metric_type == pb::common::MetricType::METRIC_TYPE_COSINE) {
+      radius = 0.8F;
+    }
+
+    std::vector<pb::index::VectorWithDistanceResult> expect_results;
+    auto flat_index = NewFlatIndex(metric_type);
+    ASSERT_TRUE(flat_index->RangeSearch(queries, radius, {}, false, {}, expect_results).ok());
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status =
+        VectorIndexBruteforce::ScanRangeSearch(reader, range, metric_type, kDimension, queries, radius, {}, results);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    ASSERT_EQ(kQueryCount, results.size());
+
+    for (int i = 0; i < kQueryCount; ++i) {
+      std::set<int64_t> expect_ids;
+      for (const auto& vector_with_distance : expect_results[i].vector_with_distances()) {
+        expect_ids.insert(vector_with_distance.vector_with_id().id());
+      }
+
+      std::set<int64_t> actual_ids;
+      for (const auto& vector_with_distance : results[i].vector_with_distances()) {
+        EXPECT_LT(vector_with_distance.distance(), radius);
+        actual_ids.insert(vector_with_distance.vector_with_id().id());
+      }
+
+      EXPECT_FALSE(actual_ids.empty());
+      EXPECT_EQ(expect_ids, actual_ids);
+    }
+  }
+}
+
+// Search over candidate ids by point lookup, same result as scan search with list filter.
+TEST_F(VectorIndexBruteforceTest, CandidateSearch) {
+  const int topk = 10;
+  auto reader = engine->Reader();
+
+  // Not exist and duplicated ids are skipped.
+  std::vector<int64_t> candidate_ids;
+  for (int64_t id = kDataCount + 10; id > 0; id -= 3) {
+    candidate_ids.push_back(id);
+  }
+  candidate_ids.push_back(candidate_ids.back());
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  filters.push_back(std::make_shared<VectorIndex::HnswListFilterFunctor>(candidate_ids));
+
+  for (auto metric_type : {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_COSINE}) {
+    for (int64_t batch_count : {7, 2048}) {
+      FLAGS_vector_index_bruteforce_batch_count = batch_count;
+
+      std::vector<pb::index::VectorWithDistanceResult> expect_results;
+      ASSERT_TRUE(VectorIndexBruteforce::ScanSearch(reader, range, metric_type, kDimension, queries, topk, filters,
+                                                    expect_results)
+                      .ok());
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status = VectorIndexBruteforce::CandidateSearch(reader, range, metric_type, kDimension, queries, topk,
+                                                           candidate_ids, results);
+      ASSERT_TRUE(status.ok()) << status.error_str();
+      ASSERT_EQ(kQueryCount, results.size());
+
+      for (int i = 0; i < kQueryCount; ++i) {
+        ASSERT_EQ(topk, results[i].vector_with_distances_size());
+        for (int j = 0; j < topk; ++j) {
+          EXPECT_EQ(expect_results[i].vector_with_distances(j).vector_with_id().id(),
+                    results[i].vector_with_distances(j).vector_with_id().id());
+        }
+      }
+
+      float radius = metric_type == pb::common::MetricType::METRIC_TYPE_L2 ? 36.0F : 0.8F;
+      expect_results.clear();
+      ASSERT_TRUE(VectorIndexBruteforce::ScanRangeSearch(reader, range, metric_type, kDimension, queries, radius,
+                                                         filters, expect_results)
+                      .ok());
+      results.clear();
+      ASSERT_TRUE(VectorIndexBruteforce::CandidateRangeSearch(reader, range, metric_type, kDimension, queries, radius,
+                                                              candidate_ids, results)
+                      .ok());
+      ASSERT_EQ(kQueryCount, results.size());
+      for (int i = 0; i < kQueryCount; ++i) {
+        EXPECT_EQ(expect_results[i].vector_with_distances_size(), results[i].vector_with_distances_size());
+      }
+    }
+  }
+
+  FLAGS_vector_index_bruteforce_batch_count = 2048;
+
+  // Empty candidates.
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(VectorIndexBruteforce::CandidateSearch(reader, range, pb::common::MetricType::METRIC_TYPE_L2, kDimension,
+                                                     queries, topk, {}, results)
+                  .ok());
+  ASSERT_EQ(kQueryCount, results.size());
+  EXPECT_EQ(0, results[0].vector_with_distances_size());
+}
+
+// Compare scan search cost of every simd level.
+TEST_F(VectorIndexBruteforceTest, ScanSearchPerf) {
+  auto reader = engine->Reader();
+  auto origin_level = VectorDistance::GetSimdLevel();
+
+  for (auto level : {VectorDistance::SimdLevel::kScalar, VectorDistance::SimdLevel::kAvx2,
+                     VectorDistance::SimdLevel::kAvx512}) {
+    if (!VectorDistance::SetSimdLevel(level)) {
+      continue;
+    }
+
+    butil::Timer timer;
+    timer.start();
+    for (int i = 0; i < 10; ++i) {
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      ASSERT_TRUE(VectorIndexBruteforce::ScanSearch(reader, range, pb::common::MetricType::METRIC_TYPE_L2, kDimension,
+                                                    queries, 10, {}, results)
+                      .ok());
+    }
+    timer.stop();
+
+    std::cout << fmt::format("simd level({}) data count({}) query count({}) elapsed time({}us)",
+                             VectorDistance::GetSimdLevelName(level), kDataCount, kQueryCount, timer.u_elapsed())
+              << '\n';
+  }
+
+  ASSERT_TRUE(VectorDistance::SetSimdLevel(origin_level));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,284 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_diskann.h"
+
+namespace dingodb {
+
+DECLARE_string(diskann_work_path);
+DECLARE_int64(diskann_min_build_count);
+
+class VectorIndexDiskAnnTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    data_base.resize(kDataBaseSize * kDimension);
+    for (auto& value : data_base) {
+      value = distrib(rng);
+    }
+  }
+
+  void SetUp() override {
+    work_path_ = FLAGS_diskann_work_path;
+    min_build_count_ = FLAGS_diskann_min_build_count;
+    FLAGS_diskann_work_path = kWorkPath;
+    FLAGS_diskann_min_build_count = 100;
+  }
+
+  void TearDown() override {
+    FLAGS_diskann_work_path = work_path_;
+    FLAGS_diskann_min_build_count = min_build_count_;
+    std::filesystem::remove_all(kWorkPath);
+    std::filesystem::remove_all(kSnapshotPath);
+  }
+
+  static std::shared_ptr<VectorIndexDiskAnn> NewIndex(pb::common::MetricType metric_type) {
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(10);
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN);
+    auto* diskann_parameter = index_parameter.mutable_diskann_parameter();
+    diskann_parameter->set_dimension(kDimension);
+    diskann_parameter->set_metric_type(metric_type);
+    diskann_parameter->set_num_trees(1);
+    diskann_parameter->set_num_neighbors(32);
+    diskann_parameter->set_num_threads(2);
+    return std::make_shared<VectorIndexDiskAnn>(1, index_parameter, epoch, pb::common::Range());
+  }
+
+  static pb::common::VectorWithId MakeVector(int64_t id, const float* values) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    vector_with_id.mutable_vector()->set_dimension(kDimension);
+    vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+    for (int i = 0; i < kDimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(values[i]);
+    }
+    return vector_with_id;
+  }
+
+  // Vector id is offset + row.
+  static void AddAll(std::shared_ptr<VectorIndexDiskAnn> index) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int i = 0; i < kDataBaseSize; ++i) {
+      vector_with_ids.push_back(MakeVector(kIdOffset + i, data_base.data() + i * kDimension));
+    }
+    ASSERT_TRUE(index->Add(vector_with_ids).ok());
+  }
+
+  static std::vector<pb::index::VectorWithDistanceResult> Search(
+      std::shared_ptr<VectorIndexDiskAnn> index, int row, uint32_t topk,
+      std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters = {}) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_diskann()->set_search_list_size(100);
+    auto status = index->Search({MakeVector(0, data_base.data() + row * kDimension)}, topk, filters, false,
+                                parameter, results);
+    EXPECT_TRUE(status.ok()) << status.error_str();
+    return results;
+  }
+
+  static float Recall(std::shared_ptr<VectorIndexDiskAnn> index) {
+    int hit = 0;
+    for (int row = 0; row < kDataBaseSize; row += 50) {
+      auto results = Search(index, row, 1);
+      if (!results.empty() && results[0].vector_with_distances_size() > 0 &&
+          results[0].vector_with_distances(0).vector_with_id().id() == kIdOffset + row) {
+        ++hit;
+      }
+    }
+    return static_cast<float>(hit) / (kDataBaseSize / 50);
+  }
+
+  inline static const std::string kWorkPath = "./diskann_test_work";
+  inline static const std::string kSnapshotPath = "./diskann_test_snapshot";
+  inline static constexpr int kDimension = 16;
+  inline static constexpr int kDataBaseSize = 2000;
+  inline static constexpr int64_t kIdOffset = 1000;
+  inline static std::vector<float> data_base;
+
+  std::string work_path_;
+  int64_t min_build_count_;
+};
+
+TEST_F(VectorIndexDiskAnnTest, SmallDataInMemory) {
+  FLAGS_diskann_min_build_count = kDataBaseSize + 1;
+  auto index = NewIndex(pb::common::METRIC_TYPE_L2);
+  EXPECT_FALSE(index->IsTrained());
+  AddAll(index);
+  ASSERT_TRUE(index->Build().ok());
+  EXPECT_TRUE(index->IsTrained());
+
+  int64_t count = 0;
+  ASSERT_TRUE(index->GetCount(count).ok());
+  EXPECT_EQ(kDataBaseSize, count);
+  EXPECT_EQ(1.0f, Recall(index));
+
+  auto results = Search(index, 10, 5);
+  ASSERT_EQ(1, results.size());
+  ASSERT_EQ(5, results[0].vector_with_distances_size());
+  EXPECT_FLOAT_EQ(0.0f, results[0].vector_with_distances(0).distance());
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_LE(results[0].vector_with_distances(i - 1).distance(), results[0].vector_with_distances(i).distance());
+  }
+}
+
+TEST_F(VectorIndexDiskAnnTest, BuildAndSearch) {
+  auto index = NewIndex(pb::common::METRIC_TYPE_L2);
+  AddAll(index);
+  ASSERT_TRUE(index->Build().ok());
+
+  int64_t count = 0;
+  ASSERT_TRUE(index->GetCount(count).ok());
+  EXPECT_EQ(kDataBaseSize, count);
+  EXPECT_GE(Recall(index), 0.9f);
+
+  // Range search is not supported, caller fall back to brute force.
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto status = index->RangeSearch({MakeVector(0, data_base.data())}, 1.0f, {}, false, {}, results);
+  EXPECT_EQ(pb::error::EVECTOR_NOT_SUPPORT, status.error_code());
+}
+
+TEST_F(VectorIndexDiskAnnTest, InnerProduct) {
+  auto index = NewIndex(pb::common::METRIC_TYPE_INNER_PRODUCT);
+  AddAll(index);
+  ASSERT_TRUE(index->Build().ok());
+
+  auto results = Search(index, 7, 3);
+  ASSERT_EQ(1, results.size());
+  ASSERT_GT(results[0].vector_with_distances_size(), 0);
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    int64_t row = vector_with_distance.vector_with_id().id() - kIdOffset;
+    float ip = 0.0f;
+    for (int i = 0; i < kDimension; ++i) {
+      ip += data_base[row * kDimension + i] * data_base[7 * kDimension + i];
+    }
+    EXPECT_NEAR(1.0f - ip, vector_with_distance.distance(), 1e-4);
+  }
+}
+
+TEST_F(VectorIndexDiskAnnTest, UpsertAndDelete) {
+  auto index = NewIndex(pb::common::METRIC_TYPE_L2);
+  AddAll(index);
+  ASSERT_TRUE(index->Build().ok());
+
+  // Deleted disk vector is not returned.
+  ASSERT_TRUE(index->Delete({kIdOffset + 10}).ok());
+  auto results = Search(index, 10, 1);
+  ASSERT_EQ(1, results[0].vector_with_distances_size());
+  EXPECT_NE(kIdOffset + 10, results[0].vector_with_distances(0).vector_with_id().id());
+
+  // Overwrite disk vector 20 with vector of row 30, both are found by query 30.
+  ASSERT_TRUE(index->Upsert({MakeVector(kIdOffset + 20, data_base.data() + 30 * kDimension)}).ok());
+  results = Search(index, 30, 2);
+  ASSERT_EQ(2, results[0].vector_with_distances_size());
+  EXPECT_FLOAT_EQ(0.0f, results[0].vector_with_distances(1).distance());
+  results = Search(index, 20, 1);
+  EXPECT_NE(kIdOffset + 20, results[0].vector_with_distances(0).vector_with_id().id());
+
+  // New vector lives in delta.
+  ASSERT_TRUE(index->Upsert({MakeVector(1, data_base.data() + 40 * kDimension)}).ok());
+  results = Search(index, 40, 2);
+  std::vector<int64_t> ids;
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    ids.push_back(vector_with_distance.vector_with_id().id());
+  }
+  EXPECT_NE(ids.end(), std::find(ids.begin(), ids.end(), 1));
+
+  int64_t count = 0;
+  int64_t deleted_count = 0;
+  ASSERT_TRUE(index->GetCount(count).ok());
+  ASSERT_TRUE(index->GetDeletedCount(deleted_count).ok());
+  EXPECT_EQ(kDataBaseSize, count);
+  EXPECT_EQ(2, deleted_count);
+  EXPECT_FALSE(index->NeedToRebuild());
+
+  // Too many changes since build.
+  std::vector<int64_t> delete_ids;
+  for (int i = 0; i < kDataBaseSize / 2; ++i) {
+    delete_ids.push_back(kIdOffset + i);
+  }
+  ASSERT_TRUE(index->Delete(delete_ids).ok());
+  EXPECT_TRUE(index->NeedToRebuild());
+}
+
+TEST_F(VectorIndexDiskAnnTest, Filter) {
+  auto index = NewIndex(pb::common::METRIC_TYPE_L2);
+  AddAll(index);
+  ASSERT_TRUE(index->Build().ok());
+
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  filters.push_back(std::make_shared<VectorIndex::RangeFilterFunctor>(kIdOffset + 100, kIdOffset + 200));
+  auto results = Search(index, 150, 10, filters);
+  ASSERT_EQ(1, results.size());
+  ASSERT_GT(results[0].vector_with_distances_size(), 0);
+  EXPECT_EQ(kIdOffset + 150, results[0].vector_with_distances(0).vector_with_id().id());
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    EXPECT_GE(vector_with_distance.vector_with_id().id(), kIdOffset + 100);
+    EXPECT_LT(vector_with_distance.vector_with_id().id(), kIdOffset + 200);
+  }
+}
+
+TEST_F(VectorIndexDiskAnnTest, SaveAndLoad) {
+  auto index = NewIndex(pb::common::METRIC_TYPE_COSINE);
+  AddAll(index);
+  ASSERT_TRUE(index->Build().ok());
+  ASSERT_TRUE(index->Delete({kIdOffset + 10}).ok());
+  ASSERT_TRUE(index->Upsert({MakeVector(1, data_base.data() + 40 * kDimension)}).ok());
+  EXPECT_TRUE(index->SupportSave());
+
+  std::filesystem::create_directories(kSnapshotPath);
+  std::string path = kSnapshotPath + "/index_1_100.idx";
+  index->LockWrite();
+  auto status = index->Save(path);
+  index->UnlockWrite();
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  auto new_index = NewIndex(pb::common::METRIC_TYPE_COSINE);
+  status = new_index->Load(path);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  EXPECT_TRUE(new_index->IsTrained());
+
+  // The loaded index does not depend on snapshot files.
+  std::filesystem::remove_all(kSnapshotPath);
+
+  int64_t count = 0;
+  ASSERT_TRUE(new_index->GetCount(count).ok());
+  EXPECT_EQ(kDataBaseSize, count);
+  for (int row : {10, 40, 300}) {
+    auto expect_results = Search(index, row, 5);
+    auto results = Search(new_index, row, 5);
+    EXPECT_EQ(expect_results[0].ShortDebugString(), results[0].ShortDebugString());
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,310 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_hnsw.h"
+#include "vector/vector_index_hnsw_space.h"
+
+namespace dingodb {
+
+class VectorIndexHnswQuantizerTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::mt19937 rng(2023);
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    data_base.resize(kDataBaseSize * kDimension);
+    for (auto& value : data_base) {
+      value = distrib(rng);
+    }
+    queries.resize(kQueryCount * kDimension);
+    for (auto& value : queries) {
+      value = distrib(rng);
+    }
+  }
+
+  static float L2Sqr(const float* x, const float* y) {
+    float sum = 0.0f;
+    for (int i = 0; i < kDimension; ++i) {
+      sum += (x[i] - y[i]) * (x[i] - y[i]);
+    }
+    return sum;
+  }
+
+  static float InnerProductDistance(const float* x, const float* y) {
+    float sum = 0.0f;
+    for (int i = 0; i < kDimension; ++i) {
+      sum += x[i] * y[i];
+    }
+    return 1.0f - sum;
+  }
+
+  // Exact top k ids of a query by float distance.
+  static std::vector<int64_t> ExactTopk(const float* query, pb::common::MetricType metric_type, int topk) {
+    std::vector<std::pair<float, int64_t>> distances;
+    for (int i = 0; i < kDataBaseSize; ++i) {
+      const float* vector = data_base.data() + i * kDimension;
+      float distance = metric_type == pb::common::METRIC_TYPE_L2 ? L2Sqr(query, vector)
+                                                                  : InnerProductDistance(query, vector);
+      distances.emplace_back(distance, i);
+    }
+    std::partial_sort(distances.begin(), distances.begin() + topk, distances.end());
+
+    std::vector<int64_t> ids;
+    for (int i = 0; i < topk; ++i) {
+      ids.push_back(distances[i].second);
+    }
+    return ids;
+  }
+
+  // Brute force recall of the quantized distance, it is the best recall a quantized hnsw can get.
+  static double SpaceRecall(HnswQuantizedSpace* space, pb::common::MetricType metric_type, int topk) {
+    size_t code_size = space->get_data_size();
+    std::vector<uint8_t> codes(kDataBaseSize * code_size);
+    for (int i = 0; i < kDataBaseSize; ++i) {
+      space->Encode(data_base.data() + i * kDimension, codes.data() + i * code_size);
+    }
+
+    auto dist_func = space->get_dist_func();
+    std::vector<uint8_t> query_code(code_size);
+    int hit = 0;
+    for (int q = 0; q < kQueryCount; ++q) {
+      const float* query = queries.data() + q * kDimension;
+      space->Encode(query, query_code.data());
+
+      std::vector<std::pair<float, int64_t>> distances;
+      for (int i = 0; i < kDataBaseSize; ++i) {
+        distances.emplace_back(
+            dist_func(query_code.data(), codes.data() + i * code_size, space->get_dist_func_param()), i);
+      }
+      std::partial_sort(distances.begin(), distances.begin() + topk, distances.end());
+
+      auto exact_ids = ExactTopk(query, metric_type, topk);
+      std::set<int64_t> exact_set(exact_ids.begin(), exact_ids.end());
+      for (int i = 0; i < topk; ++i) {
+        hit += exact_set.count(distances[i].second);
+      }
+    }
+
+    return static_cast<double>(hit) / (kQueryCount * topk);
+  }
+
+  static std::shared_ptr<VectorIndex> NewHnsw(pb::common::HnswQuantizerType quantizer_type) {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    auto* hnsw_parameter = index_parameter.mutable_hnsw_parameter();
+    hnsw_parameter->set_dimension(kDimension);
+    hnsw_parameter->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    hnsw_parameter->set_efconstruction(100);
+    hnsw_parameter->set_max_elements(kDataBaseSize);
+    hnsw_parameter->set_nlinks(16);
+    hnsw_parameter->set_quantizer_type(quantizer_type);
+
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(1);
+    return VectorIndexFactory::New(1, index_parameter, epoch, pb::common::Range());
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectorWithIds(const std::vector<float>& datas, int count) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int i = 0; i < count; ++i) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(i);
+      for (int j = 0; j < kDimension; ++j) {
+        vector_with_id.mutable_vector()->add_float_values(datas[i * kDimension + j]);
+      }
+      vector_with_ids.push_back(std::move(vector_with_id));
+    }
+    return vector_with_ids;
+  }
+
+  inline static const int kDimension = 64;
+  inline static const int kDataBaseSize = 2000;
+  inline static const int kQueryCount = 50;
+  inline static std::vector<float> data_base;
+  inline static std::vector<float> queries;
+};
+
+TEST_F(VectorIndexHnswQuantizerTest, Fp16Convert) {
+  std::vector<float> values = {0.0f, -0.0f, 1.0f, -2.5f, 0.333333f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f};
+  for (auto value : values) {
+    float result = HnswFp16Space::Fp16ToFloat(HnswFp16Space::FloatToFp16(value));
+    EXPECT_NEAR(value, result, std::abs(value) * 1e-3);
+  }
+
+  // round to nearest even
+  EXPECT_EQ(0x3c00, HnswFp16Space::FloatToFp16(1.0f + 1.0f / 4096));
+  EXPECT_EQ(0x3c02, HnswFp16Space::FloatToFp16(1.0f + 3.0f / 2048));
+
+  // overflow and special value
+  EXPECT_EQ(0x7c00, HnswFp16Space::FloatToFp16(1e10f));
+  EXPECT_EQ(0xfc00, HnswFp16Space::FloatToFp16(-std::numeric_limits<float>::infinity()));
+  EXPECT_TRUE(std::isnan(HnswFp16Space::Fp16ToFloat(HnswFp16Space::FloatToFp16(std::nanf("")))));
+}
+
+TEST_F(VectorIndexHnswQuantizerTest, Sq8EncodeDecode) {
+  std::unique_ptr<HnswQuantizedSpace> space(
+      HnswQuantizedSpace::New(pb::common::HNSW_QUANTIZER_SQ8, pb::common::METRIC_TYPE_L2, kDimension));
+  ASSERT_NE(nullptr, space);
+  EXPECT_EQ(HnswSq8Space::kHeaderSize + kDimension, space->get_data_size());
+
+  std::vector<uint8_t> code(space->get_data_size());
+  std::vector<float> decoded(kDimension);
+  space->Encode(data_base.data(), code.data());
+  space->Decode(code.data(), decoded.data());
+
+  // The error is at most half of the step, step is (max - min) / 255.
+  for (int i = 0; i < kDimension; ++i) {
+    EXPECT_NEAR(data_base[i], decoded[i], 2.0f / 255 / 2 + 1e-5);
+  }
+
+  // Same value vector
+  std::vector<float> same(kDimension, 0.5f);
+  space->Encode(same.data(), code.data());
+  space->Decode(code.data(), decoded.data());
+  for (int i = 0; i < kDimension; ++i) {
+    EXPECT_FLOAT_EQ(0.5f, decoded[i]);
+  }
+}
+
+TEST_F(VectorIndexHnswQuantizerTest, Distance) {
+  std::vector<pb::common::HnswQuantizerType> quantizer_types = {pb::common::HNSW_QUANTIZER_FP16,
+                                                                pb::common::HNSW_QUANTIZER_SQ8};
+  std::vector<pb::common::MetricType> metric_types = {pb::common::METRIC_TYPE_L2,
+                                                      pb::common::METRIC_TYPE_INNER_PRODUCT};
+  for (auto quantizer_type : quantizer_types) {
+    for (auto metric_type : metric_types) {
+      std::unique_ptr<HnswQuantizedSpace> space(HnswQuantizedSpace::New(quantizer_type, metric_type, kDimension));
+      ASSERT_NE(nullptr, space);
+
+      std::vector<uint8_t> code_x(space->get_data_size());
+      std::vector<uint8_t> code_y(space->get_data_size());
+      for (int i = 0; i + 1 < 20; ++i) {
+        const float* x = data_base.data() + i * kDimension;
+        const float* y = data_base.data() + (i + 1) * kDimension;
+        space->Encode(x, code_x.data());
+        space->Encode(y, code_y.data());
+
+        float expect = metric_type == pb::common::METRIC_TYPE_L2 ? L2Sqr(x, y) : InnerProductDistance(x, y);
+        float distance = space->get_dist_func()(code_x.data(), code_y.data(), space->get_dist_func_param());
+        EXPECT_NEAR(expect, distance, 0.1) << pb::common::HnswQuantizerType_Name(quantizer_type) << " "
+                                            << pb::common::MetricType_Name(metric_type);
+      }
+    }
+  }
+
+  EXPECT_EQ(nullptr,
+            HnswQuantizedSpace::New(pb::common::HNSW_QUANTIZER_NONE, pb::common::METRIC_TYPE_L2, kDimension));
+}
+
+TEST_F(VectorIndexHnswQuantizerTest, SpaceRecall) {
+  std::unique_ptr<HnswQuantizedSpace> fp16(
+      HnswQuantizedSpace::New(pb::common::HNSW_QUANTIZER_FP16, pb::common::METRIC_TYPE_L2, kDimension));
+  EXPECT_GE(SpaceRecall(fp16.get(), pb::common::METRIC_TYPE_L2, 10), 0.99);
+
+  std::unique_ptr<HnswQuantizedSpace> sq8(
+      HnswQuantizedSpace::New(pb::common::HNSW_QUANTIZER_SQ8, pb::common::METRIC_TYPE_L2, kDimension));
+  EXPECT_GE(SpaceRecall(sq8.get(), pb::common::METRIC_TYPE_L2, 10), 0.9);
+
+  std::unique_ptr<HnswQuantizedSpace> sq8_ip(
+      HnswQuantizedSpace::New(pb::common::HNSW_QUANTIZER_SQ8, pb::common::METRIC_TYPE_INNER_PRODUCT, kDimension));
+  EXPECT_GE(SpaceRecall(sq8_ip.get(), pb::common::METRIC_TYPE_INNER_PRODUCT, 10), 0.9);
+}
+
+TEST_F(VectorIndexHnswQuantizerTest, Memory) {
+  EXPECT_EQ(kDimension * 4, HnswQuantizedSpace::CodeSize(pb::common::HNSW_QUANTIZER_NONE, kDimension));
+  EXPECT_EQ(kDimension * 2, HnswQuantizedSpace::CodeSize(pb::common::HNSW_QUANTIZER_FP16, kDimension));
+  EXPECT_EQ(kDimension + 16, HnswQuantizedSpace::CodeSize(pb::common::HNSW_QUANTIZER_SQ8, kDimension));
+
+  // Quantized vector make a region hold more vectors.
+  int64_t memory_size = 1024L * 1024L * 1024L;
+  auto float_count =
+      VectorIndexHnsw::CalcHnswCountFromMemory(memory_size, 768, 32, pb::common::HNSW_QUANTIZER_NONE);
+  auto fp16_count = VectorIndexHnsw::CalcHnswCountFromMemory(memory_size, 768, 32, pb::common::HNSW_QUANTIZER_FP16);
+  auto sq8_count = VectorIndexHnsw::CalcHnswCountFromMemory(memory_size, 768, 32, pb::common::HNSW_QUANTIZER_SQ8);
+  EXPECT_GT(fp16_count, float_count * 1.8);
+  EXPECT_GT(sq8_count, float_count * 3);
+}
+
+TEST_F(VectorIndexHnswQuantizerTest, SearchRecall) {
+  auto float_index = NewHnsw(pb::common::HNSW_QUANTIZER_NONE);
+  auto sq8_index = NewHnsw(pb::common::HNSW_QUANTIZER_SQ8);
+  auto fp16_index = NewHnsw(pb::common::HNSW_QUANTIZER_FP16);
+  ASSERT_NE(nullptr, float_index);
+  ASSERT_NE(nullptr, sq8_index);
+  ASSERT_NE(nullptr, fp16_index);
+
+  auto vector_with_ids = GenVectorWithIds(data_base, kDataBaseSize);
+  ASSERT_TRUE(float_index->Upsert(vector_with_ids).ok());
+  ASSERT_TRUE(sq8_index->Upsert(vector_with_ids).ok());
+  ASSERT_TRUE(fp16_index->Upsert(vector_with_ids).ok());
+
+  int64_t float_memory_size = 0;
+  int64_t sq8_memory_size = 0;
+  int64_t fp16_memory_size = 0;
+  float_index->GetMemorySize(float_memory_size);
+  sq8_index->GetMemorySize(sq8_memory_size);
+  fp16_index->GetMemorySize(fp16_memory_size);
+  EXPECT_LT(fp16_memory_size, float_memory_size);
+  EXPECT_LT(sq8_memory_size, fp16_memory_size);
+
+  const uint32_t topk = 10;
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_hnsw()->set_efsearch(128);
+
+  auto query_with_ids = GenVectorWithIds(queries, kQueryCount);
+  auto calc_recall = [&](std::shared_ptr<VectorIndex> vector_index) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = vector_index->Search(query_with_ids, topk, {}, true, parameter, results);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(kQueryCount, results.size());
+
+    int hit = 0;
+    for (int q = 0; q < kQueryCount && q < static_cast<int>(results.size()); ++q) {
+      auto exact_ids = ExactTopk(queries.data() + q * kDimension, pb::common::METRIC_TYPE_L2, topk);
+      std::set<int64_t> exact_set(exact_ids.begin(), exact_ids.end());
+      for (const auto& vector_with_distance : results[q].vector_with_distances()) {
+        hit += exact_set.count(vector_with_distance.vector_with_id().id());
+        // quantized index can not reconstruct vector.
+        if (vector_index != float_index) {
+          EXPECT_EQ(0, vector_with_distance.vector_with_id().vector().float_values_size());
+        }
+      }
+    }
+    return static_cast<double>(hit) / (kQueryCount * topk);
+  };
+
+  double float_recall = calc_recall(float_index);
+  EXPECT_GE(calc_recall(fp16_index), float_recall - 0.02);
+  EXPECT_GE(calc_recall(sq8_index), float_recall - 0.1);
+}
+
+}  // namespace dingodb
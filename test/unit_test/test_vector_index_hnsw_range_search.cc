@@ -0,0 +1,301 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "butil/time.h"
+#include "common/constant.h"
+#include "engine/mem_engine.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_distance.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_bruteforce.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+static const char kPrefix = 'r';
+static const int64_t kPartitionId = 1;
+
+class VectorIndexHnswRangeSearchTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    engine = std::make_shared<MemEngine>();
+    ASSERT_TRUE(engine->Init(nullptr, {Constant::kVectorDataCF}));
+
+    std::string start_key;
+    std::string end_key;
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, 0, start_key);
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, INT64_MAX, end_key);
+    range.set_start_key(start_key);
+    range.set_end_key(end_key);
+
+    std::mt19937 rng(2023);
+    std::uniform_real_distribution<float> distrib(-1.0, 1.0);
+
+    auto writer = engine->Writer();
+    for (int64_t id = 1; id <= kDataCount; ++id) {
+      auto& vector_with_id = vector_with_ids.emplace_back();
+      vector_with_id.set_id(id);
+      vector_with_id.mutable_vector()->set_dimension(kDimension);
+      vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      for (int i = 0; i < kDimension; ++i) {
+        vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+      }
+
+      pb::common::KeyValue kv;
+      VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, id, *kv.mutable_key());
+      kv.set_value(vector_with_id.vector().SerializeAsString());
+      ASSERT_TRUE(writer->KvPut(Constant::kVectorDataCF, kv).ok());
+    }
+
+    for (int i = 0; i < kQueryCount; ++i) {
+      auto& query = queries.emplace_back();
+      query.mutable_vector()->set_dimension(kDimension);
+      query.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      for (int j = 0; j < kDimension; ++j) {
+        query.mutable_vector()->add_float_values(distrib(rng));
+      }
+    }
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine = nullptr;
+    vector_with_ids.clear();
+    queries.clear();
+  }
+
+  static std::shared_ptr<VectorIndex> NewHnsw(pb::common::MetricType metric_type) {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    auto* hnsw_parameter = index_parameter.mutable_hnsw_parameter();
+    hnsw_parameter->set_dimension(kDimension);
+    hnsw_parameter->set_metric_type(metric_type);
+    hnsw_parameter->set_efconstruction(200);
+    hnsw_parameter->set_max_elements(kDataCount);
+    hnsw_parameter->set_nlinks(32);
+
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(1);
+    auto hnsw_index = VectorIndexFactory::New(1, index_parameter, epoch, range);
+    EXPECT_NE(nullptr, hnsw_index);
+    EXPECT_TRUE(hnsw_index->Add(vector_with_ids).ok());
+    return hnsw_index;
+  }
+
+  // Exact distance of same definition as vector index, L2 is squared, IP/COSINE is 1-ip.
+  static float Distance(pb::common::MetricType metric_type, const pb::common::VectorWithId& x,
+                        const pb::common::VectorWithId& y) {
+    std::vector<float> x_values(x.vector().float_values().begin(), x.vector().float_values().end());
+    std::vector<float> y_values(y.vector().float_values().begin(), y.vector().float_values().end());
+    if (metric_type == pb::common::MetricType::METRIC_TYPE_L2) {
+      return VectorDistance::L2Sqr(x_values.data(), y_values.data(), kDimension);
+    }
+    if (metric_type == pb::common::MetricType::METRIC_TYPE_COSINE) {
+      VectorDistance::Normalize(x_values.data(), kDimension);
+      VectorDistance::Normalize(y_values.data(), kDimension);
+    }
+    return 1.0F - VectorDistance::InnerProduct(x_values.data(), y_values.data(), kDimension);
+  }
+
+  // Radius which include about count vectors of the query, and the ids within the radius.
+  static std::pair<float, std::set<int64_t>> ExactRangeSearch(pb::common::MetricType metric_type,
+                                                              const pb::common::VectorWithId& query, int count) {
+    std::vector<std::pair<float, int64_t>> distances;
+    for (const auto& vector_with_id : vector_with_ids) {
+      distances.emplace_back(Distance(metric_type, query, vector_with_id), vector_with_id.id());
+    }
+    std::nth_element(distances.begin(), distances.begin() + count, distances.end());
+    float radius = distances[count].first;
+
+    std::set<int64_t> ids;
+    for (const auto& [distance, id] : distances) {
+      if (distance < radius) {
+        ids.insert(id);
+      }
+    }
+    return {radius, ids};
+  }
+
+  static constexpr int kDimension = 32;
+  static constexpr int kDataCount = 20000;
+  static constexpr int kQueryCount = 8;
+  static constexpr int kRangeCount = 200;
+
+  static std::shared_ptr<MemEngine> engine;
+  static pb::common::Range range;
+  static std::vector<pb::common::VectorWithId> vector_with_ids;
+  static std::vector<pb::common::VectorWithId> queries;
+};
+
+std::shared_ptr<MemEngine> VectorIndexHnswRangeSearchTest::engine = nullptr;
+pb::common::Range VectorIndexHnswRangeSearchTest::range;
+std::vector<pb::common::VectorWithId> VectorIndexHnswRangeSearchTest::vector_with_ids;
+std::vector<pb::common::VectorWithId> VectorIndexHnswRangeSearchTest::queries;
+
+TEST_F(VectorIndexHnswRangeSearchTest, RangeSearch) {
+  for (auto metric_type : {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT,
+                           pb::common::MetricType::METRIC_TYPE_COSINE}) {
+    auto hnsw_index = NewHnsw(metric_type);
+
+    int hit = 0;
+    int expect_count = 0;
+    for (const auto& query : queries) {
+      auto [radius, expect_ids] = ExactRangeSearch(metric_type, query, kRangeCount);
+
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status = hnsw_index->RangeSearch({query}, radius, {}, false, {}, results);
+      ASSERT_TRUE(status.ok()) << status.error_str();
+      ASSERT_EQ(1, results.size());
+
+      float last_distance = -1e10F;
+      for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+        EXPECT_LT(vector_with_distance.distance(), radius);
+        EXPECT_LE(last_distance, vector_with_distance.distance());
+        last_distance = vector_with_distance.distance();
+        hit += expect_ids.count(vector_with_distance.vector_with_id().id());
+      }
+      expect_count += expect_ids.size();
+    }
+
+    double recall = static_cast<double>(hit) / expect_count;
+    std::cout << fmt::format("metric({}) range search recall({})", pb::common::MetricType_Name(metric_type), recall)
+              << '\n';
+    EXPECT_GE(recall, 0.85);
+  }
+}
+
+TEST_F(VectorIndexHnswRangeSearchTest, RangeSearchWithFilter) {
+  auto hnsw_index = NewHnsw(pb::common::MetricType::METRIC_TYPE_L2);
+  const auto& query = queries[0];
+  auto [radius, expect_ids] = ExactRangeSearch(pb::common::MetricType::METRIC_TYPE_L2, query, kRangeCount);
+
+  // Range filter, only the first half of ids.
+  {
+    int64_t max_id = kDataCount / 2;
+    auto filter = std::make_shared<VectorIndex::RangeFilterFunctor>(0, max_id);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(hnsw_index->RangeSearch({query}, radius, {filter}, false, {}, results).ok());
+    ASSERT_EQ(1, results.size());
+    EXPECT_GT(results[0].vector_with_distances_size(), 0);
+    for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_LT(vector_with_distance.vector_with_id().id(), max_id);
+    }
+  }
+
+  // List filter, only the even ids within radius.
+  {
+    std::vector<int64_t> list_ids;
+    for (auto id : expect_ids) {
+      if (id % 2 == 0) {
+        list_ids.push_back(id);
+      }
+    }
+    auto filter = std::make_shared<VectorIndex::HnswListFilterFunctor>(list_ids);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(hnsw_index->RangeSearch({query}, radius, {filter}, true, {}, results).ok());
+    ASSERT_EQ(1, results.size());
+    EXPECT_GT(results[0].vector_with_distances_size(), 0);
+    for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_EQ(0, vector_with_distance.vector_with_id().id() % 2);
+      EXPECT_EQ(kDimension, vector_with_distance.vector_with_id().vector().float_values_size());
+    }
+  }
+
+  // Deleted vectors are not returned.
+  {
+    std::vector<int64_t> delete_ids(expect_ids.begin(), expect_ids.end());
+    delete_ids.resize(delete_ids.size() / 2);
+    ASSERT_TRUE(hnsw_index->Delete(delete_ids).ok());
+
+    std::set<int64_t> delete_set(delete_ids.begin(), delete_ids.end());
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(hnsw_index->RangeSearch({query}, radius, {}, false, {}, results).ok());
+    ASSERT_EQ(1, results.size());
+    EXPECT_GT(results[0].vector_with_distances_size(), 0);
+    for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_EQ(0, delete_set.count(vector_with_distance.vector_with_id().id()));
+    }
+  }
+
+  // Nothing within radius.
+  {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(hnsw_index->RangeSearch({query}, 0.0F, {}, false, {}, results).ok());
+    ASSERT_EQ(1, results.size());
+    EXPECT_EQ(0, results[0].vector_with_distances_size());
+  }
+
+  // Illegal efsearch.
+  {
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_hnsw()->set_efsearch(2000);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    EXPECT_EQ(pb::error::EILLEGAL_PARAMTETERS,
+              hnsw_index->RangeSearch({query}, radius, {}, false, parameter, results).error_code());
+  }
+}
+
+// Compare range search cost of hnsw graph and brute force scan, brute force is the fallback of range search
+// before hnsw support it. Increase kDataCount to get the cost of a large region, e.g. 1M vectors.
+TEST_F(VectorIndexHnswRangeSearchTest, RangeSearchPerf) {
+  auto hnsw_index = NewHnsw(pb::common::MetricType::METRIC_TYPE_L2);
+  auto reader = engine->Reader();
+
+  std::vector<float> radiuses;
+  for (const auto& query : queries) {
+    radiuses.push_back(ExactRangeSearch(pb::common::MetricType::METRIC_TYPE_L2, query, kRangeCount).first);
+  }
+
+  butil::Timer hnsw_timer;
+  hnsw_timer.start();
+  for (int i = 0; i < kQueryCount; ++i) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(hnsw_index->RangeSearch({queries[i]}, radiuses[i], {}, false, {}, results).ok());
+  }
+  hnsw_timer.stop();
+
+  butil::Timer bruteforce_timer;
+  bruteforce_timer.start();
+  for (int i = 0; i < kQueryCount; ++i) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(VectorIndexBruteforce::ScanRangeSearch(reader, range, pb::common::MetricType::METRIC_TYPE_L2,
+                                                       kDimension, {queries[i]}, radiuses[i], {}, results)
+                    .ok());
+  }
+  bruteforce_timer.stop();
+
+  std::cout << fmt::format("data count({}) query count({}) hnsw range search({}us) brute force range search({}us)",
+                           kDataCount, kQueryCount, hnsw_timer.u_elapsed(), bruteforce_timer.u_elapsed())
+            << '\n';
+}
+
+}  // namespace dingodb
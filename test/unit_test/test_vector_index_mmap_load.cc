@@ -0,0 +1,159 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_ivf_flat.h"
+#include "vector/vector_index_raw_ivf_pq.h"
+
+namespace dingodb {
+
+DECLARE_bool(vector_index_load_snapshot_mmap);
+
+class VectorIndexMmapLoadTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<> distrib;
+    data_base.resize(kDataBaseSize * kDimension);
+    for (auto& value : data_base) {
+      value = distrib(rng);
+    }
+  }
+
+  static void TearDownTestSuite() {
+    std::remove(kSnapshotPath.c_str());
+    std::remove(kResavePath.c_str());
+    FLAGS_vector_index_load_snapshot_mmap = false;
+  }
+
+  static std::shared_ptr<VectorIndex> NewIndex(pb::common::VectorIndexType index_type) {
+    static const pb::common::Range kRange;
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(10);
+
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(index_type);
+    if (index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT) {
+      index_parameter.mutable_ivf_flat_parameter()->set_dimension(kDimension);
+      index_parameter.mutable_ivf_flat_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+      index_parameter.mutable_ivf_flat_parameter()->set_ncentroids(kNcentroids);
+      return std::make_shared<VectorIndexIvfFlat>(1, index_parameter, epoch, kRange);
+    }
+
+    index_parameter.mutable_ivf_pq_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_ivf_pq_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_ivf_pq_parameter()->set_ncentroids(kNcentroids);
+    index_parameter.mutable_ivf_pq_parameter()->set_nsubvector(8);
+    index_parameter.mutable_ivf_pq_parameter()->set_nbits_per_idx(8);
+    return std::make_shared<VectorIndexRawIvfPq>(1, index_parameter, epoch, kRange);
+  }
+
+  static std::vector<pb::common::VectorWithId> MakeVectors(int64_t start_id, int count) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int i = 0; i < count; ++i) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(start_id + i);
+      for (int j = 0; j < kDimension; ++j) {
+        vector_with_id.mutable_vector()->add_float_values(data_base[(i % kDataBaseSize) * kDimension + j]);
+      }
+      vector_with_ids.push_back(vector_with_id);
+    }
+    return vector_with_ids;
+  }
+
+  static std::vector<int64_t> SearchIds(std::shared_ptr<VectorIndex> vector_index, int64_t query_id) {
+    auto query = MakeVectors(query_id, 1);
+    pb::common::VectorSearchParameter parameter;
+    if (vector_index->VectorIndexType() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT) {
+      parameter.mutable_ivf_flat()->set_nprobe(kNcentroids);
+    } else {
+      parameter.mutable_ivf_pq()->set_nprobe(kNcentroids);
+    }
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = vector_index->Search(query, 10, {}, false, parameter, results);
+    EXPECT_EQ(status.error_code(), pb::error::Errno::OK);
+
+    std::vector<int64_t> ids;
+    for (const auto& result : results) {
+      for (const auto& vector_with_distance : result.vector_with_distances()) {
+        ids.push_back(vector_with_distance.vector_with_id().id());
+      }
+    }
+    return ids;
+  }
+
+  static void CheckMmapLoad(pb::common::VectorIndexType index_type) {
+    auto vector_index = NewIndex(index_type);
+    ASSERT_EQ(vector_index->Train(data_base).error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(vector_index->Add(MakeVectors(0, kDataBaseSize)).error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(vector_index->Save(kSnapshotPath).error_code(), pb::error::Errno::OK);
+
+    FLAGS_vector_index_load_snapshot_mmap = true;
+    auto mmap_index = NewIndex(index_type);
+    ASSERT_EQ(mmap_index->Load(kSnapshotPath).error_code(), pb::error::Errno::OK);
+    FLAGS_vector_index_load_snapshot_mmap = false;
+
+    int64_t count = 0;
+    mmap_index->GetCount(count);
+    EXPECT_EQ(count, kDataBaseSize);
+    EXPECT_EQ(SearchIds(mmap_index, 0), SearchIds(vector_index, 0));
+
+    // save before write, the lists must be written with data instead of the reference to snapshot file.
+    ASSERT_EQ(mmap_index->Save(kResavePath).error_code(), pb::error::Errno::OK);
+
+    // the first write copy the mapped lists into memory.
+    ASSERT_EQ(mmap_index->Delete({0}).error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(mmap_index->Upsert(MakeVectors(kDataBaseSize, 1)).error_code(), pb::error::Errno::OK);
+    mmap_index->GetCount(count);
+    EXPECT_EQ(count, kDataBaseSize);
+
+    auto ids = SearchIds(mmap_index, kDataBaseSize);
+    ASSERT_FALSE(ids.empty());
+    EXPECT_EQ(ids[0], kDataBaseSize);
+
+    // the resaved snapshot is independent of the first one.
+    std::remove(kSnapshotPath.c_str());
+    auto heap_index = NewIndex(index_type);
+    ASSERT_EQ(heap_index->Load(kResavePath).error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(SearchIds(heap_index, 0), SearchIds(vector_index, 0));
+  }
+
+  inline static const int kDimension = 32;
+  inline static const int kDataBaseSize = 2000;
+  inline static const int kNcentroids = 16;
+  inline static const std::string kSnapshotPath = "./mmap_load_snapshot";
+  inline static const std::string kResavePath = "./mmap_load_resave";
+  inline static std::vector<float> data_base;
+};
+
+TEST_F(VectorIndexMmapLoadTest, IvfFlat) { CheckMmapLoad(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT); }
+
+TEST_F(VectorIndexMmapLoadTest, RawIvfPq) { CheckMmapLoad(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ); }
+
+}  // namespace dingodb
@@ -0,0 +1,247 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "log/segment_log_storage.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "proto/raft.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_manager.h"
+
+DECLARE_int64(vector_index_replay_wal_chunk_size);
+DECLARE_int32(vector_index_replay_wal_parallel_num);
+DECLARE_int64(vector_index_replay_wal_batch_size);
+
+namespace dingodb {
+
+static const std::string kRootPath = "./unit_test_vector_index_replay_wal";
+static const std::string kLogPath = kRootPath + "/log";
+
+class VectorIndexReplayWalTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Helper::CreateDirectories(kLogPath);
+
+    log_storage = std::make_shared<SegmentLogStorage>(kLogPath, kRegionId, 8 * 1024 * 1024);
+    static braft::ConfigurationManager configuration_manager;
+    ASSERT_EQ(0, log_storage->Init(&configuration_manager));
+
+    pb::common::Range range;
+    std::string start_key;
+    std::string end_key;
+    VectorCodec::EncodeVectorKey(Constant::kExecutorRaw, 1, 0, start_key);
+    VectorCodec::EncodeVectorKey(Constant::kExecutorRaw, 2, 0, end_key);
+    range.set_start_key(start_key);
+    range.set_end_key(end_key);
+
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(1);
+
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    index_parameter.mutable_flat_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    vector_index = VectorIndexFactory::New(kRegionId, index_parameter, epoch, range);
+    ASSERT_NE(nullptr, vector_index);
+  }
+
+  void TearDown() override {
+    FLAGS_vector_index_replay_wal_chunk_size = 4096;
+    FLAGS_vector_index_replay_wal_parallel_num = 4;
+    FLAGS_vector_index_replay_wal_batch_size = 32768;
+
+    vector_index = nullptr;
+    log_storage->Reset(log_storage->LastLogIndex() + 1);
+    log_storage->GcInstance(kLogPath);
+    log_storage = nullptr;
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  // The value of vector is {id, version}, so the version of every id can be checked after replay.
+  static pb::common::VectorWithId GenVector(int64_t vector_id, int64_t version) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(vector_id);
+    auto* vector = vector_with_id.mutable_vector();
+    vector->set_dimension(kDimension);
+    vector->set_value_type(pb::common::ValueType::FLOAT);
+    vector->add_float_values(static_cast<float>(vector_id));
+    vector->add_float_values(static_cast<float>(version));
+    return vector_with_id;
+  }
+
+  void AppendLog(const pb::raft::RaftCmdRequest& raft_cmd) {
+    auto* log_entry = new braft::LogEntry();
+    log_entry->AddRef();
+    log_entry->type = braft::ENTRY_TYPE_DATA;
+    log_entry->id.term = 1;
+    log_entry->id.index = log_storage->LastLogIndex() + 1;
+
+    butil::IOBufAsZeroCopyOutputStream wrapper(&log_entry->data);
+    raft_cmd.SerializeToZeroCopyStream(&wrapper);
+
+    ASSERT_EQ(0, log_storage->AppendEntry(log_entry));
+    log_entry->Release();
+  }
+
+  // One log add the vectors and delete the ids.
+  void AppendLog(const std::map<int64_t, int64_t>& adds, const std::vector<int64_t>& delete_ids) {
+    pb::raft::RaftCmdRequest raft_cmd;
+    if (!adds.empty()) {
+      auto* request = raft_cmd.add_requests();
+      request->set_cmd_type(pb::raft::VECTOR_ADD);
+      for (const auto& [vector_id, version] : adds) {
+        *request->mutable_vector_add()->add_vectors() = GenVector(vector_id, version);
+      }
+    }
+    if (!delete_ids.empty()) {
+      auto* request = raft_cmd.add_requests();
+      request->set_cmd_type(pb::raft::VECTOR_DELETE);
+      for (auto vector_id : delete_ids) {
+        request->mutable_vector_delete()->add_ids(vector_id);
+      }
+    }
+    AppendLog(raft_cmd);
+
+    // Keep the expected result in log order.
+    for (const auto& [vector_id, version] : adds) {
+      expect_vectors[vector_id] = version;
+    }
+    for (auto vector_id : delete_ids) {
+      expect_vectors.erase(vector_id);
+    }
+  }
+
+  void Replay() {
+    auto status = VectorIndexManager::ReplayWalToVectorIndex(vector_index, log_storage, log_storage->FirstLogIndex(),
+                                                             log_storage->LastLogIndex());
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    EXPECT_EQ(log_storage->LastLogIndex(), vector_index->ApplyLogId());
+  }
+
+  // Vector index has the same vectors as expect_vectors, the nearest vector of {id, version} must be itself.
+  void CheckIndexVectors() {
+    int64_t count = 0;
+    ASSERT_TRUE(vector_index->GetCount(count).ok());
+    ASSERT_EQ(expect_vectors.size(), count);
+
+    for (const auto& [vector_id, version] : expect_vectors) {
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status = vector_index->Search({GenVector(vector_id, version)}, 1, {}, false, {}, results);
+      ASSERT_TRUE(status.ok()) << status.error_str();
+      ASSERT_EQ(1, results.size());
+      ASSERT_EQ(1, results[0].vector_with_distances_size());
+      const auto& vector_with_distance = results[0].vector_with_distances(0);
+      EXPECT_EQ(vector_id, vector_with_distance.vector_with_id().id());
+      EXPECT_FLOAT_EQ(0.0, vector_with_distance.distance()) << fmt::format("vector_id: {}", vector_id);
+    }
+  }
+
+  static constexpr int64_t kRegionId = 1001;
+  static constexpr int kDimension = 2;
+
+  std::shared_ptr<SegmentLogStorage> log_storage;
+  VectorIndexPtr vector_index;
+  std::map<int64_t, int64_t> expect_vectors;
+};
+
+TEST_F(VectorIndexReplayWalTest, AddDeleteAddInChunk) {
+  AppendLog({{1, 1}, {2, 1}}, {});
+  AppendLog({}, {1});
+  AppendLog({{1, 2}}, {});
+  // Add and delete in the same log, delete is the later one.
+  AppendLog({{3, 1}}, {2, 3});
+
+  Replay();
+  CheckIndexVectors();
+  EXPECT_EQ(1, expect_vectors.size());
+}
+
+TEST_F(VectorIndexReplayWalTest, AddDeleteAddAcrossChunks) {
+  FLAGS_vector_index_replay_wal_chunk_size = 1;
+  FLAGS_vector_index_replay_wal_parallel_num = 2;
+
+  AppendLog({{1, 1}, {2, 1}}, {});
+  AppendLog({}, {1});
+  AppendLog({{1, 2}}, {});
+  AppendLog({}, {2});
+  AppendLog({{2, 2}, {3, 1}}, {});
+
+  Replay();
+  CheckIndexVectors();
+  EXPECT_EQ(3, expect_vectors.size());
+}
+
+TEST_F(VectorIndexReplayWalTest, DeleteOnlyTail) {
+  FLAGS_vector_index_replay_wal_chunk_size = 2;
+  FLAGS_vector_index_replay_wal_batch_size = 1;
+
+  // Vectors already in vector index, e.g. loaded from snapshot.
+  std::vector<pb::common::VectorWithId> vectors = {GenVector(1, 1), GenVector(2, 1), GenVector(3, 1)};
+  ASSERT_TRUE(vector_index->Upsert(vectors).ok());
+  expect_vectors = {{1, 1}, {2, 1}, {3, 1}};
+
+  AppendLog({{4, 1}}, {});
+  AppendLog({}, {1});
+  // The tail chunks only have delete.
+  AppendLog({}, {2});
+  AppendLog({}, {4});
+  AppendLog({}, {5});
+
+  Replay();
+  CheckIndexVectors();
+  EXPECT_EQ(1, expect_vectors.size());
+}
+
+TEST_F(VectorIndexReplayWalTest, SmallChunkParallel) {
+  FLAGS_vector_index_replay_wal_chunk_size = 3;
+  FLAGS_vector_index_replay_wal_parallel_num = 4;
+  FLAGS_vector_index_replay_wal_batch_size = 4;
+
+  std::mt19937 rng(20231018);
+  std::uniform_int_distribution<int64_t> id_distrib(1, 10);
+  for (int64_t log_id = 1; log_id <= 50; ++log_id) {
+    std::map<int64_t, int64_t> adds;
+    std::vector<int64_t> delete_ids;
+    for (int i = 0; i < 3; ++i) {
+      if (rng() % 3 == 0) {
+        delete_ids.push_back(id_distrib(rng));
+      } else {
+        adds[id_distrib(rng)] = log_id;
+      }
+    }
+    AppendLog(adds, delete_ids);
+  }
+
+  Replay();
+  CheckIndexVectors();
+}
+
+}  // namespace dingodb
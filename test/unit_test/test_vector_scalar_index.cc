@@ -0,0 +1,307 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/mem_engine.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_scalar_index.h"
+
+namespace dingodb {
+
+static const char kPrefix = 'r';
+static const int64_t kPartitionId = 1;
+
+class VectorScalarIndexTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    engine = std::make_shared<MemEngine>();
+    ASSERT_TRUE(engine->Init(nullptr, {Constant::kVectorScalarCF}));
+
+    std::string start_key;
+    std::string end_key;
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, 0, start_key);
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, INT64_MAX, end_key);
+    range.set_start_key(start_key);
+    range.set_end_key(end_key);
+
+    for (int64_t id = 1; id <= kDataCount; ++id) {
+      PutScalar(id, GenScalarData(id));
+    }
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine = nullptr;
+    scalar_datas.clear();
+  }
+
+  static pb::common::VectorScalardata GenScalarData(int64_t id) {
+    pb::common::VectorScalardata scalar_data;
+
+    pb::common::ScalarValue color;
+    color.set_field_type(pb::common::ScalarFieldType::STRING);
+    color.add_fields()->set_string_data(fmt::format("color_{}", id % 5));
+    scalar_data.mutable_scalar_data()->insert({"color", color});
+
+    pb::common::ScalarValue age;
+    age.set_field_type(pb::common::ScalarFieldType::INT64);
+    age.add_fields()->set_long_data(id % 7);
+    scalar_data.mutable_scalar_data()->insert({"age", age});
+
+    // Only part of vectors have this key.
+    if (id % 3 == 0) {
+      pb::common::ScalarValue valid;
+      valid.set_field_type(pb::common::ScalarFieldType::BOOL);
+      valid.add_fields()->set_bool_data(id % 2 == 0);
+      scalar_data.mutable_scalar_data()->insert({"valid", valid});
+    }
+
+    return scalar_data;
+  }
+
+  static void PutScalar(int64_t id, const pb::common::VectorScalardata& scalar_data) {
+    pb::common::KeyValue kv;
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, id, *kv.mutable_key());
+    kv.set_value(scalar_data.SerializeAsString());
+    ASSERT_TRUE(engine->Writer()->KvPut(Constant::kVectorScalarCF, kv).ok());
+    scalar_datas[id] = scalar_data;
+  }
+
+  static void DeleteScalar(int64_t id) {
+    std::string key;
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, id, key);
+    ASSERT_TRUE(engine->Writer()->KvDelete(Constant::kVectorScalarCF, key).ok());
+    scalar_datas.erase(id);
+  }
+
+  // Same as the scan of VectorReader::DoVectorSearchForScalarPreFilter.
+  static std::vector<int64_t> ScanMatch(const pb::common::VectorScalardata& filter) {
+    std::vector<int64_t> vector_ids;
+    for (const auto& [id, scalar_data] : scalar_datas) {
+      bool match = true;
+      for (const auto& [key, value] : filter.scalar_data()) {
+        auto it = scalar_data.scalar_data().find(key);
+        if (it == scalar_data.scalar_data().end() || !Helper::IsEqualVectorScalarValue(value, it->second)) {
+          match = false;
+          break;
+        }
+      }
+      if (match) {
+        vector_ids.push_back(id);
+      }
+    }
+    return vector_ids;
+  }
+
+  static std::vector<pb::common::VectorScalardata> GenFilters() {
+    std::vector<pb::common::VectorScalardata> filters;
+    filters.emplace_back();
+    for (int64_t id = 1; id <= 12; ++id) {
+      auto scalar_data = GenScalarData(id);
+      // color
+      auto& filter1 = filters.emplace_back();
+      filter1.mutable_scalar_data()->insert({"color", scalar_data.scalar_data().at("color")});
+      // color and age
+      filters.push_back(scalar_data);
+      filters.back().mutable_scalar_data()->erase("valid");
+      // all
+      filters.push_back(scalar_data);
+    }
+
+    // Not exist value.
+    pb::common::ScalarValue color;
+    color.set_field_type(pb::common::ScalarFieldType::STRING);
+    color.add_fields()->set_string_data("color_unknown");
+    filters.emplace_back().mutable_scalar_data()->insert({"color", color});
+
+    return filters;
+  }
+
+  static void CheckSearch(VectorScalarIndexPtr scalar_index) {
+    for (const auto& filter : GenFilters()) {
+      std::vector<int64_t> vector_ids;
+      ASSERT_TRUE(scalar_index->Search(engine->Reader(), range, filter, vector_ids));
+      EXPECT_EQ(ScanMatch(filter), vector_ids) << filter.ShortDebugString();
+    }
+  }
+
+  static constexpr int kDataCount = 20000;
+
+  static std::shared_ptr<MemEngine> engine;
+  static pb::common::Range range;
+  static std::map<int64_t, pb::common::VectorScalardata> scalar_datas;
+};
+
+std::shared_ptr<MemEngine> VectorScalarIndexTest::engine = nullptr;
+pb::common::Range VectorScalarIndexTest::range;
+std::map<int64_t, pb::common::VectorScalardata> VectorScalarIndexTest::scalar_datas;
+
+TEST_F(VectorScalarIndexTest, Bitmap) {
+  std::mt19937_64 rng(0);
+  VectorIdBitmap bitmap1;
+  VectorIdBitmap bitmap2;
+  std::set<int64_t> set1;
+  std::set<int64_t> set2;
+
+  // Dense in [0, 65536) to convert to bitset, sparse in others.
+  for (int i = 0; i < 50000; ++i) {
+    int64_t id = (i % 2 == 0) ? rng() % 65536 : rng() % (INT64_MAX >> 1);
+    bitmap1.Add(id);
+    set1.insert(id);
+  }
+  for (int i = 0; i < 20000; ++i) {
+    int64_t id = rng() % 65536;
+    bitmap2.Add(id);
+    set2.insert(id);
+  }
+  EXPECT_EQ(static_cast<int64_t>(set1.size()), bitmap1.Cardinality());
+  EXPECT_EQ(static_cast<int64_t>(set2.size()), bitmap2.Cardinality());
+
+  std::vector<int64_t> ids;
+  bitmap1.ToVector(ids);
+  EXPECT_EQ(std::vector<int64_t>(set1.begin(), set1.end()), ids);
+
+  // Remove until bitset convert back to array.
+  for (int64_t id = 0; id < 60000; ++id) {
+    bitmap2.Remove(id);
+    set2.erase(id);
+    EXPECT_EQ(static_cast<int64_t>(set2.size()), bitmap2.Cardinality());
+  }
+  for (auto id : set2) {
+    EXPECT_TRUE(bitmap2.Contains(id));
+  }
+  EXPECT_FALSE(bitmap2.Contains(1));
+
+  VectorIdBitmap result = bitmap1;
+  result.And(bitmap2);
+  std::vector<int64_t> expect_ids;
+  std::set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(), std::back_inserter(expect_ids));
+  ids.clear();
+  result.ToVector(ids);
+  EXPECT_EQ(expect_ids, ids);
+
+  VectorIdBitmap empty;
+  result.And(empty);
+  EXPECT_TRUE(result.Empty());
+}
+
+TEST_F(VectorScalarIndexTest, EncodeTerm) {
+  pb::common::ScalarValue value1;
+  value1.set_field_type(pb::common::ScalarFieldType::DOUBLE);
+  value1.add_fields()->set_double_data(0.0);
+  pb::common::ScalarValue value2;
+  value2.set_field_type(pb::common::ScalarFieldType::DOUBLE);
+  value2.add_fields()->set_double_data(-0.0);
+
+  std::string term1;
+  std::string term2;
+  ASSERT_TRUE(VectorScalarIndex::EncodeTerm("key", value1, term1));
+  ASSERT_TRUE(VectorScalarIndex::EncodeTerm("key", value2, term2));
+  EXPECT_EQ(term1, term2);
+
+  // Different key.
+  ASSERT_TRUE(VectorScalarIndex::EncodeTerm("key2", value1, term2));
+  EXPECT_NE(term1, term2);
+
+  // Key and value boundary.
+  pb::common::ScalarValue value3;
+  value3.set_field_type(pb::common::ScalarFieldType::STRING);
+  value3.add_fields()->set_string_data("bc");
+  pb::common::ScalarValue value4;
+  value4.set_field_type(pb::common::ScalarFieldType::STRING);
+  value4.add_fields()->set_string_data("c");
+  ASSERT_TRUE(VectorScalarIndex::EncodeTerm("a", value3, term1));
+  ASSERT_TRUE(VectorScalarIndex::EncodeTerm("ab", value4, term2));
+  EXPECT_NE(term1, term2);
+}
+
+TEST_F(VectorScalarIndexTest, Search) {
+  auto scalar_index = VectorScalarIndex::New(1);
+  EXPECT_FALSE(scalar_index->IsReady());
+
+  CheckSearch(scalar_index);
+  EXPECT_TRUE(scalar_index->IsReady());
+  EXPECT_GT(scalar_index->MemorySize(), 0);
+}
+
+TEST_F(VectorScalarIndexTest, UpsertAndDelete) {
+  auto scalar_index = VectorScalarIndex::New(1);
+
+  // Not built, do nothing.
+  google::protobuf::RepeatedPtrField<pb::common::VectorWithId> vector_with_ids;
+  scalar_index->Upsert(vector_with_ids);
+  scalar_index->Delete({1});
+  EXPECT_FALSE(scalar_index->IsReady());
+
+  CheckSearch(scalar_index);
+
+  // Change scalar data of exist vectors and add new vectors, same as VectorAddHandler.
+  for (int64_t id = kDataCount - 100; id <= kDataCount + 100; ++id) {
+    auto& vector_with_id = *vector_with_ids.Add();
+    vector_with_id.set_id(id);
+    *vector_with_id.mutable_scalar_data() = GenScalarData(id + 1);
+    PutScalar(id, vector_with_id.scalar_data());
+  }
+  scalar_index->Upsert(vector_with_ids);
+  CheckSearch(scalar_index);
+
+  // Same as VectorDeleteHandler.
+  std::vector<int64_t> delete_ids;
+  for (int64_t id = 1; id <= kDataCount; id += 3) {
+    DeleteScalar(id);
+    delete_ids.push_back(id);
+  }
+  scalar_index->Delete(delete_ids);
+  CheckSearch(scalar_index);
+
+  // Build again from engine.
+  scalar_index->Reset();
+  EXPECT_FALSE(scalar_index->IsReady());
+  EXPECT_EQ(0, scalar_index->MemorySize());
+  CheckSearch(scalar_index);
+}
+
+TEST_F(VectorScalarIndexTest, RangeChange) {
+  auto scalar_index = VectorScalarIndex::New(1);
+  CheckSearch(scalar_index);
+
+  // Half range after split.
+  pb::common::Range half_range;
+  half_range.set_start_key(range.start_key());
+  VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, kDataCount / 2, *half_range.mutable_end_key());
+
+  std::vector<int64_t> vector_ids;
+  ASSERT_TRUE(scalar_index->Search(engine->Reader(), half_range, pb::common::VectorScalardata(), vector_ids));
+  ASSERT_FALSE(vector_ids.empty());
+  EXPECT_LT(vector_ids.back(), kDataCount / 2);
+
+  CheckSearch(scalar_index);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,193 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_search_batcher.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_search_batch_window_us);
+DECLARE_int32(vector_search_batch_max_vector_count);
+
+class VectorSearchBatcherTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    window_us_ = FLAGS_vector_search_batch_window_us;
+    max_vector_count_ = FLAGS_vector_search_batch_max_vector_count;
+  }
+
+  void TearDown() override {
+    FLAGS_vector_search_batch_window_us = window_us_;
+    FLAGS_vector_search_batch_max_vector_count = max_vector_count_;
+  }
+
+  static std::vector<pb::common::VectorWithId> GenQueries(int64_t start_id, int count) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int i = 0; i < count; ++i) {
+      vector_with_ids.emplace_back().set_id(start_id + i);
+    }
+    return vector_with_ids;
+  }
+
+  // Echo the query id as the result id, so it is easy to check split.
+  static butil::Status EchoSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    for (const auto& vector_with_id : vector_with_ids) {
+      results.emplace_back().add_vector_with_distances()->mutable_vector_with_id()->set_id(vector_with_id.id());
+    }
+    return butil::Status::OK();
+  }
+
+  int64_t window_us_;
+  int32_t max_vector_count_;
+};
+
+TEST_F(VectorSearchBatcherTest, GenKey) {
+  pb::common::Range range;
+  range.set_start_key("a");
+  range.set_end_key("b");
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_hnsw()->set_efsearch(32);
+
+  auto key = VectorSearchBatcher::GenKey(10, true, range, parameter);
+
+  // Parameters not used by index search do not change key.
+  auto parameter2 = parameter;
+  parameter2.set_without_scalar_data(true);
+  parameter2.add_selected_keys("key");
+  EXPECT_EQ(key, VectorSearchBatcher::GenKey(10, true, range, parameter2));
+
+  EXPECT_NE(key, VectorSearchBatcher::GenKey(11, true, range, parameter));
+  EXPECT_NE(key, VectorSearchBatcher::GenKey(10, false, range, parameter));
+  parameter2.mutable_hnsw()->set_efsearch(64);
+  EXPECT_NE(key, VectorSearchBatcher::GenKey(10, true, range, parameter2));
+  range.set_end_key("c");
+  EXPECT_NE(key, VectorSearchBatcher::GenKey(10, true, range, parameter));
+}
+
+TEST_F(VectorSearchBatcherTest, Single) {
+  auto batcher = VectorSearchBatcher::New(1);
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto status = batcher->Search("key", GenQueries(1, 3), EchoSearch, results);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(3, results.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i + 1, results[i].vector_with_distances(0).vector_with_id().id());
+  }
+}
+
+TEST_F(VectorSearchBatcherTest, Concurrent) {
+  FLAGS_vector_search_batch_window_us = 5000;
+  FLAGS_vector_search_batch_max_vector_count = 16;
+  auto batcher = VectorSearchBatcher::New(1);
+
+  std::mutex mutex;
+  std::vector<size_t> batch_sizes;
+  auto search_func = [&](const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                         std::vector<pb::index::VectorWithDistanceResult>& results) {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      batch_sizes.push_back(vector_with_ids.size());
+    }
+    return EchoSearch(vector_with_ids, results);
+  };
+
+  std::atomic<int32_t> fail_num = 0;
+  std::atomic<size_t> query_num = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 16; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < 20; ++j) {
+        int64_t start_id = (i * 100 + j) * 10;
+        int count = 1 + (i + j) % 3;
+        // Two kinds of key, only searches with same key are merged.
+        std::string key = (i % 2 == 0) ? "key1" : "key2";
+        query_num += count;
+
+        std::vector<pb::index::VectorWithDistanceResult> results;
+        auto status = batcher->Search(key, GenQueries(start_id, count), search_func, results);
+        if (!status.ok() || static_cast<int>(results.size()) != count) {
+          ++fail_num;
+          continue;
+        }
+        for (int k = 0; k < count; ++k) {
+          if (results[k].vector_with_distances(0).vector_with_id().id() != start_id + k) {
+            ++fail_num;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0, fail_num.load());
+
+  size_t max_batch_size = 0;
+  size_t total_size = 0;
+  for (auto size : batch_sizes) {
+    max_batch_size = std::max(max_batch_size, size);
+    total_size += size;
+  }
+  EXPECT_LE(max_batch_size, 16);
+  EXPECT_GT(max_batch_size, 3);
+  EXPECT_LT(batch_sizes.size(), 16 * 20);
+  EXPECT_EQ(query_num.load(), total_size);
+}
+
+TEST_F(VectorSearchBatcherTest, Error) {
+  FLAGS_vector_search_batch_window_us = 5000;
+  auto batcher = VectorSearchBatcher::New(1);
+
+  auto search_func = [&](const std::vector<pb::common::VectorWithId>&,
+                         std::vector<pb::index::VectorWithDistanceResult>&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return butil::Status(pb::error::EINTERNAL, "search failed");
+  };
+
+  std::atomic<int32_t> fail_num = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status = batcher->Search("key", GenQueries(1, 1), search_func, results);
+      if (status.error_code() == pb::error::EINTERNAL && results.empty()) {
+        ++fail_num;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(8, fail_num.load());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/error.pb.h"
+#include "vector/vector_search_executor.h"
+
+namespace dingodb {
+
+class VectorSearchExecutorTest : public testing::Test {};
+
+TEST_F(VectorSearchExecutorTest, Execute) {
+  auto& executor = VectorSearchExecutor::GetInstance();
+  EXPECT_GT(executor.WorkerNum(), 0);
+
+  auto caller_thread_id = std::this_thread::get_id();
+  std::thread::id run_thread_id;
+  int64_t sum = 0;
+  auto status = executor.Execute([&]() {
+    run_thread_id = std::this_thread::get_id();
+    for (int i = 1; i <= 100; ++i) {
+      sum += i;
+    }
+  });
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(5050, sum);
+  EXPECT_NE(caller_thread_id, run_thread_id);
+}
+
+TEST_F(VectorSearchExecutorTest, Exception) {
+  auto status = VectorSearchExecutor::GetInstance().Execute([]() { throw std::runtime_error("faiss error"); });
+  EXPECT_EQ(pb::error::EINTERNAL, status.error_code());
+
+  // The worker still work after exception.
+  bool done = false;
+  status = VectorSearchExecutor::GetInstance().Execute([&]() { done = true; });
+  EXPECT_TRUE(status.ok());
+  EXPECT_TRUE(done);
+}
+
+TEST_F(VectorSearchExecutorTest, Concurrency) {
+  auto& executor = VectorSearchExecutor::GetInstance();
+
+  std::atomic<int32_t> running_num = 0;
+  std::atomic<int32_t> max_running_num = 0;
+  std::atomic<int32_t> done_num = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 32; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 10; ++j) {
+        auto status = executor.Execute([&]() {
+          int32_t num = ++running_num;
+          int32_t max_num = max_running_num.load();
+          while (num > max_num && !max_running_num.compare_exchange_weak(max_num, num)) {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          --running_num;
+        });
+        if (status.ok()) {
+          ++done_num;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(32 * 10, done_num.load());
+  EXPECT_LE(max_running_num.load(), executor.WorkerNum());
+  EXPECT_EQ(0, executor.PendingTaskCount());
+}
+
+}  // namespace dingodb